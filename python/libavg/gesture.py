@@ -19,21 +19,23 @@
 # Current versions can be found at www.libavg.de
 #
 
-from libavg import avg, statemachine, player, filter
+from libavg import avg, statemachine, player
 
-import weakref
 import warnings
 
 import math
 
+# The recognizers below are implemented natively (see avg.Recognizer) and only send
+# their messages to python. This class stays available as a base class for recognizers
+# written in python; it uses the same message IDs as the native recognizers.
 class Recognizer(avg.Publisher):
 
-    POSSIBLE = avg.Publisher.genMessageID()
-    DETECTED = avg.Publisher.genMessageID()
-    FAILED = avg.Publisher.genMessageID()
-    MOTION = avg.Publisher.genMessageID()
-    UP = avg.Publisher.genMessageID()
-    END = avg.Publisher.genMessageID()
+    POSSIBLE = avg.Recognizer.POSSIBLE
+    DETECTED = avg.Recognizer.DETECTED
+    FAILED = avg.Recognizer.FAILED
+    MOTION = avg.Recognizer.MOTION
+    UP = avg.Recognizer.UP
+    END = avg.Recognizer.END
 
     def __init__(self, node, isContinuous, maxContacts, initialEvent,
             possibleHandler=None, failHandler=None, detectedHandler=None,
@@ -225,46 +227,21 @@ class Recognizer(avg.Publisher):
                     avg.Node.CURSOR_DOWN, self.__onDown)
 
 
-class TapRecognizer(Recognizer):
+class TapRecognizer(avg.TapRecognizer):
 
     MAX_TAP_DIST = None 
 
     def __init__(self, node, maxTime=None, maxDist=None, initialEvent=None,
             possibleHandler=None, failHandler=None, detectedHandler=None):
-        self.__maxTime = maxTime
+        if maxTime is None:
+            maxTime = 0
         if maxDist is None:
             maxDist = TapRecognizer.MAX_TAP_DIST
-        self.__maxDist = maxDist
-        super(TapRecognizer, self).__init__(node, False, 1, initialEvent,
+        super(TapRecognizer, self).__init__(node, maxTime, maxDist, initialEvent,
                 possibleHandler, failHandler, detectedHandler)
 
-    def _handleDown(self, event):
-        self._setPossible(event)
-        self.__startTime = player.getFrameTime()
-
-    def _handleMove(self, event):
-        if self.getState() != "IDLE": 
-            if (event.contact.distancefromstart > 
-                    self.__maxDist*player.getPixelsPerMM()):
-                self._setFail(event)
-
-    def _handleUp(self, event):
-        if self.getState() == "POSSIBLE":
-            if (event.contact.distancefromstart > 
-                    self.__maxDist*player.getPixelsPerMM()):
-                self._setFail(event)
-            else:
-                self._setDetected(event)
-
-    def _onFrame(self):
-        downTime = player.getFrameTime() - self.__startTime
-        if self.getState() == "POSSIBLE":
-            if self.__maxTime and downTime > self.__maxTime:
-                self._setFail(None)
-        super(TapRecognizer, self)._onFrame()
 
-
-class DoubletapRecognizer(Recognizer):
+class DoubletapRecognizer(avg.DoubletapRecognizer):
 
     MAX_DOUBLETAP_TIME = None
 
@@ -272,82 +249,13 @@ class DoubletapRecognizer(Recognizer):
             possibleHandler=None, failHandler=None, detectedHandler=None):
         if maxTime is None:
             maxTime = DoubletapRecognizer.MAX_DOUBLETAP_TIME
-        self.__maxTime = maxTime
         if maxDist is None:
             maxDist = TapRecognizer.MAX_TAP_DIST
-        self.__maxDist = maxDist
-
-        self.__stateMachine = statemachine.StateMachine("DoubletapRecognizer", "IDLE")
-        self.__stateMachine.addState("IDLE", ("DOWN1",), enterFunc=self.__enterIdle)
-        self.__stateMachine.addState("DOWN1", ("UP1", "IDLE"))
-        self.__stateMachine.addState("UP1", ("DOWN2", "IDLE"))
-        self.__stateMachine.addState("DOWN2", ("IDLE",))
-        #self.__stateMachine.traceChanges(True)
-        self.__frameHandlerID = None
-        super(DoubletapRecognizer, self).__init__(node, False, 1, 
+        super(DoubletapRecognizer, self).__init__(node, maxTime, maxDist, 
                 initialEvent, possibleHandler, failHandler, detectedHandler)
 
-    def abort(self):
-        if self.__stateMachine.state != "IDLE":
-            self.__stateMachine.changeState("IDLE")
-        super(DoubletapRecognizer, self).abort()
-
-    def enable(self, isEnabled):
-        if self.__stateMachine.state != "IDLE":
-            self.__stateMachine.changeState("IDLE")
-        super(DoubletapRecognizer, self).enable(isEnabled)
-
-    def _handleDown(self, event):
-        self.__startTime = player.getFrameTime()
-        if self.__stateMachine.state == "IDLE":
-            self.__frameHandlerID = player.subscribe(player.ON_FRAME, self.__onFrame)
-            self.__stateMachine.changeState("DOWN1")
-            self.__startPos = event.pos
-            self._setPossible(event)
-        elif self.__stateMachine.state == "UP1":
-            if ((event.pos - self.__startPos).getNorm() > 
-                    self.__maxDist*player.getPixelsPerMM()):
-                self.__stateMachine.changeState("IDLE")
-                self._setFail(event)
-            else:
-                self.__stateMachine.changeState("DOWN2")
-        else:
-            assert(False), self.__stateMachine.state
-
-    def _handleMove(self, event):
-        if self.__stateMachine.state != "IDLE": 
-            if ((event.pos - self.__startPos).getNorm() > 
-                    self.__maxDist*player.getPixelsPerMM()):
-                self.__stateMachine.changeState("IDLE")
-                self._setFail(event)
-
-    def _handleUp(self, event):
-        if self.__stateMachine.state == "DOWN1":
-            self.__startTime = player.getFrameTime()
-            self.__stateMachine.changeState("UP1")
-        elif self.__stateMachine.state == "DOWN2":
-            if ((event.pos - self.__startPos).getNorm() >
-                    self.__maxDist*player.getPixelsPerMM()):
-                self._setFail(event)
-            else:
-                self._setDetected(event)
-            self.__stateMachine.changeState("IDLE")
-        elif self.__stateMachine.state == "IDLE":
-            pass
-        else:
-            assert(False), self.__stateMachine.state
-
-    def __onFrame(self):
-        downTime = player.getFrameTime() - self.__startTime
-        if downTime > self.__maxTime:
-            self._setFail(None)
-            self.__stateMachine.changeState("IDLE")
-
-    def __enterIdle(self):
-        player.unsubscribe(player.ON_FRAME, self.__frameHandlerID)
-
 
-class SwipeRecognizer(Recognizer):
+class SwipeRecognizer(avg.SwipeRecognizer):
 
     LEFT = 1
     RIGHT = 2
@@ -362,62 +270,12 @@ class SwipeRecognizer(Recognizer):
             directionTolerance=SWIPE_DIRECTION_TOLERANCE, minDist=MIN_SWIPE_DIST, 
             maxContactDist=MAX_SWIPE_CONTACT_DIST,
             possibleHandler=None, failHandler=None, detectedHandler=None):
-
-        self.__numContacts = numContacts
-        self.__angleWanted = self.__angleFromDirection(direction)
-        self.__directionTolerance = directionTolerance
-        self.__minDist = minDist*player.getPixelsPerMM()
-        self.__maxInterContactDist = maxContactDist*player.getPixelsPerMM()
-        super(SwipeRecognizer, self).__init__(node, False, numContacts, 
-                initialEvent, possibleHandler=possibleHandler, failHandler=failHandler, 
-                detectedHandler=detectedHandler)
-
-    def _handleDown(self, event):
-        if len(self._contacts) == 1:
-            self.__startPos = event.pos
-        else:
-            if (event.pos-self.__startPos).getNorm() > self.__maxInterContactDist:
-                self._setFail(event)
-                return
-        if len(self._contacts) == self.__numContacts:
-            self._setPossible(event)
-
-    def _handleMove(self, event):
-        pass
-
-    def _handleUp(self, event):
-        if self.getState() == "POSSIBLE":
-            if (event.contact.distancefromstart < self.__minDist or
-                    not(self.__isValidAngle(event.contact.motionangle))):
-                self._setFail(event)
-            elif len(self._contacts) == 0:
-                self._setDetected(event)
-
-    def __angleFromDirection(self, direction):
-        if direction == SwipeRecognizer.RIGHT:
-            return 0
-        elif direction == SwipeRecognizer.DOWN:
-            return math.pi/2
-        elif direction == SwipeRecognizer.LEFT:
-            return math.pi
-        elif direction == SwipeRecognizer.UP:
-            return 3*math.pi/2
-        else:
-            raise RuntimeError("%s is not a valid direction."%direction)
-
-    def __isValidAngle(self, angle):
-        if angle < 0:
-            angle += 2*math.pi
-        minAngle = self.__angleWanted - self.__directionTolerance
-        maxAngle = self.__angleWanted + self.__directionTolerance
-        if minAngle >= 0:
-            return minAngle < angle < maxAngle
-        else:
-            # Valid range spans 0
-            return angle > minAngle+2*math.pi or angle < maxAngle
+        super(SwipeRecognizer, self).__init__(node, direction, numContacts, 
+                initialEvent, directionTolerance, minDist, maxContactDist,
+                possibleHandler, failHandler, detectedHandler)
 
 
-class HoldRecognizer(Recognizer):
+class HoldRecognizer(avg.HoldRecognizer):
 
     HOLD_DELAY = None
 
@@ -426,47 +284,17 @@ class HoldRecognizer(Recognizer):
             detectedHandler=None, endHandler=None, stopHandler=None):
         if delay is None:
             delay = HoldRecognizer.HOLD_DELAY
-        self.__delay = delay
         if maxDist is None:
             maxDist = TapRecognizer.MAX_TAP_DIST
-        self.__maxDist = maxDist
-
-        self.__lastEvent = None
         if stopHandler is not None:
             endHandler = stopHandler
             warnings.warn(
                     'HoldRecognizer.stopHandler is deprecated, use endHandler instead')
-        super(HoldRecognizer, self).__init__(node, True, 1, initialEvent,
+        super(HoldRecognizer, self).__init__(node, delay, maxDist, initialEvent,
                 possibleHandler, failHandler, detectedHandler, endHandler)
 
-    def _handleDown(self, event):
-        self.__lastEvent = event
-        self._setPossible(event)
-        self.__startTime = player.getFrameTime()
-
-    def _handleMove(self, event):
-        self.__lastEvent = event
-        if self.getState() == "POSSIBLE": 
-            if (event.contact.distancefromstart > 
-                    self.__maxDist*player.getPixelsPerMM()):
-                self._setFail(event)
-
-    def _handleUp(self, event):
-        self.__lastEvent = event
-        if self.getState() == "POSSIBLE":
-            self._setFail(event)
-        elif self.getState() == "RUNNING":
-            self._setEnd(event)
-
-    def _onFrame(self):
-        downTime = player.getFrameTime() - self.__startTime
-        if self.getState() == "POSSIBLE":
-            if downTime > self.__delay:
-                self._setDetected(self.__lastEvent)
-        super(HoldRecognizer, self)._onFrame()
-
 
-class DragRecognizer(Recognizer):
+class DragRecognizer(avg.DragRecognizer):
 
     ANY_DIRECTION = 0
     VERTICAL = 1
@@ -481,132 +309,17 @@ class DragRecognizer(Recognizer):
             friction=None, minDragDist=None,
             possibleHandler=None, failHandler=None, detectedHandler=None,
             moveHandler=None, upHandler=None, endHandler=None):
-
-        if coordSysNode is not None:
-            self.__coordSysNode = weakref.ref(coordSysNode)
-        else:
-            self.__coordSysNode = weakref.ref(eventNode)
-        self._verifyInitialEvent(initialEvent, self.__coordSysNode())
-
-        self.__direction = direction
-        self.__directionTolerance = directionTolerance
-
-        if minDragDist is not None:
-            self.__minDragDist = minDragDist
-        else:
-            if self.__direction == DragRecognizer.ANY_DIRECTION:
-                self.__minDragDist = 0
+        if minDragDist is None:
+            if direction == DragRecognizer.ANY_DIRECTION:
+                minDragDist = 0
             else:
-                self.__minDragDist = DragRecognizer.MIN_DRAG_DIST
-
+                minDragDist = DragRecognizer.MIN_DRAG_DIST
         if friction is None:
-            self.__friction = DragRecognizer.FRICTION
-        else:
-            self.__friction = friction
-
-        self.__isSliding = False
-        self.__inertiaHandler = None
-
-        super(DragRecognizer, self).__init__(eventNode, True, 1, 
-                initialEvent, possibleHandler=possibleHandler, failHandler=failHandler, 
-                detectedHandler=detectedHandler, endHandler=endHandler)
-        self.subscribe(Recognizer.MOTION, moveHandler)
-        self.subscribe(Recognizer.UP, upHandler)
-
-    def abort(self):
-        if self.__inertiaHandler:
-            self.__inertiaHandler.abort()
-        self.__inertiaHandler = None
-        super(DragRecognizer, self).abort()
-
-    def _handleDown(self, event):
-        if not self._handleCoordSysNodeUnlinked():
-            if self.__inertiaHandler:
-                self.__inertiaHandler.abort()
-                self._setEnd(event)
-            if self.__friction != -1:
-                self.__inertiaHandler = InertiaHandler(self.__friction,
-                        self.__onInertiaMove, self.__onInertiaStop)
-            if self.__minDragDist == 0:
-                self._setDetected(event)
-            else:
-                self._setPossible(event)
-            pos = self._relEventPos(self.__coordSysNode(), event)
-            self.__dragStartPos = pos
-            self.__lastPos = pos
-
-    def _handleMove(self, event):
-        if not self._handleCoordSysNodeUnlinked():
-            if self.getState() != "IDLE":
-                pos = self._relEventPos(self.__coordSysNode(), event)
-                offset = pos - self.__dragStartPos
-                if self.getState() == "RUNNING":
-                    self.notifySubscribers(Recognizer.MOTION, [offset])
-                else:
-                    if offset.getNorm() > self.__minDragDist*player.getPixelsPerMM():
-                        if self.__angleFits(offset):
-                            self._setDetected(event)
-                            self.notifySubscribers(Recognizer.MOTION, [offset])
-                        else:
-                            self.__fail(event)
-                if self.__inertiaHandler:
-                    self.__inertiaHandler.onDrag(Transform(pos - self.__lastPos))
-                self.__lastPos = pos
-
-    def _handleUp(self, event):
-        if not self._handleCoordSysNodeUnlinked():
-            if self.getState() != "IDLE":
-                pos = self._relEventPos(self.__coordSysNode(), event)
-                if self.getState() == "RUNNING":
-                    self.__offset = pos - self.__dragStartPos
-                    self.notifySubscribers(Recognizer.UP, [self.__offset])
-                    if self.__friction != -1:
-                        self.__isSliding = True
-                        self.__inertiaHandler.onDrag(Transform(pos - self.__lastPos))
-                        self.__inertiaHandler.onUp()
-                    else:
-                        self._setEnd(event)
-                else:
-                    self.__fail(event)
-
-    def _handleCoordSysNodeUnlinked(self):
-        if self.__coordSysNode().getParent() or isinstance(
-                self.__coordSysNode(), avg.CanvasNode):
-            return False
-        else:
-            self.abort()
-            return True
-
-    def __fail(self, event):
-        self._setFail(event)
-        if self.__inertiaHandler:
-            self.__inertiaHandler.abort()
-        self.__inertiaHandler = None
-
-    def __onInertiaMove(self, transform):
-        self.__offset += transform.trans 
-        self.notifySubscribers(Recognizer.MOTION, [self.__offset])
-
-    def __onInertiaStop(self):
-        self.__inertiaHandler = None
-        self.__isSliding = False
-        if self.getState() == "POSSIBLE":
-            self._setFail(None)
-        else:
-            self._setEnd(None)
-
-    def __angleFits(self, offset):
-        angle = offset.getAngle()
-        if angle < 0:
-            angle = -angle
-        if self.__direction == DragRecognizer.VERTICAL:
-            return (math.pi/2-self.__directionTolerance < angle
-                    < math.pi/2+self.__directionTolerance)
-        elif self.__direction == DragRecognizer.HORIZONTAL:
-            return (angle < self.__directionTolerance 
-                    or angle > math.pi-self.__directionTolerance)
-        else:
-            return True
+            friction = DragRecognizer.FRICTION
+        super(DragRecognizer, self).__init__(eventNode, coordSysNode, initialEvent,
+                direction, directionTolerance, friction, minDragDist, 
+                possibleHandler, failHandler, detectedHandler, moveHandler, upHandler,
+                endHandler)
 
 
 class Mat3x3(object):
@@ -740,275 +453,27 @@ def calcKMeans(pts):
     return l1, l2
 
 
-class Transform(object):
-    def __init__(self, trans, rot=0, scale=1, pivot=(0,0)):
-        self.trans = avg.Point2D(trans)
-        self.rot = rot
-        self.scale = scale
-        self.pivot = avg.Point2D(pivot)
-
-    def moveNode(self, node):
-        transMat = Mat3x3.translate(self.trans)
-        rotMat = Mat3x3.rotate(self.rot)
-        scaleMat = Mat3x3.scale((self.scale, self.scale))
-        pivotMat = Mat3x3.translate(self.pivot)
-        invPivotMat = pivotMat.inverse()
-        startTransform = Mat3x3.fromNode(node)
-        newTransform = pivotMat.applyMat(
-                rotMat.applyMat(
-                scaleMat.applyMat(
-                invPivotMat.applyMat(
-                transMat.applyMat(
-                startTransform)))))
-        newTransform.setNodeTransform(node)
-
-    def __repr__(self):
-        return "Transform" + str((self.trans, self.rot, self.scale, self.pivot))
+Transform = avg.Transform
 
 
-class TransformRecognizer(Recognizer):
+class TransformRecognizer(avg.TransformRecognizer):
 
     FILTER_MIN_CUTOFF = None
     FILTER_BETA = None
 
     def __init__(self, eventNode, coordSysNode=None, initialEvent=None, friction=None, 
             detectedHandler=None, moveHandler=None, upHandler=None, endHandler=None):
-        if coordSysNode is not None:
-            self.__coordSysNode = weakref.ref(coordSysNode)
-        else:
-            self.__coordSysNode = weakref.ref(eventNode)
-        self._verifyInitialEvent(initialEvent, self.__coordSysNode())
-        
         if friction is None:
-            self.__friction = DragRecognizer.FRICTION
-        else:
-            self.__friction = friction
-
-        self.__baseTransform = Mat3x3()
-        self.__lastPosns = []
-        self.__posns = []
-        self.__inertiaHandler = None
-        self.__filters = {}
-        self.__frameHandlerID = None
-
-        super(TransformRecognizer, self).__init__(eventNode, True, None, 
-                initialEvent, detectedHandler=detectedHandler, endHandler=endHandler)
-        self.subscribe(Recognizer.MOTION, moveHandler)
-        self.subscribe(Recognizer.UP, upHandler)
-
-    def enable(self, isEnabled):
-        if bool(isEnabled) != self.isEnabled() and not(isEnabled):
-            self.__abort()
-        super(TransformRecognizer, self).enable(isEnabled)
-
-    def abort(self):
-        self.__abort()
-        super(TransformRecognizer, self).abort()
-
-    def _handleDown(self, event):
-        numContacts = len(self._contacts)
-        self.__newPhase()
-        if self.__isFiltered():
-            self.__filters[event.contact] = [
-                    filter.OneEuroFilter(mincutoff=TransformRecognizer.FILTER_MIN_CUTOFF, 
-                            beta=TransformRecognizer.FILTER_BETA),
-                    filter.OneEuroFilter(mincutoff=TransformRecognizer.FILTER_MIN_CUTOFF,
-                            beta=TransformRecognizer.FILTER_BETA)]
-        if numContacts == 1:
-            if self.__inertiaHandler:
-                self.__inertiaHandler.abort()
-                self._setEnd(event)
-            self._setDetected(event)
-            self.__frameHandlerID = player.subscribe(player.ON_FRAME, self.__onFrame)
-            if self.__friction != -1:
-                self.__inertiaHandler = InertiaHandler(self.__friction, 
-                        self.__onInertiaMove, self.__onInertiaStop)
-
-    def _handleUp(self, event):
-        numContacts = len(self._contacts)
-        if numContacts == 0:
-            contact = event.contact
-            transform = Transform(self.__filteredRelContactPos(contact)
-                    - self.__lastPosns[0])
-            player.unsubscribe(player.ON_FRAME, self.__frameHandlerID)
-            self.__frameHandlerID = None
-            if self.__friction != -1:
-                self.__inertiaHandler.onDrag(transform)
-                self.__inertiaHandler.onUp()
-            else:
-                self._setEnd(event)
-            self.notifySubscribers(Recognizer.UP, [transform])
-        elif numContacts == 1:
-            self.__newPhase()
-        else:
-            self.__newPhase()
-        if self.__isFiltered():
-            del self.__filters[event.contact]
-
-    def _handleNodeGone(self):
-        if ((self.__coordSysNode and not(self.__coordSysNode())) or
-                (self.__coordSysNode().getParent() is None and
-                 not isinstance(self.__coordSysNode(), avg.CanvasNode))):
-            self.enable(False)
-            return True
-        else:
-            return super(TransformRecognizer, self)._handleNodeGone()
-
-    def __onFrame(self):
-        nodeGone = self._handleNodeGone()
-        if not(nodeGone):
-            self.__move()
-
-    def __move(self):
-        numContacts = len(self._contacts)
-        contactPosns = [self.__filteredRelContactPos(contact)
-                for contact in self._contacts]
-        if numContacts == 1:
-            transform = Transform(contactPosns[0] - self.__lastPosns[0])
-            if self.__friction != -1:
-                self.__inertiaHandler.onDrag(transform)
-            self.notifySubscribers(Recognizer.MOTION, [transform])
-            self.__lastPosns = contactPosns
-        else:
-            if numContacts == 2:
-                self.__posns = contactPosns
-            else:
-                self.__posns = [getCentroid(self.__clusters[i], contactPosns) for
-                        i in range(2)]
-
-            startDelta = self.__lastPosns[1]-self.__lastPosns[0]
-            curDelta = self.__posns[1]-self.__posns[0]
-
-            pivot = (self.__posns[0]+self.__posns[1])/2
-
-            rot = avg.Point2D.angle(curDelta, startDelta)
-
-            if self.__lastPosns[0] == self.__lastPosns[1]:
-                scale = 1
-            else:
-                scale = ((self.__posns[0]-self.__posns[1]).getNorm() / 
-                        (self.__lastPosns[0]-self.__lastPosns[1]).getNorm())
-
-            trans = ((self.__posns[0]+self.__posns[1])/2 - 
-                    (self.__lastPosns[0]+self.__lastPosns[1])/2)
-            transform = Transform(trans, rot, scale, pivot)
-            if self.__friction != -1:
-                self.__inertiaHandler.onDrag(transform)
-            self.notifySubscribers(Recognizer.MOTION, [transform])
-            self.__lastPosns = self.__posns
-
-    def __newPhase(self):
-        self.__lastPosns = []
-        numContacts = len(self._contacts)
-        contactPosns = [self.__relContactPos(contact) 
-                for contact in self._contacts]
-        if numContacts == 1:
-            self.__lastPosns.append(contactPosns[0])
-        else:
-            if numContacts == 2:
-                self.__lastPosns = contactPosns
-            else:
-                self.__clusters = calcKMeans(contactPosns)
-                self.__lastPosns = [getCentroid(self.__clusters[i], contactPosns) for
-                        i in range(2)]
-
-    def __onInertiaMove(self, transform):
-        self.notifySubscribers(Recognizer.MOTION, [transform])
-
-    def __onInertiaStop(self):
-        self.__inertiaHandler = None
-        self._setEnd(None)
-
-    def __filteredRelContactPos(self, contact):
-        rawPos = self.__relContactPos(contact)
-        if self.__isFiltered():
-            f = self.__filters[contact]
-            return avg.Point2D(f[0].apply(rawPos.x, player.getFrameTime()),
-                    f[1].apply(rawPos.y, player.getFrameTime()))
-        else:
-            return rawPos
-
-    def __relContactPos(self, contact):
-        return self._relEventPos(self.__coordSysNode(), contact.events[-1])
-
-    def __isFiltered(self):
-        return TransformRecognizer.FILTER_MIN_CUTOFF is not None
-
-    def __abort(self):
-        if self.__frameHandlerID:
-            player.unsubscribe(player.ON_FRAME, self.__frameHandlerID)
-            self.__frameHandlerID = None
-        if self.__inertiaHandler:
-            self.__inertiaHandler.abort()
-            self.__inertiaHandler = None
-
-
-class InertiaHandler(object):
-    def __init__(self, friction, moveHandler, stopHandler):
-        self.__friction = friction
-        self.__moveHandler = moveHandler
-        self.__stopHandler = stopHandler
-
-        self.__transVel = avg.Point2D(0, 0)
-        self.__curPivot = avg.Point2D(0, 0)
-        self.__angVel = 0
-        self.__sizeVel = avg.Point2D(0, 0)
-        self.__frameHandlerID = player.subscribe(player.ON_FRAME, self.__onDragFrame)
-
-    def abort(self):
-        player.unsubscribe(player.ON_FRAME, self.__frameHandlerID)
-        self.__stopHandler = None
-        self.__moveHandler = None
-
-    def onDrag(self, transform):
-        frameDuration = player.getFrameDuration()
-        if frameDuration > 0:
-            self.__transVel += 0.1*transform.trans/frameDuration
-        if transform.pivot != avg.Point2D(0,0):
-            self.__curPivot = transform.pivot
-        if transform.rot > math.pi:
-            transform.rot -= 2*math.pi
-        if frameDuration > 0:
-            self.__angVel += 0.1*transform.rot/frameDuration
-
-    def onUp(self):
-        player.unsubscribe(player.ON_FRAME, self.__frameHandlerID)
-        self.__frameHandlerID = player.subscribe(player.ON_FRAME, self.__onInertiaFrame)
-        self.__onInertiaFrame()
-
-    def __onDragFrame(self):
-        self.__transVel *= 0.9
-        self.__angVel *= 0.9
-
-    def __onInertiaFrame(self):
-        transNorm = self.__transVel.getNorm()
-        if transNorm - self.__friction > 0:
-            direction = self.__transVel.getNormalized()
-            self.__transVel = direction * (transNorm-self.__friction)
-            curTrans = self.__transVel * player.getFrameDuration()
+            friction = DragRecognizer.FRICTION
+        if TransformRecognizer.FILTER_MIN_CUTOFF is None:
+            filterMinCutoff = -1
+            filterBeta = 0
         else:
-            curTrans = avg.Point2D(0, 0)
-
-        if self.__angVel != 0:
-            angSign = self.__angVel/math.fabs(self.__angVel)
-            self.__angVel -= angSign * self.__friction / 200
-            newAngSign = self.__angVel/math.fabs(self.__angVel)
-            if newAngSign != angSign:
-                self.__angVel = 0
-        curAng = self.__angVel * player.getFrameDuration()
-        self.__curPivot += curTrans
-
-        if transNorm - self.__friction > 0 or self.__angVel != 0:
-            if self.__moveHandler:
-                self.__moveHandler(Transform(curTrans,  curAng, 1, self.__curPivot))
-        else:
-            self.__stop()
-
-    def __stop(self):
-        player.unsubscribe(player.ON_FRAME, self.__frameHandlerID)
-        self.__stopHandler()
-        self.__stopHandler = None
-        self.__moveHandler = None
+            filterMinCutoff = TransformRecognizer.FILTER_MIN_CUTOFF
+            filterBeta = TransformRecognizer.FILTER_BETA
+        super(TransformRecognizer, self).__init__(eventNode, coordSysNode, 
+                initialEvent, friction, filterMinCutoff, filterBeta, detectedHandler, 
+                moveHandler, upHandler, endHandler)
 
     
 def initConfig():
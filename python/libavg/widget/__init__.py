@@ -5,3 +5,4 @@ from scrollarea import ScrollPane, ScrollArea
 from skin import Skin
 from slider import Slider, ScrollBar, ScrollBarTrack, ScrollBarThumb, SliderThumb, ProgressBar
 from mediacontrol import TimeSlider, MediaControl
+from tiledimage import TilePyramid, TiledImageNode, generateTilePyramid
@@ -0,0 +1,421 @@
+# -*- coding: utf-8 -*-
+# libavg - Media Playback Engine.
+# Copyright (C) 2003-2014 Ulrich von Zadow
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+#
+# Current versions can be found at www.libavg.de
+
+import math
+import os
+import collections
+import xml.etree.ElementTree as ET
+
+import libavg
+from libavg import avg, player
+
+
+DZI_NAMESPACE = "http://schemas.microsoft.com/deepzoom/2008"
+
+
+class TilePyramid(object):
+
+    def __init__(self, dziPath, size, tileSize=256, overlap=0, format="png"):
+        self.dziPath = dziPath
+        self.size = (int(size[0]), int(size[1]))
+        self.tileSize = int(tileSize)
+        self.overlap = int(overlap)
+        self.format = format
+        self.maxLevel = (max(self.size)-1).bit_length()
+
+        base = os.path.splitext(dziPath)[0]
+        self.__tileDir = base + "_files"
+
+    @classmethod
+    def fromDZI(cls, dziPath):
+        try:
+            xmlRoot = ET.parse(dziPath).getroot()
+        except (IOError, ET.ParseError) as e:
+            raise RuntimeError("Can't read tile pyramid '%s': %s" % (dziPath, str(e)))
+        sizeNode = xmlRoot.find("{%s}Size" % DZI_NAMESPACE)
+        if sizeNode is None:
+            sizeNode = xmlRoot.find("Size")
+        if sizeNode is None:
+            raise RuntimeError("'%s' is not a deep zoom image descriptor." % dziPath)
+        size = (int(sizeNode.get("Width")), int(sizeNode.get("Height")))
+        return cls(dziPath, size, int(xmlRoot.get("TileSize")),
+                int(xmlRoot.get("Overlap")), xmlRoot.get("Format"))
+
+    def getLevelSize(self, level):
+        scale = 2**(self.maxLevel-level)
+        return tuple(int(math.ceil(float(extent)/scale)) for extent in self.size)
+
+    def getNumTiles(self, level):
+        return tuple(int(math.ceil(float(extent)/self.tileSize))
+                for extent in self.getLevelSize(level))
+
+    def getTileRect(self, level, col, row):
+        # Returns (tl, br) of the tile in level coordinates, including overlap.
+        levelWidth, levelHeight = self.getLevelSize(level)
+        left = max(col*self.tileSize - self.overlap, 0)
+        top = max(row*self.tileSize - self.overlap, 0)
+        right = min((col+1)*self.tileSize + self.overlap, levelWidth)
+        bottom = min((row+1)*self.tileSize + self.overlap, levelHeight)
+        return (avg.Point2D(left, top), avg.Point2D(right, bottom))
+
+    def getTilePath(self, level, col, row):
+        return os.path.join(self.__tileDir, str(level),
+                "%i_%i.%s" % (col, row, self.format))
+
+    def getBaseLevel(self):
+        # The finest level that fits into a single tile.
+        level = self.maxLevel
+        while level > 0 and self.getNumTiles(level) != (1, 1):
+            level -= 1
+        return level
+
+
+def generateTilePyramid(src, dziPath, tileSize=256, overlap=0, format="png"):
+    # Each level is generated by halving the previous one.
+    if isinstance(src, basestring):
+        bmp = avg.Bitmap(src)
+    else:
+        bmp = src
+    pyramid = TilePyramid(dziPath, bmp.getSize(), tileSize, overlap, format)
+
+    xmlRoot = ET.Element("Image", {"xmlns": DZI_NAMESPACE, "TileSize": str(tileSize),
+            "Overlap": str(overlap), "Format": format})
+    ET.SubElement(xmlRoot, "Size", {"Width": str(pyramid.size[0]),
+            "Height": str(pyramid.size[1])})
+    ET.ElementTree(xmlRoot).write(dziPath, encoding="UTF-8")
+
+    for level in range(pyramid.maxLevel, -1, -1):
+        levelSize = avg.Point2D(pyramid.getLevelSize(level))
+        if bmp.getSize() != levelSize:
+            bmp = bmp.getResized(levelSize)
+        levelDir = os.path.dirname(pyramid.getTilePath(level, 0, 0))
+        if not os.path.isdir(levelDir):
+            os.makedirs(levelDir)
+        numCols, numRows = pyramid.getNumTiles(level)
+        for row in range(numRows):
+            for col in range(numCols):
+                tl, br = pyramid.getTileRect(level, col, row)
+                if tl == avg.Point2D(0,0) and br == levelSize:
+                    tileBmp = bmp
+                else:
+                    tileBmp = avg.Bitmap(bmp, tl, br)
+                tileBmp.save(pyramid.getTilePath(level, col, row))
+    return pyramid
+
+
+class _LRUCache(object):
+
+    def __init__(self, capacity):
+        self.capacity = capacity
+        self.__items = collections.OrderedDict()
+        self.__memUsed = 0
+
+    def __contains__(self, key):
+        return key in self.__items
+
+    def __len__(self):
+        return len(self.__items)
+
+    def get(self, key):
+        item = self.__items.pop(key, None)
+        if item is not None:
+            self.__items[key] = item
+            return item[0]
+        else:
+            return None
+
+    def add(self, key, value, numBytes):
+        assert(key not in self.__items)
+        self.__items[key] = (value, numBytes)
+        self.__memUsed += numBytes
+
+    def items(self):
+        return [(key, item[0]) for key, item in self.__items.iteritems()]
+
+    def getMemUsed(self):
+        return self.__memUsed
+
+    def trim(self, protectedKeys):
+        # Drops least recently used items until the cache fits its capacity. Returns the
+        # values dropped.
+        evicted = []
+        for key in self.__items.keys():
+            if self.__memUsed <= self.capacity:
+                break
+            if key not in protectedKeys:
+                value, numBytes = self.__items.pop(key)
+                self.__memUsed -= numBytes
+                evicted.append(value)
+        return evicted
+
+    def clear(self):
+        values = [item[0] for item in self.__items.itervalues()]
+        self.__items.clear()
+        self.__memUsed = 0
+        return values
+
+
+class TiledImageNode(avg.DivNode):
+
+    MAX_PENDING_TILES = 8
+    PREFETCH_TIME = 500
+
+    def __init__(self, pyramid, zoom=1.0, offset=(0,0), cpuCapacity=64*1024*1024,
+            gpuCapacity=32*1024*1024, crop=True, parent=None, **kwargs):
+        super(TiledImageNode, self).__init__(crop=crop, **kwargs)
+        self.registerInstance(self, parent)
+
+        if isinstance(pyramid, basestring):
+            self.__pyramid = TilePyramid.fromDZI(pyramid)
+        else:
+            self.__pyramid = pyramid
+        if self.width == 0:
+            self.width = self.__pyramid.size[0]
+        if self.height == 0:
+            self.height = self.__pyramid.size[1]
+
+        self.__zoom = float(zoom)
+        self.__offset = avg.Point2D(offset)
+        self.__lastZoom = self.__zoom
+        self.__lastOffset = self.__offset
+        self.__lastFrameTime = None
+        self.__zoomSpeed = 0.0
+        self.__panSpeed = avg.Point2D(0,0)
+
+        self.__cpuCache = _LRUCache(cpuCapacity)
+        self.__gpuCache = _LRUCache(gpuCapacity)
+        self.__pendingTiles = set()
+        self.__failedTiles = set()
+        self.__loadQueue = []
+        self.__isDirty = True
+
+        # One div per level, coarse levels at the bottom: Tiles that are still missing
+        # show the coarser tiles that are underneath.
+        self.__levelDivs = [avg.DivNode(parent=self)
+                for i in range(self.__pyramid.maxLevel+1)]
+        self.__baseLevel = self.__pyramid.getBaseLevel()
+        self.__baseNode = avg.ImageNode(parent=self.__levelDivs[self.__baseLevel])
+        avg.BitmapManager.get().loadBitmap(
+                self.__pyramid.getTilePath(self.__baseLevel, 0, 0), self.__onBaseLoaded)
+
+        self.subscribe(self.SIZE_CHANGED, lambda newSize: self.__setDirty())
+        self.subscribe(self.KILLED, self.__onKilled)
+        self.__frameHandlerID = player.subscribe(player.ON_FRAME, self.__onFrame)
+
+    @property
+    def pyramid(self):
+        return self.__pyramid
+
+    def getZoom(self):
+        return self.__zoom
+
+    def setZoom(self, zoom):
+        if zoom <= 0:
+            raise RuntimeError("TiledImageNode: zoom must be positive (is %f)." % zoom)
+        self.__zoom = float(zoom)
+        self.__setDirty()
+
+    zoom = property(getZoom, setZoom)
+
+    def getOffset(self):
+        return self.__offset
+
+    def setOffset(self, offset):
+        self.__offset = avg.Point2D(offset)
+        self.__setDirty()
+
+    offset = property(getOffset, setOffset)
+
+    def getCapacity(self):
+        return (self.__cpuCache.capacity, self.__gpuCache.capacity)
+
+    def setCapacity(self, capacity):
+        self.__cpuCache.capacity, self.__gpuCache.capacity = capacity
+        self.__setDirty()
+
+    capacity = property(getCapacity, setCapacity)
+
+    def getNumTiles(self):
+        return (len(self.__cpuCache), len(self.__gpuCache))
+
+    def getMemUsed(self):
+        return (self.__cpuCache.getMemUsed(), self.__gpuCache.getMemUsed())
+
+    def getNumPendingTiles(self):
+        return len(self.__pendingTiles) + len(self.__loadQueue)
+
+    def zoomAt(self, pos, factor):
+        # Zooms by factor, keeping the image point under pos (in node coordinates) fixed.
+        imagePos = self.__offset + avg.Point2D(pos)/self.__zoom
+        self.setZoom(self.__zoom*factor)
+        self.setOffset(imagePos - avg.Point2D(pos)/self.__zoom)
+
+    def __setDirty(self):
+        self.__isDirty = True
+
+    def __onKilled(self):
+        if self.__frameHandlerID is not None:
+            player.unsubscribe(player.ON_FRAME, self.__frameHandlerID)
+            self.__frameHandlerID = None
+        self.__cpuCache.clear()
+        for node in self.__gpuCache.clear():
+            node.unlink(True)
+
+    def __onFrame(self):
+        self.__updateSpeed()
+        if self.__isDirty:
+            self.__isDirty = False
+            self.__update()
+
+    def __updateSpeed(self):
+        # Smoothed pan and zoom speeds per millisecond. Zoom speed is measured in levels.
+        frameTime = player.getFrameTime()
+        if self.__lastFrameTime is not None and frameTime > self.__lastFrameTime:
+            dt = float(frameTime - self.__lastFrameTime)
+            panSpeed = (self.__offset - self.__lastOffset)/dt
+            zoomSpeed = math.log(self.__zoom/self.__lastZoom, 2)/dt
+            self.__panSpeed = self.__panSpeed*0.5 + panSpeed*0.5
+            self.__zoomSpeed = self.__zoomSpeed*0.5 + zoomSpeed*0.5
+        self.__lastFrameTime = frameTime
+        self.__lastOffset = self.__offset
+        self.__lastZoom = self.__zoom
+
+    def __update(self):
+        level = self.__getLevel(self.__zoom)
+        shownTiles = set()
+        missingTiles = []
+        for tile in self.__getTilesInView(level, self.__offset, self.__zoom):
+            if tile[0] == self.__baseLevel:
+                # Always shown by the base node.
+                continue
+            if self.__showTile(tile):
+                shownTiles.add(tile)
+            else:
+                if tile not in self.__failedTiles:
+                    missingTiles.append(tile)
+                ancestor = self.__findCachedAncestor(tile)
+                if ancestor is not None and self.__showTile(ancestor):
+                    shownTiles.add(ancestor)
+
+        # Prefetch the tiles needed for the view predicted from the current pan & zoom
+        # speed.
+        prefetchTiles = []
+        if self.__panSpeed.getNorm() > 0.001 or abs(self.__zoomSpeed) > 0.0001:
+            zoom = self.__zoom*2**(self.__zoomSpeed*self.PREFETCH_TIME)
+            offset = self.__offset + self.__panSpeed*self.PREFETCH_TIME
+            prefetchLevel = self.__getLevel(zoom)
+            for tile in self.__getTilesInView(prefetchLevel, offset, zoom):
+                if (tile[0] != self.__baseLevel and tile not in self.__cpuCache and
+                        tile not in self.__gpuCache and tile not in self.__failedTiles):
+                    prefetchTiles.append(tile)
+
+        for tile, node in self.__gpuCache.items():
+            node.active = tile in shownTiles
+            if node.active:
+                self.__positionTile(node, tile)
+        self.__positionTile(self.__baseNode, (self.__baseLevel, 0, 0))
+
+        for node in self.__gpuCache.trim(shownTiles):
+            node.unlink(True)
+        self.__cpuCache.trim(shownTiles)
+
+        self.__loadQueue = [tile for tile in missingTiles + prefetchTiles
+                if tile not in self.__pendingTiles]
+        self.__loadTiles()
+
+    def __getLevel(self, zoom):
+        # The coarsest level that has at least one pixel per screen pixel.
+        level = self.__pyramid.maxLevel + int(math.ceil(math.log(zoom, 2) - 0.0001))
+        return max(self.__baseLevel, min(level, self.__pyramid.maxLevel))
+
+    def __getTilesInView(self, level, offset, zoom):
+        scale = 2**(self.__pyramid.maxLevel-level)
+        tileSize = self.__pyramid.tileSize
+        numCols, numRows = self.__pyramid.getNumTiles(level)
+        tl = offset/scale
+        br = (offset + self.size/zoom)/scale
+        minCol = max(0, int(math.floor(tl.x/tileSize)))
+        minRow = max(0, int(math.floor(tl.y/tileSize)))
+        maxCol = min(numCols-1, int(math.ceil(br.x/tileSize))-1)
+        maxRow = min(numRows-1, int(math.ceil(br.y/tileSize))-1)
+
+        # Tiles closest to the center of the view load first.
+        center = ((tl+br)/2)/tileSize
+        tiles = [(level, col, row) for row in range(minRow, maxRow+1)
+                for col in range(minCol, maxCol+1)]
+        tiles.sort(key=lambda tile:
+                (avg.Point2D(tile[1]+0.5, tile[2]+0.5)-center).getNorm())
+        return tiles
+
+    def __findCachedAncestor(self, tile):
+        level, col, row = tile
+        while level > self.__baseLevel:
+            level -= 1
+            col //= 2
+            row //= 2
+            if (level, col, row) in self.__gpuCache or (level, col, row) in self.__cpuCache:
+                return (level, col, row)
+        return None
+
+    def __showTile(self, tile):
+        if self.__gpuCache.get(tile) is not None:
+            return True
+        bmp = self.__cpuCache.get(tile)
+        if bmp is None:
+            return False
+        node = avg.ImageNode(parent=self.__levelDivs[tile[0]])
+        node.setBitmap(bmp)
+        self.__gpuCache.add(tile, node, bmp.getMemNeeded())
+        return True
+
+    def __positionTile(self, node, tile):
+        level, col, row = tile
+        scale = 2**(self.__pyramid.maxLevel-level) * self.__zoom
+        tl, br = self.__pyramid.getTileRect(level, col, row)
+        node.pos = tl*scale - self.__offset*self.__zoom
+        node.size = (br-tl)*scale
+
+    def __loadTiles(self):
+        while self.__loadQueue and len(self.__pendingTiles) < self.MAX_PENDING_TILES:
+            tile = self.__loadQueue.pop(0)
+            self.__pendingTiles.add(tile)
+            avg.BitmapManager.get().loadBitmap(self.__pyramid.getTilePath(*tile),
+                    lambda bmp, tile=tile: self.__onTileLoaded(tile, bmp))
+
+    def __onTileLoaded(self, tile, bmp):
+        self.__pendingTiles.discard(tile)
+        if self.__frameHandlerID is None:
+            return
+        if isinstance(bmp, Exception):
+            libavg.logger.warning("TiledImageNode: Can't load tile %s: %s" %
+                    (self.__pyramid.getTilePath(*tile), str(bmp)))
+            self.__failedTiles.add(tile)
+        elif tile not in self.__cpuCache:
+            self.__cpuCache.add(tile, bmp, bmp.getMemNeeded())
+            self.__setDirty()
+        self.__loadTiles()
+
+    def __onBaseLoaded(self, bmp):
+        if self.__frameHandlerID is None:
+            return
+        if isinstance(bmp, Exception):
+            raise bmp
+        self.__baseNode.setBitmap(bmp)
+        self.__setDirty()
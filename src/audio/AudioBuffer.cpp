@@ -23,6 +23,8 @@
 
 #include "AudioBuffer.h"
 
+#include "../base/ObjectCounter.h"
+
 #include <string>
 #include <cstring>
 
@@ -30,16 +32,25 @@
 
 namespace avg {
 
+static const std::string MEM_CATEGORY = "Audio buffers";
+
 AudioBuffer::AudioBuffer(int numFrames, AudioParams ap)
     : m_NumFrames(numFrames),
       m_AP(ap)
 {
     m_pData = new short[numFrames*sizeof(short)*ap.m_Channels];
+    ObjectCounter::get()->incMemory(MEM_CATEGORY, getMemAllocated());
 }
 
 AudioBuffer::~AudioBuffer()
 {
     delete[] m_pData;
+    ObjectCounter::get()->decMemory(MEM_CATEGORY, getMemAllocated());
+}
+
+long long AudioBuffer::getMemAllocated() const
+{
+    return (long long)m_NumFrames*sizeof(short)*m_AP.m_Channels*sizeof(short);
 }
 
 short* AudioBuffer::getData()
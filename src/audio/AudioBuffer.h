@@ -49,6 +49,8 @@ class AVG_API AudioBuffer
         void volumize(float lastVol, float curVol);
 
     private:
+        long long getMemAllocated() const;
+
         int m_NumFrames;
         short* m_pData;
         AudioParams m_AP;
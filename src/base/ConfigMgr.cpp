@@ -81,6 +81,15 @@ ConfigMgr::ConfigMgr()
     addOption("scr", "vsyncmode", "auto");
     addOption("scr", "videoaccel", "true");
     addOption("scr", "imgcachesize", "-1,-1");
+    addOption("scr", "parallelrender", "false");
+    addOption("scr", "headless", "false");
+    addOption("scr", "frametimepolicy", "realtime");
+    addOption("scr", "maxframestep", "3");
+    addOption("scr", "latestart", "false");
+    addOption("scr", "latestartmargin", "2");
+    addOption("scr", "prerenderthreads", "0");
+    addOption("scr", "mipmapthreads", "0");
+    addOption("scr", "mipmapuploadbudget", "8192");
     
     addSubsys("aud");
     addOption("aud", "channels", "2");
@@ -102,6 +111,8 @@ ConfigMgr::ConfigMgr()
     addSubsys("touch");
     addOption("touch", "area", "0, 0");
     addOption("touch", "offset", "0, 0");
+    addOption("touch", "filtermincutoff", "-1");
+    addOption("touch", "filterbeta", "0");
 
     m_sFName = "avgrc";
     loadFile(getGlobalConfigDir()+m_sFName);
@@ -185,6 +196,23 @@ int ConfigMgr::getIntOption(const string& sSubsys,
     return Result;
 }
 
+float ConfigMgr::getFloatOption(const string& sSubsys, 
+        const string& sName, float Default) const
+{
+    const string * psOption = getOption(sSubsys, sName);
+    if (psOption == 0) {
+        return Default;
+    }
+    float Result;
+    int rc = sscanf(psOption->c_str(), "%f", &Result);
+    if (rc < 1) {
+        AVG_LOG_ERROR(m_sFName << ": Unrecognized value for option "<<sName<<": " 
+                << *psOption << ". Must be a number. Aborting.");
+        exit(-1);
+    }
+    return Result;
+}
+
 void ConfigMgr::getGammaOption(const string& sSubsys, 
             const string& sName, float* Val) const
 {
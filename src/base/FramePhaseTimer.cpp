@@ -0,0 +1,129 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "FramePhaseTimer.h"
+
+#include "Exception.h"
+#include "TimeSource.h"
+
+using namespace std;
+
+namespace avg {
+
+FramePhaseTimer* FramePhaseTimer::s_pCurTimer = 0;
+boost::thread::id FramePhaseTimer::s_ThreadID;
+long long FramePhaseTimer::s_CurFrameTimes[NUM_PHASES];
+long long FramePhaseTimer::s_PhaseTimes[NUM_PHASES];
+long long FramePhaseTimer::s_FrameTime = 0;
+int FramePhaseTimer::s_NumFrames = 0;
+
+FramePhaseTimer::FramePhaseTimer(Phase phase)
+    : m_Phase(phase),
+      m_bActive(boost::this_thread::get_id() == s_ThreadID),
+      m_pOuterTimer(0)
+{
+    if (m_bActive) {
+        m_StartTime = TimeSource::get()->getCurrentMicrosecs();
+        m_pOuterTimer = s_pCurTimer;
+        if (m_pOuterTimer) {
+            s_CurFrameTimes[m_pOuterTimer->m_Phase] += 
+                    m_StartTime - m_pOuterTimer->m_StartTime;
+        }
+        s_pCurTimer = this;
+    }
+}
+
+FramePhaseTimer::~FramePhaseTimer()
+{
+    if (m_bActive) {
+        long long curTime = TimeSource::get()->getCurrentMicrosecs();
+        s_CurFrameTimes[m_Phase] += curTime - m_StartTime;
+        s_pCurTimer = m_pOuterTimer;
+        if (m_pOuterTimer) {
+            m_pOuterTimer->m_StartTime = curTime;
+        }
+    }
+}
+
+void FramePhaseTimer::startMeasuring()
+{
+    AVG_ASSERT(!s_pCurTimer);
+    s_ThreadID = boost::this_thread::get_id();
+    reset();
+}
+
+void FramePhaseTimer::reset()
+{
+    for (int i=0; i<NUM_PHASES; ++i) {
+        s_CurFrameTimes[i] = 0;
+        s_PhaseTimes[i] = 0;
+    }
+    s_FrameTime = 0;
+    s_NumFrames = 0;
+}
+
+void FramePhaseTimer::countFrame(long long frameDuration)
+{
+    for (int i=0; i<NUM_PHASES; ++i) {
+        s_PhaseTimes[i] += s_CurFrameTimes[i];
+        s_CurFrameTimes[i] = 0;
+    }
+    s_FrameTime += frameDuration;
+    s_NumFrames++;
+}
+
+int FramePhaseTimer::getNumFrames()
+{
+    return s_NumFrames;
+}
+
+long long FramePhaseTimer::getPhaseTime(Phase phase)
+{
+    return s_PhaseTimes[phase];
+}
+
+long long FramePhaseTimer::getFrameTime()
+{
+    return s_FrameTime;
+}
+
+const char* FramePhaseTimer::getPhaseName(Phase phase)
+{
+    switch (phase) {
+        case TIMERS:
+            return "timers";
+        case EVENTS:
+            return "events";
+        case PRERENDER:
+            return "prerender";
+        case RENDER:
+            return "render";
+        case UPLOAD:
+            return "upload";
+        case SWAP:
+            return "swap";
+        default:
+            AVG_ASSERT(false);
+            return 0;
+    }
+}
+
+}
@@ -0,0 +1,71 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _FramePhaseTimer_H_
+#define _FramePhaseTimer_H_
+
+#include "../api.h"
+
+#include <boost/thread.hpp>
+
+namespace avg {
+
+// Splits the wall clock time of the main loop into coarse phases. Unlike ScopeTimer,
+// this is always enabled and cheap enough to run in every frame. Nested timers pause
+// the enclosing phase, so the phase times add up to the time spent in the frame.
+// Only the thread that called startMeasuring() is measured; work done in other threads
+// is accounted to the phase the main thread is waiting in.
+class AVG_API FramePhaseTimer
+{
+public:
+    enum Phase {TIMERS, EVENTS, PRERENDER, RENDER, UPLOAD, SWAP, NUM_PHASES};
+
+    FramePhaseTimer(Phase phase);
+    ~FramePhaseTimer();
+
+    static void startMeasuring();
+    static void reset();
+    static void countFrame(long long frameDuration);
+
+    static int getNumFrames();
+    static long long getPhaseTime(Phase phase);
+    static long long getFrameTime();
+    static const char* getPhaseName(Phase phase);
+
+private:
+    Phase m_Phase;
+    bool m_bActive;
+    long long m_StartTime;
+    FramePhaseTimer* m_pOuterTimer;
+
+    static FramePhaseTimer* s_pCurTimer;
+    static boost::thread::id s_ThreadID;
+    // Times of the current frame are added to the totals in countFrame(), so the
+    // totals always belong to complete frames.
+    static long long s_CurFrameTimes[NUM_PHASES];
+    static long long s_PhaseTimes[NUM_PHASES];
+    static long long s_FrameTime;
+    static int s_NumFrames;
+};
+
+}
+
+#endif
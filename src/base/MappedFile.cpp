@@ -0,0 +1,101 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "MappedFile.h"
+#include "Exception.h"
+#include "FileHelper.h"
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include <string.h>
+
+using namespace std;
+
+namespace avg {
+
+MappedFile::MappedFile(const string& sFilename)
+    : m_sFilename(sFilename),
+      m_pData(0),
+      m_Size(0)
+{
+#ifdef _WIN32
+    string sContent;
+    readWholeFile(sFilename, sContent);
+    m_Size = sContent.size();
+    if (m_Size > 0) {
+        m_pData = new unsigned char[m_Size];
+        memcpy(m_pData, sContent.data(), m_Size);
+    }
+#else
+    int fd = open(sFilename.c_str(), O_RDONLY);
+    if (fd == -1) {
+        throw Exception(AVG_ERR_FILEIO, "Opening "+sFilename+" for reading failed.");
+    }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) == -1) {
+        close(fd);
+        throw Exception(AVG_ERR_FILEIO, "Reading "+sFilename+" failed.");
+    }
+    m_Size = size_t(fileStat.st_size);
+    if (m_Size > 0) {
+        void* pData = mmap(0, m_Size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (pData == MAP_FAILED) {
+            close(fd);
+            throw Exception(AVG_ERR_FILEIO, "Mapping "+sFilename+" into memory failed.");
+        }
+        m_pData = (unsigned char*)pData;
+    }
+    // The mapping stays valid after the descriptor is closed.
+    close(fd);
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    delete[] m_pData;
+#else
+    if (m_pData) {
+        munmap(m_pData, m_Size);
+    }
+#endif
+}
+
+const unsigned char* MappedFile::getData() const
+{
+    return m_pData;
+}
+
+size_t MappedFile::getSize() const
+{
+    return m_Size;
+}
+
+const string& MappedFile::getFilename() const
+{
+    return m_sFilename;
+}
+
+}
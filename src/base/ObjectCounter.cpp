@@ -26,6 +26,7 @@
 #include <boost/thread/mutex.hpp>
 
 #include <iostream>
+#include <iomanip>
 #include <sstream>
 #include <vector>
 #include <algorithm>
@@ -43,6 +44,18 @@ namespace avg {
 
 using namespace std;
 
+MemoryStats::MemoryStats()
+    : m_NumBytes(0),
+      m_NumObjects(0)
+{
+}
+
+MemoryStats::MemoryStats(long long numBytes, int numObjects)
+    : m_NumBytes(numBytes),
+      m_NumObjects(numObjects)
+{
+}
+
 ObjectCounter* ObjectCounter::s_pObjectCounter = 0;
 bool ObjectCounter::s_bDeleted = false;
 boost::mutex * pCounterMutex;
@@ -131,6 +144,70 @@ int ObjectCounter::getCount(const std::type_info* pType)
     
 }
 
+void ObjectCounter::incMemory(const std::string& sCategory, long long numBytes)
+{
+#ifdef DEBUG_ALLOC
+    lock_guard Lock(*pCounterMutex);
+    MemoryStats& stats = m_MemoryStats[sCategory];
+    stats.m_NumBytes += numBytes;
+    stats.m_NumObjects++;
+#endif
+}
+
+void ObjectCounter::decMemory(const std::string& sCategory, long long numBytes)
+{
+#ifdef DEBUG_ALLOC
+    if (s_bDeleted) {
+        return;
+    }
+    lock_guard Lock(*pCounterMutex);
+    MemoryStatsMap::iterator it = m_MemoryStats.find(sCategory);
+    AVG_ASSERT(it != m_MemoryStats.end());
+    it->second.m_NumBytes -= numBytes;
+    it->second.m_NumObjects--;
+    AVG_ASSERT(it->second.m_NumBytes >= 0 && it->second.m_NumObjects >= 0);
+#endif
+}
+
+MemoryStatsMap ObjectCounter::getMemoryStats()
+{
+    lock_guard Lock(*pCounterMutex);
+    return m_MemoryStats;
+}
+
+MemoryStatsMap ObjectCounter::diffMemoryStats(const MemoryStatsMap& oldStats, 
+        const MemoryStatsMap& newStats)
+{
+    MemoryStatsMap diff = newStats;
+    MemoryStatsMap::const_iterator it;
+    for (it = oldStats.begin(); it != oldStats.end(); ++it) {
+        MemoryStats& stats = diff[it->first];
+        stats.m_NumBytes -= it->second.m_NumBytes;
+        stats.m_NumObjects -= it->second.m_NumObjects;
+    }
+    MemoryStatsMap::iterator diffIt = diff.begin();
+    while (diffIt != diff.end()) {
+        if (diffIt->second.m_NumBytes == 0 && diffIt->second.m_NumObjects == 0) {
+            diff.erase(diffIt++);
+        } else {
+            ++diffIt;
+        }
+    }
+    return diff;
+}
+
+std::string ObjectCounter::dumpMemoryStats(const MemoryStatsMap& stats)
+{
+    stringstream ss;
+    ss << fixed << setprecision(1);
+    MemoryStatsMap::const_iterator it;
+    for (it = stats.begin(); it != stats.end(); ++it) {
+        ss << "  " << it->first << ": " << it->second.m_NumBytes/1024.f << " KB, " 
+                << it->second.m_NumObjects << " objects" << endl;
+    }
+    return ss.str();
+}
+
 std::string ObjectCounter::dump()
 {
     stringstream ss;
@@ -31,6 +31,16 @@ namespace avg {
 
 typedef std::map<const std::type_info *, int> TypeMap;
 
+// Memory held by objects of one category (e.g. bitmaps of one pixel format).
+struct AVG_API MemoryStats {
+    MemoryStats();
+    MemoryStats(long long numBytes, int numObjects);
+
+    long long m_NumBytes;
+    int m_NumObjects;
+};
+typedef std::map<std::string, MemoryStats> MemoryStatsMap;
+
 class AVG_API ObjectCounter {
 public:
     static ObjectCounter* get();
@@ -41,6 +51,14 @@ public:
 
     int getCount(const std::type_info* pType);
 
+    // Memory accounting. Each incMemory() call counts one object of the category.
+    void incMemory(const std::string& sCategory, long long numBytes);
+    void decMemory(const std::string& sCategory, long long numBytes);
+    MemoryStatsMap getMemoryStats();
+    static MemoryStatsMap diffMemoryStats(const MemoryStatsMap& oldStats, 
+            const MemoryStatsMap& newStats);
+    static std::string dumpMemoryStats(const MemoryStatsMap& stats);
+
     std::string demangle(std::string s);
     std::string dump();
     TypeMap getObjectCount();
@@ -50,6 +68,7 @@ private:
     static void deleteSingleton();
 
     TypeMap m_TypeMap;
+    MemoryStatsMap m_MemoryStats;
 
     static ObjectCounter* s_pObjectCounter;
     static bool s_bDeleted;
@@ -0,0 +1,117 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "OneEuroFilter.h"
+
+#include "Exception.h"
+#include "MathHelper.h"
+
+#include <math.h>
+
+using namespace std;
+
+namespace avg {
+
+OneEuroFilter::OneEuroFilter(double minCutoff, double beta, double dCutoff)
+    : m_Freq(60),    // Initial freq, updated as soon as we have > 1 sample
+      m_MinCutoff(minCutoff),
+      m_Beta(beta),
+      m_DCutoff(dCutoff),
+      m_LastDerivative(0),
+      m_LastTime(0),
+      m_bHasLastTime(false)
+{
+    if (minCutoff <= 0) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE, "OneEuroFilter: mincutoff should be >0");
+    }
+    if (dCutoff <= 0) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE, "OneEuroFilter: dcutoff should be >0");
+    }
+}
+
+double OneEuroFilter::apply(double x, double time)
+{
+    if (m_bHasLastTime && m_LastTime == time) {
+        return x;
+    }
+    // Update the sampling frequency based on timestamps.
+    if (m_bHasLastTime && m_LastTime != 0 && time != 0) {
+        m_Freq = 1000.0/(time-m_LastTime);
+    }
+    m_LastTime = time;
+    m_bHasLastTime = true;
+
+    // Estimate the current variation per second.
+    double dx = 0.0;
+    if (m_X.hasLastValue()) {
+        dx = (x-m_X.getLastValue())*m_Freq;
+    }
+    m_LastDerivative = m_DX.apply(dx, alpha(m_DCutoff));
+
+    // Use it to update the cutoff frequency and filter the given value.
+    double cutoff = m_MinCutoff + m_Beta*fabs(m_LastDerivative);
+    return m_X.apply(x, alpha(cutoff));
+}
+
+double OneEuroFilter::getDerivative() const
+{
+    return m_LastDerivative;
+}
+
+double OneEuroFilter::alpha(double cutoff) const
+{
+    double te = 1.0/m_Freq;
+    double tau = 1.0/(2*M_PI*cutoff);
+    return 1.0/(1.0 + tau/te);
+}
+
+OneEuroFilter::LowPassFilter::LowPassFilter()
+    : m_bHasValue(false),
+      m_Y(0),
+      m_S(0)
+{
+}
+
+double OneEuroFilter::LowPassFilter::apply(double value, double alpha)
+{
+    double s;
+    if (m_bHasValue) {
+        s = alpha*value + (1.0-alpha)*m_S;
+    } else {
+        s = value;
+    }
+    m_Y = value;
+    m_S = s;
+    m_bHasValue = true;
+    return s;
+}
+
+bool OneEuroFilter::LowPassFilter::hasLastValue() const
+{
+    return m_bHasValue;
+}
+
+double OneEuroFilter::LowPassFilter::getLastValue() const
+{
+    return m_Y;
+}
+
+}
@@ -0,0 +1,74 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _OneEuroFilter_H_
+#define _OneEuroFilter_H_
+
+#include "../api.h"
+
+namespace avg {
+
+// Input filter based on:
+// Casiez, G., Roussel, N. and Vogel, D. (2012). 1€ Filter: A Simple Speed-based Low-pass
+// Filter for Noisy Input in Interactive Systems. Proceedings of the ACM Conference on
+// Human Factors in Computing Systems (CHI '12). Austin, Texas (May 5-12, 2012). New York:
+// ACM Press, pp. 2527-2530.
+//
+// Same algorithm as libavg.filter.OneEuroFilter.
+class AVG_API OneEuroFilter
+{
+public:
+    OneEuroFilter(double minCutoff=1.0, double beta=0.0, double dCutoff=1.0);
+
+    // time is in milliseconds.
+    double apply(double x, double time);
+    double getDerivative() const;
+
+private:
+    class LowPassFilter {
+    public:
+        LowPassFilter();
+        double apply(double value, double alpha);
+        bool hasLastValue() const;
+        double getLastValue() const;
+
+    private:
+        bool m_bHasValue;
+        double m_Y;
+        double m_S;
+    };
+
+    double alpha(double cutoff) const;
+
+    double m_Freq;
+    double m_MinCutoff;
+    double m_Beta;
+    double m_DCutoff;
+    LowPassFilter m_X;
+    LowPassFilter m_DX;
+    double m_LastDerivative;
+    double m_LastTime;
+    bool m_bHasLastTime;
+};
+
+}
+
+#endif
@@ -0,0 +1,139 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "TriangulationCache.h"
+
+#include "Polygon.h"
+#include "ThreadHelper.h"
+
+#include <boost/functional/hash.hpp>
+
+using namespace std;
+
+namespace avg {
+
+// Upper bound for the number of outline points stored in the cache.
+static const unsigned MAX_CACHED_PTS = 256*1024;
+
+TriangulationCache* TriangulationCache::s_pTriangulationCache = 0;
+static boost::mutex s_InstanceMutex;
+
+TriangulationCache* TriangulationCache::get()
+{
+    lock_guard lock(s_InstanceMutex);
+    if (!s_pTriangulationCache) {
+        s_pTriangulationCache = new TriangulationCache;
+    }
+    return s_pTriangulationCache;
+}
+
+TriangulationCache::TriangulationCache()
+    : m_NumCachedPts(0),
+      m_NumHits(0),
+      m_NumMisses(0)
+{
+}
+
+TriangulationCache::~TriangulationCache()
+{
+}
+
+void TriangulationCache::triangulate(const Vec2Vector& pts, Vec2Vector& resultVertexes,
+        vector<int>& resultIndexes)
+{
+    size_t hash = calcHash(pts);
+    {
+        lock_guard lock(m_Mutex);
+        map<size_t, EntryList::iterator>::iterator it = m_EntryMap.find(hash);
+        if (it != m_EntryMap.end() && it->second->m_Pts == pts) {
+            m_Entries.splice(m_Entries.begin(), m_Entries, it->second);
+            resultVertexes = it->second->m_TriPts;
+            resultIndexes = it->second->m_TriIndexes;
+            m_NumHits++;
+            return;
+        }
+        m_NumMisses++;
+    }
+
+    // Tessellate without holding the lock so several threads can work in parallel.
+    Polygon poly(pts);
+    poly.triangulate(resultVertexes, resultIndexes);
+
+    lock_guard lock(m_Mutex);
+    map<size_t, EntryList::iterator>::iterator it = m_EntryMap.find(hash);
+    if (it != m_EntryMap.end()) {
+        m_NumCachedPts -= it->second->m_Pts.size();
+        m_Entries.erase(it->second);
+        m_EntryMap.erase(it);
+    }
+    Entry entry;
+    entry.m_Hash = hash;
+    entry.m_Pts = pts;
+    entry.m_TriPts = resultVertexes;
+    entry.m_TriIndexes = resultIndexes;
+    m_Entries.push_front(entry);
+    m_EntryMap[hash] = m_Entries.begin();
+    m_NumCachedPts += pts.size();
+    evict();
+}
+
+void TriangulationCache::clear()
+{
+    lock_guard lock(m_Mutex);
+    m_Entries.clear();
+    m_EntryMap.clear();
+    m_NumCachedPts = 0;
+}
+
+int TriangulationCache::getNumHits() const
+{
+    lock_guard lock(m_Mutex);
+    return m_NumHits;
+}
+
+int TriangulationCache::getNumMisses() const
+{
+    lock_guard lock(m_Mutex);
+    return m_NumMisses;
+}
+
+size_t TriangulationCache::calcHash(const Vec2Vector& pts)
+{
+    size_t hash = 0;
+    for (Vec2Vector::const_iterator it = pts.begin(); it != pts.end(); ++it) {
+        boost::hash_combine(hash, it->x);
+        boost::hash_combine(hash, it->y);
+    }
+    return hash;
+}
+
+void TriangulationCache::evict()
+{
+    // Always keep the entry that was just added.
+    while (m_NumCachedPts > MAX_CACHED_PTS && m_Entries.size() > 1) {
+        const Entry& entry = m_Entries.back();
+        m_NumCachedPts -= entry.m_Pts.size();
+        m_EntryMap.erase(entry.m_Hash);
+        m_Entries.pop_back();
+    }
+}
+
+}
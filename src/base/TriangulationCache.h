@@ -0,0 +1,77 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _TriangulationCache_H_
+#define _TriangulationCache_H_
+
+#include "../api.h"
+#include "GLMHelper.h"
+
+#include <boost/thread/mutex.hpp>
+
+#include <vector>
+#include <list>
+#include <map>
+
+namespace avg {
+
+// Process-wide cache of polygon triangulations, keyed by a hash of the polygon
+// outline. Tessellation is expensive, and animated or repeatedly rebuilt polygons
+// often return to outlines that have been triangulated before. Thread-safe.
+class AVG_API TriangulationCache {
+public:
+    static TriangulationCache* get();
+    virtual ~TriangulationCache();
+
+    void triangulate(const Vec2Vector& pts, Vec2Vector& resultVertexes, 
+            std::vector<int>& resultIndexes);
+    void clear();
+
+    int getNumHits() const;
+    int getNumMisses() const;
+
+private:
+    struct Entry {
+        size_t m_Hash;
+        Vec2Vector m_Pts;
+        Vec2Vector m_TriPts;
+        std::vector<int> m_TriIndexes;
+    };
+    typedef std::list<Entry> EntryList;
+
+    TriangulationCache();
+    static size_t calcHash(const Vec2Vector& pts);
+    void evict();
+
+    // Most recently used entries first.
+    EntryList m_Entries;
+    std::map<size_t, EntryList::iterator> m_EntryMap;
+    unsigned m_NumCachedPts;
+    int m_NumHits;
+    int m_NumMisses;
+    mutable boost::mutex m_Mutex;
+
+    static TriangulationCache* s_pTriangulationCache;
+};
+
+}
+
+#endif
@@ -0,0 +1,312 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+
+#include "Queue.h"
+#include "CmdQueue.h"
+#include "WorkerThread.h"
+#include "Signal.h"
+#include "Logger.h"
+#include "ILogSink.h"
+#include "ScopeTimer.h"
+#include "ProfilingZoneID.h"
+#include "ThreadProfiler.h"
+#include "TimeSource.h"
+
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+
+using namespace avg;
+using namespace std;
+
+// Collects one sample per measured batch (or per cross-thread message) in nanoseconds
+// and prints throughput together with the latency distribution.
+class BenchmarkStats {
+public:
+    BenchmarkStats(const string& sName)
+        : m_sName(sName)
+    {
+    }
+
+    void addSample(double ns)
+    {
+        m_Samples.push_back(ns);
+    }
+
+    void dump(long long numOps, long long elapsedMicros)
+    {
+        sort(m_Samples.begin(), m_Samples.end());
+        double nsPerOp = elapsedMicros*1000./numOps;
+        cerr << setiosflags(ios::fixed) << setprecision(1);
+        cerr << left << setw(40) << m_sName << right
+                << setw(10) << nsPerOp << " ns/op"
+                << setw(12) << setprecision(0) << 1e9/nsPerOp << " ops/s"
+                << setprecision(1)
+                << "  p50: " << getPercentile(0.5)
+                << "  p90: " << getPercentile(0.9)
+                << "  p99: " << getPercentile(0.99)
+                << "  max: " << getPercentile(1)
+                << " ns" << endl;
+    }
+
+private:
+    double getPercentile(double p) const
+    {
+        if (m_Samples.empty()) {
+            return 0;
+        }
+        size_t i = size_t(p*(m_Samples.size()-1)+0.5);
+        return m_Samples[i];
+    }
+
+    string m_sName;
+    vector<double> m_Samples;
+};
+
+long long now()
+{
+    return TimeSource::get()->getCurrentMicrosecs();
+}
+
+// Runs func numBatches*batchSize times and records the time per call for each batch.
+// Single operations are far below the resolution of the clock, so percentiles are
+// computed over batch averages.
+template<class FUNC>
+void runBatched(const string& sName, FUNC func, int numBatches=200, int batchSize=1000)
+{
+    BenchmarkStats stats(sName);
+    long long startTime = now();
+    for (int i = 0; i < numBatches; ++i) {
+        long long batchStart = now();
+        for (int j = 0; j < batchSize; ++j) {
+            func();
+        }
+        stats.addSample((now()-batchStart)*1000./batchSize);
+    }
+    stats.dump((long long)numBatches*batchSize, now()-startTime);
+}
+
+
+typedef Queue<long long> TimestampQueue;
+
+void pushPopQueue(TimestampQueue* pQueue)
+{
+    pQueue->push(TimestampQueue::QElementPtr(new long long(0)));
+    pQueue->pop(false);
+}
+
+void produceTimestamps(TimestampQueue* pQueue, int numOps)
+{
+    for (int i = 0; i < numOps; ++i) {
+        pQueue->push(TimestampQueue::QElementPtr(new long long(now())));
+    }
+}
+
+// Producer threads push the time of the push, the main thread pops and measures the
+// time each element spent in transit.
+void runQueueBenchmark(int numProducers, int numOpsPerProducer)
+{
+    stringstream ss;
+    ss << "Queue " << numProducers << ":1";
+    BenchmarkStats stats(ss.str());
+    TimestampQueue queue(64);
+    long long startTime = now();
+    vector<boost::thread*> pProducers;
+    for (int i = 0; i < numProducers; ++i) {
+        pProducers.push_back(new boost::thread(
+                boost::bind(&produceTimestamps, &queue, numOpsPerProducer)));
+    }
+    int numOps = numProducers*numOpsPerProducer;
+    for (int i = 0; i < numOps; ++i) {
+        TimestampQueue::QElementPtr pTime = queue.pop(true);
+        stats.addSample((now()-*pTime)*1000.);
+    }
+    long long elapsed = now()-startTime;
+    for (unsigned i = 0; i < pProducers.size(); ++i) {
+        pProducers[i]->join();
+        delete pProducers[i];
+    }
+    stats.dump(numOps, elapsed);
+}
+
+
+class BenchmarkThread: public WorkerThread<BenchmarkThread>
+{
+public:
+    BenchmarkThread(CQueue& cmdQ, vector<long long>* pLatencies)
+        : WorkerThread<BenchmarkThread>("BenchmarkThread", cmdQ),
+          m_pLatencies(pLatencies)
+    {
+    }
+
+    bool work()
+    {
+        waitForCommand();
+        return true;
+    }
+
+    void handleCmd(long long pushTime)
+    {
+        m_pLatencies->push_back(now()-pushTime);
+    }
+
+private:
+    vector<long long>* m_pLatencies;
+};
+
+void runCmdQueueBenchmark(int numOps)
+{
+    BenchmarkStats stats("CmdQueue dispatch");
+    vector<long long> latencies;
+    latencies.reserve(numOps);
+    BenchmarkThread::CQueue cmdQ(64);
+    long long startTime = now();
+    boost::thread* pThread = new boost::thread(BenchmarkThread(cmdQ, &latencies));
+    for (int i = 0; i < numOps; ++i) {
+        cmdQ.pushCmd(boost::bind(&BenchmarkThread::handleCmd, _1, now()));
+    }
+    cmdQ.pushCmd(boost::bind(&BenchmarkThread::stop, _1));
+    pThread->join();
+    long long elapsed = now()-startTime;
+    delete pThread;
+    for (unsigned i = 0; i < latencies.size(); ++i) {
+        stats.addSample(latencies[i]*1000.);
+    }
+    stats.dump(numOps, elapsed);
+}
+
+
+class NullLogSink: public ILogSink
+{
+public:
+    virtual void logMessage(const tm* pTime, unsigned millis, const category_t& category,
+            severity_t severity, const UTF8String& sMsg)
+    {
+    }
+};
+
+void logMessage(const category_t& category, severity_t severity)
+{
+    AVG_TRACE(category, severity, "Benchmark message " << 42 << ", " << 23.5);
+}
+
+void runLoggerBenchmarks()
+{
+    Logger* pLogger = Logger::get();
+    pLogger->removeStdLogSink();
+    category_t category = pLogger->configureCategory("BENCHMARK",
+            Logger::severity::INFO);
+    runBatched("Logger category disabled",
+            boost::bind(&logMessage, category, Logger::severity::DEBUG));
+    runBatched("Logger enabled, no sinks",
+            boost::bind(&logMessage, category, Logger::severity::INFO), 50);
+    LogSinkPtr pSink(new NullLogSink);
+    pLogger->addLogSink(pSink);
+    runBatched("Logger enabled, null sink",
+            boost::bind(&logMessage, category, Logger::severity::INFO), 50);
+    pLogger->removeLogSink(pSink);
+}
+
+
+static ProfilingZoneID BenchmarkProfilingZone("Benchmark");
+
+void enterScopeTimer()
+{
+    ScopeTimer timer(BenchmarkProfilingZone);
+}
+
+void runScopeTimerBenchmarks()
+{
+    ScopeTimer::enableTimers(false);
+    runBatched("ScopeTimer, profiling off", &enterScopeTimer);
+    ThreadProfiler::get()->start();
+    ScopeTimer::enableTimers(true);
+    runBatched("ScopeTimer, profiling on", &enterScopeTimer);
+    ScopeTimer::enableTimers(false);
+    ThreadProfiler::kill();
+}
+
+
+class SignalListener
+{
+public:
+    SignalListener()
+        : m_NumCalls(0)
+    {
+    }
+
+    void onSignal()
+    {
+        m_NumCalls++;
+    }
+
+private:
+    int m_NumCalls;
+};
+
+void emitSignal(Signal<SignalListener>* pSignal)
+{
+    pSignal->emit();
+}
+
+void runSignalBenchmark(int numListeners)
+{
+    Signal<SignalListener> signal(&SignalListener::onSignal);
+    vector<SignalListener> listeners(numListeners);
+    for (int i = 0; i < numListeners; ++i) {
+        signal.connect(&listeners[i]);
+    }
+    stringstream ss;
+    ss << "Signal emit, " << numListeners << " listeners";
+    runBatched(ss.str(), boost::bind(&emitSignal, &signal), 200, 100000/numListeners);
+    for (int i = 0; i < numListeners; ++i) {
+        signal.disconnect(&listeners[i]);
+    }
+}
+
+
+void runBenchmarks()
+{
+    TimestampQueue queue;
+    runBatched("Queue push/pop, single thread", boost::bind(&pushPopQueue, &queue));
+    runQueueBenchmark(1, 200000);
+    runQueueBenchmark(4, 50000);
+    runCmdQueueBenchmark(200000);
+    runLoggerBenchmarks();
+    runScopeTimerBenchmarks();
+    runSignalBenchmark(1);
+    runSignalBenchmark(10);
+    runSignalBenchmark(100);
+    runSignalBenchmark(1000);
+}
+
+int main(int nargs, char** args)
+{
+    runBenchmarks();
+    return 0;
+}
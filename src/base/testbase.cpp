@@ -25,6 +25,7 @@
 #include "WorkerThread.h"
 #include "ObjectCounter.h"
 #include "Polygon.h"
+#include "TriangulationCache.h"
 #include "GLMHelper.h"
 #include "GeomHelper.h"
 #include "OSHelper.h"
@@ -40,6 +41,7 @@
 #include "Triangle.h"
 #include "TestSuite.h"
 #include "TimeSource.h"
+#include "FramePhaseTimer.h"
 #include "XMLHelper.h"
 #include "Logger.h"
 
@@ -364,6 +366,24 @@ public:
             TEST(ObjectCounter::get()->getCount(&typeid(dummy1)) == 2);
         }
         TEST(ObjectCounter::get()->getCount(&typeid(DummyClass)) == 0);
+
+        ObjectCounter* pCounter = ObjectCounter::get();
+        MemoryStatsMap oldStats = pCounter->getMemoryStats();
+        pCounter->incMemory("Test", 100);
+        pCounter->incMemory("Test", 50);
+        MemoryStatsMap stats = pCounter->getMemoryStats();
+        TEST(stats["Test"].m_NumBytes == 150);
+        TEST(stats["Test"].m_NumObjects == 2);
+        MemoryStatsMap diff = ObjectCounter::diffMemoryStats(oldStats, stats);
+        TEST(diff.size() == 1);
+        TEST(diff["Test"].m_NumBytes == 150);
+        pCounter->decMemory("Test", 100);
+        diff = ObjectCounter::diffMemoryStats(stats, pCounter->getMemoryStats());
+        TEST(diff["Test"].m_NumBytes == -100);
+        TEST(diff["Test"].m_NumObjects == -1);
+        pCounter->decMemory("Test", 50);
+        diff = ObjectCounter::diffMemoryStats(oldStats, pCounter->getMemoryStats());
+        TEST(diff.empty());
     }
 };
 
@@ -518,6 +538,48 @@ public:
 };
 
 
+class TriangulationCacheTest: public Test
+{
+public:
+    TriangulationCacheTest()
+        : Test("TriangulationCacheTest", 2)
+    {
+    }
+
+    void runTests()
+    {
+        TriangulationCache* pCache = TriangulationCache::get();
+        pCache->clear();
+        int numHits = pCache->getNumHits();
+        int numMisses = pCache->getNumMisses();
+
+        glm::vec2 polyArray[] = {glm::vec2(0,0), glm::vec2(8,2), glm::vec2(9,0), 
+                glm::vec2(9,3), glm::vec2(1,1), glm::vec2(0,3)};
+        Vec2Vector pts = vectorFromCArray(6, polyArray);
+        Vec2Vector baselineTriPts;
+        vector<int> baselineIndexes;
+        Polygon(pts).triangulate(baselineTriPts, baselineIndexes);
+
+        Vec2Vector triPts;
+        vector<int> indexes;
+        pCache->triangulate(pts, triPts, indexes);
+        TEST(pCache->getNumMisses() == numMisses+1);
+        pCache->triangulate(pts, triPts, indexes);
+        TEST(pCache->getNumHits() == numHits+1);
+        TEST(triPts == baselineTriPts);
+        TEST(indexes == baselineIndexes);
+
+        pts[3] = glm::vec2(9,4);
+        pCache->triangulate(pts, triPts, indexes);
+        TEST(pCache->getNumMisses() == numMisses+2);
+        Polygon(pts).triangulate(baselineTriPts, baselineIndexes);
+        TEST(triPts == baselineTriPts);
+        TEST(indexes == baselineIndexes);
+        pCache->clear();
+    }
+};
+
+
 class FileTest: public Test
 {
 public:
@@ -553,6 +615,62 @@ public:
 };
 
 
+class FramePhaseTimerTest: public Test
+{
+public:
+    FramePhaseTimerTest()
+        : Test("FramePhaseTimerTest", 2)
+    {
+    }
+
+    void runTests()
+    {
+        FramePhaseTimer::startMeasuring();
+        long long startTime = TimeSource::get()->getCurrentMicrosecs();
+        {
+            FramePhaseTimer renderTimer(FramePhaseTimer::RENDER);
+            msleep(10);
+            {
+                FramePhaseTimer uploadTimer(FramePhaseTimer::UPLOAD);
+                msleep(20);
+            }
+        }
+        long long blockTime = TimeSource::get()->getCurrentMicrosecs()-startTime;
+        // Times are only visible once the frame is complete.
+        TEST(FramePhaseTimer::getPhaseTime(FramePhaseTimer::UPLOAD) == 0);
+        FramePhaseTimer::countFrame(100000);
+        TEST(FramePhaseTimer::getNumFrames() == 1);
+        TEST(FramePhaseTimer::getFrameTime() == 100000);
+        long long renderTime = FramePhaseTimer::getPhaseTime(FramePhaseTimer::RENDER);
+        long long uploadTime = FramePhaseTimer::getPhaseTime(FramePhaseTimer::UPLOAD);
+        TEST(renderTime >= 10000);
+        TEST(uploadTime >= 20000);
+        // The nested upload doesn't count as render time.
+        TEST(renderTime+uploadTime <= blockTime);
+        TEST(FramePhaseTimer::getPhaseTime(FramePhaseTimer::SWAP) == 0);
+
+        // Other threads aren't measured.
+        boost::thread otherThread(&FramePhaseTimerTest::timeInThread);
+        otherThread.join();
+        FramePhaseTimer::countFrame(100000);
+        TEST(FramePhaseTimer::getPhaseTime(FramePhaseTimer::SWAP) == 0);
+
+        FramePhaseTimer::reset();
+        TEST(FramePhaseTimer::getNumFrames() == 0);
+        TEST(FramePhaseTimer::getPhaseTime(FramePhaseTimer::UPLOAD) == 0);
+        TEST(string(FramePhaseTimer::getPhaseName(FramePhaseTimer::PRERENDER)) == 
+                "prerender");
+    }
+
+private:
+    static void timeInThread()
+    {
+        FramePhaseTimer swapTimer(FramePhaseTimer::SWAP);
+        msleep(1);
+    }
+};
+
+
 class StringTest: public Test
 {
 public:
@@ -987,8 +1105,10 @@ public:
         addTest(TestPtr(new ObjectCounterTest));
         addTest(TestPtr(new GeomTest));
         addTest(TestPtr(new TriangleTest));
+        addTest(TestPtr(new TriangulationCacheTest));
         addTest(TestPtr(new FileTest));
         addTest(TestPtr(new OSTest));
+        addTest(TestPtr(new FramePhaseTimerTest));
         addTest(TestPtr(new StringTest));
         addTest(TestPtr(new SplineTest));
         addTest(TestPtr(new BezierCurveTest));
@@ -45,6 +45,21 @@ namespace avg {
 template<class Pixel>
 void createTrueColorCopy(Bitmap& destBmp, const Bitmap & srcBmp);
 
+static vector<string> createMemCategories()
+{
+    vector<string> sCategories;
+    for (int pf = 0; pf <= NO_PIXELFORMAT; ++pf) {
+        sCategories.push_back("Bitmap pixels: "+getPixelFormatString(PixelFormat(pf)));
+    }
+    return sCategories;
+}
+
+static const string& getMemCategory(PixelFormat pf)
+{
+    static const vector<string> sCategories = createMemCategories();
+    return sCategories[pf];
+}
+
 Bitmap::Bitmap(glm::vec2 size, PixelFormat pf, const UTF8String& sName, int stride)
     : m_Size(size),
       m_PF(pf),
@@ -128,19 +143,13 @@ Bitmap::Bitmap(Bitmap& origBmp, const IntRect& rect)
 Bitmap::~Bitmap()
 {
     ObjectCounter::get()->decRef(&typeid(*this));
-    if (m_bOwnsBits) {
-        delete[] m_pBits;
-        m_pBits = 0;
-    }
+    freeBits();
 }
 
 Bitmap &Bitmap::operator =(const Bitmap& origBmp)
 {
     if (this != &origBmp) {
-        if (m_bOwnsBits) {
-            delete[] m_pBits;
-            m_pBits = 0;
-        }
+        freeBits();
         m_Size = origBmp.getSize();
         m_PF = origBmp.getPixelFormat();
         m_bOwnsBits = origBmp.m_bOwnsBits;
@@ -1162,10 +1171,22 @@ void Bitmap::allocBits(int stride)
         //XXX: We allocate more than nessesary here because ffmpeg seems to
         // overwrite memory after the bits - probably during yuv conversion.
         // Yuck.
-        m_pBits = new unsigned char[size_t(m_Stride+1)*(m_Size.y+1)];
+        m_NumBytesAllocated = size_t(m_Stride+1)*(m_Size.y+1);
     } else {
-        m_pBits = new unsigned char[size_t(m_Stride)*m_Size.y];
+        m_NumBytesAllocated = size_t(m_Stride)*m_Size.y;
+    }
+    m_pBits = new unsigned char[m_NumBytesAllocated];
+    m_AllocPF = m_PF;
+    ObjectCounter::get()->incMemory(getMemCategory(m_AllocPF), m_NumBytesAllocated);
+}
+
+void Bitmap::freeBits()
+{
+    if (m_bOwnsBits && m_pBits) {
+        delete[] m_pBits;
+        ObjectCounter::get()->decMemory(getMemCategory(m_AllocPF), m_NumBytesAllocated);
     }
+    m_pBits = 0;
 }
 
 void YUYV422toBGR32Line(const unsigned char* pSrcLine, Pixel32* pDestLine, int width)
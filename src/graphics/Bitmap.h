@@ -103,6 +103,7 @@ public:
 private:
     void initWithData(unsigned char* pBits, int stride, bool bCopyBits);
     void allocBits(int stride=0);
+    void freeBits();
     void YCbCrtoBGR(const Bitmap& origBmp);
     void YCbCrtoI8(const Bitmap& origBmp);
     void I8toI16(const Bitmap& origBmp);
@@ -120,6 +121,9 @@ private:
     unsigned char* m_pBits;
     bool m_bOwnsBits;
     UTF8String m_sName;
+    // Memory accounting: Size and pixel format at the time the bits were allocated.
+    size_t m_NumBytesAllocated;
+    PixelFormat m_AllocPF;
 
     static bool s_bMagickInitialized;
     static bool s_bGTKInitialized;
@@ -64,6 +64,26 @@ void BmpTextureMover::moveBmpToTexture(BitmapPtr pBmp, GLTexture& tex)
     GLContext::checkError("BmpTextureMover::moveBmpToTexture: glTexSubImage2D()");
 }
 
+void BmpTextureMover::moveBmpRectToTexture(BitmapPtr pBmp, const IntRect& rect, 
+        GLTexture& tex)
+{
+    AVG_ASSERT(pBmp->getSize() == tex.getSize());
+    AVG_ASSERT(getSize() == pBmp->getSize());
+    AVG_ASSERT(pBmp->getPixelFormat() == getPF());
+    AVG_ASSERT(rect.tl.x >= 0 && rect.tl.y >= 0);
+    AVG_ASSERT(rect.br.x <= getSize().x && rect.br.y <= getSize().y);
+    tex.activate(WrapMode());
+    // GLES can't skip pixels at the end of each line (GL_UNPACK_ROW_LENGTH), so the
+    // rect is copied to a bitmap of its own.
+    Bitmap srcBmp(*pBmp, rect);
+    Bitmap rectBmp(rect.size(), getPF());
+    rectBmp.copyPixels(srcBmp);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, rect.tl.x, rect.tl.y, rect.width(), rect.height(),
+            tex.getGLFormat(getPF()), tex.getGLType(getPF()), rectBmp.getPixels());
+    tex.generateMipmaps();
+    GLContext::checkError("BmpTextureMover::moveBmpRectToTexture: glTexSubImage2D()");
+}
+
 BitmapPtr BmpTextureMover::moveTextureToBmp(GLTexture& tex, int mipmapLevel)
 {
     GLContext* pContext = GLContext::getCurrent();
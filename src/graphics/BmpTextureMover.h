@@ -35,6 +35,8 @@ public:
     virtual ~BmpTextureMover();
 
     virtual void moveBmpToTexture(BitmapPtr pBmp, GLTexture& tex);
+    virtual void moveBmpRectToTexture(BitmapPtr pBmp, const IntRect& rect, 
+            GLTexture& tex);
     virtual BitmapPtr moveTextureToBmp(GLTexture& tex, int mipmapLevel=0);
 
 private:
@@ -37,13 +37,17 @@ using namespace std;
 using namespace boost;
 
 CGLContext::CGLContext(const GLConfig& glConfig, const IntPoint& windowSize, 
-        const SDL_SysWMinfo* pSDLWMInfo)
+        const SDL_SysWMinfo* pSDLWMInfo, CGLContext* pSharedContext)
     : GLContext(windowSize)
 {
     if (pSDLWMInfo) {
         m_Context = CGLGetCurrentContext();
         AVG_ASSERT(m_Context);
         setCurrent();
+        if (pSharedContext) {
+            // SDL has already created the context with sharing enabled.
+            setShareGroup(pSharedContext);
+        }
     } else {
         CGLPixelFormatObj pixelFormatObj;
         GLint numPixelFormats;
@@ -51,7 +55,18 @@ CGLContext::CGLContext(const GLConfig& glConfig, const IntPoint& windowSize,
         CGLPixelFormatAttribute attribs[] = {(CGLPixelFormatAttribute)NULL};
         CGLChoosePixelFormat(attribs, &pixelFormatObj, &numPixelFormats);
 
-        CGLError err = CGLCreateContext(pixelFormatObj, 0, &m_Context);
+        CGLContextObj shareContext = 0;
+        if (pSharedContext) {
+            shareContext = pSharedContext->m_Context;
+        }
+        CGLError err = CGLCreateContext(pixelFormatObj, shareContext, &m_Context);
+        if (err && shareContext) {
+            AVG_LOG_WARNING("Creating shared OpenGL context failed: " << 
+                    CGLErrorString(err));
+            err = CGLCreateContext(pixelFormatObj, 0, &m_Context);
+        } else if (shareContext) {
+            setShareGroup(pSharedContext);
+        }
         if (err) {
             cerr << CGLErrorString(err) << endl;
             AVG_ASSERT(false);
@@ -78,6 +93,13 @@ void CGLContext::activate()
     setCurrent();
 }
 
+void CGLContext::deactivate()
+{
+    CGLError err = CGLSetCurrentContext(0);
+    AVG_ASSERT(err == kCGLNoError);
+    clearCurrent();
+}
+
 void CGLContext::swapBuffers()
 {
     CGLFlushDrawable(m_Context);
@@ -37,10 +37,11 @@ class AVG_API CGLContext: public GLContext
 {
 public:
     CGLContext(const GLConfig& glConfig, const IntPoint& windowSize=IntPoint(0,0), 
-            const SDL_SysWMinfo* pSDLWMInfo=0);
+            const SDL_SysWMinfo* pSDLWMInfo=0, CGLContext* pSharedContext=0);
     virtual ~CGLContext();
 
     void activate();
+    void deactivate();
     void swapBuffers();
 
 private:
@@ -33,6 +33,7 @@
 #ifdef _WIN32
 #include "WinDisplay.h"
 #endif
+#include "HeadlessDisplay.h"
 #include "Bitmap.h"
 
 #include "../base/Logger.h"
@@ -71,6 +72,13 @@ bool Display::isInitialized()
     return (s_pInstance != DisplayPtr());
 }
 
+void Display::initHeadless()
+{
+    // Replaces the platform display so nothing queries a screen that isn't there.
+    s_pInstance = DisplayPtr(new HeadlessDisplay());
+    s_pInstance->init();
+}
+
 Display::Display()
     : m_bAutoPPMM(true),
       m_RefreshRate(0)
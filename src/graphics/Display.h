@@ -41,6 +41,7 @@ class AVG_API Display
 public:
     static DisplayPtr get();
     static bool isInitialized();
+    static void initHeadless();
     virtual ~Display();
     void init();
     void rereadScreenResolution();
@@ -40,11 +40,15 @@ namespace avg{
 using namespace std;
 
 EGLContext::EGLContext(const GLConfig& glConfig, const IntPoint& windowSize,
-        const SDL_SysWMinfo* pSDLWMInfo)
-    : GLContext(windowSize)
+        const SDL_SysWMinfo* pSDLWMInfo, EGLContext* pSharedContext)
+    : GLContext(windowSize),
+      m_xDisplay(0)
 {
     if (pSDLWMInfo) {
         useSDLContext(pSDLWMInfo);
+        if (pSharedContext) {
+            setShareGroup(pSharedContext);
+        }
     } else {
         createEGLContext(glConfig, windowSize);
     }
@@ -61,6 +65,12 @@ EGLContext::~EGLContext()
         eglDestroySurface(m_Display, m_Surface);
         eglTerminate(m_Display);
         m_Context = 0;
+#ifndef AVG_ENABLE_RPI
+        if (m_xDisplay) {
+            XCloseDisplay((_XDisplay*)m_xDisplay);
+            m_xDisplay = 0;
+        }
+#endif
     }
 }
 
@@ -78,8 +88,13 @@ void EGLContext::createEGLContext(const GLConfig&, const IntPoint& windowSize)
 #ifdef AVG_ENABLE_RPI
     m_Display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
 #else
-    m_xDisplay = (EGLNativeDisplayType)getX11Display();
-    m_Display = eglGetDisplay(m_xDisplay);
+    // Without an X server (e.g. headless), render to a pbuffer on the default display.
+    m_xDisplay = (EGLNativeDisplayType)XOpenDisplay(0);
+    if (m_xDisplay) {
+        m_Display = eglGetDisplay(m_xDisplay);
+    } else {
+        m_Display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
 #endif
     checkEGLError(m_Display == EGL_NO_DISPLAY, "No EGL display available");
 
@@ -99,6 +114,11 @@ void EGLContext::createEGLContext(const GLConfig&, const IntPoint& windowSize)
 #endif
     fbAttrs.append(EGL_ALPHA_SIZE, alphaSize);
     fbAttrs.append(EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT);
+#ifndef AVG_ENABLE_RPI
+    if (!m_xDisplay) {
+        fbAttrs.append(EGL_SURFACE_TYPE, EGL_PBUFFER_BIT);
+    }
+#endif
     EGLint numFBConfig;
     EGLConfig config;
     bOk = eglChooseConfig(m_Display, fbAttrs.get(), &config, 1, &numFBConfig);
@@ -109,13 +129,15 @@ void EGLContext::createEGLContext(const GLConfig&, const IntPoint& windowSize)
     AVG_ASSERT(bOk);
 
 #ifndef AVG_ENABLE_RPI
-    XVisualInfo visTemplate;
-    visTemplate.visualid = vid;
-    int num_visuals;
-    XVisualInfo* pVisualInfo = XGetVisualInfo((_XDisplay*)m_xDisplay, VisualIDMask,
-            &visTemplate,
-            &num_visuals);
-    AVG_ASSERT(pVisualInfo);
+    if (m_xDisplay) {
+        XVisualInfo visTemplate;
+        visTemplate.visualid = vid;
+        int num_visuals;
+        XVisualInfo* pVisualInfo = XGetVisualInfo((_XDisplay*)m_xDisplay, VisualIDMask,
+                &visTemplate,
+                &num_visuals);
+        AVG_ASSERT(pVisualInfo);
+    }
 #endif
 
     if (!eglBindAPI(EGL_OPENGL_ES_API)) {
@@ -130,18 +152,26 @@ void EGLContext::createEGLContext(const GLConfig&, const IntPoint& windowSize)
 #ifdef AVG_ENABLE_RPI
     m_Surface = createBCMPixmapSurface(m_Display, config);
 #else
-    XVisualInfo visTemplate, *results;
-    visTemplate.screen = 0;
-    int numVisuals;
-    results = XGetVisualInfo((_XDisplay*)m_xDisplay, VisualScreenMask,
-            &visTemplate, & numVisuals);
-
-    Pixmap pmp = XCreatePixmap((_XDisplay*)m_xDisplay,
-            RootWindow((_XDisplay*)m_xDisplay, results[0].screen), 8, 8,
-            results[0].depth);
-
-    m_Surface = eglCreatePixmapSurface(m_Display, config, (EGLNativePixmapType)pmp,
-            NULL);
+    if (m_xDisplay) {
+        XVisualInfo visTemplate, *results;
+        visTemplate.screen = 0;
+        int numVisuals;
+        results = XGetVisualInfo((_XDisplay*)m_xDisplay, VisualScreenMask,
+                &visTemplate, & numVisuals);
+
+        Pixmap pmp = XCreatePixmap((_XDisplay*)m_xDisplay,
+                RootWindow((_XDisplay*)m_xDisplay, results[0].screen), 8, 8,
+                results[0].depth);
+
+        m_Surface = eglCreatePixmapSurface(m_Display, config, (EGLNativePixmapType)pmp,
+                NULL);
+    } else {
+        // Rendering goes to FBOs, so the surface only needs to exist.
+        GLContextAttribs surfaceAttrs;
+        surfaceAttrs.append(EGL_WIDTH, 8);
+        surfaceAttrs.append(EGL_HEIGHT, 8);
+        m_Surface = eglCreatePbufferSurface(m_Display, config, surfaceAttrs.get());
+    }
 #endif
     
     //dumpEGLConfig(config);
@@ -159,6 +189,12 @@ void EGLContext::activate()
     setCurrent();
 }
 
+void EGLContext::deactivate()
+{
+    eglMakeCurrent(m_Display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    clearCurrent();
+}
+
 void EGLContext::swapBuffers()
 {
     AVG_ASSERT(false);
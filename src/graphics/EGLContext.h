@@ -33,11 +33,14 @@ namespace avg {
 class AVG_API EGLContext: public GLContext
 {
 public:
+    // Sharing is only supported for contexts created by SDL. Offscreen contexts each 
+    // have their own display.
     EGLContext(const GLConfig& glConfig, const IntPoint& windowSize=IntPoint(0,0),
-            const SDL_SysWMinfo* pSDLWMInfo=0);
+            const SDL_SysWMinfo* pSDLWMInfo=0, EGLContext* pSharedContext=0);
     virtual ~EGLContext();
 
     void activate();
+    void deactivate();
     void swapBuffers();
 
 private:
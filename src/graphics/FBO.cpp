@@ -157,6 +157,20 @@ void FBO::moveToPBO(int i) const
 #endif
 }
  
+void FBO::moveToPBO(PBO& pbo, int i) const
+{
+    // Like moveToPBO(), but reads into a PBO owned by the caller so several readbacks
+    // can be in flight at once.
+    AVG_ASSERT(GLContext::getCurrent()->getMemoryMode() == MM_PBO);
+#ifndef AVG_ENABLE_EGL
+    copyToDestTexture();
+    glproc::BindFramebuffer(GL_FRAMEBUFFER, m_OutputFBO); 
+    glReadBuffer(GL_COLOR_ATTACHMENT0+i); 
+    GLContext::checkError("FBO::moveToPBO ReadBuffer()"); 
+    pbo.moveFramebufferToPBO(getSize());
+#endif
+}
+ 
 BitmapPtr FBO::getImageFromPBO() const
 {
 #ifdef AVG_ENABLE_EGL
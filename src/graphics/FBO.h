@@ -56,6 +56,7 @@ public:
     void copyToDestTexture() const;
     BitmapPtr getImage(int i=0) const;
     void moveToPBO(int i=0) const;
+    void moveToPBO(PBO& pbo, int i=0) const;
     BitmapPtr getImageFromPBO() const;
     GLTexturePtr getTex(int i=0) const;
 
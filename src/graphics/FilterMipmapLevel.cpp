@@ -0,0 +1,176 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "FilterMipmapLevel.h"
+
+#include "../base/Exception.h"
+
+#include <math.h>
+#include <algorithm>
+
+namespace avg {
+
+using namespace std;
+
+namespace {
+
+// sRGB <-> linear conversion tables. Built during static initialization, so they're
+// ready before any worker thread uses them.
+class GammaTables
+{
+public:
+    GammaTables()
+    {
+        for (int i = 0; i < 256; ++i) {
+            float c = i/255.f;
+            if (c <= 0.04045f) {
+                m_ToLinear[i] = c/12.92f;
+            } else {
+                m_ToLinear[i] = powf((c+0.055f)/1.055f, 2.4f);
+            }
+        }
+        for (int i = 0; i < LINEAR_STEPS; ++i) {
+            float c = float(i)/(LINEAR_STEPS-1);
+            float s;
+            if (c <= 0.0031308f) {
+                s = c*12.92f;
+            } else {
+                s = 1.055f*powf(c, 1/2.4f) - 0.055f;
+            }
+            m_ToSRGB[i] = (unsigned char)(s*255+0.5f);
+        }
+    }
+
+    float toLinear(unsigned char c) const
+    {
+        return m_ToLinear[c];
+    }
+
+    unsigned char toSRGB(float c) const
+    {
+        int i = int(c*(LINEAR_STEPS-1)+0.5f);
+        return m_ToSRGB[max(0, min(i, LINEAR_STEPS-1))];
+    }
+
+private:
+    static const int LINEAR_STEPS = 4096;
+    float m_ToLinear[256];
+    unsigned char m_ToSRGB[LINEAR_STEPS];
+};
+
+static const GammaTables s_GammaTables;
+
+}
+
+FilterMipmapLevel::FilterMipmapLevel()
+    : Filter()
+{
+}
+
+FilterMipmapLevel::~FilterMipmapLevel()
+{
+}
+
+BitmapPtr FilterMipmapLevel::apply(BitmapPtr pBmpSrc)
+{
+    PixelFormat pf = pBmpSrc->getPixelFormat();
+    AVG_ASSERT(isSupported(pf));
+    IntPoint srcSize = pBmpSrc->getSize();
+    IntPoint destSize(max(1, srcSize.x/2), max(1, srcSize.y/2));
+    BitmapPtr pBmpDest(new Bitmap(destSize, pf, pBmpSrc->getName()));
+
+    int bpp = getBytesPerPixel(pf);
+    // A8 is coverage, not light, so it is averaged as is.
+    bool bIsLinear = (pf == A8);
+    bool bHasAlpha = pixelFormatHasAlpha(pf) && bpp == 4;
+    int numColorChannels = bHasAlpha ? 3 : bpp;
+    int srcStride = pBmpSrc->getStride();
+    const unsigned char* pSrcPixels = pBmpSrc->getPixels();
+
+    unsigned char* pDestLine = pBmpDest->getPixels();
+    for (int y = 0; y < destSize.y; ++y) {
+        int y0 = y*2;
+        int y1 = (y == destSize.y-1) ? srcSize.y : y0+2;
+        unsigned char* pDest = pDestLine;
+        for (int x = 0; x < destSize.x; ++x) {
+            int x0 = x*2;
+            int x1 = (x == destSize.x-1) ? srcSize.x : x0+2;
+            float colorSum[4] = {0, 0, 0, 0};
+            float alphaSum = 0;
+            for (int srcY = y0; srcY < y1; ++srcY) {
+                const unsigned char* pSrc = pSrcPixels + srcY*srcStride + x0*bpp;
+                for (int srcX = x0; srcX < x1; ++srcX) {
+                    float weight = 1;
+                    if (bHasAlpha) {
+                        weight = pSrc[3]/255.f;
+                        alphaSum += weight;
+                    }
+                    for (int c = 0; c < numColorChannels; ++c) {
+                        if (bIsLinear) {
+                            colorSum[c] += pSrc[c];
+                        } else {
+                            colorSum[c] += s_GammaTables.toLinear(pSrc[c])*weight;
+                        }
+                    }
+                    pSrc += bpp;
+                }
+            }
+            float numPixels = float((x1-x0)*(y1-y0));
+            float weightSum = numPixels;
+            if (bHasAlpha) {
+                if (alphaSum > 0) {
+                    weightSum = alphaSum;
+                }
+                pDest[3] = (unsigned char)(alphaSum*255/numPixels+0.5f);
+            }
+            for (int c = 0; c < numColorChannels; ++c) {
+                if (bIsLinear) {
+                    pDest[c] = (unsigned char)(colorSum[c]/numPixels+0.5f);
+                } else {
+                    pDest[c] = s_GammaTables.toSRGB(colorSum[c]/weightSum);
+                }
+            }
+            pDest += bpp;
+        }
+        pDestLine += pBmpDest->getStride();
+    }
+    return pBmpDest;
+}
+
+bool FilterMipmapLevel::isSupported(PixelFormat pf)
+{
+    switch (pf) {
+        case B8G8R8A8:
+        case B8G8R8X8:
+        case R8G8B8A8:
+        case R8G8B8X8:
+        case B8G8R8:
+        case R8G8B8:
+        case I8:
+        case A8:
+            return true;
+        default:
+            return false;
+    }
+}
+
+}
@@ -0,0 +1,49 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _FilterMipmapLevel_H_
+#define _FilterMipmapLevel_H_
+
+#include "../api.h"
+#include "Filter.h"
+#include "Bitmap.h"
+
+namespace avg {
+
+// Returns the next mipmap level of a bitmap: Half the size (rounded down, at least one
+// pixel) with each pixel the average of the corresponding 2x2 source block. Color
+// channels are averaged in linear light and weighted by alpha, so downscaled images
+// don't get darker or show dark fringes around transparent areas. For odd sizes, the
+// last row or column of destination pixels also covers the remaining source pixels.
+class AVG_API FilterMipmapLevel : public Filter
+{
+public:
+    FilterMipmapLevel();
+    virtual ~FilterMipmapLevel();
+    virtual BitmapPtr apply(BitmapPtr pBmpSource);
+
+    static bool isSupported(PixelFormat pf);
+};
+
+}
+
+#endif
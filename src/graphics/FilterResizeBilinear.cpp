@@ -25,8 +25,11 @@
 
 namespace avg {
 
-FilterResizeBilinear::FilterResizeBilinear(const IntPoint& newSize)
-    : m_NewSize(newSize)
+FilterResizeBilinear::FilterResizeBilinear(const IntPoint& newSize, int maxThreads,
+        bool bUseSIMD)
+    : m_NewSize(newSize),
+      m_MaxThreads(maxThreads),
+      m_bUseSIMD(bUseSIMD)
 {
 }
 
@@ -42,7 +45,7 @@ BitmapPtr FilterResizeBilinear::apply(BitmapPtr pBmpSrc)
     switch (bpp) {
         case 4:
             {
-                TwoPassScale<CDataRGBA_UBYTE> sS(f);
+                TwoPassScale<CDataRGBA_UBYTE> sS(f, m_MaxThreads, m_bUseSIMD);
                 sS.Scale((CDataRGBA_UBYTE::PixelClass *) pBmpSrc->getPixels(), 
                         pBmpSrc->getSize(), pBmpSrc->getStride(), 
                         (CDataRGBA_UBYTE::PixelClass *) pBmpDest->getPixels(),
@@ -51,7 +54,7 @@ BitmapPtr FilterResizeBilinear::apply(BitmapPtr pBmpSrc)
             break;
         case 3:
             {
-                TwoPassScale <CDataRGB_UBYTE> sS(f);
+                TwoPassScale <CDataRGB_UBYTE> sS(f, m_MaxThreads, m_bUseSIMD);
                 sS.Scale((CDataRGB_UBYTE::PixelClass *) pBmpSrc->getPixels(), 
                         pBmpSrc->getSize(), pBmpSrc->getStride(), 
                         (CDataRGB_UBYTE::PixelClass *) pBmpDest->getPixels(),
@@ -60,7 +63,7 @@ BitmapPtr FilterResizeBilinear::apply(BitmapPtr pBmpSrc)
             break;
         case 1:
             {
-                TwoPassScale <CDataA_UBYTE> sS(f);
+                TwoPassScale <CDataA_UBYTE> sS(f, m_MaxThreads, m_bUseSIMD);
                 sS.Scale((CDataA_UBYTE::PixelClass *) pBmpSrc->getPixels(), 
                         pBmpSrc->getSize(), pBmpSrc->getStride(), 
                         (CDataA_UBYTE::PixelClass *) pBmpDest->getPixels(),
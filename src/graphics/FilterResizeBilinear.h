@@ -27,11 +27,15 @@ namespace avg {
 class AVG_API FilterResizeBilinear : public Filter
 {
 public:
-    FilterResizeBilinear(const IntPoint& newSize);
+    // Large bitmaps are scaled using up to maxThreads threads (0 means one per core).
+    // bUseSIMD=false restricts scaling to the scalar code.
+    FilterResizeBilinear(const IntPoint& newSize, int maxThreads=0, bool bUseSIMD=true);
     virtual BitmapPtr apply(BitmapPtr pBmpSrc);
 
 private:
     IntPoint m_NewSize;
+    int m_MaxThreads;
+    bool m_bUseSIMD;
 };
 
 }
@@ -25,9 +25,12 @@
 
 namespace avg {
 
-FilterResizeGaussian::FilterResizeGaussian(const IntPoint& newSize, float radius)
+FilterResizeGaussian::FilterResizeGaussian(const IntPoint& newSize, float radius,
+        int maxThreads, bool bUseSIMD)
     : m_NewSize(newSize),
-      m_Radius(radius)
+      m_Radius(radius),
+      m_MaxThreads(maxThreads),
+      m_bUseSIMD(bUseSIMD)
 {
 }
 
@@ -43,7 +46,7 @@ BitmapPtr FilterResizeGaussian::apply(BitmapPtr pBmpSrc)
     switch (bpp) {
         case 4:
             {
-                TwoPassScale<CDataRGBA_UBYTE> sS(f);
+                TwoPassScale<CDataRGBA_UBYTE> sS(f, m_MaxThreads, m_bUseSIMD);
                 sS.Scale((CDataRGBA_UBYTE::PixelClass *) pBmpSrc->getPixels(), 
                         pBmpSrc->getSize(), pBmpSrc->getStride(), 
                         (CDataRGBA_UBYTE::PixelClass *) pBmpDest->getPixels(),
@@ -52,7 +55,7 @@ BitmapPtr FilterResizeGaussian::apply(BitmapPtr pBmpSrc)
             break;
         case 3:
             {
-                TwoPassScale <CDataRGB_UBYTE> sS(f);
+                TwoPassScale <CDataRGB_UBYTE> sS(f, m_MaxThreads, m_bUseSIMD);
                 sS.Scale((CDataRGB_UBYTE::PixelClass *) pBmpSrc->getPixels(), 
                         pBmpSrc->getSize(), pBmpSrc->getStride(), 
                         (CDataRGB_UBYTE::PixelClass *) pBmpDest->getPixels(),
@@ -61,7 +64,7 @@ BitmapPtr FilterResizeGaussian::apply(BitmapPtr pBmpSrc)
             break;
         case 1:
             {
-                TwoPassScale <CDataA_UBYTE> sS(f);
+                TwoPassScale <CDataA_UBYTE> sS(f, m_MaxThreads, m_bUseSIMD);
                 sS.Scale((CDataA_UBYTE::PixelClass *) pBmpSrc->getPixels(), 
                         pBmpSrc->getSize(), pBmpSrc->getStride(), 
                         (CDataA_UBYTE::PixelClass *) pBmpDest->getPixels(),
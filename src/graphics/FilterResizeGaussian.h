@@ -28,12 +28,17 @@ namespace avg {
 class AVG_API FilterResizeGaussian : public Filter
 {
 public:
-    FilterResizeGaussian(const IntPoint& newSize, float radius);
+    // Large bitmaps are scaled using up to maxThreads threads (0 means one per core).
+    // bUseSIMD=false restricts scaling to the scalar code.
+    FilterResizeGaussian(const IntPoint& newSize, float radius, int maxThreads=0,
+            bool bUseSIMD=true);
     virtual BitmapPtr apply(BitmapPtr pBmpSrc);
 
 private:
     IntPoint m_NewSize;
     float m_Radius;
+    int m_MaxThreads;
+    bool m_bUseSIMD;
 };
 
 }
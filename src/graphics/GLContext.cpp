@@ -30,6 +30,7 @@
 #include "../base/Logger.h"
 #include "../base/MathHelper.h"
 #include "../base/OSHelper.h"
+#include "../base/StringHelper.h"
 
 #include <SDL2/SDL.h>
 
@@ -41,23 +42,30 @@ namespace avg {
 using namespace std;
 using namespace boost;
 
-GLContext* GLContext::s_pCurrentContext;
+thread_specific_ptr<GLContext*> GLContext::s_pCurrentContext;
 bool GLContext::s_bErrorCheckEnabled = false;
 bool GLContext::s_bErrorLogEnabled = true;
+int GLContext::s_NumContextsCreated = 0;
 
 
 GLContext::GLContext(const IntPoint& windowSize)
-    : m_MaxTexSize(0),
+    : m_pShareGroup(this),
+      m_MaxTexSize(0),
       m_bCheckedGPUMemInfoExtension(false),
       m_bCheckedMemoryMode(false),
       m_BlendColor(0.f, 0.f, 0.f, 0.f),
       m_BlendMode(BLEND_ADD),
+      m_ActiveTexUnit(0),
+      m_NumIssuedStateChanges(0),
+      m_NumElidedStateChanges(0),
       m_MajorGLVersion(-1)
 {
     string sVal;
     if (getEnv("AVG_ENABLE_GL_ERROR_CHECKS", sVal)) {
         enableErrorChecks(true);
     }
+    m_sTextureMemCategory = "GL textures: context "+toString(s_NumContextsCreated);
+    s_NumContextsCreated++;
     GLContextManager::get()->registerContext(this);
 }
 
@@ -131,18 +139,21 @@ void GLContext::init(const GLConfig& glConfig, bool bOwnsContext)
     glEnable(GL_STENCIL_TEST);
     checkError("init: glEnable(GL_STENCIL_TEST)");
 
+    m_UploadBufferPool.init(isSyncSupported());
     m_pStandardShader = new StandardShader(this);
 }
 
 void GLContext::deleteObjects()
 {
     delete m_pStandardShader;
+    m_UploadBufferPool.dumpStatistics();
+    m_UploadBufferPool.deleteBuffers();
     for (unsigned i=0; i<m_FBOIDs.size(); ++i) {
         glproc::DeleteFramebuffers(1, &(m_FBOIDs[i]));
     }
     m_FBOIDs.clear();
-    if (s_pCurrentContext == this) {
-        s_pCurrentContext = 0;
+    if (getCurrent() == this) {
+        clearCurrent();
     }
 }
 
@@ -159,7 +170,17 @@ bool GLContext::ownsContext() const
 
 void GLContext::setCurrent()
 {
-    s_pCurrentContext = this;
+    if (s_pCurrentContext.get() == 0) {
+        s_pCurrentContext.reset(new (GLContext*));
+    }
+    *s_pCurrentContext = this;
+}
+
+void GLContext::clearCurrent()
+{
+    if (s_pCurrentContext.get() != 0) {
+        *s_pCurrentContext = 0;
+    }
 }
 
 ShaderRegistryPtr GLContext::getShaderRegistry() const
@@ -182,11 +203,31 @@ GLConfig::ShaderUsage GLContext::getShaderUsage() const
     return m_GLConfig.m_ShaderUsage;
 }
 
+void GLContext::setShareGroup(GLContext* pSharedContext)
+{
+    m_pShareGroup = pSharedContext->getShareGroup();
+}
+
+GLContext* GLContext::getShareGroup() const
+{
+    return m_pShareGroup;
+}
+
+const string& GLContext::getTextureMemCategory() const
+{
+    return m_sTextureMemCategory;
+}
+
 GLBufferCache& GLContext::getPBOCache()
 {
     return m_PBOCache;
 }
 
+UploadBufferPool& GLContext::getUploadBufferPool()
+{
+    return m_UploadBufferPool;
+}
+
 unsigned GLContext::genFBO()
 {
     unsigned fboID;
@@ -217,6 +258,9 @@ void GLContext::setBlendColor(const glm::vec4& color)
     if (m_BlendColor != color) {
         glproc::BlendColor(color[0], color[1], color[2], color[3]);
         m_BlendColor = color;
+        countStateChange(true);
+    } else {
+        countStateChange(false);
     }
 }
 
@@ -265,6 +309,9 @@ void GLContext::setBlendMode(BlendMode mode, bool bPremultipliedAlpha)
 
         m_BlendMode = mode;
         m_bPremultipliedAlpha = bPremultipliedAlpha;
+        countStateChange(true);
+    } else {
+        countStateChange(false);
     }
 }
 
@@ -277,17 +324,56 @@ bool GLContext::isBlendModeSupported(BlendMode mode) const
     }
 }
 
+void GLContext::setActiveTexture(unsigned unit)
+{
+    if (m_ActiveTexUnit != unit) {
+        glproc::ActiveTexture(unit);
+        checkError("GLContext::setActiveTexture()");
+        m_ActiveTexUnit = unit;
+        countStateChange(true);
+    } else {
+        countStateChange(false);
+    }
+}
+
 void GLContext::bindTexture(unsigned unit, unsigned texID)
 {
     if (m_BoundTextures[unit-GL_TEXTURE0] != texID) {
-        glproc::ActiveTexture(unit);
-        checkError("GLContext::bindTexture ActiveTexture()");
+        setActiveTexture(unit);
         glBindTexture(GL_TEXTURE_2D, texID);
         checkError("GLContext::bindTexture BindTexture()");
         m_BoundTextures[unit-GL_TEXTURE0] = texID;
+        countStateChange(true);
+    } else {
+        countStateChange(false);
+    }
+}
+
+void GLContext::countStateChange(bool bIssued)
+{
+    if (bIssued) {
+        m_NumIssuedStateChanges++;
+    } else {
+        m_NumElidedStateChanges++;
     }
 }
 
+void GLContext::resetStateChangeStats()
+{
+    m_NumIssuedStateChanges = 0;
+    m_NumElidedStateChanges = 0;
+}
+
+unsigned GLContext::getNumIssuedStateChanges() const
+{
+    return m_NumIssuedStateChanges;
+}
+
+unsigned GLContext::getNumElidedStateChanges() const
+{
+    return m_NumElidedStateChanges;
+}
+
 const GLConfig& GLContext::getConfig()
 {
     return m_GLConfig;
@@ -369,6 +455,33 @@ bool GLContext::arePBOsSupported()
     }
 }
 
+bool GLContext::isInstancingSupported() const
+{
+    if (isGLES()) {
+        return queryOGLExtension("GL_EXT_instanced_arrays");
+    } else {
+        bool bIsCore = (m_MajorGLVersion > 3 || 
+                (m_MajorGLVersion == 3 && m_MinorGLVersion >= 3));
+        return bIsCore || (queryOGLExtension("GL_ARB_instanced_arrays") &&
+                queryOGLExtension("GL_ARB_draw_instanced"));
+    }
+}
+
+bool GLContext::isSyncSupported() const
+{
+#ifdef AVG_ENABLE_EGL
+    return false;
+#else
+    if (isGLES()) {
+        return false;
+    } else {
+        bool bIsCore = (m_MajorGLVersion > 3 || 
+                (m_MajorGLVersion == 3 && m_MinorGLVersion >= 2));
+        return bIsCore || queryOGLExtension("GL_ARB_sync");
+    }
+#endif
+}
+
 OGLMemoryMode GLContext::getMemoryMode()
 {
     if (!m_bCheckedMemoryMode) {
@@ -503,7 +616,10 @@ GLContext::BlendMode GLContext::stringToBlendMode(const string& s)
 
 GLContext* GLContext::getCurrent()
 {
-    return s_pCurrentContext;
+    if (s_pCurrentContext.get() == 0) {
+        return 0;
+    }
+    return *s_pCurrentContext;
 }
 
 int GLContext::nextMultiSampleValue(int curSamples)
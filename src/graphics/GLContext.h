@@ -24,6 +24,7 @@
 #include "../api.h"
 
 #include "GLBufferCache.h"
+#include "UploadBufferPool.h"
 #include "GLConfig.h"
 
 #include "../base/GLMHelper.h"
@@ -46,13 +47,25 @@ public:
     virtual ~GLContext();
 
     virtual void activate()=0;
+    // Releases the context so another thread can activate it.
+    virtual void deactivate()=0;
     ShaderRegistryPtr getShaderRegistry() const;
     StandardShader* getStandardShader();
     bool useGPUYUVConversion() const;
     GLConfig::ShaderUsage getShaderUsage() const;
 
+    // Contexts that share GL objects (textures, buffers) form a share group. The first
+    // context created in the group identifies it. Contexts that don't share objects 
+    // are their own share group.
+    void setShareGroup(GLContext* pSharedContext);
+    GLContext* getShareGroup() const;
+
+    // Memory accounting category for textures created in this context.
+    const std::string& getTextureMemCategory() const;
+
     // GL Object caching.
     GLBufferCache& getPBOCache();
+    UploadBufferPool& getUploadBufferPool();
     unsigned genFBO();
     void returnFBOToCache(unsigned fboID);
 
@@ -61,8 +74,16 @@ public:
     enum BlendMode {BLEND_BLEND, BLEND_ADD, BLEND_MIN, BLEND_MAX, BLEND_COPY};
     void setBlendMode(BlendMode mode, bool bPremultipliedAlpha = false);
     bool isBlendModeSupported(BlendMode mode) const;
+    void setActiveTexture(unsigned unit);
     void bindTexture(unsigned unit, unsigned texID);
 
+    // Number of state changes sent to GL and skipped because the state was already
+    // set since the last call to resetStateChangeStats().
+    void countStateChange(bool bIssued);
+    void resetStateChangeStats();
+    unsigned getNumIssuedStateChanges() const;
+    unsigned getNumElidedStateChanges() const;
+
     const GLConfig& getConfig();
     void logConfig();
     size_t getVideoMemInstalled();
@@ -70,6 +91,8 @@ public:
     int getMaxTexSize();
     bool usePOTTextures();
     bool arePBOsSupported();
+    bool isInstancingSupported() const;
+    bool isSyncSupported() const;
     OGLMemoryMode getMemoryMode();
     bool isGLES() const;
     bool isVendor(const std::string& sWantedVendor) const;
@@ -99,6 +122,7 @@ protected:
     bool ownsContext() const;
 
     void setCurrent();
+    void clearCurrent();
 
 private:
     void checkGPUMemInfoSupport();
@@ -107,11 +131,14 @@ private:
         GLenum severity, GLsizei length, const GLchar* message, void* userParam);
 
     bool m_bOwnsContext;
+    GLContext* m_pShareGroup;
+    std::string m_sTextureMemCategory;
     
     ShaderRegistryPtr m_pShaderRegistry;
     StandardShader* m_pStandardShader;
 
     GLBufferCache m_PBOCache;
+    UploadBufferPool m_UploadBufferPool;
     std::vector<unsigned int> m_FBOIDs;
 
     int m_MaxTexSize;
@@ -125,8 +152,12 @@ private:
     glm::vec4 m_BlendColor;
     BlendMode m_BlendMode;
     bool m_bPremultipliedAlpha;
+    unsigned m_ActiveTexUnit;
     unsigned m_BoundTextures[16];
 
+    unsigned m_NumIssuedStateChanges;
+    unsigned m_NumElidedStateChanges;
+
     std::string m_sVendor;
     std::string m_sRenderer;
     int m_MajorGLVersion;
@@ -134,8 +165,10 @@ private:
 
     static bool s_bErrorCheckEnabled;
     static bool s_bErrorLogEnabled;
+    static int s_NumContextsCreated;
 
-    static GLContext* s_pCurrentContext;
+    // Each render thread has its own current context.
+    static boost::thread_specific_ptr<GLContext*> s_pCurrentContext;
 };
 
 }
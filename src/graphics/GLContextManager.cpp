@@ -25,12 +25,15 @@
 #include "../base/Logger.h"
 #include "../base/Backtrace.h"
 #include "../base/ScopeTimer.h"
+#include "../base/FramePhaseTimer.h"
+#include "../base/ThreadHelper.h"
 
 #include "GLTexture.h"
 #include "MCTexture.h"
 #include "VertexArray.h"
 #include "MCFBO.h"
 #include "ShaderRegistry.h"
+#include "FilterMipmapLevel.h"
 
 #ifdef __APPLE__
     #include "CGLContext.h"
@@ -44,6 +47,10 @@
     #include "WGLContext.h"
 #endif
 
+#include <boost/bind.hpp>
+
+#include <string.h>
+
 
 namespace avg {
 
@@ -63,6 +70,10 @@ bool GLContextManager::isActive()
 }
 
 GLContextManager::GLContextManager()
+    : m_pSharedChangesFence(0),
+      m_MipmapUploadBudget(0),
+      m_NextMipmapJobID(0),
+      m_bMipmapUploadsPlanned(false)
 {
 //    AVG_ASSERT(!s_pGLContextManager);
     s_pGLContextManager = this;
@@ -70,6 +81,7 @@ GLContextManager::GLContextManager()
 
 GLContextManager::~GLContextManager()
 {
+    stopMipmapThreads();
     m_pPendingTexCreates.clear();
     m_pPendingTexUploads.clear();
     m_PendingTexDeletes.clear();
@@ -83,24 +95,29 @@ GLContextManager::~GLContextManager()
 }
 
 GLContext* GLContextManager::createContext(const GLConfig& glConfig, 
-            const IntPoint& windowSize, const SDL_SysWMinfo* pSDLWMInfo)
+            const IntPoint& windowSize, const SDL_SysWMinfo* pSDLWMInfo,
+            GLContext* pSharedContext)
 {
     if (glConfig.m_bGLES) {
         AVG_ASSERT(isGLESSupported());
     }
     GLContext* pContext;
 #ifdef __APPLE__
-    pContext = new CGLContext(glConfig, windowSize, pSDLWMInfo);
+    pContext = new CGLContext(glConfig, windowSize, pSDLWMInfo,
+            dynamic_cast<CGLContext*>(pSharedContext));
 #elif defined __linux__
     #ifdef AVG_ENABLE_EGL
         GLConfig tempConfig = glConfig;
         tempConfig.m_bGLES = true;
-        pContext = new EGLContext(tempConfig, windowSize, pSDLWMInfo);
+        pContext = new EGLContext(tempConfig, windowSize, pSDLWMInfo,
+                dynamic_cast<EGLContext*>(pSharedContext));
     #else
-        pContext = new GLXContext(glConfig, windowSize, pSDLWMInfo);
+        pContext = new GLXContext(glConfig, windowSize, pSDLWMInfo,
+                dynamic_cast<GLXContext*>(pSharedContext));
     #endif
 #elif defined _WIN32
-    pContext = new WGLContext(glConfig, windowSize, pSDLWMInfo);
+    pContext = new WGLContext(glConfig, windowSize, pSDLWMInfo,
+            dynamic_cast<WGLContext*>(pSharedContext));
 #else
     AVG_ASSERT(false);
     pContext = 0;
@@ -115,6 +132,9 @@ void GLContextManager::registerContext(GLContext* pContext)
 
 void GLContextManager::unregisterContext(GLContext* pContext)
 {
+    // Shared objects are keyed by the first context of the share group, so that context
+    // needs to be deleted last.
+    AVG_ASSERT(!hasSharingContexts(pContext));
     vector<GLContext*>::iterator it;
     for (it=m_pContexts.begin(); it!=m_pContexts.end(); ++it) {
         if (*it == pContext) {
@@ -136,10 +156,22 @@ int GLContextManager::getContextIndex(GLContext* pContext)
     return -1;
 }
 
+int GLContextManager::getNumShareGroups() const
+{
+    int numGroups = 0;
+    for (unsigned i=0; i<m_pContexts.size(); ++i) {
+        if (m_pContexts[i]->getShareGroup() == m_pContexts[i]) {
+            numGroups++;
+        }
+    }
+    return numGroups;
+}
+
 MCTexturePtr GLContextManager::createTexture(const IntPoint& size, PixelFormat pf, 
         bool bMipmap, bool bForcePOT, int potBorderColor)
 {
-    MCTexturePtr pTex(new MCTexture(size, pf, bMipmap, bForcePOT, potBorderColor));
+    MCTexturePtr pTex(new MCTexture(size, pf, bMipmap, bForcePOT, potBorderColor, 
+            true));
     m_pPendingTexCreates.push_back(pTex);
     return pTex;
 }
@@ -154,19 +186,50 @@ MCFBOPtr GLContextManager::createFBO(const IntPoint& size, PixelFormat pf,
     return pFBO;
 }
 
-void GLContextManager::createShader(const string& sID)
+void GLContextManager::createShader(const string& sID, const string& sVertID)
 {
     GLContext* pContext = GLContext::getCurrent();
     for (unsigned i=0; i<m_pContexts.size(); ++i) {
         m_pContexts[i]->activate();
-        m_pContexts[i]->getShaderRegistry()->createShader(sID);
+        m_pContexts[i]->getShaderRegistry()->createShader(sID, sVertID);
     }
     pContext->activate();
 }
 
 void GLContextManager::scheduleTexUpload(MCTexturePtr pTex, BitmapPtr pBmp)
 {
-    m_pPendingTexUploads[pTex] = pBmp;
+    // GLES 2 has no GL_TEXTURE_BASE_LEVEL.
+    if (!m_pMipmapThreads.empty() && !m_pContexts[0]->isGLES() && 
+            pTex->canStreamMipmaps())
+    {
+        m_pPendingTexUploads.erase(pTex);
+        scheduleMipmapStream(pTex, pBmp);
+        return;
+    }
+    TexUpload& upload = m_pPendingTexUploads[pTex];
+    upload.m_pBmp = pBmp;
+    upload.m_bIsFullUpload = true;
+    upload.m_DirtyRects.clear();
+}
+
+void GLContextManager::scheduleTexUpload(MCTexturePtr pTex, BitmapPtr pBmp, 
+        const IntRect& dirtyRect)
+{
+    IntRect rect = dirtyRect;
+    rect.intersect(IntRect(IntPoint(0,0), pBmp->getSize()));
+    if (rect.width() <= 0 || rect.height() <= 0) {
+        return;
+    }
+    if (hasMipmapStream(pTex)) {
+        // The levels being streamed are outdated now.
+        scheduleTexUpload(pTex, pBmp);
+        return;
+    }
+    // Earlier dirty rects are uploaded from the new bitmap as well, since it contains
+    // the current contents of the complete texture.
+    TexUpload& upload = m_pPendingTexUploads[pTex];
+    upload.m_pBmp = pBmp;
+    upload.addDirtyRect(rect, pBmp->getSize());
 }
 
 MCTexturePtr GLContextManager::createTextureFromBmp(BitmapPtr pBmp, bool bMipmap,
@@ -183,16 +246,49 @@ void GLContextManager::deleteTexture(unsigned texID)
     m_PendingTexDeletes.push_back(texID);
 }
 
+void GLContextManager::setMipmapThreads(int numThreads)
+{
+    AVG_ASSERT(numThreads >= 0);
+    stopMipmapThreads();
+    if (numThreads == 0) {
+        return;
+    }
+    m_pMipmapCmdQueue = MipmapThread::CQueuePtr(new MipmapThread::CQueue);
+    m_pMipmapResultQueue = MipmapResultQueuePtr(new MipmapResultQueue);
+    for (int i = 0; i < numThreads; ++i) {
+        m_pMipmapThreads.push_back(new boost::thread(
+                MipmapThread(*m_pMipmapCmdQueue, *m_pMipmapResultQueue)));
+    }
+}
+
+int GLContextManager::getMipmapThreads() const
+{
+    return m_pMipmapThreads.size();
+}
+
+void GLContextManager::setMipmapUploadBudget(int numBytes)
+{
+    AVG_ASSERT(numBytes >= 0);
+    m_MipmapUploadBudget = numBytes;
+}
+
+int GLContextManager::getNumPendingMipmaps() const
+{
+    return m_MipmapStreams.size();
+}
+
 VertexArrayPtr GLContextManager::createVertexArray(int reserveVerts,
         int reserveIndexes)
 {
     VertexArrayPtr pVA(new VertexArray(reserveVerts, reserveIndexes));
+    lock_guard lock(m_VAMutex);
     m_pPendingVACreates.push_back(pVA);
     return pVA;
 }
 
 void GLContextManager::deleteBuffers(BufferIDMap& bufferIDs)
 {
+    lock_guard lock(m_VAMutex);
     m_PendingBufferDeletes.push_back(bufferIDs);
 }
 
@@ -212,7 +308,11 @@ static ProfilingZoneID UploadDataProfilingZone("uploadData");
 void GLContextManager::uploadDataForContext()
 {
     ScopeTimer timer(UploadDataProfilingZone);
+    FramePhaseTimer phaseTimer(FramePhaseTimer::UPLOAD);
     GLContext* pContext = GLContext::getCurrent();
+    if (!m_bMipmapUploadsPlanned) {
+        planMipmapUploads();
+    }
     for (unsigned i=0; i<m_PendingBufferDeletes.size(); ++i) {
         glproc::DeleteBuffers(1, &m_PendingBufferDeletes[i][pContext]);
         GLContext::checkError("GLContextManager: delete buffers");
@@ -227,15 +327,41 @@ void GLContextManager::uploadDataForContext()
         GLContext::checkError("GLContextManager: delete textures");
     }
 
-    for (unsigned i=0; i<m_pPendingTexCreates.size(); ++i) {
-        m_pPendingTexCreates[i]->initForGLContext(pContext);
-    }
+    // Textures are shared, so they are created and uploaded once per share group.
+    if (pContext->getShareGroup() == pContext) {
+        for (unsigned i=0; i<m_pPendingTexCreates.size(); ++i) {
+            m_pPendingTexCreates[i]->initForGLContext(pContext);
+        }
+
+        TexUploadMap::iterator it;
+        for (it=m_pPendingTexUploads.begin(); it!=m_pPendingTexUploads.end(); ++it) {
+            MCTexturePtr pTex = it->first;
+            const TexUpload& upload = it->second;
+            if (upload.m_bIsFullUpload) {
+                pTex->moveBmpToTexture(pContext, upload.m_pBmp);
+            } else {
+                for (unsigned i=0; i<upload.m_DirtyRects.size(); ++i) {
+                    pTex->moveBmpRectToTexture(pContext, upload.m_pBmp, 
+                            upload.m_DirtyRects[i]);
+                }
+            }
+        }
 
-    TexUploadMap::iterator it;
-    for (it=m_pPendingTexUploads.begin(); it!=m_pPendingTexUploads.end(); ++it) {
-        MCTexturePtr pTex = it->first;
-        BitmapPtr pBmp = it->second;
-        pTex->moveBmpToTexture(pContext, pBmp);
+        // Levels of one texture are ordered coarse to fine, so the base level ends up
+        // at the finest level available.
+        for (unsigned i=0; i<m_MipmapLevelUploads.size(); ++i) {
+            const MipmapLevelUpload& upload = m_MipmapLevelUploads[i];
+            upload.m_pTex->moveBmpToMipmapLevel(pContext, upload.m_pBmp, 
+                    upload.m_Level);
+            upload.m_pTex->setMipmapBaseLevel(pContext, upload.m_Level);
+        }
+        if (hasSharingContexts(pContext) && (!m_pPendingTexCreates.empty() || 
+                !m_pPendingTexUploads.empty() || !m_MipmapLevelUploads.empty()))
+        {
+            // Submits the changes, but doesn't wait for them to complete. Contexts
+            // in other threads need to call waitForSharedChanges() before using them.
+            glFlush();
+        }
     }
 
     for (unsigned i=0; i<m_pPendingFBOCreates.size(); ++i) {
@@ -248,8 +374,34 @@ void GLContextManager::uploadDataForContext()
     
 }
 
+void GLContextManager::fenceSharedChanges()
+{
+    deleteSharedChangesFence();
+#ifndef AVG_ENABLE_EGL
+    if (GLContext::getCurrent()->isSyncSupported()) {
+        m_pSharedChangesFence = glproc::FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        GLContext::checkError("GLContextManager: FenceSync()");
+        // Other contexts can only wait for the fence once it has been submitted.
+        glFlush();
+        return;
+    }
+#endif
+    glFinish();
+}
+
+void GLContextManager::waitForSharedChanges()
+{
+#ifndef AVG_ENABLE_EGL
+    if (m_pSharedChangesFence) {
+        glproc::WaitSync((GLsync)m_pSharedChangesFence, 0, GL_TIMEOUT_IGNORED);
+        GLContext::checkError("GLContextManager: WaitSync()");
+    }
+#endif
+}
+
 void GLContextManager::reset()
 {
+    deleteSharedChangesFence();
     // Tex deletes are cleared first, because clearing the creates/uploads can actually
     // cause texture deletes to be scheduled!
     m_PendingTexDeletes.clear();
@@ -261,6 +413,248 @@ void GLContextManager::reset()
 
     m_pPendingVACreates.clear();
     m_PendingBufferDeletes.clear();
+
+    m_MipmapLevelUploads.clear();
+    m_bMipmapUploadsPlanned = false;
+}
+
+GLContextManager::TexUpload::TexUpload()
+    : m_bIsFullUpload(false)
+{
+}
+
+void GLContextManager::TexUpload::addDirtyRect(const IntRect& rect, 
+        const IntPoint& texSize)
+{
+    // A few large transfers are faster than lots of small ones.
+    static const unsigned MAX_DIRTY_RECTS = 8;
+
+    if (m_bIsFullUpload) {
+        return;
+    }
+    // Merge the new rect with all rects it overlaps or that it can be combined with 
+    // without uploading additional pixels.
+    IntRect newRect = rect;
+    bool bMerged = true;
+    while (bMerged) {
+        bMerged = false;
+        vector<IntRect>::iterator it;
+        for (it=m_DirtyRects.begin(); it!=m_DirtyRects.end(); ++it) {
+            IntRect boundingRect = newRect;
+            boundingRect.expand(*it);
+            int boundingArea = boundingRect.width()*boundingRect.height();
+            int sumArea = newRect.width()*newRect.height() + it->width()*it->height();
+            if (newRect.intersects(*it) || boundingArea <= sumArea) {
+                newRect = boundingRect;
+                m_DirtyRects.erase(it);
+                bMerged = true;
+                break;
+            }
+        }
+    }
+    m_DirtyRects.push_back(newRect);
+
+    if (m_DirtyRects.size() > MAX_DIRTY_RECTS) {
+        IntRect boundingRect = m_DirtyRects[0];
+        for (unsigned i=1; i<m_DirtyRects.size(); ++i) {
+            boundingRect.expand(m_DirtyRects[i]);
+        }
+        m_DirtyRects.clear();
+        m_DirtyRects.push_back(boundingRect);
+    }
+    int dirtyArea = 0;
+    for (unsigned i=0; i<m_DirtyRects.size(); ++i) {
+        dirtyArea += m_DirtyRects[i].width()*m_DirtyRects[i].height();
+    }
+    if (dirtyArea*2 > texSize.x*texSize.y) {
+        m_bIsFullUpload = true;
+        m_DirtyRects.clear();
+    }
+}
+
+void GLContextManager::deleteSharedChangesFence()
+{
+#ifndef AVG_ENABLE_EGL
+    if (m_pSharedChangesFence) {
+        glproc::DeleteSync((GLsync)m_pSharedChangesFence);
+        m_pSharedChangesFence = 0;
+    }
+#endif
+}
+
+bool GLContextManager::hasSharingContexts(GLContext* pContext) const
+{
+    for (unsigned i=0; i<m_pContexts.size(); ++i) {
+        if (m_pContexts[i] != pContext && m_pContexts[i]->getShareGroup() == pContext) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void GLContextManager::scheduleMipmapStream(MCTexturePtr pTex, BitmapPtr pBmp)
+{
+    cancelMipmapStream(pTex);
+    unsigned jobID = m_NextMipmapJobID++;
+    MipmapStream& stream = m_MipmapStreams[jobID];
+    stream.m_pTex = pTex;
+    stream.m_pLevels.push_back(pBmp);
+    stream.m_bCalculated = false;
+    stream.m_NextLevel = -1;
+    // Until the first level is uploaded, the texture contents are undefined. An
+    // estimate of the coarsest level is cheap and goes up in the next upload round.
+    stream.m_pCoarsestEstimate = estimateCoarsestMipmap(pBmp);
+    stream.m_CoarsestLevel = 0;
+    while (pTex->getMipmapSize(stream.m_CoarsestLevel) != IntPoint(1,1)) {
+        stream.m_CoarsestLevel++;
+    }
+    m_pMipmapCmdQueue->pushCmd(boost::bind(&MipmapThread::generateMipmaps, _1, jobID,
+            pBmp));
+}
+
+bool GLContextManager::hasMipmapStream(const MCTexturePtr& pTex) const
+{
+    MipmapStreamMap::const_iterator it;
+    for (it=m_MipmapStreams.begin(); it!=m_MipmapStreams.end(); ++it) {
+        if (it->second.m_pTex.lock() == pTex) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void GLContextManager::cancelMipmapStream(const MCTexturePtr& pTex)
+{
+    // The result of a job that is still running is ignored when it arrives.
+    MipmapStreamMap::iterator it;
+    for (it=m_MipmapStreams.begin(); it!=m_MipmapStreams.end(); ++it) {
+        if (it->second.m_pTex.lock() == pTex) {
+            m_MipmapStreams.erase(it);
+            return;
+        }
+    }
+}
+
+static ProfilingZoneID PlanMipmapUploadsProfilingZone("planMipmapUploads");
+
+void GLContextManager::planMipmapUploads()
+{
+    m_bMipmapUploadsPlanned = true;
+    if (m_MipmapStreams.empty()) {
+        return;
+    }
+    ScopeTimer timer(PlanMipmapUploadsProfilingZone);
+    while (!m_pMipmapResultQueue->empty()) {
+        MipmapResultQueue::QElementPtr pResult = m_pMipmapResultQueue->pop();
+        MipmapStreamMap::iterator it = m_MipmapStreams.find(pResult->m_JobID);
+        if (it != m_MipmapStreams.end()) {
+            MipmapStream& stream = it->second;
+            stream.m_pLevels.insert(stream.m_pLevels.end(), pResult->m_pLevels.begin(),
+                    pResult->m_pLevels.end());
+            stream.m_bCalculated = true;
+            stream.m_NextLevel = stream.m_pLevels.size()-1;
+        }
+    }
+
+    // Estimates are tiny and required for correct rendering, so they ignore the budget.
+    MipmapStreamMap::iterator it;
+    for (it=m_MipmapStreams.begin(); it!=m_MipmapStreams.end(); ++it) {
+        MipmapStream& stream = it->second;
+        MCTexturePtr pTex = stream.m_pTex.lock();
+        if (pTex && stream.m_pCoarsestEstimate) {
+            MipmapLevelUpload upload;
+            upload.m_pTex = pTex;
+            upload.m_pBmp = stream.m_pCoarsestEstimate;
+            upload.m_Level = stream.m_CoarsestLevel;
+            m_MipmapLevelUploads.push_back(upload);
+            stream.m_pCoarsestEstimate = BitmapPtr();
+        }
+    }
+
+    // Each pass uploads one level of every stream, so coarse levels of all textures
+    // become visible before the fine levels of any texture. At least one level is 
+    // uploaded per round, even if it exceeds the budget.
+    int budget = m_MipmapUploadBudget;
+    bool bBudgetExceeded = false;
+    bool bUploaded = true;
+    while (bUploaded && !bBudgetExceeded) {
+        bUploaded = false;
+        for (it=m_MipmapStreams.begin(); it!=m_MipmapStreams.end(); ++it) {
+            MipmapStream& stream = it->second;
+            MCTexturePtr pTex = stream.m_pTex.lock();
+            if (!pTex || stream.m_NextLevel < 0) {
+                continue;
+            }
+            BitmapPtr pBmp = stream.m_pLevels[stream.m_NextLevel];
+            int numBytes = pBmp->getMemNeeded();
+            if (m_MipmapUploadBudget > 0 && numBytes > budget && 
+                    !m_MipmapLevelUploads.empty())
+            {
+                bBudgetExceeded = true;
+                break;
+            }
+            MipmapLevelUpload upload;
+            upload.m_pTex = pTex;
+            upload.m_pBmp = pBmp;
+            upload.m_Level = stream.m_NextLevel;
+            m_MipmapLevelUploads.push_back(upload);
+            budget -= numBytes;
+            stream.m_NextLevel--;
+            bUploaded = true;
+        }
+    }
+
+    it = m_MipmapStreams.begin();
+    while (it != m_MipmapStreams.end()) {
+        const MipmapStream& stream = it->second;
+        if (stream.m_pTex.expired() || 
+                (stream.m_bCalculated && stream.m_NextLevel < 0))
+        {
+            m_MipmapStreams.erase(it++);
+        } else {
+            ++it;
+        }
+    }
+}
+
+BitmapPtr GLContextManager::estimateCoarsestMipmap(BitmapPtr pBmp)
+{
+    // Filters a sparse sample of at most 16x16 pixels down to one pixel.
+    IntPoint size = pBmp->getSize();
+    IntPoint step(max(size.x/16, 1), max(size.y/16, 1));
+    IntPoint sampleSize(size.x/step.x, size.y/step.y);
+    BitmapPtr pSampleBmp(new Bitmap(sampleSize, pBmp->getPixelFormat()));
+    int bpp = pBmp->getBytesPerPixel();
+    for (int y = 0; y < sampleSize.y; ++y) {
+        const unsigned char* pSrc = pBmp->getPixels() + y*step.y*pBmp->getStride();
+        unsigned char* pDest = pSampleBmp->getPixels() + y*pSampleBmp->getStride();
+        for (int x = 0; x < sampleSize.x; ++x) {
+            memcpy(pDest+x*bpp, pSrc+x*step.x*bpp, bpp);
+        }
+    }
+    FilterMipmapLevel filter;
+    while (pSampleBmp->getSize() != IntPoint(1,1)) {
+        pSampleBmp = filter.apply(pSampleBmp);
+    }
+    return pSampleBmp;
+}
+
+void GLContextManager::stopMipmapThreads()
+{
+    // All threads share one queue, so each thread picks up exactly one stop command.
+    for (unsigned i = 0; i < m_pMipmapThreads.size(); ++i) {
+        m_pMipmapCmdQueue->pushCmd(boost::bind(&MipmapThread::stop, _1));
+    }
+    for (unsigned i = 0; i < m_pMipmapThreads.size(); ++i) {
+        m_pMipmapThreads[i]->join();
+        delete m_pMipmapThreads[i];
+    }
+    m_pMipmapThreads.clear();
+    m_pMipmapCmdQueue = MipmapThread::CQueuePtr();
+    m_pMipmapResultQueue = MipmapResultQueuePtr();
+
+    m_MipmapStreams.clear();
+    m_MipmapLevelUploads.clear();
 }
 
 bool GLContextManager::isGLESSupported()
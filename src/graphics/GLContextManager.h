@@ -26,6 +26,13 @@
 #include "PixelFormat.h"
 #include "GLContext.h"
 #include "MCShaderParam.h"
+#include "MipmapThread.h"
+
+#include "../base/Rect.h"
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/weak_ptr.hpp>
 
 #include <map>
 
@@ -53,18 +60,23 @@ public:
     GLContextManager();
     virtual ~GLContextManager();
 
+    // If pSharedContext is set, the new context shares GL objects with it where the
+    // platform supports this. For SDL windows, SDL must have created the context with
+    // sharing enabled.
     GLContext* createContext(const GLConfig& glConfig, 
-            const IntPoint& windowSize=IntPoint(0,0), const SDL_SysWMinfo* pSDLWMInfo=0);
+            const IntPoint& windowSize=IntPoint(0,0), const SDL_SysWMinfo* pSDLWMInfo=0,
+            GLContext* pSharedContext=0);
     void registerContext(GLContext* pContext);
     void unregisterContext(GLContext* pContext);
     int getContextIndex(GLContext* pContext);
+    int getNumShareGroups() const;
 
     MCTexturePtr createTexture(const IntPoint& size, PixelFormat pf, bool bMipmap=false,
             bool bForcePOT=false, int potBorderColor=0);
     MCFBOPtr createFBO(const IntPoint& size, PixelFormat pf, unsigned numTextures=1, 
             unsigned multisampleSamples=1, bool bUsePackedDepthStencil=false,
             bool bUseStencil=false, bool bMipmap=false);
-    void createShader(const std::string& sID);
+    void createShader(const std::string& sID, const std::string& sVertID="standard");
     template<class VAL_TYPE>
     boost::shared_ptr<MCShaderParamTemplate<VAL_TYPE> > createShaderParam(
             const std::string& sShaderName, const std::string& sParamName)
@@ -76,34 +88,101 @@ public:
     }
 
     void scheduleTexUpload(MCTexturePtr pTex, BitmapPtr pBmp);
+    // Uploads only the part of pBmp inside dirtyRect. Multiple rects scheduled for the
+    // same texture before the next upload are coalesced.
+    void scheduleTexUpload(MCTexturePtr pTex, BitmapPtr pBmp, const IntRect& dirtyRect);
     MCTexturePtr createTextureFromBmp(BitmapPtr pBmp, bool bMipmap=false, 
             bool bForcePOT=false, int potBorderColor=0);
     void deleteTexture(unsigned texID);
 
+    // With mipmap threads, full uploads of mipmapped textures calculate the mipmap
+    // levels in worker threads. The levels are uploaded coarse to fine over the 
+    // following frames, limited by the upload budget (in bytes per frame, 0 means 
+    // unlimited).
+    void setMipmapThreads(int numThreads);
+    int getMipmapThreads() const;
+    void setMipmapUploadBudget(int numBytes);
+    int getNumPendingMipmaps() const;
+
     VertexArrayPtr createVertexArray(int reserveVerts = 0, int reserveIndexes = 0);
     typedef std::map<const GLContext*, unsigned> BufferIDMap;
     void deleteBuffers(BufferIDMap& bufferIDs);
 
     void uploadData();
     void uploadDataForContext();
+    // Changes to shared objects are only guaranteed to be visible in contexts used by
+    // other threads once they are complete. fenceSharedChanges() is called in the
+    // context that made the changes, waitForSharedChanges() in each of the others
+    // before they use the objects.
+    void fenceSharedChanges();
+    void waitForSharedChanges();
     void reset();
 
     static bool isGLESSupported();
 
 private:
+    bool hasSharingContexts(GLContext* pContext) const;
+    void deleteSharedChangesFence();
+    void scheduleMipmapStream(MCTexturePtr pTex, BitmapPtr pBmp);
+    bool hasMipmapStream(const MCTexturePtr& pTex) const;
+    void cancelMipmapStream(const MCTexturePtr& pTex);
+    void planMipmapUploads();
+    static BitmapPtr estimateCoarsestMipmap(BitmapPtr pBmp);
+    void stopMipmapThreads();
+
     std::vector<GLContext*> m_pContexts;
+    void* m_pSharedChangesFence;
 
     std::vector<MCTexturePtr> m_pPendingTexCreates;
-    typedef std::map<MCTexturePtr, BitmapPtr> TexUploadMap;
+    struct TexUpload {
+        TexUpload();
+        void addDirtyRect(const IntRect& rect, const IntPoint& texSize);
+
+        BitmapPtr m_pBmp;
+        bool m_bIsFullUpload;
+        std::vector<IntRect> m_DirtyRects;
+    };
+    typedef std::map<MCTexturePtr, TexUpload> TexUploadMap;
     TexUploadMap m_pPendingTexUploads;
     std::vector<unsigned> m_PendingTexDeletes;
 
     std::vector<MCFBOPtr> m_pPendingFBOCreates;
     std::vector<MCShaderParamPtr> m_pPendingShaderParamCreates;
 
+    // Vertex arrays can be created and deleted by window render threads.
+    boost::mutex m_VAMutex;
     std::vector<VertexArrayPtr> m_pPendingVACreates;
     std::vector<BufferIDMap> m_PendingBufferDeletes;
 
+    std::vector<boost::thread*> m_pMipmapThreads;
+    MipmapThread::CQueuePtr m_pMipmapCmdQueue;
+    MipmapResultQueuePtr m_pMipmapResultQueue;
+    int m_MipmapUploadBudget;
+    unsigned m_NextMipmapJobID;
+    struct MipmapStream {
+        boost::weak_ptr<MCTexture> m_pTex;
+        // Level 0 is the uploaded bitmap, the others arrive from the mipmap threads.
+        std::vector<BitmapPtr> m_pLevels;
+        bool m_bCalculated;
+        // Next level to upload, starting with the coarsest. -1 if there is nothing
+        // to upload.
+        int m_NextLevel;
+        // Uploaded before the calculated levels are available.
+        BitmapPtr m_pCoarsestEstimate;
+        int m_CoarsestLevel;
+    };
+    // Keyed by job id, so older streams come first.
+    typedef std::map<unsigned, MipmapStream> MipmapStreamMap;
+    MipmapStreamMap m_MipmapStreams;
+    struct MipmapLevelUpload {
+        MCTexturePtr m_pTex;
+        BitmapPtr m_pBmp;
+        int m_Level;
+    };
+    // Levels uploaded to every share group in the current upload round.
+    std::vector<MipmapLevelUpload> m_MipmapLevelUploads;
+    bool m_bMipmapUploadsPlanned;
+
     static GLContextManager* s_pGLContextManager;
 };
 
@@ -30,11 +30,13 @@ using namespace std;
 
 namespace avg {
 GLShaderParam::GLShaderParam()
+    : m_pContext(0)
 {
 }
 
 GLShaderParam::GLShaderParam(OGLShader* pShader, const std::string& sName)
-    : m_sName(sName)
+    : m_sName(sName),
+      m_pContext(GLContext::getCurrent())
 {
     m_Location = glproc::GetUniformLocation(pShader->getProgram(), sName.c_str());
     string sErr = std::string("Shader param '") + sName + "' not found in shader '" + 
@@ -48,6 +50,13 @@ int GLShaderParam::getLocation() const
     return m_Location;
 }
 
+void GLShaderParam::countStateChange(bool bIssued) const
+{
+    if (m_pContext) {
+        m_pContext->countStateChange(bIssued);
+    }
+}
+
 const string& GLShaderParam::getName() const
 {
     return m_sName;
@@ -48,10 +48,12 @@ public:
 
 protected:
     int getLocation() const;
+    void countStateChange(bool bIssued) const;
 
 private:
     std::string m_sName;
     int m_Location;
+    GLContext* m_pContext;
 };
 
 
@@ -74,6 +76,9 @@ public:
             GLContext::checkError("OGLShaderParam::set");
             m_Val = val;
             m_bValSet = true;
+            countStateChange(true);
+        } else {
+            countStateChange(false);
         }
     };
 
@@ -25,6 +25,7 @@
 #include "../base/StringHelper.h"
 #include "../base/MathHelper.h"
 #include "../base/ObjectCounter.h"
+#include "../base/ThreadHelper.h"
 
 #include "GLContext.h"
 #include "GLContextManager.h"
@@ -67,6 +68,7 @@ GLTexture::~GLTexture()
     if (GLContextManager::isActive()) {
         GLContextManager::get()->deleteTexture(m_TexID);
     }
+    ObjectCounter::get()->decMemory(m_sMemCategory, getMemAllocated());
     ObjectCounter::get()->decRef(&typeid(*this));
 }
 
@@ -74,6 +76,8 @@ void GLTexture::init()
 {
     s_LastTexID++;
     m_TexID = s_LastTexID;
+    m_sMemCategory = m_pContext->getTextureMemCategory();
+    ObjectCounter::get()->incMemory(m_sMemCategory, getMemAllocated());
 
     m_pContext->bindTexture(GL_TEXTURE0, m_TexID);
 
@@ -109,9 +113,13 @@ void GLTexture::init()
 
 void GLTexture::activate(const WrapMode& wrapMode, int textureUnit)
 {
-    m_pContext->bindTexture(textureUnit, m_TexID);
+    // Textures in a share group are used by several contexts, so the state cache of 
+    // the context that is current right now needs to be updated.
+    GLContext* pContext = GLContext::getCurrent();
+    pContext->bindTexture(textureUnit, m_TexID);
+    lock_guard lock(m_WrapModeMutex);
     if (wrapMode.getS() != m_WrapMode.getS() || wrapMode.getT() != m_WrapMode.getT()) {
-        glproc::ActiveTexture(textureUnit);
+        pContext->setActiveTexture(textureUnit);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrapMode.getS());
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrapMode.getT());
         m_WrapMode = wrapMode;
@@ -121,7 +129,7 @@ void GLTexture::activate(const WrapMode& wrapMode, int textureUnit)
 void GLTexture::generateMipmaps()
 {
     if (getUseMipmap()) {
-        m_pContext->bindTexture(GL_TEXTURE0, m_TexID);
+        GLContext::getCurrent()->bindTexture(GL_TEXTURE0, m_TexID);
         glproc::GenerateMipmap(GL_TEXTURE_2D);
         GLContext::checkError("GLTexture::generateMipmap()");
     }
@@ -129,15 +137,41 @@ void GLTexture::generateMipmaps()
 
 void GLTexture::moveBmpToTexture(BitmapPtr pBmp)
 {
-    unsigned usage = GL_DYNAMIC_DRAW;
-    if (getPF() == A8 && m_pContext->isVendor("ATI")) {
-        // Workaround for https://github.com/libavg/libavg/issues/687
-        usage = GL_STATIC_DRAW;
-    }
-    TextureMoverPtr pMover = TextureMover::create(getSize(), getPF(), usage);
+    TextureMoverPtr pMover = TextureMover::create(getSize(), getPF(), getUploadUsage());
     pMover->moveBmpToTexture(pBmp, *this);
 }
 
+void GLTexture::moveBmpRectToTexture(BitmapPtr pBmp, const IntRect& rect)
+{
+    TextureMoverPtr pMover = TextureMover::create(getSize(), getPF(), getUploadUsage());
+    pMover->moveBmpRectToTexture(pBmp, rect, *this);
+}
+
+void GLTexture::moveBmpToMipmapLevel(BitmapPtr pBmp, int level)
+{
+    AVG_ASSERT(getUseMipmap());
+    AVG_ASSERT(pBmp->getSize() == getMipmapSize(level));
+    AVG_ASSERT(pBmp->getPixelFormat() == getPF());
+    PixelFormat pf = getPF();
+    IntPoint size = pBmp->getSize();
+    if (pBmp->getStride() != Bitmap::getPreferredStride(size.x, pf)) {
+        BitmapPtr pTmpBmp(new Bitmap(size, pf));
+        pTmpBmp->copyPixels(*pBmp);
+        pBmp = pTmpBmp;
+    }
+    GLContext::getCurrent()->bindTexture(GL_TEXTURE0, m_TexID);
+    glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, size.x, size.y, getGLFormat(pf), 
+            getGLType(pf), pBmp->getPixels());
+    GLContext::checkError("GLTexture::moveBmpToMipmapLevel: glTexSubImage2D()");
+}
+
+void GLTexture::setMipmapBaseLevel(int level)
+{
+    GLContext::getCurrent()->bindTexture(GL_TEXTURE0, m_TexID);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+    GLContext::checkError("GLTexture::setMipmapBaseLevel()");
+}
+
 BitmapPtr GLTexture::moveTextureToBmp(int mipmapLevel)
 {
     TextureMoverPtr pMover = TextureMover::create(getGLSize(), getPF(), GL_DYNAMIC_READ);
@@ -149,4 +183,24 @@ unsigned GLTexture::getID() const
     return m_TexID;
 }
 
+long long GLTexture::getMemAllocated() const
+{
+    long long memNeeded = getMemNeeded();
+    if (getUseMipmap()) {
+        // The mipmap levels add up to a third of the base level.
+        memNeeded += memNeeded/3;
+    }
+    return memNeeded;
+}
+
+unsigned GLTexture::getUploadUsage() const
+{
+    if (getPF() == A8 && m_pContext->isVendor("ATI")) {
+        // Workaround for https://github.com/libavg/libavg/issues/687
+        return GL_STATIC_DRAW;
+    } else {
+        return GL_DYNAMIC_DRAW;
+    }
+}
+
 }
@@ -28,6 +28,7 @@
 #include "OGLHelper.h"
 
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 
 namespace avg {
 
@@ -48,14 +49,26 @@ public:
     void generateMipmaps();
 
     void moveBmpToTexture(BitmapPtr pBmp);
+    void moveBmpRectToTexture(BitmapPtr pBmp, const IntRect& rect);
+    // Uploads a single, precalculated mipmap level. No mipmaps are generated.
+    void moveBmpToMipmapLevel(BitmapPtr pBmp, int level);
+    // Restricts sampling to levels >= level, e.g. while finer levels are still missing.
+    void setMipmapBaseLevel(int level);
     BitmapPtr moveTextureToBmp(int mipmapLevel=0);
 
     unsigned getID() const;
 
 private:
+    unsigned getUploadUsage() const;
+    long long getMemAllocated() const;
+
     GLContext* m_pContext;
+    std::string m_sMemCategory;
 
+    // Wrap mode is texture object state, which is shared by all contexts in a share
+    // group and can be changed from several render threads.
     WrapMode m_WrapMode;
+    boost::mutex m_WrapModeMutex;
     static unsigned s_LastTexID;
     unsigned m_TexID;
 };
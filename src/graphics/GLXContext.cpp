@@ -43,7 +43,7 @@ static bool s_bDumpX11ErrorMsg;
 static int (*s_DefaultErrorHandler) (::Display *, XErrorEvent *);
 
 GLXContext::GLXContext(const GLConfig& glConfig, const IntPoint& windowSize, 
-        const SDL_SysWMinfo* pSDLWMInfo)
+        const SDL_SysWMinfo* pSDLWMInfo, GLXContext* pSharedContext)
     : GLContext(windowSize),
       m_pDisplay(0),
       m_bOwnsDisplay(false),
@@ -54,12 +54,13 @@ GLXContext::GLXContext(const GLConfig& glConfig, const IntPoint& windowSize,
 {
     s_bX11Error = false;
     GLConfig config = glConfig;
-    createGLXContext(config, windowSize, pSDLWMInfo);
+    createGLXContext(config, windowSize, pSDLWMInfo, pSharedContext);
     init(config, pSDLWMInfo == 0);
 }
 
 GLXContext::GLXContext(const GLConfig& glConfig, const string& sDisplay,
-            const IntRect& windowDimensions, bool bHasWindowFrame)
+            const IntRect& windowDimensions, bool bHasWindowFrame,
+            GLXContext* pSharedContext)
     : GLContext(windowDimensions.size()),
       m_pDisplay(0),
       m_bOwnsDisplay(true),
@@ -70,7 +71,8 @@ GLXContext::GLXContext(const GLConfig& glConfig, const string& sDisplay,
 {
     s_bX11Error = false;
     GLConfig config = glConfig;
-    createContextAndWindow(config, sDisplay, windowDimensions, bHasWindowFrame);
+    createContextAndWindow(config, sDisplay, windowDimensions, bHasWindowFrame,
+            pSharedContext);
     init(config, 0);
 }
 
@@ -94,6 +96,12 @@ void GLXContext::activate()
     setCurrent();
 }
 
+void GLXContext::deactivate()
+{
+    glXMakeCurrent(m_pDisplay, None, 0);
+    clearCurrent();
+}
+
 bool GLXContext::useDepthBuffer() const
 {
     // NVidia GLX GLES doesn't allow framebuffer stencil without depth.
@@ -129,16 +137,21 @@ bool GLXContext::isGLESSupported()
 }
 
 void GLXContext::createGLXContext(GLConfig& glConfig, const IntPoint& windowSize,
-        const SDL_SysWMinfo* pSDLWMInfo)
+        const SDL_SysWMinfo* pSDLWMInfo, GLXContext* pSharedContext)
 {
     if (pSDLWMInfo) {
         m_Context = glXGetCurrentContext();
         m_pDisplay = pSDLWMInfo->info.x11.display;
         m_bOwnsDisplay = false;
         setCurrent();
+        if (pSharedContext) {
+            // SDL has already created the context with sharing enabled.
+            setShareGroup(pSharedContext);
+        }
     } else { 
         setX11ErrorHandler();
-        XVisualInfo* pVisualInfo = createDetachedContext(getX11Display(), glConfig);
+        XVisualInfo* pVisualInfo = createDetachedContext(getX11Display(), glConfig,
+                pSharedContext);
         m_bOwnsDisplay = true;
 
         Pixmap pmp = XCreatePixmap(getDisplay(), 
@@ -153,7 +166,8 @@ void GLXContext::createGLXContext(GLConfig& glConfig, const IntPoint& windowSize
     m_Drawable = glXGetCurrentDrawable();
 }
 void GLXContext::createContextAndWindow(GLConfig& glConfig, const string& sDisplay,
-        const IntRect& windowDimensions, bool bHasWindowFrame)
+        const IntRect& windowDimensions, bool bHasWindowFrame, 
+        GLXContext* pSharedContext)
 {
     setX11ErrorHandler();
 
@@ -164,7 +178,8 @@ void GLXContext::createContextAndWindow(GLConfig& glConfig, const string& sDispl
         throw Exception(AVG_ERR_OUT_OF_RANGE,
                 "Display '" + sDisplay + "' is not available.");
     }
-    XVisualInfo* pVisualInfo = createDetachedContext(pDisplay, glConfig);
+    XVisualInfo* pVisualInfo = createDetachedContext(pDisplay, glConfig, 
+            pSharedContext);
 
     XSetWindowAttributes swa;
     swa.event_mask = ButtonPressMask;
@@ -195,12 +210,41 @@ void GLXContext::createContextAndWindow(GLConfig& glConfig, const string& sDispl
     m_Drawable = glXGetCurrentDrawable();
 }
 
-XVisualInfo* GLXContext::createDetachedContext(::Display* pDisplay, GLConfig& glConfig)
+XVisualInfo* GLXContext::createDetachedContext(::Display* pDisplay, GLConfig& glConfig,
+        GLXContext* pSharedContext)
 {
     m_pDisplay = pDisplay;
     GLXFBConfig fbConfig = getFBConfig(glConfig);
     XVisualInfo* pVisualInfo = glXGetVisualFromFBConfig(m_pDisplay, fbConfig);
 
+    if (pSharedContext) {
+        // Sharing fails e.g. if the contexts are on different screens.
+        m_Context = createContextHandle(fbConfig, pVisualInfo, glConfig, 
+                pSharedContext->m_Context);
+        if (m_Context) {
+            setShareGroup(pSharedContext);
+        } else {
+            AVG_LOG_WARNING("Creating shared OpenGL context failed. Textures will be "
+                    "uploaded separately for each window.");
+            s_bX11Error = false;
+        }
+    }
+    if (!m_Context) {
+        m_Context = createContextHandle(fbConfig, pVisualInfo, glConfig, 0);
+    }
+    AVG_ASSERT(m_Context);
+    
+    m_Colormap = XCreateColormap(pDisplay, RootWindow(m_pDisplay, pVisualInfo->screen),
+            pVisualInfo->visual, AllocNone);
+    AVG_ASSERT(m_Colormap);
+
+    return pVisualInfo;
+}
+
+::GLXContext GLXContext::createContextHandle(GLXFBConfig fbConfig, 
+        XVisualInfo* pVisualInfo, GLConfig& glConfig, ::GLXContext shareContext)
+{
+    ::GLXContext context;
     if (haveARBCreateContext()) {
         GLContextAttribs attrs;
         GLContextAttribs attrsWODebug;
@@ -218,27 +262,34 @@ XVisualInfo* GLXContext::createDetachedContext(::Display* pDisplay, GLConfig& gl
             getglXProcAddress("glXCreateContextAttribsARB");
 
         s_bDumpX11ErrorMsg = false;
-        m_Context = CreateContextAttribsARB(m_pDisplay, fbConfig, 0, 1, attrs.get());
+        context = CreateContextAttribsARB(m_pDisplay, fbConfig, shareContext, 1, 
+                attrs.get());
         s_bDumpX11ErrorMsg = true;
-        if(!m_Context && glConfig.m_bUseDebugContext) {
+        if(!context && glConfig.m_bUseDebugContext) {
             //On intel HW ContextCreation with DebugBit fails
             AVG_LOG_WARNING(
                     "Failed to create DEBUG context… falling back to standard context");
             s_bX11Error = false;
-            m_Context = CreateContextAttribsARB(m_pDisplay, fbConfig, 0, 1, 
+            context = CreateContextAttribsARB(m_pDisplay, fbConfig, shareContext, 1, 
                     attrsWODebug.get());
-            AVG_ASSERT(m_Context);
+            if (!shareContext) {
+                AVG_ASSERT(context);
+            }
         }
     } else {
-        m_Context = glXCreateContext(m_pDisplay, pVisualInfo, 0, GL_TRUE);
+        context = glXCreateContext(m_pDisplay, pVisualInfo, shareContext, GL_TRUE);
     }
-    AVG_ASSERT(m_Context);
-    
-    m_Colormap = XCreateColormap(pDisplay, RootWindow(m_pDisplay, pVisualInfo->screen),
-            pVisualInfo->visual, AllocNone);
-    AVG_ASSERT(m_Colormap);
-
-    return pVisualInfo;
+    if (shareContext) {
+        // X errors arrive asynchronously.
+        s_bDumpX11ErrorMsg = false;
+        XSync(m_pDisplay, False);
+        s_bDumpX11ErrorMsg = true;
+        if (s_bX11Error && context) {
+            glXDestroyContext(m_pDisplay, context);
+            context = 0;
+        }
+    }
+    return context;
 }
 
 void GLXContext::setX11ErrorHandler()
@@ -39,12 +39,16 @@ class AVG_API GLXContext: public GLContext
 {
 public:
     GLXContext(const GLConfig& glConfig, const IntPoint& windowSize=IntPoint(0,0), 
-            const SDL_SysWMinfo* pSDLWMInfo=0);
+            const SDL_SysWMinfo* pSDLWMInfo=0, GLXContext* pSharedContext=0);
+    // Creates a context with its own window. If pSharedContext is given, the context
+    // shares GL objects with it if the driver allows it.
     GLXContext(const GLConfig& glConfig, const std::string& sDisplay,
-            const IntRect& windowDimensions, bool bHasWindowFrame);
+            const IntRect& windowDimensions, bool bHasWindowFrame,
+            GLXContext* pSharedContext=0);
     virtual ~GLXContext();
 
     void activate();
+    void deactivate();
     bool useDepthBuffer() const;
     void swapBuffers();
 
@@ -53,10 +57,14 @@ public:
 
 private:
     void createGLXContext(GLConfig& glConfig, const IntPoint& windowSize, 
-            const SDL_SysWMinfo* pSDLWMInfo);
+            const SDL_SysWMinfo* pSDLWMInfo, GLXContext* pSharedContext);
     void createContextAndWindow(GLConfig& glConfig, const std::string& sDisplay,
-        const IntRect& windowDimensions, bool bHasWindowFrame);
-    XVisualInfo* createDetachedContext(::Display* pDisplay, GLConfig& glConfig);
+        const IntRect& windowDimensions, bool bHasWindowFrame, 
+        GLXContext* pSharedContext);
+    XVisualInfo* createDetachedContext(::Display* pDisplay, GLConfig& glConfig,
+            GLXContext* pSharedContext=0);
+    ::GLXContext createContextHandle(GLXFBConfig fbConfig, XVisualInfo* pVisualInfo,
+            GLConfig& glConfig, ::GLXContext shareContext);
     void setX11ErrorHandler();
     void resetX11ErrorHandler();
     void throwOnXError(int code=AVG_ERR_VIDEO_GENERAL);
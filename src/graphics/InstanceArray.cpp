@@ -0,0 +1,239 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "InstanceArray.h"
+
+#include "GLContext.h"
+#include "GLContextManager.h"
+#include "VertexArray.h"
+#include "SubVertexArray.h"
+
+#include "../base/Exception.h"
+#include "../base/OSHelper.h"
+#include "../base/ThreadHelper.h"
+
+#include <stddef.h>
+
+using namespace std;
+
+namespace avg {
+
+const unsigned InstanceArray::INSTANCE_POS_INDEX = 3;
+const unsigned InstanceArray::INSTANCE_SIZE_INDEX = 4;
+const unsigned InstanceArray::INSTANCE_ANGLE_INDEX = 5;
+const unsigned InstanceArray::INSTANCE_COLOR_INDEX = 6;
+
+namespace {
+    // Without instancing, every instance becomes four vertexes carrying the instance
+    // data. Indexes must fit GL_INDEX_TYPE, so large arrays are drawn in batches.
+    struct ExpandedVertex {
+        GLfloat m_Corner[2];
+        InstanceData m_Instance;
+    };
+    const int MAX_QUADS_PER_DRAW = 16384;
+    const GLfloat CORNERS[4][2] = {{0,0}, {1,0}, {1,1}, {0,1}};
+}
+
+InstanceArray::InstanceArray()
+    : m_Version(1)
+{
+    // AVG_DISABLE_INSTANCING forces the expanded fallback, e.g. for testing.
+    string sDummy;
+    m_bUseInstancing = GLContext::getCurrent()->isInstancingSupported() &&
+            !getEnv("AVG_DISABLE_INSTANCING", sDummy);
+}
+
+InstanceArray::~InstanceArray()
+{
+    GLContextManager::BufferIDMap vertexBufferIDs;
+    GLContextManager::BufferIDMap indexBufferIDs;
+    ContextBufferMap::iterator it;
+    for (it=m_ContextBuffers.begin(); it!=m_ContextBuffers.end(); ++it) {
+        vertexBufferIDs[it->first] = it->second.m_VertexBufferID;
+        if (it->second.m_IndexBufferID != 0) {
+            indexBufferIDs[it->first] = it->second.m_IndexBufferID;
+        }
+    }
+    GLContextManager::get()->deleteBuffers(vertexBufferIDs);
+    GLContextManager::get()->deleteBuffers(indexBufferIDs);
+}
+
+void InstanceArray::setInstances(const vector<InstanceData>& instances)
+{
+    m_Instances = instances;
+    m_Version++;
+}
+
+int InstanceArray::getNumInstances() const
+{
+    return int(m_Instances.size());
+}
+
+bool InstanceArray::usesInstancing() const
+{
+    return m_bUseInstancing;
+}
+
+void InstanceArray::draw(GLContext* pContext, const VertexArrayPtr& pVA, 
+        SubVertexArray& quad)
+{
+    if (m_Instances.empty()) {
+        return;
+    }
+    ContextBuffers& buffers = getContextBuffers(pContext);
+    if (buffers.m_UploadedVersion != m_Version) {
+        upload(buffers);
+    }
+    if (m_bUseInstancing) {
+        // The quad comes from the canvas vertex array, which stays bound.
+        glproc::BindBuffer(GL_ARRAY_BUFFER, buffers.m_VertexBufferID);
+        activateInstanceAttribs(0, sizeof(InstanceData), 1);
+        quad.drawInstanced(getNumInstances());
+        deactivateInstanceAttribs();
+    } else {
+        drawExpanded(pContext, buffers);
+        pVA->activate(pContext);
+    }
+    GLContext::checkError("InstanceArray::draw()");
+}
+
+InstanceArray::ContextBuffers::ContextBuffers()
+    : m_VertexBufferID(0),
+      m_IndexBufferID(0),
+      m_NumIndexedQuads(0),
+      m_UploadedVersion(0)
+{
+}
+
+InstanceArray::ContextBuffers& InstanceArray::getContextBuffers(GLContext* pContext)
+{
+    // Windows can be rendered in parallel threads.
+    lock_guard lock(m_Mutex);
+    ContextBufferMap::iterator it = m_ContextBuffers.find(pContext);
+    if (it == m_ContextBuffers.end()) {
+        ContextBuffers& buffers = m_ContextBuffers[pContext];
+        glproc::GenBuffers(1, &buffers.m_VertexBufferID);
+        if (!m_bUseInstancing) {
+            glproc::GenBuffers(1, &buffers.m_IndexBufferID);
+        }
+        return buffers;
+    } else {
+        return it->second;
+    }
+}
+
+void InstanceArray::upload(ContextBuffers& buffers)
+{
+    glproc::BindBuffer(GL_ARRAY_BUFFER, buffers.m_VertexBufferID);
+    if (m_bUseInstancing) {
+        glproc::BufferData(GL_ARRAY_BUFFER, m_Instances.size()*sizeof(InstanceData),
+                &(m_Instances[0]), GL_DYNAMIC_DRAW);
+    } else {
+        vector<ExpandedVertex> vertexes(m_Instances.size()*4);
+        for (unsigned i=0; i<m_Instances.size(); ++i) {
+            for (unsigned j=0; j<4; ++j) {
+                ExpandedVertex& vertex = vertexes[i*4+j];
+                vertex.m_Corner[0] = CORNERS[j][0];
+                vertex.m_Corner[1] = CORNERS[j][1];
+                vertex.m_Instance = m_Instances[i];
+            }
+        }
+        glproc::BufferData(GL_ARRAY_BUFFER, vertexes.size()*sizeof(ExpandedVertex),
+                &(vertexes[0]), GL_DYNAMIC_DRAW);
+
+        // The index pattern is the same for every batch.
+        int numQuads = min(getNumInstances(), MAX_QUADS_PER_DRAW);
+        if (buffers.m_NumIndexedQuads < numQuads) {
+            vector<GL_INDEX_TYPE> indexes(numQuads*6);
+            for (int i=0; i<numQuads; ++i) {
+                GL_INDEX_TYPE base = (GL_INDEX_TYPE)(i*4);
+                indexes[i*6] = base;
+                indexes[i*6+1] = base+1;
+                indexes[i*6+2] = base+2;
+                indexes[i*6+3] = base;
+                indexes[i*6+4] = base+2;
+                indexes[i*6+5] = base+3;
+            }
+            glproc::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers.m_IndexBufferID);
+            glproc::BufferData(GL_ELEMENT_ARRAY_BUFFER, 
+                    indexes.size()*sizeof(GL_INDEX_TYPE), &(indexes[0]), 
+                    GL_STATIC_DRAW);
+            buffers.m_NumIndexedQuads = numQuads;
+        }
+    }
+    buffers.m_UploadedVersion = m_Version;
+    GLContext::checkError("InstanceArray::upload()");
+}
+
+void InstanceArray::activateInstanceAttribs(size_t offset, GLsizei stride, 
+        unsigned divisor)
+{
+    glproc::VertexAttribPointer(INSTANCE_POS_INDEX, 2, GL_FLOAT, GL_FALSE, stride, 
+            (void *)(offset+offsetof(InstanceData, m_Pos)));
+    glproc::VertexAttribPointer(INSTANCE_SIZE_INDEX, 2, GL_FLOAT, GL_FALSE, stride, 
+            (void *)(offset+offsetof(InstanceData, m_Size)));
+    glproc::VertexAttribPointer(INSTANCE_ANGLE_INDEX, 1, GL_FLOAT, GL_FALSE, stride, 
+            (void *)(offset+offsetof(InstanceData, m_Angle)));
+    glproc::VertexAttribPointer(INSTANCE_COLOR_INDEX, 4, GL_UNSIGNED_BYTE, GL_TRUE, 
+            stride, (void *)(offset+offsetof(InstanceData, m_Color)));
+    for (unsigned i=INSTANCE_POS_INDEX; i<=INSTANCE_COLOR_INDEX; ++i) {
+        glproc::EnableVertexAttribArray(i);
+        if (m_bUseInstancing) {
+            glproc::VertexAttribDivisor(i, divisor);
+        }
+    }
+}
+
+void InstanceArray::deactivateInstanceAttribs()
+{
+    for (unsigned i=INSTANCE_POS_INDEX; i<=INSTANCE_COLOR_INDEX; ++i) {
+        if (m_bUseInstancing) {
+            glproc::VertexAttribDivisor(i, 0);
+        }
+        glproc::DisableVertexAttribArray(i);
+    }
+}
+
+void InstanceArray::drawExpanded(GLContext* pContext, ContextBuffers& buffers)
+{
+    glproc::BindBuffer(GL_ARRAY_BUFFER, buffers.m_VertexBufferID);
+    glproc::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers.m_IndexBufferID);
+    for (int start=0; start<getNumInstances(); start+=MAX_QUADS_PER_DRAW) {
+        int numQuads = min(getNumInstances()-start, MAX_QUADS_PER_DRAW);
+        size_t offset = start*4*sizeof(ExpandedVertex);
+        glproc::VertexAttribPointer(VertexArray::POS_INDEX, 2, GL_FLOAT, GL_FALSE,
+                sizeof(ExpandedVertex), 
+                (void *)(offset+offsetof(ExpandedVertex, m_Corner)));
+        glproc::VertexAttribPointer(VertexArray::TEX_INDEX, 2, GL_FLOAT, GL_FALSE,
+                sizeof(ExpandedVertex), 
+                (void *)(offset+offsetof(ExpandedVertex, m_Corner)));
+        activateInstanceAttribs(offset+offsetof(ExpandedVertex, m_Instance), 
+                sizeof(ExpandedVertex), 0);
+#ifdef AVG_ENABLE_EGL        
+        glDrawElements(GL_TRIANGLES, numQuads*6, GL_UNSIGNED_SHORT, 0);
+#else
+        glDrawElements(GL_TRIANGLES, numQuads*6, GL_UNSIGNED_INT, 0);
+#endif
+    }
+    deactivateInstanceAttribs();
+}
+
+}
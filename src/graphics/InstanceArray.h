@@ -0,0 +1,98 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _InstanceArray_H_
+#define _InstanceArray_H_
+
+#include "../api.h"
+#include "OGLHelper.h"
+#include "Pixel32.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <map>
+#include <vector>
+
+namespace avg {
+
+class GLContext;
+class SubVertexArray;
+class VertexArray;
+typedef boost::shared_ptr<VertexArray> VertexArrayPtr;
+
+struct InstanceData {
+    GLfloat m_Pos[2];
+    GLfloat m_Size[2];
+    GLfloat m_Angle;
+    Pixel32 m_Color;
+};
+
+// Per-instance attributes for drawing many copies of a unit quad in one call. Uses 
+// hardware instancing if the context supports it and expands the quads into a 
+// vertex buffer otherwise.
+class AVG_API InstanceArray {
+public:
+    static const unsigned INSTANCE_POS_INDEX;
+    static const unsigned INSTANCE_SIZE_INDEX;
+    static const unsigned INSTANCE_ANGLE_INDEX;
+    static const unsigned INSTANCE_COLOR_INDEX;
+
+    InstanceArray();
+    virtual ~InstanceArray();
+
+    void setInstances(const std::vector<InstanceData>& instances);
+    int getNumInstances() const;
+    bool usesInstancing() const;
+
+    // pQuad must be a unit quad in pVA, and pVA must be active. It is active again
+    // when the call returns.
+    void draw(GLContext* pContext, const VertexArrayPtr& pVA, SubVertexArray& quad);
+
+private:
+    struct ContextBuffers {
+        ContextBuffers();
+
+        unsigned m_VertexBufferID;
+        unsigned m_IndexBufferID;
+        int m_NumIndexedQuads;
+        unsigned m_UploadedVersion;
+    };
+    ContextBuffers& getContextBuffers(GLContext* pContext);
+    void upload(ContextBuffers& buffers);
+    void activateInstanceAttribs(size_t offset, GLsizei stride, unsigned divisor);
+    void deactivateInstanceAttribs();
+    void drawExpanded(GLContext* pContext, ContextBuffers& buffers);
+
+    std::vector<InstanceData> m_Instances;
+    unsigned m_Version;
+    bool m_bUseInstancing;
+
+    typedef std::map<const GLContext*, ContextBuffers> ContextBufferMap;
+    ContextBufferMap m_ContextBuffers;
+    boost::mutex m_Mutex;
+};
+
+typedef boost::shared_ptr<InstanceArray> InstanceArrayPtr;
+
+}
+
+#endif
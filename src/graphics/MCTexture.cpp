@@ -31,6 +31,7 @@
 #include "GLTexture.h"
 #include "TextureMover.h"
 #include "FBO.h"
+#include "FilterMipmapLevel.h"
 
 #include <string.h>
 #include <iostream>
@@ -40,8 +41,9 @@ namespace avg {
 using namespace std;
 
 MCTexture::MCTexture(const IntPoint& size, PixelFormat pf, bool bMipmap, bool bForcePOT,
-        int potBorderColor)
+        int potBorderColor, bool bShared)
     : TexInfo(size, pf, bMipmap, usePOT(bForcePOT, bMipmap), potBorderColor),
+      m_bShared(bShared),
       m_bIsDirty(true)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
@@ -54,9 +56,9 @@ MCTexture::~MCTexture()
 
 void MCTexture::initForGLContext(GLContext* pContext)
 {
-    AVG_ASSERT(m_pTextures.count(pContext) == 0);
+    AVG_ASSERT(m_pTextures.count(getMapKey(pContext)) == 0);
     
-    m_pTextures[pContext] = GLTexturePtr(new GLTexture(pContext, *this));
+    m_pTextures[getMapKey(pContext)] = GLTexturePtr(new GLTexture(pContext, *this));
 }
 
 void MCTexture::moveBmpToTexture(GLContext* pContext, BitmapPtr pBmp)
@@ -65,6 +67,30 @@ void MCTexture::moveBmpToTexture(GLContext* pContext, BitmapPtr pBmp)
     m_bIsDirty = true;
 }
 
+void MCTexture::moveBmpRectToTexture(GLContext* pContext, BitmapPtr pBmp, 
+        const IntRect& rect)
+{
+    getTex(pContext)->moveBmpRectToTexture(pBmp, rect);
+    m_bIsDirty = true;
+}
+
+void MCTexture::moveBmpToMipmapLevel(GLContext* pContext, BitmapPtr pBmp, int level)
+{
+    getTex(pContext)->moveBmpToMipmapLevel(pBmp, level);
+    m_bIsDirty = true;
+}
+
+void MCTexture::setMipmapBaseLevel(GLContext* pContext, int level)
+{
+    getTex(pContext)->setMipmapBaseLevel(level);
+}
+
+bool MCTexture::canStreamMipmaps() const
+{
+    // The levels of POT textures include the border.
+    return getUseMipmap() && !getUsePOT() && FilterMipmapLevel::isSupported(getPF());
+}
+
 void MCTexture::setDirty()
 {
     m_bIsDirty = true;
@@ -82,9 +108,23 @@ void MCTexture::resetDirty()
 
 const GLTexturePtr& MCTexture::getTex(GLContext* pContext) const
 {
-    TexMap::const_iterator it = m_pTextures.find(pContext);
+    TexMap::const_iterator it = m_pTextures.find(getMapKey(pContext));
     return it->second;
 }
 
+bool MCTexture::isShared() const
+{
+    return m_bShared;
+}
+
+GLContext* MCTexture::getMapKey(GLContext* pContext) const
+{
+    if (m_bShared) {
+        return pContext->getShareGroup();
+    } else {
+        return pContext;
+    }
+}
+
 }
 
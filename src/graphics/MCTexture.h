@@ -26,6 +26,8 @@
 #include "TexInfo.h"
 #include "OGLHelper.h"
 
+#include "../base/Rect.h"
+
 #include <boost/shared_ptr.hpp>
 #ifdef _WIN32 
 #include <unordered_map>
@@ -46,27 +48,39 @@ typedef boost::shared_ptr<Bitmap> BitmapPtr;
 class AVG_API MCTexture: public TexInfo {
 
 public:
+    // Shared textures exist once per GL share group instead of once per context. 
+    // Textures that are rendered to (e.g. FBO attachments) can't be shared.
     MCTexture(const IntPoint& size, PixelFormat pf, bool bMipmap=false,
-            bool bForcePOT=false, int potBorderColor=0);
+            bool bForcePOT=false, int potBorderColor=0, bool bShared=false);
     virtual ~MCTexture();
 
     void initForGLContext(GLContext* pContext);
 
     void moveBmpToTexture(GLContext* pContext, BitmapPtr pBmp);
+    void moveBmpRectToTexture(GLContext* pContext, BitmapPtr pBmp, const IntRect& rect);
+    void moveBmpToMipmapLevel(GLContext* pContext, BitmapPtr pBmp, int level);
+    void setMipmapBaseLevel(GLContext* pContext, int level);
+
+    // True if precalculated mipmap levels can be uploaded one at a time. 
+    bool canStreamMipmaps() const;
 
     const GLTexturePtr& getTex(GLContext* pContext) const;
+    bool isShared() const;
 
     void setDirty();
     bool isDirty() const;
     void resetDirty();
 
 private:
+    GLContext* getMapKey(GLContext* pContext) const;
+
 #ifdef __APPLE__
     typedef boost::unordered_map<GLContext*, GLTexturePtr> TexMap;
 #else
     typedef std::tr1::unordered_map<GLContext*, GLTexturePtr> TexMap;
 #endif
     TexMap m_pTextures;
+    bool m_bShared;
 
     bool m_bIsDirty;
 };
@@ -0,0 +1,71 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "MipmapThread.h"
+
+#include "Bitmap.h"
+#include "FilterMipmapLevel.h"
+
+#include "../base/ScopeTimer.h"
+
+using namespace std;
+
+namespace avg {
+
+MipmapResult::MipmapResult(unsigned jobID)
+    : m_JobID(jobID)
+{
+}
+
+MipmapThread::MipmapThread(CQueue& cmdQ, MipmapResultQueue& resultQ)
+    : WorkerThread<MipmapThread>("Mipmap", cmdQ),
+      m_ResultQ(resultQ)
+{
+}
+
+MipmapThread::~MipmapThread()
+{
+}
+
+static ProfilingZoneID GenerateMipmapsProfilingZone("MipmapThread: generate mipmaps", 
+        true);
+
+void MipmapThread::generateMipmaps(unsigned jobID, BitmapPtr pBmp)
+{
+    ScopeTimer timer(GenerateMipmapsProfilingZone);
+    MipmapResultQueue::QElementPtr pResult(new MipmapResult(jobID));
+    FilterMipmapLevel filter;
+    while (pBmp->getSize() != IntPoint(1,1)) {
+        pBmp = filter.apply(pBmp);
+        pResult->m_pLevels.push_back(pBmp);
+    }
+    m_ResultQ.push(pResult);
+    ThreadProfiler::get()->reset();
+}
+
+bool MipmapThread::work()
+{
+    waitForCommand();
+    return true;
+}
+
+}
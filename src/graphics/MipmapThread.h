@@ -0,0 +1,71 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#ifndef _MipmapThread_H_
+#define _MipmapThread_H_
+
+#include "../api.h"
+
+#include "../base/WorkerThread.h"
+#include "../base/Queue.h"
+
+#include <boost/shared_ptr.hpp>
+
+#include <vector>
+
+namespace avg {
+
+class Bitmap;
+typedef boost::shared_ptr<Bitmap> BitmapPtr;
+
+// Mipmap levels 1..n of a bitmap, sent back to the GLContextManager. The job id is
+// used to find the texture again, so textures never leave the main thread.
+struct AVG_API MipmapResult
+{
+    MipmapResult(unsigned jobID);
+
+    unsigned m_JobID;
+    std::vector<BitmapPtr> m_pLevels;
+};
+
+typedef Queue<MipmapResult> MipmapResultQueue;
+typedef boost::shared_ptr<MipmapResultQueue> MipmapResultQueuePtr;
+
+// Calculates mipmap chains for texture uploads. All threads of a pool share one command
+// queue.
+class AVG_API MipmapThread : public WorkerThread<MipmapThread>
+{
+    public:
+        MipmapThread(CQueue& cmdQ, MipmapResultQueue& resultQ);
+        virtual ~MipmapThread();
+
+        void generateMipmaps(unsigned jobID, BitmapPtr pBmp);
+
+    private:
+        virtual bool work();
+
+        MipmapResultQueue& m_ResultQ;
+};
+
+}
+
+#endif
@@ -47,15 +47,19 @@ namespace avg {
 
 namespace glproc {
 #ifndef AVG_ENABLE_EGL
-    PFNGLBUFFERSUBDATAPROC BufferSubData;
     PFNGLGETBUFFERSUBDATAPROC GetBufferSubData;
     PFNGLBLITFRAMEBUFFERPROC BlitFramebuffer;
     PFNGLDRAWBUFFERSPROC DrawBuffers;
     PFNGLDRAWRANGEELEMENTSPROC DrawRangeElements;
     PFNGLGETOBJECTPARAMETERIVARBPROC GetObjectParameteriv;
+    PFNGLFENCESYNCPROC FenceSync;
+    PFNGLCLIENTWAITSYNCPROC ClientWaitSync;
+    PFNGLWAITSYNCPROC WaitSync;
+    PFNGLDELETESYNCPROC DeleteSync;
 #endif
     PFNGLGENBUFFERSPROC GenBuffers;
     PFNGLBUFFERDATAPROC BufferData;
+    PFNGLBUFFERSUBDATAPROC BufferSubData;
     PFNGLDEBUGMESSAGECALLBACKPROC DebugMessageCallback;
     PFNGLDELETEBUFFERSPROC DeleteBuffers;
     PFNGLBINDBUFFERPROC BindBuffer;
@@ -101,6 +105,9 @@ namespace glproc {
     PFNGLDELETERENDERBUFFERSPROC DeleteRenderbuffers;
     PFNGLVERTEXATTRIBPOINTERPROC VertexAttribPointer;
     PFNGLENABLEVERTEXATTRIBARRAYPROC EnableVertexAttribArray;
+    PFNGLDISABLEVERTEXATTRIBARRAYPROC DisableVertexAttribArray;
+    PFNGLVERTEXATTRIBDIVISORPROC VertexAttribDivisor;
+    PFNGLDRAWELEMENTSINSTANCEDPROC DrawElementsInstanced;
     PFNGLBINDATTRIBLOCATIONPROC BindAttribLocation;
 #if defined(__linux__) && !defined(AVG_ENABLE_EGL)
     PFNGLXSWAPINTERVALEXTPROC SwapIntervalEXT;
@@ -341,6 +348,7 @@ namespace glproc {
         
         GenBuffers = (PFNGLGENBUFFERSPROC)getFuzzyProcAddress("glGenBuffers");
         BufferData = (PFNGLBUFFERDATAPROC)getFuzzyProcAddress("glBufferData");
+        BufferSubData = (PFNGLBUFFERSUBDATAPROC)getFuzzyProcAddress("glBufferSubData");
         DeleteBuffers = (PFNGLDELETEBUFFERSPROC)getFuzzyProcAddress("glDeleteBuffers");
         BindBuffer = (PFNGLBINDBUFFERPROC)getFuzzyProcAddress("glBindBuffer");
         MapBuffer = (PFNGLMAPBUFFERPROC)getFuzzyProcAddress("glMapBuffer");
@@ -402,7 +410,6 @@ namespace glproc {
         DeleteRenderbuffers = (PFNGLDELETERENDERBUFFERSPROC)
                 getFuzzyProcAddress("glDeleteRenderbuffers");
 #ifndef AVG_ENABLE_EGL
-        BufferSubData = (PFNGLBUFFERSUBDATAPROC)getFuzzyProcAddress("glBufferSubData");
         GetBufferSubData = (PFNGLGETBUFFERSUBDATAPROC)getFuzzyProcAddress
             ("glGetBufferSubData");
         GetObjectParameteriv = (PFNGLGETOBJECTPARAMETERIVARBPROC)
@@ -415,11 +422,21 @@ namespace glproc {
                 getFuzzyProcAddress("glDrawRangeElements");
         DebugMessageCallback = (PFNGLDEBUGMESSAGECALLBACKARBPROC)
                 getFuzzyProcAddress("glDebugMessageCallback");
+        FenceSync = (PFNGLFENCESYNCPROC)getFuzzyProcAddress("glFenceSync");
+        ClientWaitSync = (PFNGLCLIENTWAITSYNCPROC)getFuzzyProcAddress("glClientWaitSync");
+        WaitSync = (PFNGLWAITSYNCPROC)getFuzzyProcAddress("glWaitSync");
+        DeleteSync = (PFNGLDELETESYNCPROC)getFuzzyProcAddress("glDeleteSync");
 #endif
         VertexAttribPointer = (PFNGLVERTEXATTRIBPOINTERPROC)
                 getFuzzyProcAddress("glVertexAttribPointer");
         EnableVertexAttribArray = (PFNGLENABLEVERTEXATTRIBARRAYPROC)
                 getFuzzyProcAddress("glEnableVertexAttribArray");
+        DisableVertexAttribArray = (PFNGLDISABLEVERTEXATTRIBARRAYPROC)
+                getFuzzyProcAddress("glDisableVertexAttribArray");
+        VertexAttribDivisor = (PFNGLVERTEXATTRIBDIVISORPROC)
+                getFuzzyProcAddress("glVertexAttribDivisor");
+        DrawElementsInstanced = (PFNGLDRAWELEMENTSINSTANCEDPROC)
+                getFuzzyProcAddress("glDrawElementsInstanced");
         BindAttribLocation = (PFNGLBINDATTRIBLOCATIONPROC)
                 getFuzzyProcAddress("glBindAttribLocation");
 #if defined(__linux__) && !defined(AVG_ENABLE_EGL)
@@ -101,6 +101,8 @@ GLfunction getglXProcAddress(const char * psz);
 typedef void (GL_APIENTRYP PFNGLGENBUFFERSPROC) (GLsizei n, GLuint *buffers);
 typedef void (GL_APIENTRYP PFNGLBUFFERDATAPROC) (GLenum target, GLsizeiptr size, 
         const GLvoid* data, GLenum usage);
+typedef void (GL_APIENTRYP PFNGLBUFFERSUBDATAPROC) (GLenum target, GLintptr offset, 
+        GLsizeiptr size, const GLvoid* data);
 typedef void (APIENTRY* DEBUGCALLBACKPROC) (GLenum source, GLenum type, GLuint id,
         GLenum severity, GLsizei length, const GLchar* message, GLvoid* userParam);
 typedef void (GL_APIENTRYP PFNGLDEBUGMESSAGECALLBACKPROC) (DEBUGCALLBACKPROC callback,
@@ -167,6 +169,10 @@ typedef void (GL_APIENTRYP PFNGLDELETERENDERBUFFERSPROC) (GLsizei n,
 typedef void (GL_APIENTRYP PFNGLVERTEXATTRIBPOINTERPROC) (GLuint indx, GLint size, 
         GLenum type, GLboolean normalized, GLsizei stride, const GLvoid* ptr);
 typedef void (GL_APIENTRYP PFNGLENABLEVERTEXATTRIBARRAYPROC) (GLuint index);
+typedef void (GL_APIENTRYP PFNGLDISABLEVERTEXATTRIBARRAYPROC) (GLuint index);
+typedef void (GL_APIENTRYP PFNGLVERTEXATTRIBDIVISORPROC) (GLuint index, GLuint divisor);
+typedef void (GL_APIENTRYP PFNGLDRAWELEMENTSINSTANCEDPROC) (GLenum mode, GLsizei count,
+        GLenum type, const GLvoid* indices, GLsizei primcount);
 typedef void (GL_APIENTRYP PFNGLBINDATTRIBLOCATIONPROC) (GLuint program, GLuint index, 
         const GLchar* name);
 #else
@@ -176,13 +182,17 @@ typedef void (GL_APIENTRYP PFNGLBINDATTRIBLOCATIONPROC) (GLuint program, GLuint
 namespace glproc {
     extern AVG_API PFNGLGENBUFFERSPROC GenBuffers;
     extern AVG_API PFNGLBUFFERDATAPROC BufferData;
-#ifndef AVG_ENABLE_EGL
     extern AVG_API PFNGLBUFFERSUBDATAPROC BufferSubData;
+#ifndef AVG_ENABLE_EGL
     extern AVG_API PFNGLGETBUFFERSUBDATAPROC GetBufferSubData;
     extern AVG_API PFNGLDRAWBUFFERSPROC DrawBuffers;
     extern AVG_API PFNGLDRAWRANGEELEMENTSPROC DrawRangeElements;
     extern AVG_API PFNGLBLITFRAMEBUFFERPROC BlitFramebuffer;
     extern AVG_API PFNGLGETOBJECTPARAMETERIVARBPROC GetObjectParameteriv;
+    extern AVG_API PFNGLFENCESYNCPROC FenceSync;
+    extern AVG_API PFNGLCLIENTWAITSYNCPROC ClientWaitSync;
+    extern AVG_API PFNGLWAITSYNCPROC WaitSync;
+    extern AVG_API PFNGLDELETESYNCPROC DeleteSync;
 #endif
     extern AVG_API PFNGLDEBUGMESSAGECALLBACKPROC DebugMessageCallback;
     extern AVG_API PFNGLDELETEBUFFERSPROC DeleteBuffers;
@@ -231,6 +241,9 @@ namespace glproc {
 
     extern AVG_API PFNGLVERTEXATTRIBPOINTERPROC VertexAttribPointer;
     extern AVG_API PFNGLENABLEVERTEXATTRIBARRAYPROC EnableVertexAttribArray;
+    extern AVG_API PFNGLDISABLEVERTEXATTRIBARRAYPROC DisableVertexAttribArray;
+    extern AVG_API PFNGLVERTEXATTRIBDIVISORPROC VertexAttribDivisor;
+    extern AVG_API PFNGLDRAWELEMENTSINSTANCEDPROC DrawElementsInstanced;
     extern AVG_API PFNGLBINDATTRIBLOCATIONPROC BindAttribLocation;
 #if defined(__linux__) && !defined(AVG_ENABLE_EGL)
     extern PFNGLXSWAPINTERVALEXTPROC SwapIntervalEXT;
@@ -22,6 +22,7 @@
 #include "OGLShader.h"
 #include "ShaderRegistry.h"
 #include "VertexArray.h"
+#include "InstanceArray.h"
 
 #include "../base/Logger.h"
 #include "../base/Exception.h"
@@ -44,6 +45,14 @@ OGLShader::OGLShader(const string& sName, const string& sVertProgram,
     glproc::BindAttribLocation(m_hProgram, VertexArray::TEX_INDEX, "a_TexCoord");
     glproc::BindAttribLocation(m_hProgram, VertexArray::COLOR_INDEX, "a_Color");
     glproc::BindAttribLocation(m_hProgram, VertexArray::POS_INDEX, "a_Pos");
+    glproc::BindAttribLocation(m_hProgram, InstanceArray::INSTANCE_POS_INDEX, 
+            "a_InstancePos");
+    glproc::BindAttribLocation(m_hProgram, InstanceArray::INSTANCE_SIZE_INDEX, 
+            "a_InstanceSize");
+    glproc::BindAttribLocation(m_hProgram, InstanceArray::INSTANCE_ANGLE_INDEX, 
+            "a_InstanceAngle");
+    glproc::BindAttribLocation(m_hProgram, InstanceArray::INSTANCE_COLOR_INDEX, 
+            "a_InstanceColor");
     m_hVertexShader = compileShader(GL_VERTEX_SHADER, sVertProgram, sVertPrefix);
     glproc::AttachShader(m_hProgram, m_hVertexShader);
     m_hFragmentShader = compileShader(GL_FRAGMENT_SHADER, sFragProgram, sFragPrefix);
@@ -78,7 +87,8 @@ OGLShader::~OGLShader()
 bool isMountainLion()
 {
 #ifdef __APPLE__
-    return getOSXMajorVersion() == 12;
+    static bool bIsMountainLion = (getOSXMajorVersion() == 12);
+    return bIsMountainLion;
 #else
     return false;
 #endif
@@ -93,6 +103,9 @@ void OGLShader::activate()
         glproc::UseProgram(m_hProgram);
         m_pShaderRegistry->setCurShader(m_sName);
         GLContext::checkError("OGLShader::activate: glUseProgram()");
+        GLContext::getCurrent()->countStateChange(true);
+    } else {
+        GLContext::getCurrent()->countStateChange(false);
     }
 }
 
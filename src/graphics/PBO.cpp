@@ -26,6 +26,8 @@
 #include "../base/Logger.h"
 #include "../base/Exception.h"
 #include "../base/ObjectCounter.h"
+#include "../base/ScopeTimer.h"
+#include "../base/TimeSource.h"
 
 #include <iostream>
 #include <cstring>
@@ -37,34 +39,41 @@ namespace avg {
     
 PBO::PBO(const IntPoint& size, PixelFormat pf, unsigned usage)
     : TextureMover(size, pf),
-      m_Usage(usage)
+      m_Usage(usage),
+      m_PBOID(0)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
-    m_PBOID = GLContext::getCurrent()->getPBOCache().getBuffer();
-    
-    unsigned target = getTarget();
-    glproc::BindBuffer(target, m_PBOID);
-    GLContext::checkError("PBO: BindBuffer()");
-    glproc::BufferData(target, getMemNeeded(), 0, usage);
-    GLContext::checkError("PBO: BufferData()");
-    glproc::BindBuffer(target, 0);
+    if (isReadPBO()) {
+        m_PBOID = GLContext::getCurrent()->getPBOCache().getBuffer();
+        
+        unsigned target = getTarget();
+        glproc::BindBuffer(target, m_PBOID);
+        GLContext::checkError("PBO: BindBuffer()");
+        glproc::BufferData(target, getMemNeeded(), 0, usage);
+        GLContext::checkError("PBO: BufferData()");
+        glproc::BindBuffer(target, 0);
+    }
+    // Upload PBOs get a buffer from the context's UploadBufferPool for each upload.
 }
 
 PBO::~PBO()
 {
-    glproc::BindBuffer(getTarget(), m_PBOID);
-    glproc::BufferData(getTarget(), 0, 0, m_Usage);
-    GLContext* pContext = GLContext::getCurrent();
-    if (pContext) {
-        pContext->getPBOCache().returnBuffer(m_PBOID);
+    if (m_PBOID) {
+        glproc::BindBuffer(getTarget(), m_PBOID);
+        glproc::BufferData(getTarget(), 0, 0, m_Usage);
+        GLContext* pContext = GLContext::getCurrent();
+        if (pContext) {
+            pContext->getPBOCache().returnBuffer(m_PBOID);
+        }
+        glproc::BindBuffer(getTarget(), 0);
+        GLContext::checkError("PBO: DeleteBuffers()");
     }
-    glproc::BindBuffer(getTarget(), 0);
-    GLContext::checkError("PBO: DeleteBuffers()");
     ObjectCounter::get()->decRef(&typeid(*this));
 }
 
 void PBO::activate()
 {
+    AVG_ASSERT(isReadPBO());
     glproc::BindBuffer(getTarget(), m_PBOID);
     GLContext::checkError("PBO::activate()");  
 }
@@ -74,23 +83,46 @@ int PBO::getID() const
     return m_PBOID;
 }
 
+static ProfilingZoneID UploadCopyProfilingZone("PBO upload: copy", true);
+
 void PBO::moveBmpToTexture(BitmapPtr pBmp, GLTexture& tex)
+{
+    moveBmpRectToTexture(pBmp, IntRect(IntPoint(0,0), getSize()), tex);
+}
+
+void PBO::moveBmpRectToTexture(BitmapPtr pBmp, const IntRect& rect, GLTexture& tex)
 {
     AVG_ASSERT(pBmp->getSize() == tex.getSize());
     AVG_ASSERT(getSize() == pBmp->getSize());
     AVG_ASSERT(pBmp->getPixelFormat() == getPF());
     AVG_ASSERT(tex.getPF() == getPF());
     AVG_ASSERT(!isReadPBO());
-    glproc::BindBuffer(GL_PIXEL_UNPACK_BUFFER_EXT, m_PBOID);
+    AVG_ASSERT(rect.tl.x >= 0 && rect.tl.y >= 0);
+    AVG_ASSERT(rect.br.x <= getSize().x && rect.br.y <= getSize().y);
+    // Only the rect is copied to the upload buffer, so small changes need small
+    // buffers.
+    unsigned stride = getStride(rect.width());
+    unsigned memNeeded = stride*rect.height();
+    UploadBufferPool& pool = GLContext::getCurrent()->getUploadBufferPool();
+    UploadBufferPool::Buffer buffer = pool.acquireBuffer(memNeeded, m_Usage);
+    glproc::BindBuffer(GL_PIXEL_UNPACK_BUFFER_EXT, buffer.m_ID);
     GLContext::checkError("PBO::moveBmpToTexture BindBuffer()");
-    void * pPBOPixels = glproc::MapBuffer(GL_PIXEL_UNPACK_BUFFER_EXT, GL_WRITE_ONLY);
-    GLContext::checkError("PBO::moveBmpToTexture MapBuffer()");
-    Bitmap PBOBitmap(getSize(), getPF(), (unsigned char *)pPBOPixels, getStride(), false);
-    PBOBitmap.copyPixels(*pBmp);
-    glproc::UnmapBuffer(GL_PIXEL_UNPACK_BUFFER_EXT);
-    GLContext::checkError("PBO::moveBmpToTexture: UnmapBuffer()");
+    {
+        ScopeTimer timer(UploadCopyProfilingZone);
+        long long startTime = TimeSource::get()->getCurrentMicrosecs();
+        void * pPBOPixels = glproc::MapBuffer(GL_PIXEL_UNPACK_BUFFER_EXT, GL_WRITE_ONLY);
+        GLContext::checkError("PBO::moveBmpToTexture MapBuffer()");
+        Bitmap PBOBitmap(rect.size(), getPF(), (unsigned char *)pPBOPixels, stride, 
+                false);
+        Bitmap srcBmp(*pBmp, rect);
+        PBOBitmap.copyPixels(srcBmp);
+        glproc::UnmapBuffer(GL_PIXEL_UNPACK_BUFFER_EXT);
+        GLContext::checkError("PBO::moveBmpToTexture: UnmapBuffer()");
+        pool.countUpload(memNeeded, TimeSource::get()->getCurrentMicrosecs()-startTime);
+    }
 
-    moveToTexture(tex);
+    moveToTexture(buffer.m_ID, rect, tex);
+    pool.releaseBuffer(buffer);
 }
 
 BitmapPtr PBO::moveTextureToBmp(GLTexture& tex, int mipmapLevel)
@@ -121,17 +153,47 @@ void PBO::moveTextureToPBO(GLTexture& tex, int mipmapLevel)
     }
 }
 
-BitmapPtr PBO::movePBOToBmp() const
+void PBO::moveFramebufferToPBO(const IntPoint& size)
+{
+    // Reads from the framebuffer and read buffer that are currently bound. The call
+    // returns immediately; the transfer completes when the PBO is mapped.
+    AVG_ASSERT(isReadPBO());
+    AVG_ASSERT(size.x <= getSize().x && size.y <= getSize().y);
+    glproc::BindBuffer(GL_PIXEL_PACK_BUFFER_EXT, m_PBOID);
+    GLContext::checkError("PBO::moveFramebufferToPBO BindBuffer()");
+    glReadPixels(0, 0, size.x, size.y, GLTexture::getGLFormat(getPF()), 
+            GLTexture::getGLType(getPF()), 0);
+    GLContext::checkError("PBO::moveFramebufferToPBO: glReadPixels()");
+    glproc::BindBuffer(GL_PIXEL_PACK_BUFFER_EXT, 0);
+    m_ActiveSize = size;
+    m_BufferStride = size.x;
+}
+
+BitmapPtr PBO::movePBOToBmp(bool bFlip) const
 {
     AVG_ASSERT(isReadPBO());
     glproc::BindBuffer(GL_PIXEL_PACK_BUFFER_EXT, m_PBOID);
     GLContext::checkError("PBO::movePBOToBmp BindBuffer()");
     void * pPBOPixels = glproc::MapBuffer(GL_PIXEL_PACK_BUFFER_EXT, GL_READ_ONLY);
     GLContext::checkError("PBO::movePBOToBmp MapBuffer()");
-    Bitmap PBOBitmap(m_ActiveSize, getPF(), (unsigned char *)pPBOPixels, 
-            m_BufferStride*getBytesPerPixel(getPF()), false);
+    int pboStride = m_BufferStride*getBytesPerPixel(getPF());
     BitmapPtr pBmp(new Bitmap(m_ActiveSize, getPF()));
-    pBmp->copyPixels(PBOBitmap);
+    if (bFlip) {
+        // Flip while copying out of the mapped buffer instead of in a separate pass.
+        int lineLen = m_ActiveSize.x*getBytesPerPixel(getPF());
+        unsigned char * pSrcLine = (unsigned char *)pPBOPixels + 
+                (m_ActiveSize.y-1)*pboStride;
+        unsigned char * pDestLine = pBmp->getPixels();
+        for (int y = 0; y < m_ActiveSize.y; ++y) {
+            memcpy(pDestLine, pSrcLine, lineLen);
+            pSrcLine -= pboStride;
+            pDestLine += pBmp->getStride();
+        }
+    } else {
+        Bitmap PBOBitmap(m_ActiveSize, getPF(), (unsigned char *)pPBOPixels, 
+                pboStride, false);
+        pBmp->copyPixels(PBOBitmap);
+    }
     glproc::UnmapBuffer(GL_PIXEL_PACK_BUFFER_EXT);
     GLContext::checkError("PBO::movePBOToBmp: UnmapBuffer()");
     glproc::BindBuffer(GL_PIXEL_PACK_BUFFER_EXT, 0);
@@ -156,17 +218,10 @@ bool PBO::isReadPBO() const
     }
 }
 
-void PBO::moveToTexture(GLTexture& tex)
+void PBO::moveToTexture(unsigned bufferID, const IntRect& rect, GLTexture& tex)
 {
     AVG_ASSERT(!isReadPBO());
-    IntPoint size = tex.getSize();
-    if (size.x > getSize().x) {
-        size.x = getSize().x;
-    } 
-    if (size.y > getSize().y) {
-        size.y = getSize().y;
-    } 
-    glproc::BindBuffer(GL_PIXEL_UNPACK_BUFFER_EXT, m_PBOID);
+    glproc::BindBuffer(GL_PIXEL_UNPACK_BUFFER_EXT, bufferID);
     GLContext::checkError("PBO::moveToTexture: glBindBuffer()");
     tex.activate(WrapMode(), GL_TEXTURE0);
 #ifdef __APPLE__
@@ -177,7 +232,7 @@ void PBO::moveToTexture(GLTexture& tex)
         glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
     }
 #endif
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, size.x, size.y,
+    glTexSubImage2D(GL_TEXTURE_2D, 0, rect.tl.x, rect.tl.y, rect.width(), rect.height(),
             GLTexture::getGLFormat(getPF()), GLTexture::getGLType(getPF()), 0);
     GLContext::checkError("PBO::setImage: glTexSubImage2D()");
     glproc::BindBuffer(GL_PIXEL_UNPACK_BUFFER_EXT, 0);
@@ -191,13 +246,17 @@ unsigned PBO::getMemNeeded() const
 
 unsigned PBO::getStride() const
 {
-    IntPoint size = getSize();
-    unsigned stride = Bitmap::getPreferredStride(size.x, getPF());
+    return getStride(getSize().x);
+}
+
+unsigned PBO::getStride(int width) const
+{
+    unsigned stride = Bitmap::getPreferredStride(width, getPF());
 #ifdef __APPLE__
     if (getPF() == A8) {
         // Workaround for apparent bug in Apple/NVidia drivers (Verified on OS X 10.6.8,
         // MBP early 2011): GL_UNPACK_ALIGNMENT != 1 causes broken A8 textures.
-        stride = size.x;
+        stride = width;
     }
 #endif
     return stride;
@@ -44,18 +44,21 @@ public:
     void activate();
 
     void moveBmpToTexture(BitmapPtr pBmp, GLTexture& tex);
+    void moveBmpRectToTexture(BitmapPtr pBmp, const IntRect& rect, GLTexture& tex);
     virtual BitmapPtr moveTextureToBmp(GLTexture& tex, int mipmapLevel=0);
 
     void moveTextureToPBO(GLTexture& tex, int mipmapLevel=0);
-    BitmapPtr movePBOToBmp() const;
+    void moveFramebufferToPBO(const IntPoint& size);
+    BitmapPtr movePBOToBmp(bool bFlip=false) const;
 
     bool isReadPBO() const;
     int getID() const;
 
 private:
-    void moveToTexture(GLTexture& tex);
+    void moveToTexture(unsigned bufferID, const IntRect& rect, GLTexture& tex);
     unsigned getMemNeeded() const;
     unsigned getStride() const;
+    unsigned getStride(int width) const;
     unsigned getTarget() const;
 
     unsigned m_Usage;
@@ -75,13 +75,13 @@ void ShaderRegistry::setPreprocessorDefine(const string& sName, const string& sV
     m_PreprocessorDefinesMap[sName] = sValue;
 }
 
-void ShaderRegistry::createShader(const std::string& sID)
+void ShaderRegistry::createShader(const std::string& sID, const std::string& sVertID)
 {
     OGLShaderPtr pShader = getShader(sID);
     if (!pShader) {
         string sShaderCode;
         string sVertPreprocessed;
-        loadShaderString(s_sLibPath+"/standard.vert", sVertPreprocessed);
+        loadShaderString(s_sLibPath+"/"+sVertID+".vert", sVertPreprocessed);
         string sFilename = s_sLibPath+"/"+sID+".frag";
         string sFragPreprocessed;
         loadShaderString(sFilename, sFragPreprocessed);
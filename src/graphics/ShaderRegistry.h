@@ -27,6 +27,7 @@
 #include <boost/shared_ptr.hpp>
 
 #include <map>
+#include <string>
 
 namespace avg {
 
@@ -44,7 +45,7 @@ public:
     static void setShaderPath(const std::string& sLibPath);
     void setPreprocessorDefine(const std::string& sName, const std::string& sValue);
 
-    void createShader(const std::string& sID);
+    void createShader(const std::string& sID, const std::string& sVertID="standard");
     OGLShaderPtr getShader(const std::string& sID) const;
 
     OGLShaderPtr getCurShader() const;
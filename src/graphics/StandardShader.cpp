@@ -94,11 +94,15 @@ void StandardShader::activate()
         m_AlphaParam.set(m_Alpha);
 
         m_UseColorCoeffParam.set(m_bUseColorCoeff);
-        const glm::mat4& mat = m_ColorMatrix;
-        m_ColorCoeff0Param.set(glm::vec4(mat[0][0], mat[0][1], mat[0][2], 0));
-        m_ColorCoeff1Param.set(glm::vec4(mat[1][0], mat[1][1], mat[1][2], 0));
-        m_ColorCoeff2Param.set(glm::vec4(mat[2][0], mat[2][1], mat[2][2], 0));
-        m_ColorCoeff3Param.set(glm::vec4(mat[3][0], mat[3][1], mat[3][2], 1));
+        // The coefficients are only read by the shader for color conversion, so
+        // they're left alone otherwise.
+        if (m_bUseColorCoeff || m_ColorModel == 1 || m_ColorModel == 3) {
+            const glm::mat4& mat = m_ColorMatrix;
+            m_ColorCoeff0Param.set(glm::vec4(mat[0][0], mat[0][1], mat[0][2], 0));
+            m_ColorCoeff1Param.set(glm::vec4(mat[1][0], mat[1][1], mat[1][2], 0));
+            m_ColorCoeff2Param.set(glm::vec4(mat[2][0], mat[2][1], mat[2][2], 0));
+            m_ColorCoeff3Param.set(glm::vec4(mat[3][0], mat[3][1], mat[3][2], 1));
+        }
         m_GammaParam.set(m_Gamma);
 
         m_PremultipliedAlphaParam.set(m_bPremultipliedAlpha);
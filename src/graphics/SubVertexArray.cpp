@@ -92,6 +92,11 @@ void SubVertexArray::draw()
     m_pVA->draw(m_StartIndex, m_NumIndexes, m_StartVertex, m_StartIndex);
 }
 
+void SubVertexArray::drawInstanced(int numInstances)
+{
+    m_pVA->drawInstanced(m_StartIndex, m_NumIndexes, numInstances);
+}
+
 void SubVertexArray::dump() const
 {
     cerr << "SubVertexArray: m_StartVertex=" << m_StartVertex << ", " 
@@ -49,6 +49,7 @@ public:
     int getNumVerts() const;
 
     void draw();
+    void drawInstanced(int numInstances);
     void dump() const;
 
 private:
@@ -27,6 +27,7 @@
 #include "OGLHelper.h"
 
 #include "../base/GLMHelper.h"
+#include "../base/Rect.h"
 
 #include <boost/shared_ptr.hpp>
 
@@ -50,6 +51,9 @@ public:
     virtual ~TextureMover();
 
     virtual void moveBmpToTexture(BitmapPtr pBmp, GLTexture& tex) = 0;
+    // Transfers only the pixels inside rect. The rest of the texture is unchanged.
+    virtual void moveBmpRectToTexture(BitmapPtr pBmp, const IntRect& rect, 
+            GLTexture& tex) = 0;
     virtual BitmapPtr moveTextureToBmp(GLTexture& tex, int mipmapLevel=0) = 0;
 
     PixelFormat getPF() const;
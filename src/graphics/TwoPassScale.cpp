@@ -0,0 +1,241 @@
+// Fast and accurate bitmap scaling. Original code by Eran Yariv and Jake Montgomery,
+// posted on codeguru.com.
+
+#include "TwoPassScale.h"
+
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <map>
+#include <typeinfo>
+
+namespace avg {
+
+using namespace std;
+
+LineContribs::LineContribs(const ContribDef& contribDef, int lineSize, int srcSize)
+{
+    float dScale = float(lineSize)/srcSize;
+    float dWidth;
+    float dFScale = 1.0;
+    float dFilterWidth = contribDef.GetWidth();
+
+    if (dScale < 1.0) {
+        // Minification
+        dWidth = dFilterWidth / dScale;
+        dFScale = dScale;
+    } else {
+        // Magnification
+        dWidth= dFilterWidth;
+    }
+
+    // Window size is the number of sampled pixels
+    m_WindowSize = 2 * (int)ceil(dWidth) + 1;
+    m_Left.resize(lineSize);
+    m_Right.resize(lineSize);
+    m_Weights.resize(size_t(lineSize)*m_WindowSize, 0);
+
+    vector<int> weights(m_WindowSize);
+    for (int u = 0; u < lineSize; u++) {
+        // Scan through line of contributions
+        float dCenter = (u+0.5f)/dScale-0.5f;   // Reverse mapping
+        // Find the significant edge points that affect the pixel
+        int iLeft = std::max (0, (int)floor (dCenter - dWidth));
+        int iRight = std::min ((int)ceil (dCenter + dWidth), srcSize - 1);
+
+        // Cut edge points to fit in filter window in case of spill-off
+        if (iRight - iLeft + 1 > m_WindowSize) {
+            if (iLeft < (srcSize - 1 / 2)) {
+                iLeft++;
+            } else {
+                iRight--;
+            }
+        }
+        m_Left[u] = iLeft;
+        m_Right[u] = iRight;
+
+        int dTotalWeight = 0;  // Zero sum of weights
+        for (int iSrc = iLeft; iSrc <= iRight; iSrc++) {
+            // Calculate weights
+            int CurWeight = int (dFScale * (contribDef.Filter (dFScale *
+                    (dCenter - (float)iSrc)))*256);
+            weights[iSrc-iLeft] = CurWeight;
+            dTotalWeight += CurWeight;
+        }
+        AVG_ASSERT(dTotalWeight >= 0);   // An error in the filter function can cause this
+        short * pWeights = &m_Weights[size_t(u)*m_WindowSize];
+        if (dTotalWeight > 0) {
+            // Normalize weight of neighbouring points
+            int UsedWeight = 0;
+            for (int iSrc = iLeft; iSrc < iRight; iSrc++) {
+                // Normalize point
+                int CurWeight = (weights[iSrc-iLeft]*256)/dTotalWeight;
+                pWeights[iSrc-iLeft] = short(CurWeight);
+                UsedWeight += CurWeight;
+            }
+            // The last point gets everything that's left over so the sum is
+            // always correct.
+            pWeights[iRight-iLeft] = short(256 - UsedWeight);
+        } else {
+            for (int iSrc = iLeft; iSrc <= iRight; iSrc++) {
+                pWeights[iSrc-iLeft] = short(weights[iSrc-iLeft]);
+            }
+        }
+    }
+}
+
+namespace {
+
+struct ContribKey
+{
+    ContribKey(const ContribDef& contribDef, int lineSize, int srcSize)
+        : m_sFilterType(typeid(contribDef).name()),
+          m_FilterWidth(contribDef.GetWidth()),
+          m_LineSize(lineSize),
+          m_SrcSize(srcSize)
+    {
+    }
+
+    bool operator <(const ContribKey& other) const
+    {
+        if (m_LineSize != other.m_LineSize) {
+            return m_LineSize < other.m_LineSize;
+        }
+        if (m_SrcSize != other.m_SrcSize) {
+            return m_SrcSize < other.m_SrcSize;
+        }
+        if (m_FilterWidth != other.m_FilterWidth) {
+            return m_FilterWidth < other.m_FilterWidth;
+        }
+        return m_sFilterType < other.m_sFilterType;
+    }
+
+    string m_sFilterType;
+    float m_FilterWidth;
+    int m_LineSize;
+    int m_SrcSize;
+};
+
+typedef map<ContribKey, LineContribsPtr> ContribCache;
+
+// Thumbnail generation and camera downscaling scale lots of images with the same
+// parameters. The cache is small, so it's simply emptied when it's full.
+const unsigned MAX_CACHED_CONTRIBS = 64;
+ContribCache s_ContribCache;
+boost::mutex s_ContribCacheMutex;
+
+// Below this amount of work (in bytes touched), a thread isn't worth starting.
+const long long MIN_WORK_PER_THREAD = 256*1024;
+
+}
+
+LineContribsPtr getLineContribs(const ContribDef& contribDef, int lineSize, int srcSize)
+{
+    ContribKey key(contribDef, lineSize, srcSize);
+    {
+        boost::mutex::scoped_lock lock(s_ContribCacheMutex);
+        ContribCache::iterator it = s_ContribCache.find(key);
+        if (it != s_ContribCache.end()) {
+            return it->second;
+        }
+    }
+    LineContribsPtr pContribs(new LineContribs(contribDef, lineSize, srcSize));
+    boost::mutex::scoped_lock lock(s_ContribCacheMutex);
+    if (s_ContribCache.size() >= MAX_CACHED_CONTRIBS) {
+        s_ContribCache.clear();
+    }
+    s_ContribCache[key] = pContribs;
+    return pContribs;
+}
+
+void accumulateRows(int* pAccum, const unsigned char* pSrc0, int w0,
+        const unsigned char* pSrc1, int w1, int numBytes, bool bUseSIMD)
+{
+    int i = 0;
+#ifdef AVG_TWOPASSSCALE_SSE2
+    // 16 bytes at a time. The bytes of both rows are interleaved as 16 bit values so
+    // _mm_madd_epi16 calculates w0*pSrc0[i] + w1*pSrc1[i] in one step.
+    __m128i zero = _mm_setzero_si128();
+    __m128i weights = _mm_set1_epi32((unsigned short)w0 | (w1 << 16));
+    for (; bUseSIMD && i+16 <= numBytes; i += 16) {
+        __m128i row0 = _mm_loadu_si128((const __m128i*)(pSrc0+i));
+        __m128i row1 = pSrc1 ? _mm_loadu_si128((const __m128i*)(pSrc1+i)) : zero;
+        __m128i interleaved = _mm_unpacklo_epi8(row0, row1);
+        __m128i lo = _mm_unpacklo_epi8(interleaved, zero);
+        __m128i hi = _mm_unpackhi_epi8(interleaved, zero);
+        __m128i* pDest = (__m128i*)(pAccum+i);
+        _mm_storeu_si128(pDest, _mm_add_epi32(_mm_loadu_si128(pDest),
+                _mm_madd_epi16(lo, weights)));
+        _mm_storeu_si128(pDest+1, _mm_add_epi32(_mm_loadu_si128(pDest+1),
+                _mm_madd_epi16(hi, weights)));
+        interleaved = _mm_unpackhi_epi8(row0, row1);
+        lo = _mm_unpacklo_epi8(interleaved, zero);
+        hi = _mm_unpackhi_epi8(interleaved, zero);
+        _mm_storeu_si128(pDest+2, _mm_add_epi32(_mm_loadu_si128(pDest+2),
+                _mm_madd_epi16(lo, weights)));
+        _mm_storeu_si128(pDest+3, _mm_add_epi32(_mm_loadu_si128(pDest+3),
+                _mm_madd_epi16(hi, weights)));
+    }
+#endif
+    if (pSrc1) {
+        for (; i < numBytes; ++i) {
+            pAccum[i] += w0*pSrc0[i] + w1*pSrc1[i];
+        }
+    } else {
+        for (; i < numBytes; ++i) {
+            pAccum[i] += w0*pSrc0[i];
+        }
+    }
+}
+
+void storeAccumulatedRow(const int* pAccum, unsigned char* pDest, int numBytes,
+        bool bUseSIMD)
+{
+    int i = 0;
+#ifdef AVG_TWOPASSSCALE_SSE2
+    __m128i round = _mm_set1_epi32(128);
+    for (; bUseSIMD && i+16 <= numBytes; i += 16) {
+        const __m128i* pSrc = (const __m128i*)(pAccum+i);
+        __m128i v0 = _mm_srai_epi32(_mm_add_epi32(_mm_loadu_si128(pSrc), round), 8);
+        __m128i v1 = _mm_srai_epi32(_mm_add_epi32(_mm_loadu_si128(pSrc+1), round), 8);
+        __m128i v2 = _mm_srai_epi32(_mm_add_epi32(_mm_loadu_si128(pSrc+2), round), 8);
+        __m128i v3 = _mm_srai_epi32(_mm_add_epi32(_mm_loadu_si128(pSrc+3), round), 8);
+        __m128i result = _mm_packus_epi16(_mm_packs_epi32(v0, v1),
+                _mm_packs_epi32(v2, v3));
+        _mm_storeu_si128((__m128i*)(pDest+i), result);
+    }
+#endif
+    for (; i < numBytes; ++i) {
+        pDest[i] = (unsigned char)((pAccum[i] + 128)/256);
+    }
+}
+
+void processRowsInParallel(int numRows, long long workPerRow, int maxThreads,
+        const RowRangeFunc& rowFunc)
+{
+    int numThreads = maxThreads;
+    if (numThreads == 0) {
+        numThreads = max(1, int(boost::thread::hardware_concurrency()));
+    }
+    long long maxUsefulThreads = max(1LL, (workPerRow*numRows)/MIN_WORK_PER_THREAD);
+    numThreads = int(min((long long)(min(numThreads, numRows)), maxUsefulThreads));
+    if (numThreads <= 1) {
+        rowFunc(0, numRows);
+        return;
+    }
+
+    // The calling thread processes the first range itself.
+    vector<boost::thread*> pThreads;
+    for (int i = 1; i < numThreads; ++i) {
+        int startRow = int((long long)(numRows)*i/numThreads);
+        int endRow = int((long long)(numRows)*(i+1)/numThreads);
+        pThreads.push_back(new boost::thread(rowFunc, startRow, endRow));
+    }
+    rowFunc(0, numRows/numThreads);
+    for (unsigned i = 0; i < pThreads.size(); ++i) {
+        pThreads[i]->join();
+        delete pThreads[i];
+    }
+}
+
+}
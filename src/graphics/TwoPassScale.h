@@ -4,28 +4,101 @@
 #ifndef _TwoPassScale_h_
 #define _TwoPassScale_h_
 
+#include "../api.h"
 #include "ContribDefs.h"
 
 #include "../base/Exception.h"
+#include "../base/GLMHelper.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
+#include <boost/bind.hpp>
+
+#if defined(__SSE2__) || defined(_WIN32)
+#include <emmintrin.h>
+#define AVG_TWOPASSSCALE_SSE2
+#endif
 
 #include <math.h>
 #include <algorithm>
 #include <cstring>
+#include <vector>
 
 namespace avg {
 
-typedef struct
+// Contribution information for an entire line (row or column): For every destination
+// pixel, the bounds of the source pixel window and the normalized weights (summing up
+// to 256) of the source pixels in it. Only depends on the filter and the sizes, so it
+// is cached and shared between threads.
+class AVG_API LineContribs
 {
-   int *Weights;     // Normalized weights of neighboring pixels
-   int Left,Right;   // Bounds of source pixels window
-} ContributionType;  // Contirbution information for a single pixel
+public:
+    LineContribs(const ContribDef& contribDef, int lineSize, int srcSize);
 
-typedef struct
+    int getLeft(int i) const
+    {
+        return m_Left[i];
+    }
+
+    int getRight(int i) const
+    {
+        return m_Right[i];
+    }
+
+    const short* getWeights(int i) const
+    {
+        return &m_Weights[size_t(i)*m_WindowSize];
+    }
+
+private:
+    int m_WindowSize;
+    std::vector<int> m_Left;
+    std::vector<int> m_Right;
+    std::vector<short> m_Weights;
+};
+
+typedef boost::shared_ptr<const LineContribs> LineContribsPtr;
+
+AVG_API LineContribsPtr getLineContribs(const ContribDef& contribDef, int lineSize,
+        int srcSize);
+
+// Vertical pass helpers that work on complete rows of bytes, independent of the pixel
+// format: pAccum[i] += w0*pSrc0[i] + w1*pSrc1[i]. pSrc1 may be 0 if w1 is 0. SSE2 is
+// used if available and bUseSIMD is set.
+AVG_API void accumulateRows(int* pAccum, const unsigned char* pSrc0, int w0,
+        const unsigned char* pSrc1, int w1, int numBytes, bool bUseSIMD=true);
+AVG_API void storeAccumulatedRow(const int* pAccum, unsigned char* pDest, int numBytes,
+        bool bUseSIMD=true);
+
+// Calls rowFunc(startRow, endRow) for disjoint row ranges covering all rows. Large jobs
+// are split between up to maxThreads threads (0 means one per core).
+typedef boost::function<void (int, int)> RowRangeFunc;
+AVG_API void processRowsInParallel(int numRows, long long workPerRow, int maxThreads,
+        const RowRangeFunc& rowFunc);
+
+
+// The accumulators sum up weight*value for a window of source pixels. Weights are
+// normalized to 256, so Store() divides by 256 with rounding. Accumulate() uses SSE2
+// where available, AccumulateScalar() never does. All arithmetic is integer, so both
+// give exactly the same results.
+
+#ifdef AVG_TWOPASSSCALE_SSE2
+// Returns the weights of two neighboring pixels as 16 bit pairs for _mm_madd_epi16.
+inline __m128i loadContribWeightPair(const short* pWeights)
 {
-   ContributionType *ContribRow; // Row (or column) of contribution weights
-   int WindowSize,               // Filter window size (of affecting source pixels)
-       LineLength;               // Length of line (no. or rows / cols)
-} LineContribType;               // Contribution information for an entire line (row or column)
+    return _mm_set1_epi32((unsigned short)pWeights[0] | (pWeights[1] << 16));
+}
+
+// Adds four 32 bit sums (one per channel) to pSums.
+inline void addAccumulatorVec(__m128i vec, int* pSums)
+{
+    int vecSums[4];
+    _mm_storeu_si128((__m128i*)vecSums, vec);
+    for (int i = 0; i < 4; ++i) {
+        pSums[i] += vecSums[i];
+    }
+}
+#endif
 
 class CDataA_UBYTE
 {
@@ -36,17 +109,52 @@ public:
       _Accumulator ()
       {
         val = 0;
+#ifdef AVG_TWOPASSSCALE_SSE2
+        vec = _mm_setzero_si128();
+#endif
       };
-      void Accumulate (int Weight, PixelClass &value)
+
+      void Accumulate (const short* pWeights, const PixelClass* pSrc, int numPixels)
       {
-        val += (Weight * value);
+        int i = 0;
+#ifdef AVG_TWOPASSSCALE_SSE2
+        // Eight pixels at a time: _mm_madd_epi16 multiplies and adds pairs.
+        __m128i zero = _mm_setzero_si128();
+        for (; i+8 <= numPixels; i += 8) {
+            __m128i values = _mm_unpacklo_epi8(
+                    _mm_loadl_epi64((const __m128i*)(pSrc+i)), zero);
+            __m128i weights = _mm_loadu_si128((const __m128i*)(pWeights+i));
+            vec = _mm_add_epi32(vec, _mm_madd_epi16(values, weights));
+        }
+#endif
+        AccumulateScalar(pWeights+i, pSrc+i, numPixels-i);
+      };
+
+      void AccumulateScalar (const short* pWeights, const PixelClass* pSrc, 
+              int numPixels)
+      {
+        for (int i = 0; i < numPixels; i++) {
+            val += (pWeights[i] * pSrc[i]);
+        }
       };
 
       void Store (PixelClass* value)
       {
-        *value = (unsigned char) ((val + 128)/256);
+        int sum = val;
+#ifdef AVG_TWOPASSSCALE_SSE2
+        __m128i hi = _mm_shuffle_epi32(vec, _MM_SHUFFLE(1, 0, 3, 2));
+        __m128i sum2 = _mm_add_epi32(vec, hi);
+        hi = _mm_shuffle_epi32(sum2, _MM_SHUFFLE(2, 3, 0, 1));
+        sum += _mm_cvtsi128_si32(_mm_add_epi32(sum2, hi));
+#endif
+        *value = (unsigned char) ((sum + 128)/256);
       };
+
+  private:
       int val;
+#ifdef AVG_TWOPASSSCALE_SSE2
+      __m128i vec;
+#endif
   };
 };
 
@@ -59,25 +167,64 @@ public:
       _Accumulator ()
       {
         val [0] = val [1] = val [2] = 0;
+#ifdef AVG_TWOPASSSCALE_SSE2
+        vec = _mm_setzero_si128();
+#endif
+      };
+
+      void Accumulate (const short* pWeights, const PixelClass* pSrc, int numPixels)
+      {
+#ifdef AVG_TWOPASSSCALE_SSE2
+        // Two pixels at a time, with the channels interleaved as 16 bit values
+        // (r0 r1 g0 g1 b0 b1 x x) so _mm_madd_epi16 can add up the pairs. Loading
+        // two pixels reads 8 bytes, so the last pixels in the window are handled
+        // one at a time to avoid reading past the end of the bitmap.
+        __m128i zero = _mm_setzero_si128();
+        int i = 0;
+        for (; i+3 <= numPixels; i += 2) {
+            __m128i pixels = _mm_unpacklo_epi8(
+                    _mm_loadl_epi64((const __m128i*)(pSrc+i)), zero);
+            pixels = _mm_unpacklo_epi16(pixels, _mm_srli_si128(pixels, 6));
+            vec = _mm_add_epi32(vec, _mm_madd_epi16(pixels,
+                    loadContribWeightPair(pWeights+i)));
+        }
+        AccumulateScalar(pWeights+i, pSrc+i, numPixels-i);
+#else
+        AccumulateScalar(pWeights, pSrc, numPixels);
+#endif
       };
-      void Accumulate (int Weight, PixelClass &value)
+
+      void AccumulateScalar (const short* pWeights, const PixelClass* pSrc, 
+              int numPixels)
       {
-        val [0] += (Weight * value [0]);
-        val [1] += (Weight * value [1]);
-        val [2] += (Weight * value [2]);
+        for (int i = 0; i < numPixels; i++) {
+            val [0] += (pWeights[i] * pSrc[i][0]);
+            val [1] += (pWeights[i] * pSrc[i][1]);
+            val [2] += (pWeights[i] * pSrc[i][2]);
+        }
       };
 
       void Store (PixelClass* value)
       {
-        (*value) [0] = (unsigned char) ((val [0] + 128)/256);
-        (*value) [1] = (unsigned char) ((val [1] + 128)/256);
-        (*value) [2] = (unsigned char) ((val [2] + 128)/256);
+        int sum [4] = {val [0], val [1], val [2], 0};
+#ifdef AVG_TWOPASSSCALE_SSE2
+        addAccumulatorVec(vec, sum);
+#endif
+        (*value) [0] = (unsigned char) ((sum [0] + 128)/256);
+        (*value) [1] = (unsigned char) ((sum [1] + 128)/256);
+        (*value) [2] = (unsigned char) ((sum [2] + 128)/256);
       };
+
+  private:
       int val [3];
+#ifdef AVG_TWOPASSSCALE_SSE2
+      __m128i vec;
+#endif
   };
 };
 
-class CDataRGBA_UBYTE {
+class CDataRGBA_UBYTE
+{
 public:
   typedef unsigned char PixelClass[4];
   class _Accumulator {
@@ -85,23 +232,58 @@ public:
       _Accumulator ()
       {
         val [0] = val [1] = val [2] = val [3] = 0;
+#ifdef AVG_TWOPASSSCALE_SSE2
+        vec = _mm_setzero_si128();
+#endif
+      };
+
+      void Accumulate (const short* pWeights, const PixelClass* pSrc, int numPixels)
+      {
+#ifdef AVG_TWOPASSSCALE_SSE2
+        // Two pixels at a time, interleaved as r0 r1 g0 g1 b0 b1 a0 a1.
+        __m128i zero = _mm_setzero_si128();
+        int i = 0;
+        for (; i+2 <= numPixels; i += 2) {
+            __m128i pixels = _mm_unpacklo_epi8(
+                    _mm_loadl_epi64((const __m128i*)(pSrc+i)), zero);
+            pixels = _mm_unpacklo_epi16(pixels, _mm_srli_si128(pixels, 8));
+            vec = _mm_add_epi32(vec, _mm_madd_epi16(pixels,
+                    loadContribWeightPair(pWeights+i)));
+        }
+        AccumulateScalar(pWeights+i, pSrc+i, numPixels-i);
+#else
+        AccumulateScalar(pWeights, pSrc, numPixels);
+#endif
       };
-      void Accumulate (int dWeight, PixelClass &value)
+
+      void AccumulateScalar (const short* pWeights, const PixelClass* pSrc, 
+              int numPixels)
       {
-        val [0] += (dWeight * (value [0]));
-        val [1] += (dWeight * (value [1]));
-        val [2] += (dWeight * (value [2]));
-        val [3] += (dWeight * (value [3]));
+        for (int i = 0; i < numPixels; i++) {
+            val [0] += (pWeights[i] * pSrc[i][0]);
+            val [1] += (pWeights[i] * pSrc[i][1]);
+            val [2] += (pWeights[i] * pSrc[i][2]);
+            val [3] += (pWeights[i] * pSrc[i][3]);
+        }
       };
 
       void Store (PixelClass* value)
       {
-        (*value) [0] = (unsigned char) ((val [0] + 128)/256);
-        (*value) [1] = (unsigned char) ((val [1] + 128)/256);
-        (*value) [2] = (unsigned char) ((val [2] + 128)/256);
-        (*value) [3] = (unsigned char) ((val [3] + 128)/256);
+        int sum [4] = {val [0], val [1], val [2], val [3]};
+#ifdef AVG_TWOPASSSCALE_SSE2
+        addAccumulatorVec(vec, sum);
+#endif
+        (*value) [0] = (unsigned char) ((sum [0] + 128)/256);
+        (*value) [1] = (unsigned char) ((sum [1] + 128)/256);
+        (*value) [2] = (unsigned char) ((sum [2] + 128)/256);
+        (*value) [3] = (unsigned char) ((sum [3] + 128)/256);
       };
+
+  private:
       int val [4];
+#ifdef AVG_TWOPASSSCALE_SSE2
+      __m128i vec;
+#endif
   };
 };
 
@@ -111,150 +293,58 @@ class TwoPassScale
 public:
     typedef typename DataClass::PixelClass PixelClass;
 
-    TwoPassScale (const ContribDef& contribDef)
-        : m_ContribDef (contribDef)
+    // maxThreads limits the number of threads used for large images. 0 means one
+    // thread per core. Without bUseSIMD, only the scalar code is used, e.g. to verify
+    // or benchmark the SSE2 code.
+    TwoPassScale (const ContribDef& contribDef, int maxThreads=0, bool bUseSIMD=true)
+        : m_ContribDef (contribDef),
+          m_MaxThreads (maxThreads),
+          m_bUseSIMD (bUseSIMD)
     {};
 
     virtual ~TwoPassScale() {};
 
-    void Scale(PixelClass * pSrcData, const IntPoint& srcSize, int srcStride, 
+    void Scale(PixelClass * pSrcData, const IntPoint& srcSize, int srcStride,
             PixelClass *pDstData, const IntPoint& dstSize, int dstStride);
 
 private:
-    LineContribType *AllocContributions (unsigned uLineLength,
-                                         unsigned uWindowSize);
-
-    void FreeContributions (LineContribType * p);
-
-    LineContribType *CalcContributions (unsigned    uLineSize,
-                                        unsigned    uSrcSize);
-
-    void ScaleRow(PixelClass *pSrc, int uSrcWidth, PixelClass *pDest, int uResWidth, 
-            LineContribType *pContrib);
+    void ScaleRow(const PixelClass *pSrc, PixelClass *pDest, int uResWidth,
+            const LineContribs& contribs);
 
-    void HorizScale(PixelClass * pSrcData, const IntPoint& srcSize, int srcStride, 
+    void HorizScale(PixelClass * pSrcData, const IntPoint& srcSize, int srcStride,
             PixelClass *pDestData, const IntPoint& destSize, int destStride);
 
+    void HorizScaleRows(PixelClass * pSrcData, int srcStride, PixelClass *pDestData,
+            int destWidth, int destStride, const LineContribs* pContribs,
+            int startRow, int endRow);
+
     void VertScale(PixelClass *pSrcData, const IntPoint& srcSize, int srcStride,
             PixelClass *pDestData, const IntPoint& destSize, int destStride);
 
+    void VertScaleRows(PixelClass *pSrcData, int srcStride, PixelClass *pDestData,
+            int destWidth, int destStride, const LineContribs* pContribs,
+            int startRow, int endRow);
+
     const ContribDef& m_ContribDef;
+    int m_MaxThreads;
+    bool m_bUseSIMD;
 };
 
-template <class DataClass>
-LineContribType *
-TwoPassScale<DataClass>::AllocContributions (unsigned uLineLength, unsigned uWindowSize)
-{
-    LineContribType *res = new LineContribType;
-        // Init structure header
-    res->WindowSize = uWindowSize;
-    res->LineLength = uLineLength;
-        // Allocate list of contributions
-    res->ContribRow = new ContributionType[uLineLength];
-    for (unsigned u = 0 ; u < uLineLength ; u++)
-    {
-        // Allocate contributions for every pixel
-        res->ContribRow[u].Weights = new int[uWindowSize];
-    }
-    return res;
-}
-
 template <class DataClass>
 void
-TwoPassScale<DataClass>::FreeContributions (LineContribType * p)
-{
-    for (int u = 0; u < p->LineLength; u++)
-    {
-        // Free contribs for every pixel
-        delete [] p->ContribRow[u].Weights;
-    }
-    delete [] p->ContribRow;    // Free list of pixels contribs
-    delete p;                   // Free contribs header
-}
-
-template <class DataClass>
-LineContribType *
-TwoPassScale<DataClass>::CalcContributions(unsigned uLineSize, unsigned uSrcSize)
-{
-    float dScale = float(uLineSize)/uSrcSize;
-    float dWidth;
-    float dFScale = 1.0;
-    float dFilterWidth = m_ContribDef.GetWidth();
-
-    if (dScale < 1.0) {
-        // Minification
-        dWidth = dFilterWidth / dScale;
-        dFScale = dScale;
-    } else {
-        // Magnification
-        dWidth= dFilterWidth;
-    }
-
-    // Window size is the number of sampled pixels
-    int iWindowSize = 2 * (int)ceil(dWidth) + 1;
-
-    // Allocate a new line contributions strucutre
-    LineContribType *res = AllocContributions (uLineSize, iWindowSize);
-
-    for (unsigned u = 0; u < uLineSize; u++) {
-        // Scan through line of contributions
-        float dCenter = (u+0.5f)/dScale-0.5f;   // Reverse mapping
-        // Find the significant edge points that affect the pixel
-        int iLeft = std::max (0, (int)floor (dCenter - dWidth));
-        int iRight = std::min ((int)ceil (dCenter + dWidth), int(uSrcSize) - 1);
-
-        // Cut edge points to fit in filter window in case of spill-off
-        if (iRight - iLeft + 1 > iWindowSize) {
-            if (iLeft < (int(uSrcSize) - 1 / 2)) {
-                iLeft++;
-            } else {
-                iRight--;
-            }
-        }
-        res->ContribRow[u].Left = iLeft;
-        res->ContribRow[u].Right = iRight;
-        
-        int dTotalWeight = 0;  // Zero sum of weights
-        for (int iSrc = iLeft; iSrc <= iRight; iSrc++) {
-            // Calculate weights
-            int CurWeight = int (dFScale * (m_ContribDef.Filter (dFScale * 
-                    (dCenter - (float)iSrc)))*256);
-            res->ContribRow[u].Weights[iSrc-iLeft] = CurWeight;
-            dTotalWeight += CurWeight;
-        }
-        AVG_ASSERT(dTotalWeight >= 0);   // An error in the filter function can cause this
-        int UsedWeight = 0;
-        if (dTotalWeight > 0) {
-            // Normalize weight of neighbouring points
-            for (int iSrc = iLeft; iSrc < iRight; iSrc++) {
-                // Normalize point
-                int CurWeight = (res->ContribRow[u].Weights[iSrc-iLeft]*256)/dTotalWeight;
-                res->ContribRow[u].Weights[iSrc-iLeft] = CurWeight;
-                UsedWeight += CurWeight;
-            }
-            // The last point gets everything that's left over so the sum is
-            // always correct.
-            res->ContribRow[u].Weights[iRight-iLeft] = 256 - UsedWeight;
-        }
-   }
-   return res;
-}
-
-template <class DataClass>
-void
-TwoPassScale<DataClass>::ScaleRow(PixelClass *pSrc, int uSrcWidth,
-        PixelClass *pDest, int uResWidth, LineContribType *pContrib)
+TwoPassScale<DataClass>::ScaleRow(const PixelClass *pSrc, PixelClass *pDest,
+        int uResWidth, const LineContribs& contribs)
 {
     PixelClass * pDestPixel = pDest;
     for (int x = 0; x < uResWidth; x++) {
         typename DataClass::_Accumulator a;
-        int iLeft = pContrib->ContribRow[x].Left;    // Retrieve left boundries
-        int iRight = pContrib->ContribRow[x].Right;  // Retrieve right boundries
-        int * Weights = pContrib->ContribRow[x].Weights;
-        for (int i = iLeft; i <= iRight; i++) {
-            // Scan between boundries
-            // Accumulate weighted effect of each neighboring pixel
-            a.Accumulate(Weights[i-iLeft], pSrc[i]);
+        int iLeft = contribs.getLeft(x);
+        int iRight = contribs.getRight(x);
+        // Accumulate weighted effect of each neighboring pixel
+        if (m_bUseSIMD) {
+            a.Accumulate(contribs.getWeights(x), pSrc+iLeft, iRight-iLeft+1);
+        } else {
+            a.AccumulateScalar(contribs.getWeights(x), pSrc+iLeft, iRight-iLeft+1);
         }
         a.Store(pDestPixel);
         pDestPixel++;
@@ -262,7 +352,7 @@ TwoPassScale<DataClass>::ScaleRow(PixelClass *pSrc, int uSrcWidth,
 }
 
 template <class DataClass>
-void TwoPassScale<DataClass>::HorizScale(PixelClass * pSrcData, const IntPoint& srcSize, 
+void TwoPassScale<DataClass>::HorizScale(PixelClass * pSrcData, const IntPoint& srcSize,
         int srcStride, PixelClass *pDestData, const IntPoint& destSize, int destStride)
 {
     PixelClass * pSrc = pSrcData;
@@ -275,16 +365,27 @@ void TwoPassScale<DataClass>::HorizScale(PixelClass * pSrcData, const IntPoint&
             pDest = (PixelClass*)((char*)(pDest)+destStride);
         }
     } else {
-        LineContribType * pContrib = CalcContributions(destSize.x, srcSize.x);
-        for (int y = 0; y < destSize.y; y++) {
-            ScaleRow(pSrc, srcSize.x, pDest, destSize.x, pContrib);
-            pSrc = (PixelClass*)((char*)(pSrc)+srcStride);
-            pDest = (PixelClass*)((char*)(pDest)+destStride);
-        }
-        FreeContributions(pContrib);  // Free contributions structure
+        LineContribsPtr pContribs = getLineContribs(m_ContribDef, destSize.x, srcSize.x);
+        long long workPerRow = (long long)(srcSize.x+destSize.x)*sizeof(PixelClass);
+        processRowsInParallel(destSize.y, workPerRow, m_MaxThreads,
+                boost::bind(&TwoPassScale::HorizScaleRows, this, pSrcData, srcStride,
+                        pDestData, destSize.x, destStride, pContribs.get(), _1, _2));
     }
 }
 
+template <class DataClass>
+void TwoPassScale<DataClass>::HorizScaleRows(PixelClass * pSrcData, int srcStride,
+        PixelClass *pDestData, int destWidth, int destStride,
+        const LineContribs* pContribs, int startRow, int endRow)
+{
+    PixelClass * pSrc = (PixelClass*)((char*)(pSrcData) + size_t(startRow)*srcStride);
+    PixelClass * pDest = (PixelClass*)((char*)(pDestData) + size_t(startRow)*destStride);
+    for (int y = startRow; y < endRow; y++) {
+        ScaleRow(pSrc, pDest, destWidth, *pContribs);
+        pSrc = (PixelClass*)((char*)(pSrc)+srcStride);
+        pDest = (PixelClass*)((char*)(pDest)+destStride);
+    }
+}
 
 template <class DataClass>
 void TwoPassScale<DataClass>::VertScale(PixelClass *pSrcData, const IntPoint& srcSize,
@@ -300,38 +401,49 @@ void TwoPassScale<DataClass>::VertScale(PixelClass *pSrcData, const IntPoint& sr
             pDest = (PixelClass*)((char*)(pDest)+destStride);
         }
     } else {
-        LineContribType * pContrib = CalcContributions(destSize.y, srcSize.y);
-        for (int y = 0; y < destSize.y; y++) {
-            PixelClass * pDestPixel = pDest;
-            int * pWeights = pContrib->ContribRow[y].Weights;
-            int iLeft = pContrib->ContribRow[y].Left;
-            int iRight = pContrib->ContribRow[y].Right;
-            PixelClass* pSrcPixelBase = (PixelClass*)((char*)(pSrc)
-                    + size_t(iLeft)*srcStride);
-            for (int x = 0; x < destSize.x; x++) {
-                typename DataClass::_Accumulator a;
-                int * pWeight = pWeights;
-                PixelClass * pSrcPixel = pSrcPixelBase;
-                pSrcPixelBase++;
-                for (int i = iLeft; i <= iRight; i++) {
-                    // Scan between boundries
-                    // Accumulate weighted effect of each neighboring pixel
-                    a.Accumulate(*pWeight, *pSrcPixel);
-                    pWeight++;
-                    pSrcPixel = (PixelClass*)((char*)(pSrcPixel)+srcStride);
-                }
-                a.Store(pDestPixel);
-                pDestPixel++;
+        LineContribsPtr pContribs = getLineContribs(m_ContribDef, destSize.y, srcSize.y);
+        long long workPerRow =
+                (long long)(destSize.x)*(srcSize.y/destSize.y+1)*sizeof(PixelClass);
+        processRowsInParallel(destSize.y, workPerRow, m_MaxThreads,
+                boost::bind(&TwoPassScale::VertScaleRows, this, pSrcData, srcStride,
+                        pDestData, destSize.x, destStride, pContribs.get(), _1, _2));
+    }
+}
+
+template <class DataClass>
+void TwoPassScale<DataClass>::VertScaleRows(PixelClass *pSrcData, int srcStride,
+        PixelClass *pDestData, int destWidth, int destStride,
+        const LineContribs* pContribs, int startRow, int endRow)
+{
+    // Whole source rows are weighted and added up, so memory is accessed sequentially
+    // and all channels are handled the same way.
+    int numBytes = destWidth*sizeof(PixelClass);
+    std::vector<int> accum(numBytes);
+    PixelClass * pDest = (PixelClass*)((char*)(pDestData) + size_t(startRow)*destStride);
+    for (int y = startRow; y < endRow; y++) {
+        std::fill(accum.begin(), accum.end(), 0);
+        const short * pWeights = pContribs->getWeights(y);
+        int iLeft = pContribs->getLeft(y);
+        int iRight = pContribs->getRight(y);
+        for (int i = iLeft; i <= iRight; i += 2) {
+            const unsigned char * pSrc0 = (const unsigned char *)(pSrcData)
+                    + size_t(i)*srcStride;
+            if (i < iRight) {
+                accumulateRows(&accum[0], pSrc0, pWeights[i-iLeft], pSrc0+srcStride,
+                        pWeights[i+1-iLeft], numBytes, m_bUseSIMD);
+            } else {
+                accumulateRows(&accum[0], pSrc0, pWeights[i-iLeft], 0, 0, numBytes,
+                        m_bUseSIMD);
             }
-            pDest = (PixelClass*)((char*)(pDest)+destStride);
         }
-        FreeContributions(pContrib);     // Free contributions structure
+        storeAccumulatedRow(&accum[0], (unsigned char *)pDest, numBytes, m_bUseSIMD);
+        pDest = (PixelClass*)((char*)(pDest)+destStride);
     }
 }
 
 
 template <class DataClass>
-void TwoPassScale<DataClass>::Scale(PixelClass * pSrcData, const IntPoint& srcSize, 
+void TwoPassScale<DataClass>::Scale(PixelClass * pSrcData, const IntPoint& srcSize,
         int srcStride, PixelClass *pDstData, const IntPoint& dstSize, int dstStride)
 {
     // Allocate temp image
@@ -340,11 +452,11 @@ void TwoPassScale<DataClass>::Scale(PixelClass * pSrcData, const IntPoint& srcSi
     int tempStride = dstSize.x*sizeof(PixelClass);
 
     // Scale source image horizontally into temporary image
-    HorizScale(pSrcData, srcSize, srcStride, 
+    HorizScale(pSrcData, srcSize, srcStride,
             pTempData, tempSize, tempStride);
- 
+
     // Scale temporary image vertically into result image
-    VertScale (pTempData, tempSize, tempStride, 
+    VertScale (pTempData, tempSize, tempStride,
             pDstData, dstSize, dstStride);
     delete [] pTempData;
 }
@@ -352,4 +464,3 @@ void TwoPassScale<DataClass>::Scale(PixelClass * pSrcData, const IntPoint& srcSi
 }
 
 #endif
-
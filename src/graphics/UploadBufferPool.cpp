@@ -0,0 +1,252 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "UploadBufferPool.h"
+
+#include "GLContext.h"
+#include "OGLHelper.h"
+
+#include "../base/Exception.h"
+#include "../base/Logger.h"
+#include "../base/ScopeTimer.h"
+#include "../base/ObjectCounter.h"
+
+using namespace std;
+
+namespace avg {
+
+// Buffers allocated by a pool, including buffers in use. If this is exceeded, free
+// buffers are reused even if the GPU is still reading them.
+static const unsigned MAX_POOL_BYTES = 64*1024*1024;
+static const unsigned MIN_BUCKET_SIZE = 64*1024;
+
+static const string MEM_CATEGORY = "PBO pool";
+
+static ProfilingZoneID AllocProfilingZone("Upload buffer pool: alloc", true);
+static ProfilingZoneID StallProfilingZone("Upload buffer pool: stall", true);
+
+UploadBufferPool::UploadBufferPool()
+    : m_bUseFences(false),
+      m_NumBytesAllocated(0),
+      m_NumHits(0),
+      m_NumMisses(0),
+      m_NumStalls(0),
+      m_NumUploads(0),
+      m_NumBytesUploaded(0),
+      m_CopyTime(0)
+{
+}
+
+UploadBufferPool::~UploadBufferPool()
+{
+}
+
+void UploadBufferPool::init(bool bUseFences)
+{
+    m_bUseFences = bUseFences;
+}
+
+UploadBufferPool::Buffer UploadBufferPool::acquireBuffer(unsigned memNeeded, 
+        unsigned usage)
+{
+#ifdef AVG_ENABLE_EGL
+    // PBOs aren't used with GLES.
+    AVG_ASSERT(false);
+    return Buffer();
+#else
+    unsigned size = getBucketSize(memNeeded);
+    BufferQueue& freeBuffers = m_FreeBuffers[BucketKey(size, usage)];
+    if (!freeBuffers.empty()) {
+        Buffer& buffer = freeBuffers.front();
+        bool bIdle = isIdle(buffer);
+        if (bIdle || m_NumBytesAllocated+size > MAX_POOL_BYTES) {
+            if (!bIdle) {
+                ScopeTimer timer(StallProfilingZone);
+                waitForBuffer(buffer);
+                m_NumStalls++;
+            }
+            Buffer result = buffer;
+            freeBuffers.pop_front();
+            deleteFence(result);
+            if (!m_bUseFences) {
+                // Orphan the old storage so the driver doesn't need to synchronize.
+                glproc::BindBuffer(GL_PIXEL_UNPACK_BUFFER_EXT, result.m_ID);
+                glproc::BufferData(GL_PIXEL_UNPACK_BUFFER_EXT, size, 0, usage);
+                GLContext::checkError("UploadBufferPool: BufferData()");
+                glproc::BindBuffer(GL_PIXEL_UNPACK_BUFFER_EXT, 0);
+            }
+            m_NumHits++;
+            return result;
+        }
+    }
+
+    ScopeTimer timer(AllocProfilingZone);
+    Buffer buffer;
+    buffer.m_Size = size;
+    buffer.m_Usage = usage;
+    buffer.m_pFence = 0;
+    glproc::GenBuffers(1, &buffer.m_ID);
+    GLContext::checkError("UploadBufferPool: GenBuffers()");
+    glproc::BindBuffer(GL_PIXEL_UNPACK_BUFFER_EXT, buffer.m_ID);
+    glproc::BufferData(GL_PIXEL_UNPACK_BUFFER_EXT, size, 0, usage);
+    GLContext::checkError("UploadBufferPool: BufferData()");
+    glproc::BindBuffer(GL_PIXEL_UNPACK_BUFFER_EXT, 0);
+    m_NumBytesAllocated += size;
+    ObjectCounter::get()->incMemory(MEM_CATEGORY, size);
+    m_NumMisses++;
+    return buffer;
+#endif
+}
+
+void UploadBufferPool::releaseBuffer(Buffer& buffer)
+{
+    // Called after the texture upload from the buffer has been issued.
+    if (m_NumBytesAllocated > MAX_POOL_BYTES) {
+        deleteBuffer(buffer);
+        return;
+    }
+#ifndef AVG_ENABLE_EGL
+    if (m_bUseFences) {
+        buffer.m_pFence = glproc::FenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        GLContext::checkError("UploadBufferPool: FenceSync()");
+    }
+#endif
+    m_FreeBuffers[BucketKey(buffer.m_Size, buffer.m_Usage)].push_back(buffer);
+}
+
+void UploadBufferPool::countUpload(unsigned numBytes, long long copyTime)
+{
+    m_NumUploads++;
+    m_NumBytesUploaded += numBytes;
+    m_CopyTime += copyTime;
+}
+
+void UploadBufferPool::deleteBuffers()
+{
+    map<BucketKey, BufferQueue>::iterator it;
+    for (it = m_FreeBuffers.begin(); it != m_FreeBuffers.end(); ++it) {
+        BufferQueue& buffers = it->second;
+        for (unsigned i = 0; i < buffers.size(); ++i) {
+            deleteBuffer(buffers[i]);
+        }
+    }
+    m_FreeBuffers.clear();
+}
+
+void UploadBufferPool::dumpStatistics() const
+{
+    if (m_NumUploads > 0) {
+        float megabytes = float(m_NumBytesUploaded)/(1024*1024);
+        AVG_TRACE(Logger::category::PROFILE, Logger::severity::INFO,
+                "Texture uploads: " << m_NumUploads << ", " << megabytes << " MB");
+        if (m_CopyTime > 0) {
+            AVG_TRACE(Logger::category::PROFILE, Logger::severity::INFO,
+                    "  Upload copy bandwidth: " << megabytes/(m_CopyTime/1000000.f) 
+                    << " MB/s");
+        }
+        AVG_TRACE(Logger::category::PROFILE, Logger::severity::INFO,
+                "  Upload buffer pool: " << m_NumHits << " hits, " << m_NumMisses << 
+                " misses, " << m_NumStalls << " stalls");
+    }
+}
+
+int UploadBufferPool::getNumHits() const
+{
+    return m_NumHits;
+}
+
+int UploadBufferPool::getNumMisses() const
+{
+    return m_NumMisses;
+}
+
+int UploadBufferPool::getNumStalls() const
+{
+    return m_NumStalls;
+}
+
+unsigned UploadBufferPool::getNumBytesAllocated() const
+{
+    return m_NumBytesAllocated;
+}
+
+unsigned UploadBufferPool::getBucketSize(unsigned memNeeded)
+{
+    // Bucket sizes increase in steps of 1/8 of the next power of two, so less than
+    // 25% of a buffer is wasted.
+    unsigned powerOfTwo = MIN_BUCKET_SIZE;
+    while (powerOfTwo < memNeeded) {
+        powerOfTwo *= 2;
+    }
+    if (powerOfTwo == MIN_BUCKET_SIZE) {
+        return MIN_BUCKET_SIZE;
+    }
+    unsigned size = powerOfTwo/2;
+    while (size < memNeeded) {
+        size += powerOfTwo/8;
+    }
+    return size;
+}
+
+bool UploadBufferPool::isIdle(const Buffer& buffer) const
+{
+#ifndef AVG_ENABLE_EGL
+    if (buffer.m_pFence) {
+        GLenum rc = glproc::ClientWaitSync((GLsync)buffer.m_pFence, 0, 0);
+        return rc != GL_TIMEOUT_EXPIRED;
+    }
+#endif
+    return true;
+}
+
+void UploadBufferPool::waitForBuffer(const Buffer& buffer) const
+{
+#ifndef AVG_ENABLE_EGL
+    if (buffer.m_pFence) {
+        GLenum rc;
+        do {
+            rc = glproc::ClientWaitSync((GLsync)buffer.m_pFence, 
+                    GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+        } while (rc == GL_TIMEOUT_EXPIRED);
+    }
+#endif
+}
+
+void UploadBufferPool::deleteFence(Buffer& buffer)
+{
+#ifndef AVG_ENABLE_EGL
+    if (buffer.m_pFence) {
+        glproc::DeleteSync((GLsync)buffer.m_pFence);
+        buffer.m_pFence = 0;
+    }
+#endif
+}
+
+void UploadBufferPool::deleteBuffer(Buffer& buffer)
+{
+    deleteFence(buffer);
+    glproc::DeleteBuffers(1, &buffer.m_ID);
+    GLContext::checkError("UploadBufferPool: DeleteBuffers()");
+    m_NumBytesAllocated -= buffer.m_Size;
+    ObjectCounter::get()->decMemory(MEM_CATEGORY, buffer.m_Size);
+}
+
+}
@@ -0,0 +1,88 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _UploadBufferPool_H_
+#define _UploadBufferPool_H_
+
+#include "../api.h"
+
+#include <map>
+#include <deque>
+
+namespace avg {
+
+// Per-context pool of pixel unpack buffers used for texture uploads. Buffers are
+// grouped in size buckets and reused instead of being reallocated for every upload.
+// If the context supports sync objects, a fence is set after each upload and a buffer
+// is only handed out again once the GPU has consumed its contents. This lets the
+// uploads of consecutive frames overlap. Without fences, reused buffers are orphaned.
+class AVG_API UploadBufferPool {
+public:
+    struct Buffer {
+        unsigned m_ID;
+        unsigned m_Size;
+        unsigned m_Usage;
+        void* m_pFence;
+    };
+
+    UploadBufferPool();
+    virtual ~UploadBufferPool();
+
+    void init(bool bUseFences);
+
+    Buffer acquireBuffer(unsigned memNeeded, unsigned usage);
+    void releaseBuffer(Buffer& buffer);
+    void countUpload(unsigned numBytes, long long copyTime);
+
+    void deleteBuffers();
+    void dumpStatistics() const;
+
+    int getNumHits() const;
+    int getNumMisses() const;
+    int getNumStalls() const;
+    unsigned getNumBytesAllocated() const;
+
+private:
+    typedef std::pair<unsigned, unsigned> BucketKey;
+    typedef std::deque<Buffer> BufferQueue;
+
+    static unsigned getBucketSize(unsigned memNeeded);
+    bool isIdle(const Buffer& buffer) const;
+    void waitForBuffer(const Buffer& buffer) const;
+    void deleteFence(Buffer& buffer);
+    void deleteBuffer(Buffer& buffer);
+
+    bool m_bUseFences;
+    // Oldest released buffers first.
+    std::map<BucketKey, BufferQueue> m_FreeBuffers;
+    unsigned m_NumBytesAllocated;
+
+    int m_NumHits;
+    int m_NumMisses;
+    int m_NumStalls;
+    int m_NumUploads;
+    long long m_NumBytesUploaded;
+    long long m_CopyTime;
+};
+
+}
+
+#endif
@@ -28,8 +28,11 @@
 #include "../base/Exception.h"
 #include "../base/WideLine.h"
 #include "../base/ObjectCounter.h"
+#include "../base/ThreadHelper.h"
+#include "../base/ScopeTimer.h"
 
 #include <iostream>
+#include <limits>
 #include <stddef.h>
 #include <string.h>
 
@@ -42,8 +45,12 @@ const unsigned VertexArray::TEX_INDEX = 0;
 const unsigned VertexArray::POS_INDEX = 1;
 const unsigned VertexArray::COLOR_INDEX = 2;
 
+static ProfilingZoneID VAReallocProfilingZone("VA Transfer: realloc", true);
+
 VertexArray::VertexArray(int reserveVerts, int reserveIndexes)
-    : VertexData(reserveVerts, reserveIndexes)
+    : VertexData(reserveVerts, reserveIndexes),
+      m_NumBytesTransferred(0),
+      m_NumReallocations(0)
 {
     GLContext* pContext = GLContext::getCurrent();
     m_bUseMapBuffer = (!pContext->isGLES());
@@ -51,51 +58,100 @@ VertexArray::VertexArray(int reserveVerts, int reserveIndexes)
 
 void VertexArray::initForGLContext(GLContext* pContext)
 {
-    unsigned vertexBufferID;
-    unsigned indexBufferID;
-    AVG_ASSERT(m_VertexBufferIDMap.count(pContext) == 0);
-    AVG_ASSERT(m_IndexBufferIDMap.count(pContext) == 0);
-    glproc::GenBuffers(1, &vertexBufferID);
-    m_VertexBufferIDMap[pContext] = vertexBufferID;
-    glproc::GenBuffers(1, &indexBufferID);
-    m_IndexBufferIDMap[pContext] = indexBufferID;
+    AVG_ASSERT(m_ContextBuffers.count(pContext) == 0);
+    ContextBuffers& buffers = m_ContextBuffers[pContext];
+    for (unsigned i=0; i<NUM_BUFFER_SETS; ++i) {
+        glproc::GenBuffers(1, &buffers.m_Sets[i].m_VertexBufferID);
+        glproc::GenBuffers(1, &buffers.m_Sets[i].m_IndexBufferID);
+    }
 }
 
 VertexArray::~VertexArray()
 {
-    GLContextManager::get()->deleteBuffers(m_VertexBufferIDMap);
-    GLContextManager::get()->deleteBuffers(m_IndexBufferIDMap);
+    for (unsigned i=0; i<NUM_BUFFER_SETS; ++i) {
+        GLContextManager::BufferIDMap vertexBufferIDs;
+        GLContextManager::BufferIDMap indexBufferIDs;
+        ContextBufferMap::iterator it;
+        for (it=m_ContextBuffers.begin(); it!=m_ContextBuffers.end(); ++it) {
+            vertexBufferIDs[it->first] = it->second.m_Sets[i].m_VertexBufferID;
+            indexBufferIDs[it->first] = it->second.m_Sets[i].m_IndexBufferID;
+        }
+        GLContextManager::get()->deleteBuffers(vertexBufferIDs);
+        GLContextManager::get()->deleteBuffers(indexBufferIDs);
+    }
 }
 
 void VertexArray::update(GLContext* pContext)
 {
-    AVG_ASSERT(!m_VertexBufferIDMap.empty());
-    if (hasDataChanged()) {
-        unsigned vertexBufferID = m_VertexBufferIDMap[pContext];
-        transferBuffer(GL_ARRAY_BUFFER, vertexBufferID, 
-                getReserveVerts()*sizeof(Vertex), 
-                getNumVerts()*sizeof(Vertex), getVertexPointer());
-        unsigned indexBufferID = m_IndexBufferIDMap[pContext];
-#ifdef AVG_ENABLE_EGL        
-        transferBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferID, 
-                getReserveIndexes()*sizeof(unsigned short),
-                getNumIndexes()*sizeof(unsigned short), getIndexPointer());
-#else
-        transferBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferID, 
-                getReserveIndexes()*sizeof(unsigned int),
-                getNumIndexes()*sizeof(unsigned int), getIndexPointer());
-#endif
-        GLContext::checkError("VertexArray::update()");
+    AVG_ASSERT(!m_ContextBuffers.empty());
+    ContextBuffers& buffers = getContextBuffers(pContext);
+    BufferSet uploadSet;
+    bool bRealloc;
+    {
+        // Windows can be rendered in parallel threads, and all of them update the 
+        // same VertexArray.
+        lock_guard lock(m_Mutex);
+        if (hasDataChanged()) {
+            // Every buffer set in every context needs the changes eventually.
+            int vertStart, vertEnd, indexStart, indexEnd;
+            getDirtyVerts(vertStart, vertEnd);
+            getDirtyIndexes(indexStart, indexEnd);
+            ContextBufferMap::iterator it;
+            for (it=m_ContextBuffers.begin(); it!=m_ContextBuffers.end(); ++it) {
+                for (unsigned i=0; i<NUM_BUFFER_SETS; ++i) {
+                    it->second.m_Sets[i].addDirtyRange(vertStart, vertEnd, 
+                            indexStart, indexEnd);
+                }
+            }
+            resetDataChanged();
+        }
+        BufferSet& curSet = buffers.m_Sets[buffers.m_CurSet];
+        if (!curSet.isDirty() && curSet.m_VertexCapacity >= getReserveVerts() &&
+                curSet.m_IndexCapacity >= getReserveIndexes())
+        {
+            return;
+        }
+        buffers.m_CurSet = (buffers.m_CurSet+1) % NUM_BUFFER_SETS;
+        BufferSet& newSet = buffers.m_Sets[buffers.m_CurSet];
+        bRealloc = (newSet.m_VertexCapacity < getReserveVerts() || 
+                newSet.m_IndexCapacity < getReserveIndexes());
+        if (bRealloc) {
+            // Freshly allocated buffers need all valid data.
+            newSet.m_VertexCapacity = getReserveVerts();
+            newSet.m_IndexCapacity = getReserveIndexes();
+            newSet.m_DirtyVertStart = 0;
+            newSet.m_DirtyVertEnd = getNumValidVerts();
+            newSet.m_DirtyIndexStart = 0;
+            newSet.m_DirtyIndexEnd = getNumValidIndexes();
+            m_NumReallocations++;
+        }
+        uploadSet = newSet;
+        newSet.clearDirtyRange();
+        int numVerts = max(0, min(uploadSet.m_DirtyVertEnd, getNumValidVerts()) - 
+                uploadSet.m_DirtyVertStart);
+        int numIndexes = max(0, 
+                min(uploadSet.m_DirtyIndexEnd, getNumValidIndexes()) -
+                uploadSet.m_DirtyIndexStart);
+        m_NumBytesTransferred += numVerts*sizeof(Vertex) + 
+                numIndexes*sizeof(GL_INDEX_TYPE);
     }
+    // The upload itself doesn't touch shared state and runs unlocked.
+    if (bRealloc) {
+        ScopeTimer Timer(VAReallocProfilingZone);
+        transferBuffers(uploadSet, true);
+    } else {
+        transferBuffers(uploadSet, false);
+    }
+    GLContext::checkError("VertexArray::update()");
 }
 
 void VertexArray::activate(GLContext* pContext)
 {
-    AVG_ASSERT(!m_VertexBufferIDMap.empty());
-    unsigned vertexBufferID = m_VertexBufferIDMap[pContext];
-    unsigned indexBufferID = m_IndexBufferIDMap[pContext];
-    glproc::BindBuffer(GL_ARRAY_BUFFER, vertexBufferID);
-    glproc::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferID);
+    AVG_ASSERT(!m_ContextBuffers.empty());
+    ContextBuffers& buffers = getContextBuffers(pContext);
+    const BufferSet& curSet = buffers.m_Sets[buffers.m_CurSet];
+    glproc::BindBuffer(GL_ARRAY_BUFFER, curSet.m_VertexBufferID);
+    glproc::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, curSet.m_IndexBufferID);
     glproc::VertexAttribPointer(TEX_INDEX, 2, GL_FLOAT, GL_FALSE,
             sizeof(Vertex), (void *)(offsetof(Vertex, m_Tex)));
     glproc::VertexAttribPointer(POS_INDEX, 2, GL_FLOAT, GL_FALSE, 
@@ -136,24 +192,138 @@ void VertexArray::draw(unsigned startIndex, unsigned numIndexes, unsigned startV
     GLContext::checkError("VertexArray::draw()");
 }
 
+void VertexArray::drawInstanced(unsigned startIndex, unsigned numIndexes, 
+        int numInstances)
+{
+    glproc::DrawElementsInstanced(GL_TRIANGLES, numIndexes, 
+#ifdef AVG_ENABLE_EGL        
+            GL_UNSIGNED_SHORT,
+#else
+            GL_UNSIGNED_INT,
+#endif
+            (void *)(startIndex*sizeof(GL_INDEX_TYPE)), numInstances);
+    GLContext::checkError("VertexArray::drawInstanced()");
+}
+
 void VertexArray::startSubVA(SubVertexArray& subVA)
 {
     subVA.init(this, getNumVerts(), getNumIndexes());
 }
 
-void VertexArray::transferBuffer(GLenum target, unsigned bufferID, unsigned reservedSize, 
-        unsigned usedSize, const void* pData)
+#ifndef AVG_ENABLE_EGL
+void VertexArray::readBuffers(GLContext* pContext, vector<Vertex>& verts, 
+        vector<GL_INDEX_TYPE>& indexes)
+{
+    AVG_ASSERT(!pContext->isGLES());
+    ContextBuffers& buffers = getContextBuffers(pContext);
+    const BufferSet& curSet = buffers.m_Sets[buffers.m_CurSet];
+    verts.resize(getNumVerts());
+    indexes.resize(getNumIndexes());
+    if (!verts.empty()) {
+        glproc::BindBuffer(GL_ARRAY_BUFFER, curSet.m_VertexBufferID);
+        glproc::GetBufferSubData(GL_ARRAY_BUFFER, 0, verts.size()*sizeof(Vertex), 
+                &verts[0]);
+    }
+    if (!indexes.empty()) {
+        glproc::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, curSet.m_IndexBufferID);
+        glproc::GetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, 
+                indexes.size()*sizeof(GL_INDEX_TYPE), &indexes[0]);
+    }
+    GLContext::checkError("VertexArray::readBuffers()");
+}
+#endif
+
+void VertexArray::transferBuffers(const BufferSet& uploadSet, bool bRealloc)
+{
+    transferBuffer(GL_ARRAY_BUFFER, uploadSet.m_VertexBufferID, bRealloc,
+            uploadSet.m_VertexCapacity, uploadSet.m_DirtyVertStart, 
+            uploadSet.m_DirtyVertEnd, getNumValidVerts(), sizeof(Vertex),
+            getVertexPointer());
+    transferBuffer(GL_ELEMENT_ARRAY_BUFFER, uploadSet.m_IndexBufferID, bRealloc,
+            uploadSet.m_IndexCapacity, uploadSet.m_DirtyIndexStart, 
+            uploadSet.m_DirtyIndexEnd, getNumValidIndexes(), sizeof(GL_INDEX_TYPE),
+            getIndexPointer());
+}
+
+void VertexArray::transferBuffer(GLenum target, unsigned bufferID, bool bRealloc,
+        int capacity, int dirtyStart, int dirtyEnd, int numValid, int elementSize, 
+        const void* pData)
 {
+    dirtyEnd = min(dirtyEnd, numValid);
+    if (!bRealloc && dirtyEnd <= dirtyStart) {
+        return;
+    }
     glproc::BindBuffer(target, bufferID);
-    if (m_bUseMapBuffer) {
-        glproc::BufferData(target, reservedSize, 0, GL_STREAM_DRAW);
-        void * pBuffer = glproc::MapBuffer(target, GL_WRITE_ONLY);
-        memcpy(pBuffer, pData, usedSize);
-        glproc::UnmapBuffer(target);
+    const char* pBytes = (const char*)pData;
+    if (bRealloc || (dirtyEnd-dirtyStart)*2 > numValid) {
+        // Large updates: Orphan the old storage so the driver doesn't need to 
+        // synchronize with draw calls still using it.
+        if (m_bUseMapBuffer) {
+            glproc::BufferData(target, capacity*elementSize, 0, GL_DYNAMIC_DRAW);
+            void * pBuffer = glproc::MapBuffer(target, GL_WRITE_ONLY);
+            memcpy(pBuffer, pBytes, numValid*elementSize);
+            glproc::UnmapBuffer(target);
+        } else {
+            glproc::BufferData(target, capacity*elementSize, 0, GL_DYNAMIC_DRAW);
+            glproc::BufferSubData(target, 0, numValid*elementSize, pBytes);
+        }
     } else {
-        glproc::BufferData(target, usedSize, pData, GL_STREAM_DRAW);
+        glproc::BufferSubData(target, dirtyStart*elementSize, 
+                (dirtyEnd-dirtyStart)*elementSize, pBytes+dirtyStart*elementSize);
     }
 }
 
+VertexArray::BufferSet::BufferSet()
+    : m_VertexBufferID(0),
+      m_IndexBufferID(0),
+      m_VertexCapacity(0),
+      m_IndexCapacity(0)
+{
+    clearDirtyRange();
+}
+
+void VertexArray::BufferSet::addDirtyRange(int vertStart, int vertEnd, 
+        int indexStart, int indexEnd)
+{
+    m_DirtyVertStart = min(m_DirtyVertStart, vertStart);
+    m_DirtyVertEnd = max(m_DirtyVertEnd, vertEnd);
+    m_DirtyIndexStart = min(m_DirtyIndexStart, indexStart);
+    m_DirtyIndexEnd = max(m_DirtyIndexEnd, indexEnd);
+}
+
+void VertexArray::BufferSet::clearDirtyRange()
+{
+    m_DirtyVertStart = numeric_limits<int>::max();
+    m_DirtyVertEnd = 0;
+    m_DirtyIndexStart = numeric_limits<int>::max();
+    m_DirtyIndexEnd = 0;
+}
+
+bool VertexArray::BufferSet::isDirty() const
+{
+    return m_DirtyVertEnd > m_DirtyVertStart || m_DirtyIndexEnd > m_DirtyIndexStart;
 }
 
+VertexArray::ContextBuffers::ContextBuffers()
+    : m_CurSet(0)
+{
+}
+
+VertexArray::ContextBuffers& VertexArray::getContextBuffers(const GLContext* pContext)
+{
+    ContextBufferMap::iterator it = m_ContextBuffers.find(pContext);
+    AVG_ASSERT(it != m_ContextBuffers.end());
+    return it->second;
+}
+
+long long VertexArray::getNumBytesTransferred() const
+{
+    return m_NumBytesTransferred;
+}
+
+int VertexArray::getNumReallocations() const
+{
+    return m_NumReallocations;
+}
+
+}
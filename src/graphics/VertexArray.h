@@ -27,7 +27,9 @@
 #include "OGLHelper.h"
 
 #include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
 #include <map>
+#include <vector>
 
 namespace avg {
 
@@ -49,18 +51,59 @@ public:
     void draw(GLContext* pContext);
     void draw(unsigned startIndex, unsigned numIndexes, unsigned startVertex,
             unsigned numVertexes);
+    void drawInstanced(unsigned startIndex, unsigned numIndexes, int numInstances);
 
     void startSubVA(SubVertexArray& subVA);
 
+    long long getNumBytesTransferred() const;
+    int getNumReallocations() const;
+#ifndef AVG_ENABLE_EGL
+    // Reads back the buffers that are drawn from in pContext. Used by tests; desktop GL 
+    // only.
+    void readBuffers(GLContext* pContext, std::vector<Vertex>& verts, 
+            std::vector<GL_INDEX_TYPE>& indexes);
+#endif
+
 private:
-    void transferBuffer(GLenum target, unsigned bufferID, unsigned reservedSize, 
-            unsigned usedSize, const void* pData);
+    // Each context streams into two sets of buffers in turn, so a buffer is never 
+    // written while the GPU may still be drawing the previous frame from it.
+    static const unsigned NUM_BUFFER_SETS = 2;
+
+    struct BufferSet {
+        BufferSet();
+        void addDirtyRange(int vertStart, int vertEnd, int indexStart, int indexEnd);
+        void clearDirtyRange();
+        bool isDirty() const;
+
+        unsigned m_VertexBufferID;
+        unsigned m_IndexBufferID;
+        int m_VertexCapacity;
+        int m_IndexCapacity;
+        int m_DirtyVertStart;
+        int m_DirtyVertEnd;
+        int m_DirtyIndexStart;
+        int m_DirtyIndexEnd;
+    };
+    struct ContextBuffers {
+        ContextBuffers();
+
+        BufferSet m_Sets[NUM_BUFFER_SETS];
+        unsigned m_CurSet;
+    };
+
+    ContextBuffers& getContextBuffers(const GLContext* pContext);
+    void transferBuffers(const BufferSet& uploadSet, bool bRealloc);
+    void transferBuffer(GLenum target, unsigned bufferID, bool bRealloc, 
+            int capacity, int dirtyStart, int dirtyEnd, int numValid, 
+            int elementSize, const void* pData);
 
-    typedef std::map<const GLContext*, unsigned> BufferIDMap;
-    BufferIDMap m_VertexBufferIDMap;
-    BufferIDMap m_IndexBufferIDMap;
+    typedef std::map<const GLContext*, ContextBuffers> ContextBufferMap;
+    ContextBufferMap m_ContextBuffers;
+    boost::mutex m_Mutex;
 
     bool m_bUseMapBuffer;
+    long long m_NumBytesTransferred;
+    int m_NumReallocations;
 };
 
 typedef boost::shared_ptr<VertexArray> VertexArrayPtr;
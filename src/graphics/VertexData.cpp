@@ -28,6 +28,7 @@
 #include "../base/ObjectCounter.h"
 
 #include <iostream>
+#include <limits>
 #include <stddef.h>
 #include <string.h>
 
@@ -45,12 +46,15 @@ glm::vec2 Vertex::posAsVec()
 
 }
 
+static const string MEM_CATEGORY = "Vertex array reserve";
+
 VertexData::VertexData(int reserveVerts, int reserveIndexes)
     : m_NumVerts(0),
       m_NumIndexes(0),
       m_ReserveVerts(reserveVerts),
       m_ReserveIndexes(reserveIndexes),
-      m_bDataChanged(true)
+      m_NumValidVerts(0),
+      m_NumValidIndexes(0)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
     if (m_ReserveVerts < MIN_VERTEXES) {
@@ -62,13 +66,15 @@ VertexData::VertexData(int reserveVerts, int reserveIndexes)
     
     m_pVertexData = new Vertex[m_ReserveVerts];
     m_pIndexData = new GL_INDEX_TYPE[m_ReserveIndexes];
-
+    ObjectCounter::get()->incMemory(MEM_CATEGORY, getMemReserved());
+    resetDataChanged();
 }
 
 VertexData::~VertexData()
 {
     delete[] m_pVertexData;
     delete[] m_pIndexData;
+    ObjectCounter::get()->decMemory(MEM_CATEGORY, getMemReserved());
     ObjectCounter::get()->decRef(&typeid(*this));
 }
 
@@ -78,13 +84,13 @@ void VertexData::appendPos(const glm::vec2& pos, const glm::vec2& texPos,
     if (m_NumVerts >= m_ReserveVerts-1) {
         grow();
     }
-    Vertex* pVertex = &(m_pVertexData[m_NumVerts]);
-    pVertex->m_Pos[0] = (GLfloat)(pos.x);
-    pVertex->m_Pos[1] = (GLfloat)(pos.y);
-    pVertex->m_Tex[0] = (GLfloat)(texPos.x);
-    pVertex->m_Tex[1] = (GLfloat)(texPos.y);
-    pVertex->m_Color = color;
-    m_bDataChanged = true;
+    Vertex vertex;
+    vertex.m_Pos[0] = (GLfloat)(pos.x);
+    vertex.m_Pos[1] = (GLfloat)(pos.y);
+    vertex.m_Tex[0] = (GLfloat)(texPos.x);
+    vertex.m_Tex[1] = (GLfloat)(texPos.y);
+    vertex.m_Color = color;
+    setVertex(m_NumVerts, vertex);
     m_NumVerts++;
 }
 
@@ -93,9 +99,9 @@ void VertexData::appendTriIndexes(int v0, int v1, int v2)
     if (m_NumIndexes >= m_ReserveIndexes-3) {
         grow();
     }
-    m_pIndexData[m_NumIndexes] = v0;
-    m_pIndexData[m_NumIndexes+1] = v1;
-    m_pIndexData[m_NumIndexes+2] = v2;
+    setIndex(m_NumIndexes, v0);
+    setIndex(m_NumIndexes+1, v1);
+    setIndex(m_NumIndexes+2, v2);
     m_NumIndexes += 3;
 }
 
@@ -104,12 +110,12 @@ void VertexData::appendQuadIndexes(int v0, int v1, int v2, int v3)
     if (m_NumIndexes >= m_ReserveIndexes-6) {
         grow();
     }
-    m_pIndexData[m_NumIndexes] = v0;
-    m_pIndexData[m_NumIndexes+1] = v1;
-    m_pIndexData[m_NumIndexes+2] = v2;
-    m_pIndexData[m_NumIndexes+3] = v1;
-    m_pIndexData[m_NumIndexes+4] = v2;
-    m_pIndexData[m_NumIndexes+5] = v3;
+    setIndex(m_NumIndexes, v0);
+    setIndex(m_NumIndexes+1, v1);
+    setIndex(m_NumIndexes+2, v2);
+    setIndex(m_NumIndexes+3, v1);
+    setIndex(m_NumIndexes+4, v2);
+    setIndex(m_NumIndexes+5, v3);
     m_NumIndexes += 6;
 }
 
@@ -135,30 +141,34 @@ void VertexData::appendVertexData(const VertexDataPtr& pVertexes)
         grow();
     }
 
-    memcpy(&(m_pVertexData[oldNumVerts]), pVertexes->m_pVertexData, 
-            pVertexes->getNumVerts()*sizeof(Vertex));
+    int numVerts = pVertexes->getNumVerts();
+    for (int i=0; i<numVerts; ++i) {
+        setVertex(oldNumVerts+i, pVertexes->m_pVertexData[i]);
+    }
     int numIndexes = pVertexes->getNumIndexes();
     for (int i=0; i<numIndexes; ++i) {
-        m_pIndexData[oldNumIndexes+i] = pVertexes->m_pIndexData[i] + oldNumVerts;
+        setIndex(oldNumIndexes+i, pVertexes->m_pIndexData[i] + oldNumVerts);
     }
-    m_bDataChanged = true;
 }
 
 bool VertexData::hasDataChanged() const
 {
-    return m_bDataChanged;
+    return m_DirtyVertStart < m_DirtyVertEnd || m_DirtyIndexStart < m_DirtyIndexEnd;
 }
 
 void VertexData::resetDataChanged()
 {
-    m_bDataChanged = false;
+    m_DirtyVertStart = numeric_limits<int>::max();
+    m_DirtyVertEnd = 0;
+    m_DirtyIndexStart = numeric_limits<int>::max();
+    m_DirtyIndexEnd = 0;
 }
 
 void VertexData::reset()
 {
+    // The old data stays valid until it's overwritten, so the dirty ranges are kept.
     m_NumVerts = 0;
     m_NumIndexes = 0;
-    m_bDataChanged = false;
 }
 
 FRect VertexData::calcBoundingRect() const
@@ -206,9 +216,8 @@ void VertexData::dump(unsigned startVertex, int numVerts, unsigned startIndex,
 
 void VertexData::grow()
 {
-    bool bChanged = false;
+    long long oldMemReserved = getMemReserved();
     if (m_NumVerts >= m_ReserveVerts-1) {
-        bChanged = true;
         int oldReserveVerts = m_ReserveVerts;
         m_ReserveVerts = int(m_ReserveVerts*1.5);
 #ifdef AVG_ENABLE_EGL
@@ -226,7 +235,6 @@ void VertexData::grow()
         delete[] pVertexData;
     }
     if (m_NumIndexes >= m_ReserveIndexes-6) {
-        bChanged = true;
         int oldReserveIndexes = m_ReserveIndexes;
         m_ReserveIndexes = int(m_ReserveIndexes*1.5);
         if (m_ReserveIndexes < m_NumIndexes) {
@@ -237,8 +245,34 @@ void VertexData::grow()
         memcpy(m_pIndexData, pIndexData, sizeof(GL_INDEX_TYPE)*oldReserveIndexes);
         delete[] pIndexData;
     }
-    if (bChanged) {
-        m_bDataChanged = true;
+    ObjectCounter::get()->decMemory(MEM_CATEGORY, oldMemReserved);
+    ObjectCounter::get()->incMemory(MEM_CATEGORY, getMemReserved());
+}
+
+long long VertexData::getMemReserved() const
+{
+    return (long long)m_ReserveVerts*sizeof(Vertex) + 
+            (long long)m_ReserveIndexes*sizeof(GL_INDEX_TYPE);
+}
+
+void VertexData::setVertex(int i, const Vertex& vertex)
+{
+    Vertex* pVertex = &(m_pVertexData[i]);
+    if (i >= m_NumValidVerts || memcmp(pVertex, &vertex, sizeof(Vertex)) != 0) {
+        *pVertex = vertex;
+        m_DirtyVertStart = min(m_DirtyVertStart, i);
+        m_DirtyVertEnd = max(m_DirtyVertEnd, i+1);
+        m_NumValidVerts = max(m_NumValidVerts, i+1);
+    }
+}
+
+void VertexData::setIndex(int i, GL_INDEX_TYPE index)
+{
+    if (i >= m_NumValidIndexes || m_pIndexData[i] != index) {
+        m_pIndexData[i] = index;
+        m_DirtyIndexStart = min(m_DirtyIndexStart, i);
+        m_DirtyIndexEnd = max(m_DirtyIndexEnd, i+1);
+        m_NumValidIndexes = max(m_NumValidIndexes, i+1);
     }
 }
 
@@ -262,6 +296,28 @@ int VertexData::getReserveIndexes() const
     return m_ReserveIndexes;
 }
 
+int VertexData::getNumValidVerts() const
+{
+    return m_NumValidVerts;
+}
+
+int VertexData::getNumValidIndexes() const
+{
+    return m_NumValidIndexes;
+}
+
+void VertexData::getDirtyVerts(int& start, int& end) const
+{
+    start = m_DirtyVertStart;
+    end = m_DirtyVertEnd;
+}
+
+void VertexData::getDirtyIndexes(int& start, int& end) const
+{
+    start = m_DirtyIndexStart;
+    end = m_DirtyIndexEnd;
+}
+
 std::ostream& operator<<(std::ostream& os, const Vertex& v)
 {
     os << "  ((" << v.m_Pos[0] << ", " << v.m_Pos[1] << "), (" 
@@ -79,12 +79,19 @@ public:
 protected:
     int getReserveVerts() const;
     int getReserveIndexes() const;
+    int getNumValidVerts() const;
+    int getNumValidIndexes() const;
+    void getDirtyVerts(int& start, int& end) const;
+    void getDirtyIndexes(int& start, int& end) const;
 
     static const int MIN_VERTEXES;
     static const int MIN_INDEXES;
 
 private:
     void grow();
+    long long getMemReserved() const;
+    void setVertex(int i, const Vertex& vertex);
+    void setIndex(int i, GL_INDEX_TYPE index);
 
     int m_NumVerts;
     int m_NumIndexes;
@@ -93,7 +100,14 @@ private:
     Vertex * m_pVertexData;
     GL_INDEX_TYPE * m_pIndexData;
 
-    bool m_bDataChanged;
+    // reset() keeps the old contents. Data that is appended again unchanged doesn't
+    // make the array dirty, so only the parts that really changed are uploaded.
+    int m_NumValidVerts;
+    int m_NumValidIndexes;
+    int m_DirtyVertStart;
+    int m_DirtyVertEnd;
+    int m_DirtyIndexStart;
+    int m_DirtyIndexEnd;
 };
 
 std::ostream& operator<<(std::ostream& os, const Vertex& v);
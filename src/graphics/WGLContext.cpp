@@ -64,7 +64,7 @@ void registerWindowClass()
 }
 
 WGLContext::WGLContext(const GLConfig& glConfig, const IntPoint& windowSize, 
-        const SDL_SysWMinfo* pSDLWMInfo)
+        const SDL_SysWMinfo* pSDLWMInfo, WGLContext* pSharedContext)
     : GLContext(windowSize)
 {
     bool bOwnsContext;
@@ -73,6 +73,10 @@ WGLContext::WGLContext(const GLConfig& glConfig, const IntPoint& windowSize,
         m_Context = wglGetCurrentContext();
         setCurrent();
         bOwnsContext = false;
+        if (pSharedContext) {
+            // SDL has already created the context with sharing enabled.
+            setShareGroup(pSharedContext);
+        }
     } else {
         registerWindowClass();
         m_hwnd = CreateWindow("GL", "GL",
@@ -98,6 +102,13 @@ WGLContext::WGLContext(const GLConfig& glConfig, const IntPoint& windowSize,
         SetPixelFormat(m_hDC, iFormat, &pfd);
         m_Context = wglCreateContext(m_hDC);
         checkWinError(m_Context != 0, "wglCreateContext");
+        if (pSharedContext) {
+            if (wglShareLists(pSharedContext->m_Context, m_Context)) {
+                setShareGroup(pSharedContext);
+            } else {
+                AVG_LOG_WARNING("Creating shared OpenGL context failed.");
+            }
+        }
         bOwnsContext = true;
     }
 
@@ -121,6 +132,13 @@ void WGLContext::activate()
     setCurrent();
 }
 
+void WGLContext::deactivate()
+{
+    BOOL bOk = wglMakeCurrent(0, 0);
+    checkWinError(bOk, "wglMakeCurrent");
+    clearCurrent();
+}
+
 void WGLContext::swapBuffers()
 {
     BOOL bOk = SwapBuffers(m_hDC);
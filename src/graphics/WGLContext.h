@@ -34,10 +34,11 @@ class AVG_API WGLContext: public GLContext
 {
 public:
     WGLContext(const GLConfig& glConfig, const IntPoint& windowSize=IntPoint(0,0), 
-            const SDL_SysWMinfo* pSDLWMInfo=0);
+            const SDL_SysWMinfo* pSDLWMInfo=0, WGLContext* pSharedContext=0);
     virtual ~WGLContext();
 
     void activate();
+    void deactivate();
     void swapBuffers();
 
 private:
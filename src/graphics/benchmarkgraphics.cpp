@@ -36,8 +36,11 @@
 #include "FilterGauss.h"
 #include "FilterBlur.h"
 #include "FilterBandpass.h"
+#include "FilterResizeBilinear.h"
+#include "FilterResizeGaussian.h"
 
 #include "../base/TimeSource.h"
+#include "../base/StringHelper.h"
 
 #include <iostream>
 #include <stdio.h>
@@ -233,6 +236,46 @@ private:
         
 };
 
+// Thumbnail-sized downscale of a camera-sized image. THREADS=1 is the single-threaded
+// baseline, THREADS=0 uses all cores. SIMD=false measures the scalar code.
+template<PixelFormat PF, int THREADS, bool SIMD=true>
+class ResizeBilinearPerfTest: public PerfTestBase {
+public:
+    ResizeBilinearPerfTest() 
+        : PerfTestBase(string("ResizeBilinearPerfTest(")+getPixelFormatString(PF)+", "+
+                toString(THREADS)+" threads"+(SIMD ? "" : ", scalar")+")")
+    {
+        m_pBmp = BitmapPtr(new Bitmap(IntPoint(2048, 1536), PF));
+    }
+
+    void run()
+    {
+        FilterResizeBilinear(IntPoint(256, 192), THREADS, SIMD).apply(m_pBmp);
+    }
+
+private:
+    BitmapPtr m_pBmp;
+};
+
+template<PixelFormat PF, int THREADS, bool SIMD=true>
+class ResizeGaussianPerfTest: public PerfTestBase {
+public:
+    ResizeGaussianPerfTest() 
+        : PerfTestBase(string("ResizeGaussianPerfTest(")+getPixelFormatString(PF)+", "+
+                toString(THREADS)+" threads"+(SIMD ? "" : ", scalar")+")")
+    {
+        m_pBmp = BitmapPtr(new Bitmap(IntPoint(2048, 1536), PF));
+    }
+
+    void run()
+    {
+        FilterResizeGaussian(IntPoint(1024, 768), 1.2f, THREADS, SIMD).apply(m_pBmp);
+    }
+
+private:
+    BitmapPtr m_pBmp;
+};
+
 void runPerformanceTests()
 {
     runPerformanceTest<LoadPNGPerfTest>();
@@ -244,6 +287,18 @@ void runPerformanceTests()
     runPerformanceTest<CopyRGBPerfTest>();
     runPerformanceTest<CopyRGBAPerfTest>();
     runPerformanceTest<YUV2RGBPerfTest>(200);
+    runPerformanceTest<ResizeBilinearPerfTest<B8G8R8A8, 1, false> >(20);
+    runPerformanceTest<ResizeBilinearPerfTest<B8G8R8A8, 1> >(20);
+    runPerformanceTest<ResizeBilinearPerfTest<B8G8R8A8, 0> >(20);
+    runPerformanceTest<ResizeBilinearPerfTest<B8G8R8, 1, false> >(20);
+    runPerformanceTest<ResizeBilinearPerfTest<B8G8R8, 1> >(20);
+    runPerformanceTest<ResizeBilinearPerfTest<B8G8R8, 0> >(20);
+    runPerformanceTest<ResizeBilinearPerfTest<I8, 1, false> >(20);
+    runPerformanceTest<ResizeBilinearPerfTest<I8, 1> >(20);
+    runPerformanceTest<ResizeBilinearPerfTest<I8, 0> >(20);
+    runPerformanceTest<ResizeGaussianPerfTest<B8G8R8A8, 1, false> >(20);
+    runPerformanceTest<ResizeGaussianPerfTest<B8G8R8A8, 1> >(20);
+    runPerformanceTest<ResizeGaussianPerfTest<B8G8R8A8, 0> >(20);
 }
 
 int main(int nargs, char** args)
@@ -0,0 +1,47 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2011 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+uniform mat4 transform;
+attribute vec2 a_Pos;
+attribute vec2 a_TexCoord;
+attribute vec2 a_InstancePos;
+attribute vec2 a_InstanceSize;
+attribute float a_InstanceAngle;
+attribute vec4 a_InstanceColor;
+
+varying vec2 v_TexCoord;
+varying vec4 v_Color;
+varying float v_EdgeScale;
+
+// a_Pos is a corner of the unit quad. It's scaled, rotated and moved to the instance
+// position here.
+void main(void)
+{
+    vec2 offset = (a_Pos-vec2(0.5, 0.5))*a_InstanceSize;
+    float s = sin(a_InstanceAngle);
+    float c = cos(a_InstanceAngle);
+    vec2 pos = a_InstancePos + vec2(offset.x*c - offset.y*s, offset.x*s + offset.y*c);
+    gl_Position = transform * vec4(pos, 0, 1);
+    v_TexCoord = a_TexCoord;
+    v_Color = a_InstanceColor;
+    v_EdgeScale = max(a_InstanceSize.x, a_InstanceSize.y);
+}
+
@@ -37,6 +37,7 @@
 #include "PBO.h"
 #include "ImageCache.h"
 #include "CachedImage.h"
+#include "VertexArray.h"
 
 #include "../base/TestSuite.h"
 #include "../base/Exception.h"
@@ -46,6 +47,7 @@
 #include "../base/OSHelper.h"
 
 #include <math.h>
+#include <string.h>
 #include <iostream>
 
 #include <glib-object.h>
@@ -366,6 +368,10 @@ public:
         runMipmapTest(MM_OGL, "rgb24-64x64");
         runMipmapTest(MM_OGL, "rgb24alpha-64x64");
         runMipmapTest(MM_OGL, "rgb24-65x65");
+        if (GLContext::getCurrent()->getMemoryMode() == MM_PBO) {
+            runUploadBufferPoolTest("rgb24-64x64", "rgb24alpha-64x64");
+        }
+        runRectUploadTest("rgb24-64x64", "rgb24alpha-64x64");
     }
 
 private:
@@ -419,6 +425,66 @@ private:
         testEqual(*pResultBmp, *pBaselineBmp, sName, 7, 15);
     }
 
+    void runUploadBufferPoolTest(const string& sFName1, const string& sFName2)
+    {
+        cerr << "    Testing upload buffer pool" << endl;
+        BitmapPtr pBmp1 = loadTestBmp(sFName1, B8G8R8A8);
+        BitmapPtr pBmp2 = loadTestBmp(sFName2, B8G8R8A8);
+        GLContextManager* pCM = GLContextManager::get();
+        MCTexturePtr pMCTex = pCM->createTextureFromBmp(pBmp1);
+        pCM->uploadData();
+        GLContext* pContext = GLContext::getCurrent();
+        GLTexturePtr pTex = pMCTex->getTex(pContext);
+
+        // Once the GPU is done with an upload, the next upload of the same size must
+        // reuse its buffer.
+        UploadBufferPool& pool = pContext->getUploadBufferPool();
+        glFinish();
+        int numHits = pool.getNumHits();
+        unsigned numBytesAllocated = pool.getNumBytesAllocated();
+        pTex->moveBmpToTexture(pBmp2);
+        TEST(pool.getNumHits() == numHits+1);
+        TEST(pool.getNumBytesAllocated() == numBytesAllocated);
+        BitmapPtr pDestBmp = pTex->moveTextureToBmp();
+        testEqual(*pDestBmp, *pBmp2, "upload-pool-2", 0.01, 0.1);
+
+        glFinish();
+        pTex->moveBmpToTexture(pBmp1);
+        TEST(pool.getNumHits() == numHits+2);
+        pDestBmp = pTex->moveTextureToBmp();
+        testEqual(*pDestBmp, *pBmp1, "upload-pool-1", 0.01, 0.1);
+    }
+
+    void runRectUploadTest(const string& sFName1, const string& sFName2)
+    {
+        cerr << "    Testing dirty rect uploads" << endl;
+        BitmapPtr pBmp1 = loadTestBmp(sFName1, B8G8R8A8);
+        BitmapPtr pBmp2 = loadTestBmp(sFName2, B8G8R8A8);
+        GLContextManager* pCM = GLContextManager::get();
+        MCTexturePtr pMCTex = pCM->createTextureFromBmp(pBmp1);
+        pCM->uploadData();
+        GLTexturePtr pTex = pMCTex->getTex(GLContext::getCurrent());
+
+        IntRect rect(13, 7, 45, 31);
+        pTex->moveBmpRectToTexture(pBmp2, rect);
+        BitmapPtr pBaselineBmp(new Bitmap(*pBmp1));
+        Bitmap(*pBaselineBmp, rect).copyPixels(Bitmap(*pBmp2, rect));
+        BitmapPtr pDestBmp = pTex->moveTextureToBmp();
+        testEqual(*pDestBmp, *pBaselineBmp, "rect-upload", 0.01, 0.1);
+
+        // Overlapping dirty rects are merged, the other one is uploaded separately.
+        pCM->scheduleTexUpload(pMCTex, pBmp1, IntRect(0, 0, 20, 20));
+        pCM->scheduleTexUpload(pMCTex, pBmp1, IntRect(10, 10, 30, 30));
+        pCM->scheduleTexUpload(pMCTex, pBmp1, IntRect(50, 50, 64, 64));
+        pCM->uploadData();
+        IntRect mergedRect(0, 0, 30, 30);
+        Bitmap(*pBaselineBmp, mergedRect).copyPixels(Bitmap(*pBmp1, mergedRect));
+        IntRect cornerRect(50, 50, 64, 64);
+        Bitmap(*pBaselineBmp, cornerRect).copyPixels(Bitmap(*pBmp1, cornerRect));
+        pDestBmp = pTex->moveTextureToBmp();
+        testEqual(*pDestBmp, *pBaselineBmp, "rect-upload-scheduled", 0.01, 0.1);
+    }
+
     void runCompressionTest(OGLMemoryMode memoryMode, const string& sFName)
     {
         cerr << "    Testing B5G6R5 compression, " << sFName << ", " << 
@@ -505,6 +571,166 @@ private:
 };
 
 
+// Exposes the dirty ranges of VertexData.
+class TestVertexArray: public VertexArray {
+public:
+    using VertexData::getDirtyVerts;
+    using VertexData::getDirtyIndexes;
+};
+
+class VertexArrayTest: public GraphicsTest {
+public:
+    VertexArrayTest()
+        : GraphicsTest("VertexArrayTest", 2)
+    {
+    }
+
+    void runTests()
+    {
+        GLContext* pContext = GLContext::getCurrent();
+        TestVertexArray va;
+        va.initForGLContext(pContext);
+        int start;
+        int end;
+
+        appendQuads(va, 10);
+        va.update(pContext);
+        TEST(!va.hasDataChanged());
+        testBuffers(va, pContext);
+
+        // Unchanged data appended after reset() doesn't dirty the array.
+        va.reset();
+        appendQuads(va, 10);
+        TEST(!va.hasDataChanged());
+
+        // Changes are merged into one range per buffer.
+        va.reset();
+        appendQuads(va, 10, 2, 7);
+        TEST(va.hasDataChanged());
+        va.getDirtyVerts(start, end);
+        TEST(start == 8 && end == 32);
+        va.getDirtyIndexes(start, end);
+        TEST(start >= end);
+        va.update(pContext);
+        TEST(!va.hasDataChanged());
+        testBuffers(va, pContext);
+
+        // The second buffer set needs the changes of both updates.
+        va.reset();
+        appendQuads(va, 10, 5);
+        va.getDirtyVerts(start, end);
+        TEST(start == 8 && end == 32);
+        va.update(pContext);
+        testBuffers(va, pContext);
+        va.reset();
+        appendQuads(va, 10, 5);
+        TEST(!va.hasDataChanged());
+        va.update(pContext);
+        testBuffers(va, pContext);
+
+        // Growing keeps the dirty range and the data.
+        va.reset();
+        appendQuads(va, 60, 3);
+        va.getDirtyVerts(start, end);
+        TEST(start == 12 && end == 240);
+        va.getDirtyIndexes(start, end);
+        TEST(start == 60 && end == 360);
+        va.update(pContext);
+        testBuffers(va, pContext);
+        va.reset();
+        appendQuads(va, 60, 59);
+        va.update(pContext);
+        testBuffers(va, pContext);
+
+        // resetDataChanged() clears the dirty ranges.
+        va.reset();
+        appendQuads(va, 60, 0);
+        TEST(va.hasDataChanged());
+        va.resetDataChanged();
+        TEST(!va.hasDataChanged());
+        va.getDirtyVerts(start, end);
+        TEST(start >= end);
+    }
+
+private:
+    void appendQuads(VertexArray& va, int numQuads, int changedQuad1=-1, 
+            int changedQuad2=-1)
+    {
+        for (int i=0; i<numQuads; ++i) {
+            float x = float(i);
+            if (i == changedQuad1 || i == changedQuad2) {
+                x += 100;
+            }
+            Pixel32 color(i, 255-i, 0, 255);
+            int v = va.getNumVerts();
+            va.appendPos(glm::vec2(x, 0), glm::vec2(0, 0), color);
+            va.appendPos(glm::vec2(x+1, 0), glm::vec2(1, 0), color);
+            va.appendPos(glm::vec2(x, 1), glm::vec2(0, 1), color);
+            va.appendPos(glm::vec2(x+1, 1), glm::vec2(1, 1), color);
+            va.appendQuadIndexes(v+1, v, v+3, v+2);
+        }
+    }
+
+    void testBuffers(VertexArray& va, GLContext* pContext)
+    {
+#ifndef AVG_ENABLE_EGL
+        if (pContext->isGLES()) {
+            return;
+        }
+        vector<Vertex> verts;
+        vector<GL_INDEX_TYPE> indexes;
+        va.readBuffers(pContext, verts, indexes);
+        TEST(memcmp(&verts[0], va.getVertexPointer(), verts.size()*sizeof(Vertex)) 
+                == 0);
+        TEST(memcmp(&indexes[0], va.getIndexPointer(), 
+                indexes.size()*sizeof(GL_INDEX_TYPE)) == 0);
+#endif
+    }
+};
+
+
+class SharedContextTest: public GraphicsTest {
+public:
+    SharedContextTest()
+        : GraphicsTest("SharedContextTest", 2)
+    {
+    }
+
+    void runTests()
+    {
+        GLContextManager* pCM = GLContextManager::get();
+        GLContext* pMainContext = GLContext::getCurrent();
+        GLContext* pContext = pCM->createContext(pMainContext->getConfig(), 
+                IntPoint(0,0), 0, pMainContext);
+        // Sharing isn't guaranteed, but textures need to work either way.
+        bool bShared = (pContext->getShareGroup() == pMainContext);
+        cerr << "    Context sharing supported: " << bShared << endl;
+        if (bShared) {
+            TEST(pCM->getNumShareGroups() == 1);
+        } else {
+            TEST(pCM->getNumShareGroups() == 2);
+        }
+        pMainContext->activate();
+
+        BitmapPtr pOrigBmp = loadTestBmp("rgb24-64x64", B8G8R8A8);
+        MCTexturePtr pMCTex = pCM->createTextureFromBmp(pOrigBmp);
+        pCM->uploadData();
+        GLTexturePtr pTex = pMCTex->getTex(pContext);
+        TEST((pMCTex->getTex(pMainContext) == pTex) == bShared);
+        pContext->activate();
+        BitmapPtr pDestBmp = pTex->moveTextureToBmp();
+        testEqual(*pDestBmp, *pOrigBmp, "shared-context", 0.01, 0.1);
+
+        pTex = GLTexturePtr();
+        pMCTex = MCTexturePtr();
+        pMainContext->activate();
+        pCM->uploadData();
+        delete pContext;
+        pMainContext->activate();
+    }
+};
+
+
 class GPUTestSuite: public TestSuite {
 public:
     GPUTestSuite(const string& sVariant) 
@@ -512,6 +738,8 @@ public:
     {
         addTest(TestPtr(new TextureMoverTest));
         addTest(TestPtr(new ImageCacheTest));
+        addTest(TestPtr(new SharedContextTest));
+        addTest(TestPtr(new VertexArrayTest));
         addTest(TestPtr(new BrightnessFilterTest));
         addTest(TestPtr(new HueSatFilterTest));
         addTest(TestPtr(new InvertFilterTest));
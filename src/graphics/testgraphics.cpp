@@ -39,6 +39,7 @@
 #include "FilterBlur.h"
 #include "FilterBandpass.h"
 #include "FilterFastDownscale.h"
+#include "FilterMipmapLevel.h"
 #include "FilterMask.h"
 #include "FilterThreshold.h"
 #include "FilterFloodfill.h"
@@ -46,6 +47,7 @@
 #include "FilterErosion.h"
 #include "FilterGetAlpha.h"
 #include "FilterResizeBilinear.h"
+#include "FilterResizeGaussian.h"
 #include "FilterUnmultiplyAlpha.h"
 
 #include "../base/TestSuite.h"
@@ -817,6 +819,48 @@ public:
     }
 };
 
+class FilterMipmapLevelTest: public GraphicsTest {
+public:
+    FilterMipmapLevelTest()
+        : GraphicsTest("FilterMipmapLevelTest", 2)
+    {
+    }
+
+    void runTests()
+    {
+        BitmapPtr pBmp(new Bitmap(IntPoint(5,3), I8));
+        BitmapPtr pDestBmp = FilterMipmapLevel().apply(pBmp);
+        TEST(pDestBmp->getSize() == IntPoint(2,1));
+        pDestBmp = FilterMipmapLevel().apply(pDestBmp);
+        TEST(pDestBmp->getSize() == IntPoint(1,1));
+        pDestBmp = FilterMipmapLevel().apply(pDestBmp);
+        TEST(pDestBmp->getSize() == IntPoint(1,1));
+
+        // A black and white checkerboard averages to 50% linear intensity, which is
+        // about 188 in sRGB.
+        pBmp = BitmapPtr(new Bitmap(IntPoint(4,4), B8G8R8A8));
+        for (int y = 0; y < 4; ++y) {
+            for (int x = 0; x < 4; ++x) {
+                unsigned char val = ((x+y)%2)*255;
+                pBmp->setPixel(IntPoint(x,y), Pixel32(val, val, val, 255));
+            }
+        }
+        pDestBmp = FilterMipmapLevel().apply(pBmp);
+        TEST(pDestBmp->getSize() == IntPoint(2,2));
+        Pixel32 pixel = pDestBmp->getPythonPixel(glm::vec2(1,1));
+        TEST(abs(int(pixel.getR())-188) <= 1);
+        TEST(pixel.getA() == 255);
+
+        // Fully transparent pixels don't contribute to the color.
+        pBmp->setPixel(IntPoint(0,0), Pixel32(0, 0, 0, 0));
+        pBmp->setPixel(IntPoint(1,1), Pixel32(0, 0, 0, 0));
+        pDestBmp = FilterMipmapLevel().apply(pBmp);
+        pixel = pDestBmp->getPythonPixel(glm::vec2(0,0));
+        TEST(pixel.getR() == 255);
+        TEST(abs(int(pixel.getA())-128) <= 1);
+    }
+};
+
 class FilterMaskTest: public GraphicsTest {
 public:
     FilterMaskTest()
@@ -951,6 +995,13 @@ public:
         runTestWithBitmap(pBmp);
         pBmp = loadTestBmp("rgb24-65x65", B8G8R8);
         runTestWithBitmap(pBmp);
+        runThreadsTest(pBmp);
+        runSIMDTest(pBmp);
+        pBmp = loadTestBmp("rgb24alpha-64x64", B8G8R8A8);
+        runThreadsTest(pBmp);
+        runSIMDTest(pBmp);
+        runThreadsTest(FilterGrayscale().apply(pBmp));
+        runSIMDTest(FilterGrayscale().apply(pBmp));
     }
 
 private:
@@ -962,6 +1013,35 @@ private:
         testEqual(*pDestBmp, sName, pBmp->getPixelFormat());
     }
 
+    void runThreadsTest(BitmapPtr pBmp)
+    {
+        // Bitmaps this size are split between threads. The result must be the same.
+        BitmapPtr pBigBmp = FilterResizeBilinear(IntPoint(1023,1025)).apply(pBmp);
+        BitmapPtr pSingleBmp = FilterResizeBilinear(IntPoint(301,199), 1).apply(pBigBmp);
+        BitmapPtr pMultiBmp = FilterResizeBilinear(IntPoint(301,199), 4).apply(pBigBmp);
+        TEST(*pSingleBmp == *pMultiBmp);
+        pSingleBmp = FilterResizeGaussian(IntPoint(701,499), 1.2f, 1).apply(pBigBmp);
+        pMultiBmp = FilterResizeGaussian(IntPoint(701,499), 1.2f, 4).apply(pBigBmp);
+        TEST(*pSingleBmp == *pMultiBmp);
+    }
+
+    void runSIMDTest(BitmapPtr pBmp)
+    {
+        // The sizes give filter windows of many different widths, so the remainders
+        // of the SSE2 loops are exercised as well. Results must be identical.
+        static const IntPoint sizes[] = {IntPoint(1,1), IntPoint(3,5), IntPoint(5,3), 
+                IntPoint(9,13), IntPoint(21,31), IntPoint(31,63), IntPoint(63,21), 
+                IntPoint(67,65), IntPoint(131,97)};
+        for (unsigned i = 0; i < sizeof(sizes)/sizeof(sizes[0]); ++i) {
+            BitmapPtr pSIMDBmp = FilterResizeBilinear(sizes[i], 1, true).apply(pBmp);
+            BitmapPtr pScalarBmp = FilterResizeBilinear(sizes[i], 1, false).apply(pBmp);
+            TEST(*pSIMDBmp == *pScalarBmp);
+            pSIMDBmp = FilterResizeGaussian(sizes[i], 1.7f, 1, true).apply(pBmp);
+            pScalarBmp = FilterResizeGaussian(sizes[i], 1.7f, 1, false).apply(pBmp);
+            TEST(*pSIMDBmp == *pScalarBmp);
+        }
+    }
+
 };
 
 class FilterUnmultiplyAlphaTest: public GraphicsTest {
@@ -1020,6 +1100,7 @@ public:
         addTest(TestPtr(new FilterBlurTest));
         addTest(TestPtr(new FilterBandpassTest));
         addTest(TestPtr(new FilterFastDownscaleTest));
+        addTest(TestPtr(new FilterMipmapLevelTest));
         addTest(TestPtr(new FilterMaskTest));
         addTest(TestPtr(new FilterThresholdTest));
         addTest(TestPtr(new FilterFloodfillTest));
@@ -25,6 +25,7 @@
 #include "CursorEvent.h"
 #include "MouseEvent.h"
 #include "DivNode.h"
+#include "Canvas.h"
 #include "ArgList.h"
 #include "TypeDefinition.h"
 #include "TypeRegistry.h"
@@ -51,6 +52,14 @@ using namespace std;
 
 namespace avg {
 
+static bool rectsOverlap(const FRect& cullRect, const FRect& bounds)
+{
+    if (cullRect.width() <= 0 || cullRect.height() <= 0) {
+        return false;
+    }
+    return cullRect.intersects(bounds);
+}
+
 void AreaNode::registerType()
 {
     TypeDefinition def = TypeDefinition("areanode", "node")
@@ -247,6 +256,14 @@ void AreaNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive,
     Node::preRender(pVA, bIsParentActive, parentEffectiveOpacity);
     if (isVisible()) {
         calcTransform();
+        DivNode* pParent = getParentPtr();
+        if (pParent) {
+            m_CanvasTransform = pParent->getCanvasTransform()*m_LocalTransform;
+            m_CullRect = pParent->getChildCullRect();
+        } else {
+            m_CanvasTransform = m_LocalTransform;
+            m_CullRect = getCanvas()->getVisibleRect();
+        }
     }
 }
 
@@ -254,6 +271,16 @@ void AreaNode::maybeRender(GLContext* pContext, const glm::mat4& parentTransform
 {
     AVG_ASSERT(getState() == NS_CANRENDER);
     if (isVisible()) {
+        FRect bounds;
+        if (getLocalRenderBounds(bounds)) {
+            CanvasPtr pCanvas = getCanvas();
+            FRect cullRect = m_CullRect;
+            cullRect.intersect(pCanvas->getRenderCullRect(pContext));
+            if (!rectsOverlap(cullRect, localToCanvasBounds(bounds))) {
+                pCanvas->countCulledNode(pContext);
+                return;
+            }
+        }
         render(pContext, parentTransform*m_LocalTransform);
     }
 }
@@ -340,6 +367,45 @@ Pixel32 AreaNode::getEffectiveOutlineColor(Pixel32 parentColor) const
     }
 }
 
+const glm::mat4& AreaNode::getCanvasTransform() const
+{
+    return m_CanvasTransform;
+}
+
+const FRect& AreaNode::getCullRect() const
+{
+    return m_CullRect;
+}
+
+bool AreaNode::getLocalRenderBounds(FRect& bounds)
+{
+    // Nodes that can't determine what they draw are never culled.
+    return false;
+}
+
+FRect AreaNode::localToCanvasBounds(const FRect& localRect) const
+{
+    glm::vec2 corners[4] = {localRect.tl, glm::vec2(localRect.br.x, localRect.tl.y),
+            localRect.br, glm::vec2(localRect.tl.x, localRect.br.y)};
+    glm::vec4 pt = m_CanvasTransform*glm::vec4(corners[0], 0, 1);
+    FRect canvasRect(pt.x, pt.y, pt.x, pt.y);
+    for (int i = 1; i < 4; ++i) {
+        pt = m_CanvasTransform*glm::vec4(corners[i], 0, 1);
+        canvasRect.expand(glm::vec2(pt.x, pt.y));
+    }
+    return canvasRect;
+}
+
+bool AreaNode::isCulled()
+{
+    FRect bounds;
+    if (getLocalRenderBounds(bounds)) {
+        return !rectsOverlap(m_CullRect, localToCanvasBounds(bounds));
+    } else {
+        return false;
+    }
+}
+
 void AreaNode::calcTransform()
 {
     if (m_bTransformChanged) {
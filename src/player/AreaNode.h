@@ -100,10 +100,16 @@ class AVG_API AreaNode: public Node
         virtual IntPoint getMediaSize() 
             { return IntPoint(0,0); };
 
+        const glm::mat4& getCanvasTransform() const;
+        const FRect& getCullRect() const;
+        virtual bool getLocalRenderBounds(FRect& bounds);
+
     protected:
         AreaNode(const std::string& sPublisherName);
         glm::vec2 getUserSize() const;
         Pixel32 getEffectiveOutlineColor(Pixel32 parentColor) const;
+        FRect localToCanvasBounds(const FRect& localRect) const;
+        bool isCulled();
 
     private:
         void calcTransform();
@@ -118,6 +124,10 @@ class AVG_API AreaNode: public Node
         glm::vec2 m_UserSize;
         glm::mat4 m_LocalTransform;
         bool m_bTransformChanged;
+
+        // Updated in preRender and used to skip nodes that can't be seen.
+        glm::mat4 m_CanvasTransform;
+        FRect m_CullRect;         // Canvas area the node can be visible in.
 };
 
 }
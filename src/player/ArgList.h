@@ -29,6 +29,8 @@
 #include "BoostPython.h"
 #include "Arg.h"
 
+#include "../base/Exception.h"
+
 #include <libxml/parser.h>
 
 #include <string>
@@ -53,6 +55,8 @@ public:
    
     template<class T>
     const T& getArgVal(const std::string& sName) const;
+    template<class T>
+    void setArgVal(const std::string& sName, const T& value);
     
     void getOverlayedArgVal(glm::vec2* pResult, const std::string& sName,
             const std::string& sOverlay1, const std::string& sOverlay2,
@@ -65,9 +69,9 @@ public:
     void setMembers(ExportedObject * pObj) const;
     
     void copyArgsFrom(const ArgList& argTemplates);
+    void setArgValue(const std::string & sName, const py::object& value);
 
 private:
-    void setArgValue(const std::string & sName, const py::object& value);
     void setArgValue(const std::string & sName, const std::string & sValue);
     ArgMap m_Args;
 };
@@ -77,6 +81,16 @@ const T& ArgList::getArgVal(const std::string& sName) const
 {
     return (dynamic_cast<Arg<T>* >(&*getArg(sName)))->getValue();
 }
+
+template<class T>
+void ArgList::setArgVal(const std::string& sName, const T& value)
+{
+    Arg<T>* pArg = dynamic_cast<Arg<T>* >(&*getArg(sName));
+    if (!pArg) {
+        throw Exception(AVG_ERR_INVALID_ARGS, "Type error in argument "+sName+".");
+    }
+    pArg->setValue(value);
+}
     
 
 }
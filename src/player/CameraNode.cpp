@@ -369,7 +369,7 @@ void CameraNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive,
     }
 }
 
-static ProfilingZoneID CameraProfilingZone("Camera::render");
+static ProfilingZoneID CameraProfilingZone("Camera::render", true);
 
 void CameraNode::render(GLContext* pContext, const glm::mat4& transform)
 {
@@ -30,6 +30,7 @@
 #include "../base/Exception.h"
 #include "../base/Logger.h"
 #include "../base/ScopeTimer.h"
+#include "../base/FramePhaseTimer.h"
 
 #include "../graphics/StandardShader.h"
 #include "../graphics/GLContextManager.h"
@@ -49,7 +50,8 @@ Canvas::Canvas(Player * pPlayer)
       m_PlaybackEndSignal(&IPlaybackEndListener::onPlaybackEnd),
       m_FrameEndSignal(&IFrameEndListener::onFrameEnd),
       m_PreRenderSignal(&IPreRenderListener::onPreRender),
-      m_ClipLevel(0)
+      m_TotalCulledNodes(0),
+      m_NumCullingFrames(0)
 {
 }
 
@@ -85,6 +87,7 @@ void Canvas::stopPlayback(bool bIsAbort)
         m_IDMap.clear();
         m_bIsPlaying = false;
         m_pVertexArray = VertexArrayPtr();
+        m_WindowRenderStates.clear();
     }
 }
 
@@ -148,6 +151,7 @@ void Canvas::doFrame(bool bPythonAvailable)
     emitPreRenderSignal();
     if (!m_pPlayer->isStopping()) {
         ScopeTimer Timer(RenderProfilingZone);
+        FramePhaseTimer phaseTimer(FramePhaseTimer::RENDER);
         Player::get()->startTraversingTree();
         if (bPythonAvailable) {
             Py_BEGIN_ALLOW_THREADS;
@@ -172,23 +176,23 @@ IntPoint Canvas::getSize() const
 {
     return IntPoint(m_pRootNode->getSize());
 }
-static ProfilingZoneID PushClipRectProfilingZone("pushClipRect");
+static ProfilingZoneID PushClipRectProfilingZone("pushClipRect", true);
 
 void Canvas::pushClipRect(GLContext* pContext, const glm::mat4& transform,
         SubVertexArray& va)
 {
     ScopeTimer timer(PushClipRectProfilingZone);
-    m_ClipLevel++;
+    getWindowRenderState(pContext).m_ClipLevel++;
     clip(pContext, transform, va, GL_INCR);
 }
 
-static ProfilingZoneID PopClipRectProfilingZone("popClipRect");
+static ProfilingZoneID PopClipRectProfilingZone("popClipRect", true);
 
 void Canvas::popClipRect(GLContext* pContext, const glm::mat4& transform,
         SubVertexArray& va)
 {
     ScopeTimer timer(PopClipRectProfilingZone);
-    m_ClipLevel--;
+    getWindowRenderState(pContext).m_ClipLevel--;
     clip(pContext, transform, va, GL_DECR);
 }
 
@@ -233,36 +237,77 @@ Player* Canvas::getPlayer() const
 }
 
 static ProfilingZoneID PreRenderProfilingZone("PreRender");
-static ProfilingZoneID VATransferProfilingZone("VA Transfer");
+static ProfilingZoneID ParallelPreRenderProfilingZone("PreRender: parallel phase");
+
+// Below this, the overhead of waking up the threads is larger than the gain.
+static const unsigned MIN_PARALLEL_PRERENDER_JOBS = 16;
+static ProfilingZoneID VATransferProfilingZone("VA Transfer", true);
 
 void Canvas::preRender()
 {
     ScopeTimer Timer(PreRenderProfilingZone);
+    FramePhaseTimer phaseTimer(FramePhaseTimer::PRERENDER);
     m_pVertexArray->reset();
     createStdSubVA();
+    WindowRenderStateMap::iterator it;
+    for (it = m_WindowRenderStates.begin(); it != m_WindowRenderStates.end(); ++it) {
+        m_TotalCulledNodes += it->second.m_NumCulledNodes;
+        it->second.m_NumCulledNodes = 0;
+    }
+    m_NumCullingFrames++;
+    if (m_pPlayer->hasPreRenderThreads()) {
+        ScopeTimer Timer(ParallelPreRenderProfilingZone);
+        vector<Node*> pNodes;
+        m_pRootNode->collectPreRenderJobs(pNodes);
+        if (pNodes.size() >= MIN_PARALLEL_PRERENDER_JOBS) {
+            m_pPlayer->preRenderInThreads(pNodes);
+        }
+    }
     m_pRootNode->preRender(m_pVertexArray, true, 1.0f);
 }
 
-static ProfilingZoneID RootRenderProfilingZone("RootNode: render");
+static ProfilingZoneID RootRenderProfilingZone("RootNode: render", true);
 
 void Canvas::renderWindow(WindowPtr pWindow, MCFBOPtr pFBO, const IntRect& viewport)
 {
     GLContext* pContext = pWindow->getGLContext();
     pContext->activate();
+    prepareWindowRender(pContext);
+    renderWindowContents(pWindow, pFBO, viewport);
+}
 
+void Canvas::prepareWindowRender(GLContext* pContext)
+{
     GLContextManager::get()->uploadDataForContext();
     renderFX(pContext);
+    m_WindowRenderStates.insert(make_pair(pContext, WindowRenderState()));
+}
+
+void Canvas::renderWindowContents(WindowPtr pWindow, MCFBOPtr pFBO, 
+        const IntRect& viewport)
+{
+    GLContext* pContext = pWindow->getGLContext();
+    WindowRenderState& state = getWindowRenderState(pContext);
+    state.m_ClipLevel = 0;
     glm::mat4 projMat;
     if (pFBO) {
         pFBO->activate(pContext);
         glm::vec2 size = m_pRootNode->getSize();
         projMat = glm::ortho(0.f, size.x, 0.f, size.y);
+        state.m_CullRect = FRect(glm::vec2(0,0), size);
         glViewport(0, 0, GLsizei(size.x), GLsizei(size.y));
         glFrontFace(GL_CW);
     } else {
-        glproc::BindFramebuffer(GL_FRAMEBUFFER, 0);
+        MCFBOPtr pRenderTarget = pWindow->getRenderTarget();
+        if (pRenderTarget) {
+            // Headless window: Same projection as a window, but rendered offscreen.
+            pRenderTarget->activate(pContext);
+        } else {
+            glproc::BindFramebuffer(GL_FRAMEBUFFER, 0);
+        }
         projMat = glm::ortho(float(viewport.tl.x), float(viewport.br.x), 
                 float(viewport.br.y), float(viewport.tl.y));
+        state.m_CullRect = FRect(viewport);
         IntPoint windowSize = pWindow->getSize();
         glViewport(0, 0, windowSize.x, windowSize.y);
         glFrontFace(GL_CCW);
@@ -292,10 +337,60 @@ SubVertexArray& Canvas::getStdSubVA()
     return m_StdSubVA;
 }
 
+FRect Canvas::getVisibleRect() const
+{
+    return FRect(glm::vec2(0,0), m_pRootNode->getSize());
+}
+
+const FRect& Canvas::getRenderCullRect(GLContext* pContext) const
+{
+    return getWindowRenderState(pContext).m_CullRect;
+}
+
+void Canvas::countCulledNode(GLContext* pContext)
+{
+    getWindowRenderState(pContext).m_NumCulledNodes++;
+}
+
+int Canvas::getNumCulledNodes() const
+{
+    int numCulledNodes = 0;
+    WindowRenderStateMap::const_iterator it;
+    for (it = m_WindowRenderStates.begin(); it != m_WindowRenderStates.end(); ++it) {
+        numCulledNodes += it->second.m_NumCulledNodes;
+    }
+    return numCulledNodes;
+}
+
+void Canvas::dumpCullingStatistics() const
+{
+    if (m_NumCullingFrames > 0) {
+        AVG_TRACE(Logger::category::PROFILE, Logger::severity::INFO,
+                "Culled nodes per frame: " << 
+                float(m_TotalCulledNodes+getNumCulledNodes())/m_NumCullingFrames);
+    }
+}
+
+void Canvas::dumpVATransferStatistics() const
+{
+    if (m_pVertexArray && m_NumCullingFrames > 0) {
+        AVG_TRACE(Logger::category::PROFILE, Logger::severity::INFO,
+                "Vertex bytes transferred per frame: " << 
+                float(m_pVertexArray->getNumBytesTransferred())/m_NumCullingFrames <<
+                ", vertex buffer reallocations: " << 
+                m_pVertexArray->getNumReallocations());
+    }
+}
+
 void Canvas::renderOutlines(GLContext* pContext, const glm::mat4& transform)
 {
-    VertexArrayPtr pVA = GLContextManager::get()->createVertexArray();
-    pVA->initForGLContext(pContext);
+    WindowRenderState& state = getWindowRenderState(pContext);
+    if (!state.m_pOutlineVA) {
+        state.m_pOutlineVA = VertexArrayPtr(new VertexArray());
+        state.m_pOutlineVA->initForGLContext(pContext);
+    }
+    VertexArrayPtr pVA = state.m_pOutlineVA;
+    pVA->reset();
     pContext->setBlendMode(GLContext::BLEND_BLEND, false);
     m_pRootNode->renderOutlines(pVA, Pixel32(0,0,0,0));
     StandardShader* pShader = pContext->getStandardShader();
@@ -337,6 +432,27 @@ void Canvas::resetFXSchedule()
 }
 
 
+Canvas::WindowRenderState::WindowRenderState()
+    : m_ClipLevel(0),
+      m_NumCulledNodes(0)
+{
+}
+
+Canvas::WindowRenderState& Canvas::getWindowRenderState(const GLContext* pContext)
+{
+    WindowRenderStateMap::iterator it = m_WindowRenderStates.find(pContext);
+    AVG_ASSERT(it != m_WindowRenderStates.end());
+    return it->second;
+}
+
+const Canvas::WindowRenderState& Canvas::getWindowRenderState(
+        const GLContext* pContext) const
+{
+    WindowRenderStateMap::const_iterator it = m_WindowRenderStates.find(pContext);
+    AVG_ASSERT(it != m_WindowRenderStates.end());
+    return it->second;
+}
+
 void Canvas::clip(GLContext* pContext, const glm::mat4& transform, SubVertexArray& va,
         GLenum stencilOp)
 {
@@ -357,7 +473,7 @@ void Canvas::clip(GLContext* pContext, const glm::mat4& transform, SubVertexArra
     va.draw();
 
     // Set stencil test
-    glStencilFunc(GL_LEQUAL, m_ClipLevel, ~0);
+    glStencilFunc(GL_LEQUAL, getWindowRenderState(pContext).m_ClipLevel, ~0);
     glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 
     // Disable drawing to stencil buffer
@@ -103,9 +103,19 @@ class AVG_API Canvas: public ExportedObject
 
         virtual void renderWindow(WindowPtr pWindow, MCFBOPtr pFBO, 
                 const IntRect& viewport);
+        void prepareWindowRender(GLContext* pContext);
+        void renderWindowContents(WindowPtr pWindow, MCFBOPtr pFBO, 
+                const IntRect& viewport);
         void scheduleFXRender(const RasterNodePtr& pNode);
         SubVertexArray& getStdSubVA();
 
+        virtual FRect getVisibleRect() const;
+        const FRect& getRenderCullRect(GLContext* pContext) const;
+        void countCulledNode(GLContext* pContext);
+        int getNumCulledNodes() const;
+        void dumpCullingStatistics() const;
+        void dumpVATransferStatistics() const;
+
     protected:
         Player * getPlayer() const;
         void preRender();
@@ -121,6 +131,21 @@ class AVG_API Canvas: public ExportedObject
 
         void clip(GLContext* pContext, const glm::mat4& transform, SubVertexArray& va,
                 GLenum stencilOp);
+
+        // State of one render pass. Windows can be rendered in parallel, so this is 
+        // kept per context.
+        struct WindowRenderState {
+            WindowRenderState();
+
+            FRect m_CullRect;
+            int m_ClipLevel;
+            int m_NumCulledNodes;
+            // Reused every frame so the outline buffers don't get reallocated.
+            VertexArrayPtr m_pOutlineVA;
+        };
+        WindowRenderState& getWindowRenderState(const GLContext* pContext);
+        const WindowRenderState& getWindowRenderState(const GLContext* pContext) const;
+
         Player * m_pPlayer;
         CanvasNodePtr m_pRootNode;
         bool m_bIsPlaying;
@@ -135,9 +160,13 @@ class AVG_API Canvas: public ExportedObject
         Signal<IPreRenderListener> m_PreRenderSignal;
 
         int m_MultiSampleSamples;
-        int m_ClipLevel;
 
         std::vector<RasterNodePtr> m_pScheduledFXNodes;
+
+        typedef std::map<const GLContext*, WindowRenderState> WindowRenderStateMap;
+        WindowRenderStateMap m_WindowRenderStates;
+        long long m_TotalCulledNodes;
+        long long m_NumCullingFrames;
 };
 
 }
@@ -26,12 +26,14 @@
 #include "Player.h"
 #include "PublisherDefinition.h"
 #include "NodeChain.h"
+#include "ICursorListener.h"
 
 #include "../base/Exception.h"
 #include "../base/StringHelper.h"
 #include "../base/Logger.h"
 
 #include <iostream>
+#include <algorithm>
 
 using namespace std;
 
@@ -70,6 +72,21 @@ int Contact::connectListener(PyObject* pMotionCallback, PyObject* pUpCallback)
     return s_LastListenerID;
 }
 
+void Contact::registerCursorListener(ICursorListener* pListener)
+{
+    AVG_ASSERT(find(m_CursorListeners.begin(), m_CursorListeners.end(), pListener) ==
+            m_CursorListeners.end());
+    m_CursorListeners.push_back(pListener);
+}
+
+void Contact::unregisterCursorListener(ICursorListener* pListener)
+{
+    vector<ICursorListener*>::iterator it = 
+            find(m_CursorListeners.begin(), m_CursorListeners.end(), pListener);
+    AVG_ASSERT(it != m_CursorListeners.end());
+    m_CursorListeners.erase(it);
+}
+
 void Contact::disconnectListener(int id)
 {
     avgDeprecationWarning("1.8", "Contact.disconnectListener()", 
@@ -133,6 +150,9 @@ void Contact::addEvent(CursorEventPtr pEvent)
 
 void Contact::sendEventToListeners(CursorEventPtr pCursorEvent)
 {
+    if (!m_CursorListeners.empty()) {
+        sendEventToCursorListeners(pCursorEvent);
+    }
     switch (pCursorEvent->getType()) {
         case Event::CURSOR_DOWN:
             break;
@@ -179,6 +199,35 @@ void Contact::sendEventToListeners(CursorEventPtr pCursorEvent)
     m_bSendingEvents = false;
 }
 
+void Contact::sendEventToCursorListeners(CursorEventPtr pCursorEvent)
+{
+    // Listeners can unregister other listeners, so we check that each listener is
+    // still registered before calling it.
+    vector<ICursorListener*> listeners = m_CursorListeners;
+    for (unsigned i=0; i<listeners.size(); ++i) {
+        if (find(m_CursorListeners.begin(), m_CursorListeners.end(), listeners[i]) ==
+                m_CursorListeners.end())
+        {
+            continue;
+        }
+        switch (pCursorEvent->getType()) {
+            case Event::CURSOR_DOWN:
+                break;
+            case Event::CURSOR_MOTION:
+                listeners[i]->onCursorMotion(pCursorEvent);
+                break;
+            case Event::CURSOR_UP:
+                listeners[i]->onCursorUp(pCursorEvent);
+                break;
+            default:
+                AVG_ASSERT_MSG(false, pCursorEvent->typeStr().c_str());
+        }
+    }
+    if (pCursorEvent->getType() == Event::CURSOR_UP) {
+        m_CursorListeners.clear();
+    }
+}
+
 void Contact::setNodeChain(NodeChainPtr pNodeChain)
 {
     m_pNodeChain = pNodeChain;
@@ -45,6 +45,7 @@ class NodeChain;
 typedef boost::shared_ptr<class NodeChain> NodeChainPtr;
 class Node;
 typedef boost::shared_ptr<class Node> NodePtr;
+class ICursorListener;
 
 class AVG_API Contact: public Publisher {
 public:
@@ -54,6 +55,8 @@ public:
 
     int connectListener(PyObject* pMotionCallback, PyObject* pUpCallback);
     void disconnectListener(int id);
+    void registerCursorListener(ICursorListener* pListener);
+    void unregisterCursorListener(ICursorListener* pListener);
 
     long long getAge() const;
     float getDistanceFromStart() const;
@@ -72,6 +75,7 @@ public:
     int getID() const;
     
 private:
+    void sendEventToCursorListeners(CursorEventPtr pCursorEvent);
     void calcSpeed(CursorEventPtr pEvent, CursorEventPtr pOldEvent);
     void updateDistanceTravelled(CursorEventPtr pEvent1, CursorEventPtr pEvent2);
     void dumpListeners(std::string sFuncName);
@@ -91,6 +95,7 @@ private:
 
     static int s_LastListenerID;
     std::map<int, Listener> m_ListenerMap;
+    std::vector<ICursorListener*> m_CursorListeners;
     int m_CurListenerID;
     bool m_bCurListenerIsDead;
     int m_CursorID;
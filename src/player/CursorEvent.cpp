@@ -42,7 +42,10 @@ CursorEvent::CursorEvent(int id, Type eventType, const IntPoint& pos, Source sou
       m_ID(id),
       m_UserID(-1),
       m_JointID(-1),
-      m_Speed(0,0)
+      m_Speed(0,0),
+      m_bFiltered(false),
+      m_FilteredPos(0,0),
+      m_FilteredSpeed(0,0)
 {
 }
 
@@ -68,6 +71,7 @@ CursorEventPtr CursorEvent::cloneAs(Type eventType, const glm::vec2& pos) const
 {
     CursorEventPtr pClone = cloneAs(eventType);
     pClone->m_Pos = IntPoint(pos);
+    pClone->m_bFiltered = false;
     return pClone;
 }
 
@@ -137,6 +141,36 @@ const glm::vec2& CursorEvent::getSpeed() const
     return m_Speed;
 }
 
+void CursorEvent::setFilteredState(const glm::vec2& pos, const glm::vec2& speed)
+{
+    m_bFiltered = true;
+    m_FilteredPos = pos;
+    m_FilteredSpeed = speed;
+}
+
+bool CursorEvent::isFiltered() const
+{
+    return m_bFiltered;
+}
+
+glm::vec2 CursorEvent::getFilteredPos() const
+{
+    if (m_bFiltered) {
+        return m_FilteredPos;
+    } else {
+        return getPos();
+    }
+}
+
+const glm::vec2& CursorEvent::getFilteredSpeed() const
+{
+    if (m_bFiltered) {
+        return m_FilteredSpeed;
+    } else {
+        return getSpeed();
+    }
+}
+
 void CursorEvent::setContact(ContactPtr pContact)
 {
     m_pContact = pContact;
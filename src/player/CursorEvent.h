@@ -69,6 +69,12 @@ class AVG_API CursorEvent: public Event
         NodePtr getNode() const;
         void setSpeed(glm::vec2 speed);
         virtual const glm::vec2& getSpeed() const;
+        // Set by the input device if jitter filtering is enabled. Otherwise, the
+        // getters return the unfiltered position and speed.
+        void setFilteredState(const glm::vec2& pos, const glm::vec2& speed);
+        bool isFiltered() const;
+        glm::vec2 getFilteredPos() const;
+        const glm::vec2& getFilteredSpeed() const;
 
         void setContact(ContactPtr pContact);
         ContactPtr getContact() const;
@@ -84,6 +90,9 @@ class AVG_API CursorEvent: public Event
         int m_JointID;
         NodePtr m_pNode;
         glm::vec2 m_Speed;
+        bool m_bFiltered;
+        glm::vec2 m_FilteredPos;
+        glm::vec2 m_FilteredSpeed;
 };
 
 bool operator ==(const CursorEvent& event1, const CursorEvent& event2);
@@ -28,11 +28,16 @@
 #include "DisplayParams.h"
 #include "SDLWindow.h"
 #include "SecondaryWindow.h"
+#include "HeadlessWindow.h"
 
 #include "../base/Exception.h"
 #include "../base/Logger.h"
+#include "../base/ConfigMgr.h"
+#include "../base/StringHelper.h"
 #include "../base/ScopeTimer.h"
+#include "../base/FramePhaseTimer.h"
 #include "../base/TimeSource.h"
+#include "../base/OSHelper.h"
 
 #include "../graphics/Display.h"
 #include "../graphics/BitmapLoader.h"
@@ -46,6 +51,7 @@
 #endif
 
 #include <boost/pointer_cast.hpp>
+#include <boost/bind.hpp>
 #include <SDL2/SDL.h>
 
 #ifdef __APPLE__
@@ -72,10 +78,24 @@ namespace avg {
 
 void DisplayEngine::initSDL()
 {
+#if defined(__linux__) && !defined(AVG_ENABLE_RPI)
+    // Xlib needs to know about render threads before the display is opened.
+    // Parallel rendering can be switched on after this, so always initialize.
+    XInitThreads();
+#endif
+    bool bHeadless = isHeadlessRequested();
+    if (bHeadless) {
+        // SDL is still needed for its event queue and keyboard state, but not for a
+        // display.
+        setEnv("SDL_VIDEODRIVER", "dummy");
+    }
     int err = SDL_Init(SDL_INIT_VIDEO);
     if (err == -1) {
         throw Exception(AVG_ERR_VIDEO_INIT_FAILED, SDL_GetError());
     }
+    if (bHeadless) {
+        Display::initHeadless();
+    }
 }
 
 void DisplayEngine::quitSDL()
@@ -83,6 +103,15 @@ void DisplayEngine::quitSDL()
     SDL_QuitSubSystem(SDL_INIT_VIDEO);
 }
 
+bool DisplayEngine::isHeadlessRequested()
+{
+    string sHeadless;
+    if (getEnv("AVG_HEADLESS", sHeadless)) {
+        return stringToBool(sHeadless);
+    }
+    return ConfigMgr::get()->getBoolOption("scr", "headless", false);
+}
+
 DisplayEngine::DisplayEngine()
     : InputDevice("DisplayEngine"),
       m_Size(0,0),
@@ -90,7 +119,12 @@ DisplayEngine::DisplayEngine()
       m_VBRate(0),
       m_Framerate(60),
       m_bInitialized(false),
-      m_EffFramerate(0)
+      m_bHeadless(false),
+      m_EffFramerate(0),
+      m_FrameTimePolicy(DisplayParams::FRAMETIME_REALTIME),
+      m_MaxFrameStep(3),
+      m_bLateFrameStart(false),
+      m_LateFrameStartMargin(2000)
 {
 //    _Xdebug = 1;
     m_Gamma[0] = 1.0;
@@ -104,8 +138,16 @@ DisplayEngine::~DisplayEngine()
 
 void DisplayEngine::init(const DisplayParams& dp, GLConfig glConfig) 
 {
+    m_bHeadless = dp.isHeadless();
+    if (m_bHeadless && dp.getNumWindows() > 1) {
+        throw Exception(AVG_ERR_UNSUPPORTED, 
+                "Headless rendering only supports a single window.");
+    }
     for (int i=0; i<dp.getNumWindows(); ++i) {
-        if (dp.getWindowParams(i).m_DisplayServer == 0) {
+        if (m_bHeadless) {
+            m_pWindows.push_back(WindowPtr(new HeadlessWindow(dp.getWindowParams(i),
+                    dp.isFullscreen(), glConfig)));
+        } else if (dp.getWindowParams(i).m_DisplayServer == 0) {
             m_pWindows.push_back(WindowPtr(new SDLWindow(dp, dp.getWindowParams(i),
                     glConfig)));
         } else {
@@ -133,11 +175,21 @@ void DisplayEngine::init(const DisplayParams& dp, GLConfig glConfig)
     } else {
         setFramerate(dp.getFramerate());
     }
+    setFrameTimePolicy(dp.getFrameTimePolicy(), dp.getMaxFrameStep());
+    setLateFrameStart(dp.isLateFrameStart(), dp.getLateFrameStartMargin());
+    if (dp.isParallelRender() && m_pWindows.size() > 1) {
+        startRenderThreads();
+    }
 }
 
 void DisplayEngine::teardown()
 {
-    m_pWindows.clear();
+    stopRenderThreads();
+    // The first window's context identifies the share group of the others, so it is
+    // deleted last.
+    while (!m_pWindows.empty()) {
+        m_pWindows.pop_back();
+    }
 }
 
 void DisplayEngine::initRender()
@@ -147,6 +199,14 @@ void DisplayEngine::initRender()
     m_TimeSpentWaiting = 0;
     m_StartTime = TimeSource::get()->getCurrentMicrosecs();
     m_LastFrameTime = m_StartTime;
+    m_FrameStartTime = m_StartTime;
+    m_TargetTime = m_StartTime;
+    m_Lateness = 0;
+    m_WorkTimeEstimate = 0;
+    m_FrameTime = 0;
+    m_MaxLateness = 0;
+    m_TotalLateness = 0;
+    m_bFrameLate = false;
     m_bInitialized = true;
     if (m_VBRate != 0) {
         setVBlankRate(m_VBRate);
@@ -170,13 +230,18 @@ void DisplayEngine::deinitRender()
             "  Framerate achieved: " << actualFramerate);
     AVG_TRACE(Logger::category::PROFILE,  Logger::severity::INFO,
             "  Frames too late: " << m_FramesTooLate);
+    if (m_NumFrames > 0) {
+        AVG_TRACE(Logger::category::PROFILE,  Logger::severity::INFO,
+                "  Average lateness: " << float(m_TotalLateness)/(1000*m_NumFrames) 
+                << " ms, max. lateness: " << float(m_MaxLateness)/1000 << " ms");
+    }
     AVG_TRACE(Logger::category::PROFILE,  Logger::severity::INFO,
             "  Percent of time spent waiting: " 
             << float (m_TimeSpentWaiting)/(10000*TotalTime));
     if (m_Framerate != 0) {
         AVG_TRACE(Logger::category::PROFILE,  Logger::severity::INFO,
                 "  Framerate goal was: " << m_Framerate);
-        if (m_Framerate*2 < actualFramerate && m_NumFrames > 10) {
+        if (m_Framerate*2 < actualFramerate && m_NumFrames > 10 && !m_bHeadless) {
             AVG_LOG_WARNING("Actual framerate was a lot higher than framerate goal.\
                     Is vblank sync forced off?");
         }
@@ -186,7 +251,7 @@ void DisplayEngine::deinitRender()
 
 void DisplayEngine::setFramerate(float rate)
 {
-    if (rate != 0 && m_bInitialized) {
+    if (rate != 0 && m_bInitialized && !m_bHeadless) {
         for (unsigned i=0; i<m_pWindows.size(); ++i) {
             GLContext* pContext = m_pWindows[i]->getGLContext();
             pContext->activate();
@@ -209,6 +274,13 @@ float DisplayEngine::getEffectiveFramerate()
 
 void DisplayEngine::setVBlankRate(int rate)
 {
+    if (m_bHeadless) {
+        // Nothing to sync to: Emulate the rate with a timer.
+        if (rate > 0) {
+            setFramerate(Display::get()->getRefreshRate()/rate);
+        }
+        return;
+    }
     m_VBRate = rate;
     if (m_bInitialized) {
         GLContext* pContext = m_pWindows[0]->getGLContext();
@@ -223,18 +295,36 @@ void DisplayEngine::setVBlankRate(int rate)
     }
 }
 
+void DisplayEngine::setFrameTimePolicy(DisplayParams::FrameTimePolicy policy, 
+        float maxFrameStep)
+{
+    m_FrameTimePolicy = policy;
+    m_MaxFrameStep = maxFrameStep;
+}
+
+void DisplayEngine::setLateFrameStart(bool bLateStart, float margin)
+{
+    m_bLateFrameStart = bLateStart;
+    m_LateFrameStartMargin = (long long)(margin*1000);
+}
+
 bool DisplayEngine::wasFrameLate()
 {
     return m_bFrameLate;
 }
 
+float DisplayEngine::getFrameLateness() const
+{
+    return m_Lateness/1000.f;
+}
+
 void DisplayEngine::setGamma(float red, float green, float blue)
 {
     if (m_pWindows.empty()) {
         throw Exception(AVG_ERR_UNSUPPORTED, "setGamma needs an open window.");
     }
     if (red > 0) {
-        dynamic_pointer_cast<SDLWindow>(m_pWindows[0])->setGamma(red, green, blue);
+        m_pWindows[0]->setGamma(red, green, blue);
         m_Gamma[0] = red;
         m_Gamma[1] = green;
         m_Gamma[2] = blue;
@@ -243,7 +333,10 @@ void DisplayEngine::setGamma(float red, float green, float blue)
 
 void DisplayEngine::setMousePos(const IntPoint& pos)
 {
-    dynamic_pointer_cast<SDLWindow>(m_pWindows[0])->setMousePos(pos);
+    SDLWindowPtr pWindow = dynamic_pointer_cast<SDLWindow>(m_pWindows[0]);
+    if (pWindow) {
+        pWindow->setMousePos(pos);
+    }
 }
 
 int DisplayEngine::getKeyModifierState() const
@@ -261,9 +354,40 @@ const WindowPtr DisplayEngine::getWindow(unsigned i) const
     return m_pWindows[i];
 }
 
-void DisplayEngine::endFrame()
+bool DisplayEngine::hasRenderThreads() const
 {
-    frameWait();
+    return !m_pRenderThreads.empty();
+}
+
+void DisplayEngine::renderInThreads(const WindowRenderFunc& renderFunc)
+{
+    runInRenderThreads(boost::bind(&WindowRenderThread::render, _1, renderFunc));
+}
+
+static ProfilingZoneID LateStartProfilingZone("Render - late start wait");
+
+void DisplayEngine::startFrame(bool bWait)
+{
+    long long curTime = TimeSource::get()->getCurrentMicrosecs();
+    if (m_bLateFrameStart && bWait && m_NumFrames > 0) {
+        // Start as late as possible so the events handled in this frame are as fresh
+        // as possible when the frame is presented.
+        ScopeTimer Timer(LateStartProfilingZone);
+        long long startTime = m_LastFrameTime + getNominalFrameDuration() 
+                - m_WorkTimeEstimate - m_LateFrameStartMargin;
+        if (startTime > curTime) {
+            TimeSource::get()->sleepUntil(startTime/1000);
+            long long waitEndTime = TimeSource::get()->getCurrentMicrosecs();
+            m_TimeSpentWaiting += waitEndTime-curTime;
+            curTime = waitEndTime;
+        }
+    }
+    m_FrameStartTime = curTime;
+}
+
+void DisplayEngine::endFrame(bool bWait)
+{
+    frameWait(bWait);
     swapBuffers();
 #ifdef __APPLE__
     // Hack/Workaround for bug #661: When the window is completely occluded, mac
@@ -281,16 +405,26 @@ void DisplayEngine::endFrame()
 
 static ProfilingZoneID WaitProfilingZone("Render - wait");
 
-void DisplayEngine::frameWait()
+void DisplayEngine::frameWait(bool bWait)
 {
     ScopeTimer Timer(WaitProfilingZone);
 
     m_NumFrames++;
 
     m_FrameWaitStartTime = TimeSource::get()->getCurrentMicrosecs();
-    m_TargetTime = m_LastFrameTime+(long long)(1000000/m_Framerate);
+    m_TargetTime = m_LastFrameTime+getNominalFrameDuration();
+
+    // Track the time spent on the frame. The estimate rises immediately and decays
+    // slowly, so a single fast frame doesn't cause the next late start to overshoot.
+    long long workTime = std::min(m_FrameWaitStartTime-m_FrameStartTime, 
+            getNominalFrameDuration());
+    if (workTime > m_WorkTimeEstimate) {
+        m_WorkTimeEstimate = workTime;
+    } else {
+        m_WorkTimeEstimate = (m_WorkTimeEstimate*15 + workTime)/16;
+    }
     m_bFrameLate = false;
-    if (m_VBRate == 0) {
+    if (m_VBRate == 0 && bWait) {
         if (m_FrameWaitStartTime <= m_TargetTime) {
             long long WaitTime = (m_TargetTime-m_FrameWaitStartTime)/1000;
             if (WaitTime > 5000) {
@@ -303,8 +437,64 @@ void DisplayEngine::frameWait()
 
 void DisplayEngine::swapBuffers()
 {
+    FramePhaseTimer phaseTimer(FramePhaseTimer::SWAP);
+    if (hasRenderThreads()) {
+        runInRenderThreads(boost::bind(&WindowRenderThread::swapBuffers, _1));
+    } else {
+        for (unsigned i=0; i<m_pWindows.size(); ++i) {
+            m_pWindows[i]->swapBuffers();
+        }
+    }
+}
+
+void DisplayEngine::startRenderThreads()
+{
+    AVG_TRACE(Logger::category::CONFIG, Logger::severity::INFO,
+            "Rendering " << m_pWindows.size() << " windows in parallel.");
+    m_pRenderResultQueue = WindowRenderResultQueuePtr(new WindowRenderResultQueue);
     for (unsigned i=0; i<m_pWindows.size(); ++i) {
-        m_pWindows[i]->swapBuffers();
+        WindowRenderThread::CQueuePtr pCmdQueue(new WindowRenderThread::CQueue);
+        m_pRenderCmdQueues.push_back(pCmdQueue);
+        m_pRenderThreads.push_back(new boost::thread(
+                WindowRenderThread(*pCmdQueue, *m_pRenderResultQueue, m_pWindows[i])));
+    }
+}
+
+void DisplayEngine::stopRenderThreads()
+{
+    for (unsigned i=0; i<m_pRenderThreads.size(); ++i) {
+        m_pRenderCmdQueues[i]->pushCmd(boost::bind(&WindowRenderThread::stop, _1));
+        m_pRenderThreads[i]->join();
+        delete m_pRenderThreads[i];
+    }
+    m_pRenderThreads.clear();
+    m_pRenderCmdQueues.clear();
+    m_pRenderResultQueue = WindowRenderResultQueuePtr();
+}
+
+void DisplayEngine::runInRenderThreads(const WindowRenderThread::Cmd::CmdFunc& func)
+{
+    // Each window context is activated by its render thread, so the main thread has to
+    // release its context until all threads are done.
+    GLContext* pMainContext = GLContext::getCurrent();
+    if (pMainContext) {
+        pMainContext->deactivate();
+    }
+    for (unsigned i=0; i<m_pRenderCmdQueues.size(); ++i) {
+        m_pRenderCmdQueues[i]->pushCmd(func);
+    }
+    boost::shared_ptr<Exception> pException;
+    for (unsigned i=0; i<m_pRenderCmdQueues.size(); ++i) {
+        WindowRenderResultQueue::QElementPtr pResult = m_pRenderResultQueue->pop();
+        if (pResult->m_pException && !pException) {
+            pException = pResult->m_pException;
+        }
+    }
+    if (pMainContext) {
+        pMainContext->activate();
+    }
+    if (pException) {
+        throw *pException;
     }
 }
 
@@ -329,7 +519,11 @@ void DisplayEngine::checkJitter()
         m_bFrameLate = true;
         m_FramesTooLate++;
     }
+    m_Lateness = std::max(frameTime - m_TargetTime, 0LL);
+    m_MaxLateness = std::max(m_Lateness, m_MaxLateness);
+    m_TotalLateness += m_Lateness;
 
+    advanceFrameTime(frameTime);
     m_LastFrameTime = frameTime;
     m_TimeSpentWaiting += m_LastFrameTime-m_FrameWaitStartTime;
 //    cerr << m_LastFrameTime << ", m_FrameWaitStartTime=" << m_FrameWaitStartTime << endl;
@@ -341,6 +535,45 @@ long long DisplayEngine::getDisplayTime()
     return (m_LastFrameTime-m_StartTime)/1000;
 }
 
+long long DisplayEngine::getFrameTime()
+{
+    return m_FrameTime/1000;
+}
+
+long long DisplayEngine::getPredictedPresentTime()
+{
+    return (m_LastFrameTime+getNominalFrameDuration()-m_StartTime)/1000;
+}
+
+long long DisplayEngine::getNominalFrameDuration() const
+{
+    return (long long)(1000000/m_Framerate);
+}
+
+void DisplayEngine::advanceFrameTime(long long presentTime)
+{
+    long long frameDuration = getNominalFrameDuration();
+    switch (m_FrameTimePolicy) {
+        case DisplayParams::FRAMETIME_REALTIME:
+            m_FrameTime = presentTime-m_StartTime;
+            break;
+        case DisplayParams::FRAMETIME_SMOOTH: {
+                long long step = presentTime-m_LastFrameTime;
+                if (step > m_MaxFrameStep*frameDuration) {
+                    // Hitch: Continue animations as if a single frame had passed.
+                    step = frameDuration;
+                }
+                m_FrameTime += step;
+            }
+            break;
+        case DisplayParams::FRAMETIME_FIXED:
+            m_FrameTime += frameDuration;
+            break;
+        default:
+            AVG_ASSERT(false);
+    }
+}
+
 const IntPoint& DisplayEngine::getSize() const
 {
     return m_Size;
@@ -361,6 +594,11 @@ bool DisplayEngine::isFullscreen() const
     return m_pWindows[0]->isFullscreen();
 }
 
+bool DisplayEngine::isHeadless() const
+{
+    return m_bHeadless;
+}
+
 void DisplayEngine::showCursor(bool bShow)
 {
 #ifdef _WIN32
@@ -24,6 +24,8 @@
 
 #include "../api.h"
 #include "InputDevice.h"
+#include "WindowRenderThread.h"
+#include "DisplayParams.h"
 
 #include "../graphics/GLConfig.h"
 
@@ -42,13 +44,13 @@ typedef boost::shared_ptr<class Window> WindowPtr;
 class Bitmap;
 typedef boost::shared_ptr<class Bitmap> BitmapPtr;
 class GLContext;
-class DisplayParams;
 
 class AVG_API DisplayEngine: public InputDevice
 {   
     public:
         static void initSDL();
         static void quitSDL();
+        static bool isHeadlessRequested();
 
         DisplayEngine();
         virtual ~DisplayEngine();
@@ -60,23 +62,33 @@ class AVG_API DisplayEngine: public InputDevice
         float getFramerate();
         float getEffectiveFramerate();
         void setVBlankRate(int rate);
+        void setFrameTimePolicy(DisplayParams::FrameTimePolicy policy, 
+                float maxFrameStep);
+        void setLateFrameStart(bool bLateStart, float margin);
         bool wasFrameLate();
+        float getFrameLateness() const;
         void setGamma(float Red, float Green, float Blue);
         void setMousePos(const IntPoint& pos);
         int getKeyModifierState() const;
     
         unsigned getNumWindows() const;
         const WindowPtr getWindow(unsigned i) const;
+        bool hasRenderThreads() const;
+        void renderInThreads(const WindowRenderFunc& renderFunc);
 
-        void endFrame();
-        void frameWait();
+        void startFrame(bool bWait=true);
+        void endFrame(bool bWait=true);
+        void frameWait(bool bWait=true);
         void swapBuffers();
         void checkJitter();
         long long getDisplayTime();
+        long long getFrameTime();
+        long long getPredictedPresentTime();
 
         const IntPoint& getSize() const;
         IntPoint getWindowSize() const;
         bool isFullscreen() const;
+        bool isHeadless() const;
 
         void showCursor(bool bShow);
 
@@ -86,7 +98,16 @@ class AVG_API DisplayEngine: public InputDevice
         std::vector<EventPtr> pollEvents();
 
     private:
+        void startRenderThreads();
+        void stopRenderThreads();
+        void runInRenderThreads(const WindowRenderThread::Cmd::CmdFunc& func);
+        long long getNominalFrameDuration() const;
+        void advanceFrameTime(long long presentTime);
+
         std::vector<WindowPtr> m_pWindows;
+        std::vector<boost::thread*> m_pRenderThreads;
+        std::vector<WindowRenderThread::CQueuePtr> m_pRenderCmdQueues;
+        WindowRenderResultQueuePtr m_pRenderResultQueue;
         IntPoint m_Size;
         std::string m_sWindowTitle;
 
@@ -100,12 +121,25 @@ class AVG_API DisplayEngine: public InputDevice
         long long m_LastFrameTime;
         long long m_FrameWaitStartTime;
         long long m_TargetTime;
+        long long m_FrameStartTime;
+        long long m_Lateness;
         int m_VBRate;
         float m_Framerate;
         bool m_bInitialized;
         bool m_bFrameLate;
+        bool m_bHeadless;
 
         float m_EffFramerate;
+
+        // Frame pacing.
+        DisplayParams::FrameTimePolicy m_FrameTimePolicy;
+        float m_MaxFrameStep;
+        bool m_bLateFrameStart;
+        long long m_LateFrameStartMargin;
+        long long m_WorkTimeEstimate;
+        long long m_FrameTime;
+        long long m_MaxLateness;
+        long long m_TotalLateness;
 };
 
 typedef boost::shared_ptr<DisplayEngine> DisplayEnginePtr;
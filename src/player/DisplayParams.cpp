@@ -20,6 +20,7 @@
 
 #include "DisplayParams.h"
 
+#include "../base/Exception.h"
 #include "../base/XMLHelper.h"
 #include "../base/FileHelper.h"
 #include "../base/StringHelper.h"
@@ -32,12 +33,47 @@ using namespace std;
 
 namespace avg {
 
+DisplayParams::FrameTimePolicy DisplayParams::string2FrameTimePolicy(const string& s)
+{
+    if (s == "realtime") {
+        return FRAMETIME_REALTIME;
+    } else if (s == "smooth") {
+        return FRAMETIME_SMOOTH;
+    } else if (s == "fixed") {
+        return FRAMETIME_FIXED;
+    } else {
+        throw Exception(AVG_ERR_INVALID_ARGS, "Frame time policy '"+s+
+                "' not supported. Use 'realtime', 'smooth' or 'fixed'.");
+    }
+}
+
+string DisplayParams::frameTimePolicy2String(FrameTimePolicy policy)
+{
+    switch (policy) {
+        case FRAMETIME_REALTIME:
+            return "realtime";
+        case FRAMETIME_SMOOTH:
+            return "smooth";
+        case FRAMETIME_FIXED:
+            return "fixed";
+        default:
+            AVG_ASSERT(false);
+            return "";
+    }
+}
+
 DisplayParams::DisplayParams()
     : m_bFullscreen(false),
       m_BPP(24),
       m_bShowCursor(true),
+      m_bParallelRender(false),
+      m_bHeadless(false),
       m_VBRate(1),
-      m_Framerate(0)
+      m_Framerate(0),
+      m_FrameTimePolicy(FRAMETIME_REALTIME),
+      m_MaxFrameStep(3),
+      m_bLateFrameStart(false),
+      m_LateFrameStartMargin(2)
 { 
     m_Gamma[0] = -1.0f;
     m_Gamma[1] = -1.0f;
@@ -163,6 +199,35 @@ void DisplayParams::setShowCursor(bool bShow)
     m_bShowCursor = bShow;
 }
 
+void DisplayParams::setParallelRender(bool bParallelRender)
+{
+    m_bParallelRender = bParallelRender;
+}
+
+void DisplayParams::setHeadless(bool bHeadless)
+{
+    m_bHeadless = bHeadless;
+}
+
+void DisplayParams::setFrameTimePolicy(FrameTimePolicy policy, float maxFrameStep)
+{
+    if (maxFrameStep < 1) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE, 
+                "Maximum frame step must be at least one frame.");
+    }
+    m_FrameTimePolicy = policy;
+    m_MaxFrameStep = maxFrameStep;
+}
+
+void DisplayParams::setLateFrameStart(bool bLateStart, float margin)
+{
+    if (margin < 0) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE, "Late frame start margin must be >= 0.");
+    }
+    m_bLateFrameStart = bLateStart;
+    m_LateFrameStartMargin = margin;
+}
+
 void DisplayParams::resetWindows()
 {
     m_Windows.clear();
@@ -184,6 +249,16 @@ bool DisplayParams::isCursorVisible() const
     return m_bShowCursor;
 }
 
+bool DisplayParams::isParallelRender() const
+{
+    return m_bParallelRender;
+}
+
+bool DisplayParams::isHeadless() const
+{
+    return m_bHeadless;
+}
+
 int DisplayParams::getVBRate() const
 {
     return m_VBRate;
@@ -194,6 +269,26 @@ float DisplayParams::getFramerate() const
     return m_Framerate;
 }
 
+DisplayParams::FrameTimePolicy DisplayParams::getFrameTimePolicy() const
+{
+    return m_FrameTimePolicy;
+}
+
+float DisplayParams::getMaxFrameStep() const
+{
+    return m_MaxFrameStep;
+}
+
+bool DisplayParams::isLateFrameStart() const
+{
+    return m_bLateFrameStart;
+}
+
+float DisplayParams::getLateFrameStartMargin() const
+{
+    return m_LateFrameStartMargin;
+}
+
 int DisplayParams::getNumWindows() const
 {
     return m_Windows.size();
@@ -220,8 +315,14 @@ void DisplayParams::dump() const
     cerr << "  fullscreen: " << m_bFullscreen << endl;
     cerr << "  bpp: " << m_BPP << endl;
     cerr << "  show cursor: " << m_bShowCursor << endl;
+    cerr << "  parallel render: " << m_bParallelRender << endl;
+    cerr << "  headless: " << m_bHeadless << endl;
     cerr << "  vbrate: " << m_VBRate << endl;
     cerr << "  framerate: " << m_Framerate << endl;
+    cerr << "  frame time policy: " << frameTimePolicy2String(m_FrameTimePolicy) 
+            << ", max step: " << m_MaxFrameStep << endl;
+    cerr << "  late frame start: " << m_bLateFrameStart << ", margin: " 
+            << m_LateFrameStartMargin << endl;
     for (unsigned i=0; i<m_Windows.size(); ++i) {
         m_Windows[i].dump();
     }
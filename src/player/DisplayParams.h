@@ -26,12 +26,23 @@
 
 #include "WindowParams.h"
 
+#include <string>
 #include <vector>
 
 namespace avg {
 
 class AVG_API DisplayParams {
 public:
+    // How the frame time seen by the application advances from frame to frame.
+    // REALTIME: Time the last frame was presented.
+    // SMOOTH: Like REALTIME, but hitches longer than the max. frame step count as one
+    //         frame, so animations don't jump.
+    // FIXED: Exactly one nominal frame duration per frame.
+    enum FrameTimePolicy {FRAMETIME_REALTIME, FRAMETIME_SMOOTH, FRAMETIME_FIXED};
+
+    static FrameTimePolicy string2FrameTimePolicy(const std::string& s);
+    static std::string frameTimePolicy2String(FrameTimePolicy policy);
+
     DisplayParams();
     virtual ~DisplayParams();
 
@@ -43,13 +54,23 @@ public:
     void setGamma(float red, float green, float blue);
     void setFramerate(float framerate, int vbRate);
     void setShowCursor(bool bShow);
+    void setParallelRender(bool bParallelRender);
+    void setHeadless(bool bHeadless);
+    void setFrameTimePolicy(FrameTimePolicy policy, float maxFrameStep);
+    void setLateFrameStart(bool bLateStart, float margin);
     void resetWindows();
 
     bool isFullscreen() const;
     int getBPP() const;
     bool isCursorVisible() const;
+    bool isParallelRender() const;
+    bool isHeadless() const;
     int getVBRate() const;
     float getFramerate() const;
+    FrameTimePolicy getFrameTimePolicy() const;
+    float getMaxFrameStep() const;
+    bool isLateFrameStart() const;
+    float getLateFrameStartMargin() const;
     int getNumWindows() const;
     WindowParams& getWindowParams(int i);
     const WindowParams& getWindowParams(int i) const;
@@ -61,8 +82,14 @@ private:
     bool m_bFullscreen;
     int m_BPP;
     bool m_bShowCursor;
+    bool m_bParallelRender;
+    bool m_bHeadless;
     int m_VBRate;
     float m_Framerate;
+    FrameTimePolicy m_FrameTimePolicy;
+    float m_MaxFrameStep;
+    bool m_bLateFrameStart;
+    float m_LateFrameStartMargin;
 
     float m_Gamma[3];
 
@@ -301,12 +301,24 @@ void DivNode::getElementsByPos(const glm::vec2& pos, NodeChainPtr& pElements)
     }
 }
 
+void DivNode::collectPreRenderJobs(vector<Node*>& pNodes)
+{
+    if (getActive()) {
+        for (unsigned i = 0; i < getNumChildren(); i++) {
+            m_Children[i]->collectPreRenderJobs(pNodes);
+        }
+    }
+}
+
 void DivNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive, 
         float parentEffectiveOpacity)
 {
     AreaNode::preRender(pVA, bIsParentActive, parentEffectiveOpacity);
     if (getActive()) {
+        m_ChildCullRect = getCullRect();
         if (getCrop() && getSize() != glm::vec2(0,0)) {
+            m_ChildCullRect.intersect(localToCanvasBounds(FRect(glm::vec2(0,0), 
+                    getSize())));
             pVA->startSubVA(m_ClipVA);
             glm::vec2 viewport = getSize();
             m_ClipVA.appendPos(glm::vec2(0,0), glm::vec2(0,0), Pixel32(0,0,0,0));
@@ -355,6 +367,22 @@ void DivNode::renderOutlines(const VertexArrayPtr& pVA, Pixel32 parentColor)
     }
 }
 
+bool DivNode::getLocalRenderBounds(FRect& bounds)
+{
+    // Only cropped divs have well-defined bounds.
+    if (getCrop() && getSize() != glm::vec2(0,0)) {
+        bounds = FRect(glm::vec2(0,0), getSize());
+        return true;
+    } else {
+        return false;
+    }
+}
+
+const FRect& DivNode::getChildCullRect() const
+{
+    return m_ChildCullRect;
+}
+
 string DivNode::getEffectiveMediaDir()
 {
     // TODO: There is no test for this function.
@@ -69,10 +69,13 @@ class AVG_API DivNode : public AreaNode
         void setMediaDir(const UTF8String& mediaDir);
 
         void getElementsByPos(const glm::vec2& pos, NodeChainPtr& pElements);
+        virtual void collectPreRenderJobs(std::vector<Node*>& pNodes);
         virtual void preRender(const VertexArrayPtr& pVA, bool bIsParentActive, 
                 float parentEffectiveOpacity);
         virtual void render(GLContext* pContext, const glm::mat4& transform);
         virtual void renderOutlines(const VertexArrayPtr& pVA, Pixel32 color);
+        virtual bool getLocalRenderBounds(FRect& bounds);
+        const FRect& getChildCullRect() const;
 
         virtual std::string getEffectiveMediaDir();
         virtual void checkReload();
@@ -87,6 +90,7 @@ class AVG_API DivNode : public AreaNode
         bool m_bCrop;
 
         SubVertexArray m_ClipVA;
+        FRect m_ChildCullRect;
 
         std::vector<NodePtr> m_Children;
 };
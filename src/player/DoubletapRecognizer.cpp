@@ -0,0 +1,137 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "DoubletapRecognizer.h"
+
+#include "CursorEvent.h"
+#include "Player.h"
+
+using namespace std;
+
+namespace avg {
+
+DoubletapRecognizer::DoubletapRecognizer(NodePtr pNode, float maxTime, float maxDist, 
+        CursorEventPtr pInitialEvent, const py::object& possibleHandler, 
+        const py::object& failHandler, const py::object& detectedHandler)
+    : Recognizer(pNode, false, 1, possibleHandler, failHandler, detectedHandler,
+            py::object()),
+      m_MaxTime(maxTime),
+      m_MaxDist(maxDist),
+      m_TapState(TAP_IDLE),
+      m_StartTime(0),
+      m_StartPos(0,0)
+{
+    handleInitialEvent(pInitialEvent);
+}
+
+DoubletapRecognizer::~DoubletapRecognizer()
+{
+}
+
+void DoubletapRecognizer::abort()
+{
+    m_TapState = TAP_IDLE;
+    Recognizer::abort();
+    updateFrameListener();
+}
+
+void DoubletapRecognizer::enable(bool bEnable)
+{
+    m_TapState = TAP_IDLE;
+    Recognizer::enable(bEnable);
+    updateFrameListener();
+}
+
+void DoubletapRecognizer::handleDown(CursorEventPtr pEvent)
+{
+    m_StartTime = Player::get()->getFrameTime();
+    switch (m_TapState) {
+        case TAP_IDLE:
+            m_TapState = TAP_DOWN1;
+            m_StartPos = pEvent->getPos();
+            setPossible();
+            break;
+        case TAP_UP1:
+            if (isTooFar(pEvent)) {
+                m_TapState = TAP_IDLE;
+                setFail();
+            } else {
+                m_TapState = TAP_DOWN2;
+            }
+            break;
+        default:
+            AVG_ASSERT(false);
+    }
+}
+
+void DoubletapRecognizer::handleMove(CursorEventPtr pEvent)
+{
+    if (m_TapState != TAP_IDLE && isTooFar(pEvent)) {
+        m_TapState = TAP_IDLE;
+        setFail();
+    }
+}
+
+void DoubletapRecognizer::handleUp(CursorEventPtr pEvent)
+{
+    switch (m_TapState) {
+        case TAP_DOWN1:
+            m_StartTime = Player::get()->getFrameTime();
+            m_TapState = TAP_UP1;
+            break;
+        case TAP_DOWN2:
+            if (isTooFar(pEvent)) {
+                setFail();
+            } else {
+                setDetected();
+            }
+            m_TapState = TAP_IDLE;
+            break;
+        case TAP_IDLE:
+            break;
+        default:
+            AVG_ASSERT(false);
+    }
+}
+
+void DoubletapRecognizer::handleFrame()
+{
+    if (m_TapState != TAP_IDLE) {
+        long long downTime = Player::get()->getFrameTime() - m_StartTime;
+        if (downTime > m_MaxTime) {
+            setFail();
+            m_TapState = TAP_IDLE;
+        }
+    }
+}
+
+bool DoubletapRecognizer::needsFrames() const
+{
+    return Recognizer::needsFrames() || m_TapState != TAP_IDLE;
+}
+
+bool DoubletapRecognizer::isTooFar(CursorEventPtr pEvent) const
+{
+    return glm::length(pEvent->getPos() - m_StartPos) >
+            m_MaxDist*Player::get()->getPixelsPerMM();
+}
+
+}
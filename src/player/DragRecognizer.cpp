@@ -0,0 +1,198 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "DragRecognizer.h"
+
+#include "CursorEvent.h"
+#include "Node.h"
+#include "Player.h"
+
+#include "../base/MathHelper.h"
+
+using namespace std;
+
+namespace avg {
+
+DragRecognizer::DragRecognizer(NodePtr pEventNode, NodePtr pCoordSysNode, 
+        CursorEventPtr pInitialEvent, int direction, float directionTolerance, 
+        float friction, float minDragDist, const py::object& possibleHandler, 
+        const py::object& failHandler, const py::object& detectedHandler, 
+        const py::object& moveHandler, const py::object& upHandler, 
+        const py::object& endHandler)
+    : Recognizer(pEventNode, true, 1, possibleHandler, failHandler, detectedHandler, 
+            endHandler),
+      m_pCoordSysNode(pCoordSysNode ? pCoordSysNode : pEventNode),
+      m_Direction(direction),
+      m_DirectionTolerance(directionTolerance),
+      m_Friction(friction),
+      m_MinDragDist(minDragDist),
+      m_DragStartPos(0,0),
+      m_LastPos(0,0),
+      m_Offset(0,0)
+{
+    verifyInitialEvent(pInitialEvent, m_pCoordSysNode.lock());
+    subscribeHandler("MOTION", moveHandler);
+    subscribeHandler("UP", upHandler);
+    handleInitialEvent(pInitialEvent);
+}
+
+DragRecognizer::~DragRecognizer()
+{
+}
+
+void DragRecognizer::abort()
+{
+    m_pInertiaHandler = InertiaHandlerPtr();
+    Recognizer::abort();
+    updateFrameListener();
+}
+
+void DragRecognizer::handleDown(CursorEventPtr pEvent)
+{
+    if (!handleCoordSysNodeUnlinked()) {
+        if (m_pInertiaHandler) {
+            m_pInertiaHandler = InertiaHandlerPtr();
+            setEnd();
+        }
+        if (m_Friction != -1) {
+            m_pInertiaHandler = InertiaHandlerPtr(new InertiaHandler(m_Friction));
+        }
+        if (m_MinDragDist == 0) {
+            setDetected();
+        } else {
+            setPossible();
+        }
+        glm::vec2 pos = relEventPos(m_pCoordSysNode.lock(), pEvent);
+        m_DragStartPos = pos;
+        m_LastPos = pos;
+    }
+}
+
+void DragRecognizer::handleMove(CursorEventPtr pEvent)
+{
+    if (!handleCoordSysNodeUnlinked() && getStateEnum() != IDLE) {
+        glm::vec2 pos = relEventPos(m_pCoordSysNode.lock(), pEvent);
+        glm::vec2 offset = pos - m_DragStartPos;
+        if (getStateEnum() == RUNNING) {
+            notifySubscribers("MOTION", offset);
+        } else {
+            if (glm::length(offset) > m_MinDragDist*Player::get()->getPixelsPerMM()) {
+                if (angleFits(offset)) {
+                    setDetected();
+                    notifySubscribers("MOTION", offset);
+                } else {
+                    fail();
+                }
+            }
+        }
+        if (m_pInertiaHandler) {
+            m_pInertiaHandler->onDrag(Transform(pos - m_LastPos));
+        }
+        m_LastPos = pos;
+    }
+}
+
+void DragRecognizer::handleUp(CursorEventPtr pEvent)
+{
+    if (!handleCoordSysNodeUnlinked() && getStateEnum() != IDLE) {
+        glm::vec2 pos = relEventPos(m_pCoordSysNode.lock(), pEvent);
+        if (getStateEnum() == RUNNING) {
+            m_Offset = pos - m_DragStartPos;
+            notifySubscribers("UP", m_Offset);
+            if (m_Friction != -1 && m_pInertiaHandler) {
+                m_pInertiaHandler->onDrag(Transform(pos - m_LastPos));
+                m_pInertiaHandler->onUp();
+                // The first inertia step happens immediately.
+                handleFrame();
+            } else {
+                setEnd();
+            }
+        } else {
+            fail();
+        }
+    }
+}
+
+void DragRecognizer::handleFrame()
+{
+    if (m_pInertiaHandler) {
+        InertiaHandlerPtr pInertiaHandler = m_pInertiaHandler;
+        Transform transform(glm::vec2(0,0));
+        switch (pInertiaHandler->onFrame(transform)) {
+            case InertiaHandler::MOVING:
+                m_Offset += transform.m_Trans;
+                notifySubscribers("MOTION", m_Offset);
+                break;
+            case InertiaHandler::STOPPED:
+                onInertiaStop();
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+bool DragRecognizer::needsFrames() const
+{
+    return Recognizer::needsFrames() || m_pInertiaHandler;
+}
+
+bool DragRecognizer::handleCoordSysNodeUnlinked()
+{
+    if (isNodeUnlinked(m_pCoordSysNode.lock())) {
+        abort();
+        return true;
+    } else {
+        return false;
+    }
+}
+
+void DragRecognizer::fail()
+{
+    setFail();
+    m_pInertiaHandler = InertiaHandlerPtr();
+}
+
+void DragRecognizer::onInertiaStop()
+{
+    m_pInertiaHandler = InertiaHandlerPtr();
+    if (getStateEnum() == POSSIBLE) {
+        setFail();
+    } else {
+        setEnd();
+    }
+}
+
+bool DragRecognizer::angleFits(const glm::vec2& offset) const
+{
+    float angle = fabs(getAngle(offset));
+    switch (m_Direction) {
+        case VERTICAL:
+            return M_PI/2-m_DirectionTolerance < angle && 
+                    angle < M_PI/2+m_DirectionTolerance;
+        case HORIZONTAL:
+            return angle < m_DirectionTolerance || angle > M_PI-m_DirectionTolerance;
+        default:
+            return true;
+    }
+}
+
+}
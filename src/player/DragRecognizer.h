@@ -0,0 +1,82 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _DragRecognizer_H_
+#define _DragRecognizer_H_
+
+#include "../api.h"
+
+#include "Recognizer.h"
+#include "InertiaHandler.h"
+
+#include "../base/GLMHelper.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+
+namespace avg {
+
+class AVG_API DragRecognizer: public Recognizer
+{
+public:
+    enum Direction {ANY_DIRECTION=0, VERTICAL, HORIZONTAL};
+
+    DragRecognizer(NodePtr pEventNode, NodePtr pCoordSysNode, 
+            CursorEventPtr pInitialEvent, int direction, float directionTolerance, 
+            float friction, float minDragDist, const py::object& possibleHandler, 
+            const py::object& failHandler, const py::object& detectedHandler, 
+            const py::object& moveHandler, const py::object& upHandler, 
+            const py::object& endHandler);
+    virtual ~DragRecognizer();
+
+    virtual void abort();
+
+protected:
+    virtual void handleDown(CursorEventPtr pEvent);
+    virtual void handleMove(CursorEventPtr pEvent);
+    virtual void handleUp(CursorEventPtr pEvent);
+    virtual void handleFrame();
+    virtual bool needsFrames() const;
+
+private:
+    bool handleCoordSysNodeUnlinked();
+    void fail();
+    void onInertiaStop();
+    bool angleFits(const glm::vec2& offset) const;
+
+    // Weak, so the recognizer doesn't keep the node alive.
+    boost::weak_ptr<Node> m_pCoordSysNode;
+    int m_Direction;
+    float m_DirectionTolerance;
+    float m_Friction;
+    float m_MinDragDist;
+    InertiaHandlerPtr m_pInertiaHandler;
+
+    glm::vec2 m_DragStartPos;
+    glm::vec2 m_LastPos;
+    glm::vec2 m_Offset;
+};
+
+typedef boost::shared_ptr<DragRecognizer> DragRecognizerPtr;
+
+}
+
+#endif
@@ -163,7 +163,7 @@ void FilledVectorNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive
     VectorNode::preRender(pVA, bIsParentActive, parentEffectiveOpacity);
 }
 
-static ProfilingZoneID RenderProfilingZone("FilledVectorNode::render");
+static ProfilingZoneID RenderProfilingZone("FilledVectorNode::render", true);
 
 void FilledVectorNode::render(GLContext* pContext, const glm::mat4& transform)
 {
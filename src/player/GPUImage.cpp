@@ -46,7 +46,8 @@ GPUImage::GPUImage(OGLSurface * pSurface, bool bUseMipmaps)
       m_pSurface(pSurface),
       m_State(CPU),
       m_Source(NONE),
-      m_bUseMipmaps(bUseMipmaps)
+      m_bUseMipmaps(bUseMipmaps),
+      m_bBmpShared(false)
 {
     ObjectCounter::get()->incRef(&typeid(*this));
     assertValid();
@@ -89,6 +90,7 @@ void GPUImage::moveToCPU()
     if (m_State == GPU) {
         m_State = CPU;
         m_pSurface->destroy();
+        m_pBmpTex = MCTexturePtr();
         if (m_pImage) {
             m_pImage->decTexRef();
         }
@@ -142,6 +144,7 @@ void GPUImage::setBitmap(BitmapPtr pBmp, TexCompression comp)
     changeSource(BITMAP);
     m_pBmp = BitmapPtr(new Bitmap(pBmp->getSize(), pBmp->getPixelFormat(), ""));
     m_pBmp->copyPixels(*pBmp);
+    m_bBmpShared = false;
     if (comp == TEXCOMPRESSION_B5G6R5) {
         BitmapPtr pDestBmp = BitmapPtr(new Bitmap(pBmp->getSize(), B5G6R5, ""));
         if (!BitmapLoader::get()->isBlueFirst()) {
@@ -156,6 +159,34 @@ void GPUImage::setBitmap(BitmapPtr pBmp, TexCompression comp)
     assertValid();
 }
 
+bool GPUImage::updateBitmapRect(BitmapPtr pBmp, const IntRect& dirtyRect, 
+        TexCompression comp)
+{
+    assertValid();
+    if (!pBmp) {
+        throw Exception(AVG_ERR_UNSUPPORTED, "setBitmap(): bitmap must not be None!");
+    }
+    if (m_Source != BITMAP || comp != TEXCOMPRESSION_NONE || 
+            pBmp->getSize() != m_pBmp->getSize() || 
+            pBmp->getPixelFormat() != m_pBmp->getPixelFormat())
+    {
+        return false;
+    }
+    if (m_bBmpShared) {
+        // Don't change bitmaps that the application already holds.
+        m_pBmp = BitmapPtr(new Bitmap(*m_pBmp));
+        m_bBmpShared = false;
+    }
+    Bitmap srcBmp(*pBmp, dirtyRect);
+    Bitmap destBmp(*m_pBmp, dirtyRect);
+    destBmp.copyPixels(srcBmp);
+    if (m_State == GPU) {
+        GLContextManager::get()->scheduleTexUpload(m_pBmpTex, m_pBmp, dirtyRect);
+    }
+    assertValid();
+    return true;
+}
+
 void GPUImage::setCanvas(OffscreenCanvasPtr pCanvas)
 {
     assertValid();
@@ -187,6 +218,9 @@ BitmapPtr GPUImage::getBitmap()
     if (m_Source == NONE || m_Source == SCENE) {
         return BitmapPtr();
     } else {
+        if (m_Source == BITMAP) {
+            m_bBmpShared = true;
+        }
         return m_pBmp;
     }
 }
@@ -247,8 +281,8 @@ void GPUImage::setupImageSurface()
 void GPUImage::setupBitmapSurface()
 {
     GLContextManager* pCM = GLContextManager::get();
-    MCTexturePtr pTex = pCM->createTextureFromBmp(m_pBmp, m_bUseMipmaps);
-    m_pSurface->create(m_pBmp->getPixelFormat(), pTex);
+    m_pBmpTex = pCM->createTextureFromBmp(m_pBmp, m_bUseMipmaps);
+    m_pSurface->create(m_pBmp->getPixelFormat(), m_pBmpTex);
 }
 
 bool GPUImage::changeSource(Source newSource)
@@ -285,6 +319,7 @@ void GPUImage::unload()
         m_pImage = CachedImagePtr();
     }
     m_pBmp = BitmapPtr();
+    m_pBmpTex = MCTexturePtr();
     if (m_State == GPU && m_Source != NONE) {
         m_pSurface->destroy();
     }
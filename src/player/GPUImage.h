@@ -25,6 +25,7 @@
 #include "../api.h"
 
 #include "../base/GLMHelper.h"
+#include "../base/Rect.h"
 
 #include "../graphics/PixelFormat.h"
 #include "../graphics/TexInfo.h"
@@ -41,6 +42,8 @@ class Bitmap;
 typedef boost::shared_ptr<Bitmap> BitmapPtr;
 class CachedImage;
 typedef boost::shared_ptr<CachedImage> CachedImagePtr;
+class MCTexture;
+typedef boost::shared_ptr<MCTexture> MCTexturePtr;
 
 class AVG_API GPUImage
 {
@@ -59,6 +62,10 @@ class AVG_API GPUImage
                 TexCompression comp = TEXCOMPRESSION_NONE);
         void setBitmap(BitmapPtr pBmp, 
                 TexCompression comp = TEXCOMPRESSION_NONE);
+        // Copies and uploads only the pixels inside dirtyRect. Returns false and does
+        // nothing if the bitmap can't replace the current one in place.
+        bool updateBitmapRect(BitmapPtr pBmp, const IntRect& dirtyRect,
+                TexCompression comp = TEXCOMPRESSION_NONE);
         void setCanvas(OffscreenCanvasPtr pCanvas);
         OffscreenCanvasPtr getCanvas() const;
         const std::string& getFilename() const;
@@ -83,6 +90,8 @@ class AVG_API GPUImage
 
         OffscreenCanvasPtr m_pCanvas;
         BitmapPtr m_pBmp;
+        MCTexturePtr m_pBmpTex;
+        bool m_bBmpShared; // m_pBmp has been handed out by getBitmap().
 
         State m_State;
         Source m_Source;
@@ -0,0 +1,123 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "HeadlessWindow.h"
+
+#include "../base/Exception.h"
+#include "../base/ScopeTimer.h"
+
+#include "../graphics/GLContext.h"
+#include "../graphics/GLContextManager.h"
+#include "../graphics/MCFBO.h"
+#include "../graphics/BitmapLoader.h"
+#include "../graphics/Bitmap.h"
+#include "../graphics/Filterflip.h"
+
+using namespace std;
+
+namespace avg {
+
+HeadlessWindow::HeadlessWindow(const WindowParams& wp, bool bIsFullscreen,
+        GLConfig glConfig)
+    : Window(wp, bIsFullscreen)
+{
+    // Without window info, the context manager creates a context that isn't attached
+    // to a visible window (EGL pbuffer, GLX pixmap etc.).
+    GLContext* pGLContext = GLContextManager::get()->createContext(glConfig, wp.m_Size);
+    setGLContext(pGLContext);
+    pGLContext->logConfig();
+    if (!FBOInfo::isFBOSupported()) {
+        throw Exception(AVG_ERR_UNSUPPORTED, 
+                "Headless rendering requires framebuffer object support.");
+    }
+
+    PixelFormat pf;
+    if (BitmapLoader::get()->isBlueFirst()) {
+        pf = B8G8R8A8;
+    } else {
+        pf = R8G8B8A8;
+    }
+    int numSamples = pGLContext->getConfig().m_MultiSampleSamples;
+    if (!FBOInfo::isMultisampleFBOSupported()) {
+        numSamples = 1;
+    }
+    m_pFBO = MCFBOPtr(new MCFBO(wp.m_Size, pf, 1, numSamples, 
+            pGLContext->useDepthBuffer(), true));
+    m_pFBO->initForGLContext();
+}
+
+HeadlessWindow::~HeadlessWindow()
+{
+    // The FBO needs to go before the context it lives in.
+    m_pFBO = MCFBOPtr();
+}
+
+void HeadlessWindow::setTitle(const std::string& sTitle)
+{
+}
+
+static ProfilingZoneID SwapBufferProfilingZone("Render - swap buffers", true);
+
+void HeadlessWindow::swapBuffers() const
+{
+    // Nothing to present. Flushing keeps the GPU busy without waiting for vsync.
+    ScopeTimer timer(SwapBufferProfilingZone);
+    getGLContext()->activate();
+    glFlush();
+    GLContext::checkError("HeadlessWindow::swapBuffers()");
+}
+
+BitmapPtr HeadlessWindow::screenshot(int buffer)
+{
+    // The FBO contains the current frame, so front and back buffer are the same.
+    GLContext* pContext = getGLContext();
+    pContext->activate();
+    BitmapPtr pFBOBmp = m_pFBO->getImage(pContext, 0);
+    PixelFormat pf;
+    if (pContext->isGLES()) {
+        pf = R8G8B8X8;
+    } else {
+        pf = B8G8R8X8;
+    }
+    BitmapPtr pBmp(new Bitmap(getSize(), pf, "screenshot"));
+    pBmp->copyPixels(*pFBOBmp);
+    FilterFlip().applyInPlace(pBmp);
+    return pBmp;
+}
+
+MCFBOPtr HeadlessWindow::getRenderTarget() const
+{
+    return m_pFBO;
+}
+
+vector<EventPtr> HeadlessWindow::pollEvents()
+{
+    return vector<EventPtr>();
+}
+
+#ifdef _WIN32
+HWND HeadlessWindow::getWinHWnd()
+{
+    return 0;
+}
+#endif
+
+}
@@ -0,0 +1,62 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _HeadlessWindow_H_
+#define _HeadlessWindow_H_
+
+#include "../api.h"
+#include "Window.h"
+#include "Event.h"
+
+#include "../graphics/GLConfig.h"
+
+#include <boost/shared_ptr.hpp>
+#include <string>
+
+namespace avg {
+
+// Window without an on-screen surface. Everything is rendered into an FBO, swapping
+// is a no-op and screenshots are read from the FBO.
+class AVG_API HeadlessWindow: public Window
+{
+    public:
+        HeadlessWindow(const WindowParams& wp, bool bIsFullscreen, GLConfig glConfig);
+        virtual ~HeadlessWindow();
+
+        virtual void setTitle(const std::string& sTitle);
+        void swapBuffers() const;
+        virtual BitmapPtr screenshot(int buffer=0);
+        virtual MCFBOPtr getRenderTarget() const;
+
+        virtual std::vector<EventPtr> pollEvents();
+#ifdef _WIN32
+        virtual HWND getWinHWnd();
+#endif
+
+    private:
+        MCFBOPtr m_pFBO;
+};
+
+typedef boost::shared_ptr<HeadlessWindow> HeadlessWindowPtr;
+
+}
+
+#endif
@@ -0,0 +1,83 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "HoldRecognizer.h"
+
+#include "Contact.h"
+#include "CursorEvent.h"
+#include "Player.h"
+
+using namespace std;
+
+namespace avg {
+
+HoldRecognizer::HoldRecognizer(NodePtr pNode, float delay, float maxDist, 
+        CursorEventPtr pInitialEvent, const py::object& possibleHandler, 
+        const py::object& failHandler, const py::object& detectedHandler,
+        const py::object& endHandler)
+    : Recognizer(pNode, true, 1, possibleHandler, failHandler, detectedHandler,
+            endHandler),
+      m_Delay(delay),
+      m_MaxDist(maxDist),
+      m_StartTime(0)
+{
+    handleInitialEvent(pInitialEvent);
+}
+
+HoldRecognizer::~HoldRecognizer()
+{
+}
+
+void HoldRecognizer::handleDown(CursorEventPtr pEvent)
+{
+    setPossible();
+    m_StartTime = Player::get()->getFrameTime();
+}
+
+void HoldRecognizer::handleMove(CursorEventPtr pEvent)
+{
+    if (getStateEnum() == POSSIBLE) {
+        if (pEvent->getContact()->getDistanceFromStart() > 
+                m_MaxDist*Player::get()->getPixelsPerMM())
+        {
+            setFail();
+        }
+    }
+}
+
+void HoldRecognizer::handleUp(CursorEventPtr pEvent)
+{
+    if (getStateEnum() == POSSIBLE) {
+        setFail();
+    } else if (getStateEnum() == RUNNING) {
+        setEnd();
+    }
+}
+
+void HoldRecognizer::handleFrame()
+{
+    long long downTime = Player::get()->getFrameTime() - m_StartTime;
+    if (getStateEnum() == POSSIBLE && downTime > m_Delay) {
+        setDetected();
+    }
+}
+
+}
@@ -0,0 +1,47 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _ICursorListener_H_ 
+#define _ICursorListener_H_
+
+#include "../api.h"
+
+#include <boost/shared_ptr.hpp>
+
+namespace avg {
+
+class CursorEvent;
+typedef boost::shared_ptr<class CursorEvent> CursorEventPtr;
+
+// Native counterpart to subscribing to Node.CURSOR_DOWN and Contact.CURSOR_MOTION/
+// CURSOR_UP. Listeners are called before any python subscribers.
+class AVG_API ICursorListener {
+public:
+    virtual ~ICursorListener() {};
+    virtual void onCursorDown(CursorEventPtr pEvent) = 0;
+    virtual void onCursorMotion(CursorEventPtr pEvent) = 0;
+    virtual void onCursorUp(CursorEventPtr pEvent) = 0;
+    virtual void onNodeKilled() = 0;
+};
+
+}
+
+#endif
@@ -153,6 +153,27 @@ void ImageNode::setBitmap(BitmapPtr pBmp)
     setViewport(-32767, -32767, -32767, -32767);
 }
 
+void ImageNode::setBitmap(BitmapPtr pBmp, const IntRect& dirtyRect)
+{
+    if (!pBmp) {
+        throw Exception(AVG_ERR_UNSUPPORTED, "setBitmap(): bitmap must not be None!");
+    }
+    IntPoint size = pBmp->getSize();
+    if (dirtyRect.tl.x < 0 || dirtyRect.tl.y < 0 || dirtyRect.br.x > size.x ||
+            dirtyRect.br.y > size.y)
+    {
+        throw Exception(AVG_ERR_OUT_OF_RANGE,
+                "setBitmap(): dirty rectangle not inside bitmap.");
+    }
+    if (dirtyRect.width() <= 0 || dirtyRect.height() <= 0) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE, 
+                "setBitmap(): dirty rectangle must have a positive size.");
+    }
+    if (!m_pGPUImage->updateBitmapRect(pBmp, dirtyRect, m_Compression)) {
+        setBitmap(pBmp);
+    }
+}
+
 static ProfilingZoneID PrerenderProfilingZone("ImageNode::prerender");
 
 void ImageNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive, 
@@ -170,7 +191,7 @@ void ImageNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive,
     calcVertexArray(pVA);
 }
 
-static ProfilingZoneID RenderProfilingZone("ImageNode::render");
+static ProfilingZoneID RenderProfilingZone("ImageNode::render", true);
 
 void ImageNode::render(GLContext* pContext, const glm::mat4& transform)
 {
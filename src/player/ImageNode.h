@@ -52,6 +52,7 @@ class AVG_API ImageNode : public RasterNode
         void setHRef(const UTF8String& href);
         const std::string getCompression() const;
         void setBitmap(BitmapPtr pBmp);
+        void setBitmap(BitmapPtr pBmp, const IntRect& dirtyRect);
         
         virtual void preRender(const VertexArrayPtr& pVA, bool bIsParentActive, 
                 float parentEffectiveOpacity);
@@ -0,0 +1,102 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "InertiaHandler.h"
+
+#include "Player.h"
+
+#include "../base/MathHelper.h"
+
+using namespace std;
+
+namespace avg {
+
+InertiaHandler::InertiaHandler(float friction)
+    : m_Friction(friction),
+      m_State(DRAGGING),
+      m_TransVel(0,0),
+      m_CurPivot(0,0),
+      m_AngVel(0)
+{
+}
+
+void InertiaHandler::onDrag(Transform transform)
+{
+    float frameDuration = Player::get()->getFrameDuration();
+    if (frameDuration > 0) {
+        m_TransVel += 0.1f*transform.m_Trans/frameDuration;
+    }
+    if (transform.m_Pivot != glm::vec2(0,0)) {
+        m_CurPivot = transform.m_Pivot;
+    }
+    if (transform.m_Rot > M_PI) {
+        transform.m_Rot -= float(2*M_PI);
+    }
+    if (frameDuration > 0) {
+        m_AngVel += 0.1f*transform.m_Rot/frameDuration;
+    }
+}
+
+void InertiaHandler::onUp()
+{
+    AVG_ASSERT(m_State == DRAGGING);
+    m_State = MOVING;
+}
+
+InertiaHandler::State InertiaHandler::onFrame(Transform& moveTransform)
+{
+    switch (m_State) {
+        case DRAGGING:
+            m_TransVel *= 0.9f;
+            m_AngVel *= 0.9f;
+            break;
+        case MOVING: {
+                float frameDuration = Player::get()->getFrameDuration();
+                float transNorm = glm::length(m_TransVel);
+                glm::vec2 curTrans(0,0);
+                if (transNorm - m_Friction > 0) {
+                    glm::vec2 direction = glm::normalize(m_TransVel);
+                    m_TransVel = direction*(transNorm-m_Friction);
+                    curTrans = m_TransVel*frameDuration;
+                }
+                if (m_AngVel != 0) {
+                    float angSign = m_AngVel > 0 ? 1.f : -1.f;
+                    m_AngVel -= angSign*m_Friction/200;
+                    if (m_AngVel*angSign <= 0) {
+                        m_AngVel = 0;
+                    }
+                }
+                float curAng = m_AngVel*frameDuration;
+                m_CurPivot += curTrans;
+                if (transNorm - m_Friction > 0 || m_AngVel != 0) {
+                    moveTransform = Transform(curTrans, curAng, 1, m_CurPivot);
+                } else {
+                    m_State = STOPPED;
+                }
+            }
+            break;
+        case STOPPED:
+            break;
+    }
+    return m_State;
+}
+
+}
@@ -0,0 +1,61 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _InertiaHandler_H_
+#define _InertiaHandler_H_
+
+#include "../api.h"
+
+#include "Transform.h"
+
+#include "../base/GLMHelper.h"
+
+#include <boost/shared_ptr.hpp>
+
+namespace avg {
+
+// Velocity tracking and deceleration for DragRecognizer and TransformRecognizer. 
+// The owning recognizer calls onFrame() once per frame.
+class AVG_API InertiaHandler
+{
+public:
+    enum State {DRAGGING, MOVING, STOPPED};
+
+    InertiaHandler(float friction);
+
+    void onDrag(Transform transform);
+    void onUp();
+    State onFrame(Transform& moveTransform);
+
+private:
+    float m_Friction;
+    State m_State;
+
+    glm::vec2 m_TransVel;
+    glm::vec2 m_CurPivot;
+    float m_AngVel;
+};
+
+typedef boost::shared_ptr<InertiaHandler> InertiaHandlerPtr;
+
+}
+
+#endif
@@ -0,0 +1,336 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "InstancedNode.h"
+
+#include "TypeDefinition.h"
+#include "TypeRegistry.h"
+#include "OGLSurface.h"
+#include "GPUImage.h"
+#include "Canvas.h"
+
+#include "../base/Exception.h"
+#include "../base/ScopeTimer.h"
+#include "../base/ObjectCounter.h"
+
+#include "../graphics/GLContext.h"
+#include "../graphics/GLContextManager.h"
+#include "../graphics/OGLShader.h"
+#include "../graphics/ShaderRegistry.h"
+#include "../graphics/VertexArray.h"
+
+#include <iostream>
+
+using namespace std;
+using namespace boost;
+
+#define INSTANCED_SHADER "instanced"
+
+namespace avg {
+
+void InstancedNode::registerType()
+{
+    TypeDefinition def = TypeDefinition("instanced", "areanode", 
+            ExportedObject::buildObject<InstancedNode>)
+        .addArg(Arg<UTF8String>("href", "", false, offsetof(InstancedNode, m_href)))
+        .addArg(Arg<string>("shape", "rect", false, offsetof(InstancedNode, m_sShape)));
+    TypeRegistry::get()->registerType(def);
+}
+
+InstancedNode::InstancedNode(const ArgList& args, const string& sPublisherName)
+    : AreaNode(sPublisherName),
+      m_bInstancesChanged(true)
+{
+    args.setMembers(this);
+    m_pSurface = new OGLSurface(WrapMode());
+    m_pGPUImage = GPUImagePtr(new GPUImage(m_pSurface, false));
+    setShape(m_sShape);
+    setHRef(m_href);
+    ObjectCounter::get()->incRef(&typeid(*this));
+}
+
+InstancedNode::~InstancedNode()
+{
+    delete m_pSurface;
+    ObjectCounter::get()->decRef(&typeid(*this));
+}
+
+void InstancedNode::connectDisplay()
+{
+    m_pGPUImage->moveToGPU();
+    AreaNode::connectDisplay();
+
+    GLContextManager* pCM = GLContextManager::get();
+    pCM->createShader(INSTANCED_SHADER, INSTANCED_SHADER);
+    m_pTextureParam = pCM->createShaderParam<int>(INSTANCED_SHADER, "u_Texture");
+    m_pAlphaParam = pCM->createShaderParam<float>(INSTANCED_SHADER, "u_Alpha");
+    m_pTexturedParam = pCM->createShaderParam<int>(INSTANCED_SHADER, "u_bTextured");
+    m_pShapeParam = pCM->createShaderParam<int>(INSTANCED_SHADER, "u_Shape");
+    m_pTexScaleParam = pCM->createShaderParam<glm::vec2>(INSTANCED_SHADER, 
+            "u_TexScale");
+
+    m_pInstanceArray = InstanceArrayPtr(new InstanceArray());
+    m_bInstancesChanged = true;
+}
+
+void InstancedNode::connect(CanvasPtr pCanvas)
+{
+    AreaNode::connect(pCanvas);
+    checkReload();
+}
+
+void InstancedNode::disconnect(bool bKill)
+{
+    if (bKill) {
+        m_pGPUImage->setEmpty();
+        m_href = "";
+    } else {
+        m_pGPUImage->moveToCPU();
+    }
+    m_pInstanceArray = InstanceArrayPtr();
+    m_pVA = VertexArrayPtr();
+    AreaNode::disconnect(bKill);
+}
+
+void InstancedNode::checkReload()
+{
+    bool bNewImage = Node::checkReload(m_href, m_pGPUImage);
+    if (bNewImage) {
+        // The default instance size is the image size.
+        m_bInstancesChanged = true;
+    }
+    if (getState() == Node::NS_CANRENDER) {
+        m_pGPUImage->moveToGPU();
+    }
+}
+
+const UTF8String& InstancedNode::getHRef() const
+{
+    return m_href;
+}
+
+void InstancedNode::setHRef(const UTF8String& href)
+{
+    m_href = href;
+    checkReload();
+}
+
+void InstancedNode::setBitmap(BitmapPtr pBmp)
+{
+    m_href = "";
+    if (pBmp) {
+        m_pGPUImage->setBitmap(pBmp);
+    } else {
+        m_pGPUImage->setEmpty();
+    }
+    if (getState() == Node::NS_CANRENDER) {
+        m_pGPUImage->moveToGPU();
+    }
+    m_bInstancesChanged = true;
+}
+
+const string& InstancedNode::getShape() const
+{
+    return m_sShape;
+}
+
+void InstancedNode::setShape(const string& sShape)
+{
+    if (sShape != "rect" && sShape != "circle") {
+        throw Exception(AVG_ERR_INVALID_ARGS, 
+                "InstancedNode: shape must be 'rect' or 'circle', not '"+sShape+"'.");
+    }
+    m_sShape = sShape;
+}
+
+void InstancedNode::setInstances(const vector<glm::vec2>& positions,
+        const vector<glm::vec2>& sizes, const vector<float>& angles,
+        const vector<Color>& colors, const vector<float>& opacities)
+{
+    checkArraySize(sizes.size(), positions.size(), "sizes");
+    checkArraySize(angles.size(), positions.size(), "angles");
+    checkArraySize(colors.size(), positions.size(), "colors");
+    checkArraySize(opacities.size(), positions.size(), "opacities");
+    m_Positions = positions;
+    m_Sizes = sizes;
+    m_Angles = angles;
+    m_Colors = colors;
+    m_Opacities = opacities;
+    m_bInstancesChanged = true;
+}
+
+int InstancedNode::getNumInstances() const
+{
+    return int(m_Positions.size());
+}
+
+const vector<glm::vec2>& InstancedNode::getPositions() const
+{
+    return m_Positions;
+}
+
+void InstancedNode::setPositions(const vector<glm::vec2>& positions)
+{
+    setInstances(positions, m_Sizes, m_Angles, m_Colors, m_Opacities);
+}
+
+const vector<glm::vec2>& InstancedNode::getSizes() const
+{
+    return m_Sizes;
+}
+
+void InstancedNode::setSizes(const vector<glm::vec2>& sizes)
+{
+    checkArraySize(sizes.size(), m_Positions.size(), "sizes");
+    m_Sizes = sizes;
+    m_bInstancesChanged = true;
+}
+
+const vector<float>& InstancedNode::getAngles() const
+{
+    return m_Angles;
+}
+
+void InstancedNode::setAngles(const vector<float>& angles)
+{
+    checkArraySize(angles.size(), m_Positions.size(), "angles");
+    m_Angles = angles;
+    m_bInstancesChanged = true;
+}
+
+const vector<Color>& InstancedNode::getColors() const
+{
+    return m_Colors;
+}
+
+void InstancedNode::setColors(const vector<Color>& colors)
+{
+    checkArraySize(colors.size(), m_Positions.size(), "colors");
+    m_Colors = colors;
+    m_bInstancesChanged = true;
+}
+
+const vector<float>& InstancedNode::getOpacities() const
+{
+    return m_Opacities;
+}
+
+void InstancedNode::setOpacities(const vector<float>& opacities)
+{
+    checkArraySize(opacities.size(), m_Positions.size(), "opacities");
+    m_Opacities = opacities;
+    m_bInstancesChanged = true;
+}
+
+static ProfilingZoneID PrerenderProfilingZone("InstancedNode::prerender");
+
+void InstancedNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive, 
+        float parentEffectiveOpacity)
+{
+    ScopeTimer timer(PrerenderProfilingZone);
+    AreaNode::preRender(pVA, bIsParentActive, parentEffectiveOpacity);
+    m_pVA = pVA;
+    if (m_bInstancesChanged) {
+        updateInstanceArray();
+        m_bInstancesChanged = false;
+    }
+}
+
+static ProfilingZoneID RenderProfilingZone("InstancedNode::render", true);
+
+void InstancedNode::render(GLContext* pContext, const glm::mat4& transform)
+{
+    ScopeTimer Timer(RenderProfilingZone);
+    if (m_pInstanceArray->getNumInstances() == 0) {
+        return;
+    }
+    bool bIsTextured = (m_pGPUImage->getSource() != GPUImage::NONE);
+    if (bIsTextured) {
+        m_pSurface->activate(pContext);
+    }
+    pContext->setBlendMode(GLContext::BLEND_BLEND, false);
+    OGLShaderPtr pShader = getShader(INSTANCED_SHADER);
+    pShader->activate();
+    pShader->setTransform(transform);
+    m_pTextureParam->set(pContext, 0);
+    m_pAlphaParam->set(pContext, getEffectiveOpacity());
+    m_pTexturedParam->set(pContext, bIsTextured);
+    m_pShapeParam->set(pContext, (m_sShape == "circle") ? 1 : 0);
+    if (bIsTextured) {
+        // Compensates for power-of-two textures that are larger than the image.
+        glm::vec2 texScale = glm::vec2(m_pSurface->getSize())/
+                glm::vec2(m_pSurface->getTextureSize());
+        m_pTexScaleParam->set(pContext, texScale);
+    }
+    m_pInstanceArray->draw(pContext, m_pVA, getCanvas()->getStdSubVA());
+}
+
+bool InstancedNode::getLocalRenderBounds(FRect& bounds)
+{
+    if (m_Positions.empty()) {
+        return false;
+    }
+    bounds = m_Bounds;
+    return true;
+}
+
+void InstancedNode::checkArraySize(size_t size, size_t numInstances,
+        const string& sName) const
+{
+    if (size != 0 && size != numInstances) {
+        throw Exception(AVG_ERR_INVALID_ARGS, "InstancedNode: "+sName+
+                " must be empty or contain one entry per position.");
+    }
+}
+
+void InstancedNode::updateInstanceArray()
+{
+    glm::vec2 defaultSize = glm::vec2(m_pGPUImage->getSize());
+    vector<InstanceData> instances(m_Positions.size());
+    for (unsigned i=0; i<m_Positions.size(); ++i) {
+        InstanceData& instance = instances[i];
+        glm::vec2 pos = m_Positions[i];
+        glm::vec2 size = m_Sizes.empty() ? defaultSize : m_Sizes[i];
+        instance.m_Pos[0] = pos.x;
+        instance.m_Pos[1] = pos.y;
+        instance.m_Size[0] = size.x;
+        instance.m_Size[1] = size.y;
+        instance.m_Angle = m_Angles.empty() ? 0.f : m_Angles[i];
+        Pixel32 color = m_Colors.empty() ? Pixel32(255,255,255) : Pixel32(m_Colors[i]);
+        float opacity = m_Opacities.empty() ? 1.f : m_Opacities[i];
+        color.setA((unsigned char)(glm::clamp(opacity, 0.f, 1.f)*255));
+        instance.m_Color = color;
+
+        // Conservative bounds that hold for any angle.
+        float radius = glm::length(size)/2;
+        FRect instanceRect(pos.x-radius, pos.y-radius, pos.x+radius, pos.y+radius);
+        if (i == 0) {
+            m_Bounds = instanceRect;
+        } else {
+            m_Bounds.expand(instanceRect);
+        }
+    }
+    if (m_pInstanceArray) {
+        m_pInstanceArray->setInstances(instances);
+    }
+}
+
+}
@@ -0,0 +1,117 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _InstancedNode_H_
+#define _InstancedNode_H_
+
+#include "../api.h"
+#include "AreaNode.h"
+
+#include "../base/UTF8String.h"
+#include "../graphics/Color.h"
+#include "../graphics/InstanceArray.h"
+#include "../graphics/MCShaderParam.h"
+
+#include <string>
+#include <vector>
+
+namespace avg {
+
+class Bitmap;
+typedef boost::shared_ptr<Bitmap> BitmapPtr;
+class GPUImage;
+typedef boost::shared_ptr<GPUImage> GPUImagePtr;
+class OGLSurface;
+
+// Draws many copies of one texture or shape with a single draw call. Each instance
+// has its own position, size, angle, color and opacity.
+class AVG_API InstancedNode : public AreaNode
+{
+    public:
+        static void registerType();
+        
+        InstancedNode(const ArgList& args, const std::string& sPublisherName="Node");
+        virtual ~InstancedNode();
+        virtual void connectDisplay();
+        virtual void connect(CanvasPtr pCanvas);
+        virtual void disconnect(bool bKill);
+        virtual void checkReload();
+
+        const UTF8String& getHRef() const;
+        void setHRef(const UTF8String& href);
+        void setBitmap(BitmapPtr pBmp);
+        const std::string& getShape() const;
+        void setShape(const std::string& sShape);
+
+        void setInstances(const std::vector<glm::vec2>& positions,
+                const std::vector<glm::vec2>& sizes, const std::vector<float>& angles,
+                const std::vector<Color>& colors, const std::vector<float>& opacities);
+        int getNumInstances() const;
+
+        const std::vector<glm::vec2>& getPositions() const;
+        void setPositions(const std::vector<glm::vec2>& positions);
+        const std::vector<glm::vec2>& getSizes() const;
+        void setSizes(const std::vector<glm::vec2>& sizes);
+        const std::vector<float>& getAngles() const;
+        void setAngles(const std::vector<float>& angles);
+        const std::vector<Color>& getColors() const;
+        void setColors(const std::vector<Color>& colors);
+        const std::vector<float>& getOpacities() const;
+        void setOpacities(const std::vector<float>& opacities);
+
+        virtual void preRender(const VertexArrayPtr& pVA, bool bIsParentActive, 
+                float parentEffectiveOpacity);
+        virtual void render(GLContext* pContext, const glm::mat4& transform);
+        virtual bool getLocalRenderBounds(FRect& bounds);
+
+    private:
+        void checkArraySize(size_t size, size_t numInstances, const std::string& sName)
+                const;
+        void updateInstanceArray();
+
+        UTF8String m_href;
+        std::string m_sShape;
+        OGLSurface * m_pSurface;
+        GPUImagePtr m_pGPUImage;
+
+        std::vector<glm::vec2> m_Positions;
+        std::vector<glm::vec2> m_Sizes;
+        std::vector<float> m_Angles;
+        std::vector<Color> m_Colors;
+        std::vector<float> m_Opacities;
+        bool m_bInstancesChanged;
+        FRect m_Bounds;
+
+        InstanceArrayPtr m_pInstanceArray;
+        VertexArrayPtr m_pVA;
+
+        FloatMCShaderParamPtr m_pAlphaParam;
+        IntMCShaderParamPtr m_pTexturedParam;
+        IntMCShaderParamPtr m_pShapeParam;
+        Vec2fMCShaderParamPtr m_pTexScaleParam;
+        IntMCShaderParamPtr m_pTextureParam;
+};
+
+typedef boost::shared_ptr<InstancedNode> InstancedNodePtr;
+
+}
+
+#endif
@@ -39,6 +39,8 @@
   #endif
 #endif
 
+#include <boost/bind.hpp>
+
 #include <vector>
 
 using namespace boost;
@@ -83,18 +85,50 @@ static ProfilingZoneID RootRenderProfilingZone("Render MainCanvas");
 static ProfilingZoneID SecondWindowRenderProfilingZone(
         "Render second window");
 
+FRect MainCanvas::getVisibleRect() const
+{
+    FRect visibleRect(m_pDisplayEngine->getWindow(0)->getViewport());
+    for (unsigned i=1; i<m_pDisplayEngine->getNumWindows(); ++i) {
+        FRect viewport(m_pDisplayEngine->getWindow(i)->getViewport());
+        visibleRect.expand(viewport);
+    }
+    return visibleRect;
+}
+
 void MainCanvas::renderTree()
 {
     preRender();
     DisplayEngine* pDisplayEngine = getPlayer()->getDisplayEngine();
     unsigned numWindows = pDisplayEngine->getNumWindows();
-    for (unsigned i=0; i<numWindows; ++i) {
-        ScopeTimer Timer(RootRenderProfilingZone);
-        WindowPtr pWindow = pDisplayEngine->getWindow(i);
-        IntRect viewport = pWindow->getViewport();
-        renderWindow(pWindow, MCFBOPtr(), viewport);
+    if (pDisplayEngine->hasRenderThreads()) {
+        // Uploads and effects change shared state, so they happen before the threads
+        // take over.
+        for (unsigned i=0; i<numWindows; ++i) {
+            GLContext* pContext = pDisplayEngine->getWindow(i)->getGLContext();
+            pContext->activate();
+            prepareWindowRender(pContext);
+        }
+        // Shared textures and offscreen canvases were changed in the first window's
+        // context.
+        pDisplayEngine->getWindow(0)->getGLContext()->activate();
+        GLContextManager::get()->fenceSharedChanges();
+        pDisplayEngine->renderInThreads(
+                boost::bind(&MainCanvas::renderWindowInThread, this, _1));
+    } else {
+        for (unsigned i=0; i<numWindows; ++i) {
+            ScopeTimer Timer(RootRenderProfilingZone);
+            WindowPtr pWindow = pDisplayEngine->getWindow(i);
+            IntRect viewport = pWindow->getViewport();
+            renderWindow(pWindow, MCFBOPtr(), viewport);
+        }
     }
     GLContextManager::get()->reset();
 }
 
+void MainCanvas::renderWindowInThread(const WindowPtr& pWindow)
+{
+    GLContextManager::get()->waitForSharedChanges();
+    renderWindowContents(pWindow, MCFBOPtr(), pWindow->getViewport());
+}
+
 }
@@ -43,9 +43,11 @@ class AVG_API MainCanvas: public Canvas
         virtual void initPlayback(const DisplayEnginePtr& pDisplayEngine);
        
         virtual BitmapPtr screenshot() const;
+        virtual FRect getVisibleRect() const;
 
     private:
         void renderTree();
+        void renderWindowInThread(const WindowPtr& pWindow);
         void pollEvents();
 
         DisplayEnginePtr m_pDisplayEngine;
@@ -47,6 +47,13 @@ MultitouchInputDevice::MultitouchInputDevice(const DivNodePtr& pEventReceiverNod
         }
         m_TouchOffset = ConfigMgr::get()->getSizeOption("touch", "offset");
     }
+    m_FilterMinCutoff = ConfigMgr::get()->getFloatOption("touch", "filtermincutoff", -1);
+    m_FilterBeta = ConfigMgr::get()->getFloatOption("touch", "filterbeta", 0);
+    if (m_FilterMinCutoff > 0) {
+        AVG_TRACE(Logger::category::CONFIG, Logger::severity::INFO,
+                "Touch jitter filter enabled: mincutoff=" << m_FilterMinCutoff
+                << ", beta=" << m_FilterBeta);
+    }
     m_pMutex = MutexPtr(new boost::mutex);
 }
 
@@ -96,7 +103,8 @@ TouchStatusPtr MultitouchInputDevice::getTouchStatus(int id)
 
 void MultitouchInputDevice::addTouchStatus(int id, CursorEventPtr pInitialEvent)
 {
-    TouchStatusPtr pTouchStatus(new TouchStatus(pInitialEvent));
+    TouchStatusPtr pTouchStatus(new TouchStatus(pInitialEvent, m_FilterMinCutoff, 
+            m_FilterBeta));
     m_TouchIDMap[id] = pTouchStatus;
     m_Touches.push_back(pTouchStatus);
 }
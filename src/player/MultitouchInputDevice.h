@@ -72,6 +72,8 @@ private:
     MutexPtr m_pMutex;
     glm::vec2 m_TouchArea;
     glm::vec2 m_TouchOffset;
+    float m_FilterMinCutoff;
+    float m_FilterBeta;
 };
 
 typedef boost::shared_ptr<MultitouchInputDevice> MultitouchInputDevicePtr;
@@ -31,6 +31,7 @@
 #include "PublisherDefinition.h"
 #include "GPUImage.h"
 #include "NodeChain.h"
+#include "ICursorListener.h"
 
 #include "../base/Exception.h"
 #include "../base/Logger.h"
@@ -39,6 +40,7 @@
 #include "../base/OSHelper.h"
 
 #include <string>
+#include <algorithm>
 
 using namespace std;
 using namespace boost;
@@ -141,6 +143,11 @@ DivNodePtr Node::getParent() const
     }
 }
 
+DivNode* Node::getParentPtr() const
+{
+    return m_pParent;
+}
+
 NodeChainPtr Node::getParentChain()
 {
     NodeChainPtr pChain(new NodeChain);
@@ -171,6 +178,11 @@ void Node::disconnect(bool bKill)
     setState(NS_UNCONNECTED);
     if (bKill) {
         m_EventHandlerMap.clear();
+        // Listeners usually unregister themselves in onNodeKilled().
+        vector<ICursorListener*> listeners = m_CursorListeners;
+        for (unsigned i=0; i<listeners.size(); ++i) {
+            listeners[i]->onNodeKilled();
+        }
         notifySubscribers("KILLED");
     }
 }
@@ -319,6 +331,21 @@ void Node::disconnectEventHandler(PyObject * pObj, PyObject * pFunc)
 //    dumpEventHandlers();
 }
 
+void Node::registerCursorListener(ICursorListener* pListener)
+{
+    AVG_ASSERT(find(m_CursorListeners.begin(), m_CursorListeners.end(), pListener) ==
+            m_CursorListeners.end());
+    m_CursorListeners.push_back(pListener);
+}
+
+void Node::unregisterCursorListener(ICursorListener* pListener)
+{
+    vector<ICursorListener*>::iterator it = 
+            find(m_CursorListeners.begin(), m_CursorListeners.end(), pListener);
+    AVG_ASSERT(it != m_CursorListeners.end());
+    m_CursorListeners.erase(it);
+}
+
 bool Node::reactsToMouseEvents()
 {
     return m_bActive && m_bSensitive;
@@ -368,6 +395,14 @@ void Node::getElementsByPos(const glm::vec2& pos, NodeChainPtr& pElements)
 {
 }
 
+void Node::collectPreRenderJobs(vector<Node*>& pNodes)
+{
+}
+
+void Node::runPreRenderJob()
+{
+}
+
 void Node::preRender(const VertexArrayPtr& pVA, bool bIsParentActive, 
         float parentEffectiveOpacity)
 {
@@ -387,7 +422,24 @@ CanvasPtr Node::getCanvas() const
 
 bool Node::handleEvent(EventPtr pEvent)
 {
-    if (pEvent->getSource() != Event::NONE && pEvent->getSource() != Event::CUSTOM) {
+    if (!m_CursorListeners.empty() && pEvent->getType() == Event::CURSOR_DOWN &&
+            (pEvent->getSource() == Event::MOUSE || pEvent->getSource() == Event::TOUCH))
+    {
+        // Listeners can unregister other listeners (e.g. by disabling a recognizer),
+        // so we check that each listener is still registered before calling it.
+        CursorEventPtr pCursorEvent = boost::dynamic_pointer_cast<CursorEvent>(pEvent);
+        vector<ICursorListener*> listeners = m_CursorListeners;
+        for (unsigned i=0; i<listeners.size(); ++i) {
+            if (find(m_CursorListeners.begin(), m_CursorListeners.end(), listeners[i])
+                    != m_CursorListeners.end())
+            {
+                listeners[i]->onCursorDown(pCursorEvent);
+            }
+        }
+    }
+    if (hasSubscribers() && pEvent->getSource() != Event::NONE && 
+            pEvent->getSource() != Event::CUSTOM)
+    {
         string messageID = getEventMessageID(pEvent);
         notifySubscribers(messageID, pEvent);
     }
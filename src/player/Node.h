@@ -66,6 +66,7 @@ class GPUImage;
 typedef boost::shared_ptr<GPUImage> GPUImagePtr;
 typedef boost::weak_ptr<Canvas> CanvasWeakPtr;
 class GLContext;
+class ICursorListener;
 
 class AVG_API Node: public Publisher
 {
@@ -109,6 +110,8 @@ class AVG_API Node: public Publisher
         void connectEventHandler(Event::Type type, int sources, 
                 PyObject * pObj, PyObject * pFunc);
         void disconnectEventHandler(PyObject * pObj, PyObject * pFunc=0);
+        void registerCursorListener(ICursorListener* pListener);
+        void unregisterCursorListener(ICursorListener* pListener);
 
         glm::vec2 getRelPos(const glm::vec2& absPos) const;
         glm::vec2 getAbsPos(const glm::vec2& relPos) const;
@@ -117,6 +120,12 @@ class AVG_API Node: public Publisher
         NodePtr getElementByPos(const glm::vec2& pos);
         virtual void getElementsByPos(const glm::vec2& pos, NodeChainPtr& pElements);
 
+        // Parallel part of preRender: Nodes append themselves to pNodes if they have
+        // work that can be done in runPreRenderJob(). runPreRenderJob() is called in a
+        // worker thread before preRender() and must not call GL or python or access 
+        // other nodes.
+        virtual void collectPreRenderJobs(std::vector<Node*>& pNodes);
+        virtual void runPreRenderJob();
         virtual void preRender(const VertexArrayPtr& pVA, bool bIsParentActive, 
                 float parentEffectiveOpacity);
         virtual void maybeRender(GLContext* pContext, const glm::mat4& parentTransform)
@@ -146,6 +155,7 @@ class AVG_API Node: public Publisher
         virtual bool isVisible() const;
         bool getEffectiveActive() const;
         NodePtr getSharedThis();
+        DivNode* getParentPtr() const;
 
         void logFileNotFoundWarning(const std::string& sWarn) const;
 
@@ -182,6 +192,7 @@ class AVG_API Node: public Publisher
         bool callPython(PyObject * pFunc, avg::EventPtr pEvent);
 
         EventHandlerMap m_EventHandlerMap;
+        std::vector<ICursorListener*> m_CursorListeners;
 
         CanvasWeakPtr m_pCanvas;
 
@@ -26,6 +26,7 @@
 #include "Player.h"
 #include "Window.h"
 #include "DisplayEngine.h"
+#include "ScreenshotReader.h"
 
 #include "../base/Exception.h"
 #include "../base/ProfilingZoneID.h"
@@ -120,6 +121,22 @@ BitmapPtr OffscreenCanvas::screenshotIgnoreAlpha() const
     return pBmp;
 }
 
+void OffscreenCanvas::screenshotAsync(PyObject * pyfunc)
+{
+    if (!isRunning() || !m_bIsRendered) {
+        throw(Exception(AVG_ERR_UNSUPPORTED,
+                "OffscreenCanvas::screenshotAsync(): Canvas has not been rendered. No screenshot available"));
+    }
+    if (!PyCallable_Check(pyfunc)) {
+        throw Exception(AVG_ERR_INVALID_ARGS,
+                "OffscreenCanvas.screenshotAsync(): callback is not callable.");
+    }
+    boost::python::object callback(boost::python::handle<>(
+            boost::python::borrowed(pyfunc)));
+    OffscreenCanvasPtr pThis = dynamic_pointer_cast<OffscreenCanvas>(shared_from_this());
+    getPlayer()->getScreenshotReader()->requestScreenshot(callback, pThis);
+}
+
 bool OffscreenCanvas::getHandleEvents() const
 {
     return dynamic_pointer_cast<OffscreenCanvasNode>(getRootNode())->getHandleEvents();
@@ -49,6 +49,7 @@ class AVG_API OffscreenCanvas: public Canvas
 
         virtual BitmapPtr screenshot() const;
         virtual BitmapPtr screenshotIgnoreAlpha() const;
+        void screenshotAsync(PyObject * pyfunc);
         bool getHandleEvents() const;
         bool getMipmap() const;
         bool getAutoRender() const;
@@ -37,6 +37,7 @@
 #include "PolygonNode.h"
 #include "CircleNode.h"
 #include "MeshNode.h"
+#include "InstancedNode.h"
 #include "FontStyle.h"
 #include "PluginManager.h"
 #include "TextEngine.h"
@@ -52,16 +53,19 @@
 #include "Window.h"
 #include "SDLWindow.h"
 #include "Contact.h"
+#include "Recognizer.h"
 #include "KeyEvent.h"
 #include "MouseEvent.h"
 #include "EventDispatcher.h"
 #include "PublisherDefinition.h"
 #include "BitmapManager.h"
+#include "ScreenshotReader.h"
 #include "Timeout.h"
 #include "TypeRegistry.h"
 #include "CursorState.h"
 #include "TestHelper.h"
 #include "NodeChain.h"
+#include "SceneFile.h"
 
 #include "../base/FileHelper.h"
 #include "../base/StringHelper.h"
@@ -71,6 +75,8 @@
 #include "../base/ConfigMgr.h"
 #include "../base/XMLHelper.h"
 #include "../base/ScopeTimer.h"
+#include "../base/FramePhaseTimer.h"
+#include "../base/TimeSource.h"
 #include "../base/WorkerThread.h"
 #include "../base/DAG.h"
 
@@ -92,6 +98,7 @@
 #endif
 
 #include <iostream>
+#include <algorithm>
 
 #ifdef __linux__
 #include <fenv.h>
@@ -99,6 +106,7 @@
 
 #include <glib-object.h>
 #include <boost/pointer_cast.hpp>
+#include <boost/bind.hpp>
 #include <typeinfo>
 
 using namespace std;
@@ -114,6 +122,9 @@ Player::Player()
       m_bDisplayEngineBroken(false),
       m_bIsTraversingTree(false),
       m_pMultitouchInputDevice(),
+      m_NumPreRenderThreads(0),
+      m_NumMipmapThreads(0),
+      m_MipmapUploadBudget(8192),
       m_bInHandleTimers(false),
       m_bCurrentTimeoutDeleted(false),
       m_bKeepWindowOpen(false),
@@ -122,12 +133,15 @@ Player::Player()
       m_bFakeFPS(false),
       m_FakeFPS(0),
       m_FrameTime(0),
+      m_MemoryStatsInterval(0),
+      m_LastMemoryStatsTime(0),
       m_Volume(1),
       m_bPythonAvailable(true),
       m_pLastMouseEvent(new MouseEvent(Event::CURSOR_MOTION, false, false, false, 
             IntPoint(-1, -1), MouseEvent::NO_BUTTON, glm::vec2(-1, -1), 0)),
       m_EventHookPyFunc(Py_None),
-      m_bMouseEnabled(true)
+      m_bMouseEnabled(true),
+      m_FrameSignal(&IFrameListener::onFrame)
 {
     string sDummy;
 #ifdef _WIN32
@@ -175,8 +189,10 @@ Player::Player()
     PolygonNode::registerType();
     CircleNode::registerType();
     MeshNode::registerType();
+    InstancedNode::registerType();
 
     Contact::registerType();
+    Recognizer::registerType();
 
     m_pTestHelper = TestHelperPtr(new TestHelper());
 
@@ -248,6 +264,12 @@ void Player::setWindowConfig(const string& sFileName)
     m_DP.setConfig(sFileName);
 }
 
+void Player::setParallelRender(bool bParallelRender)
+{
+    errorIfPlaying("Player.setParallelRender");
+    m_DP.setParallelRender(bParallelRender);
+}
+
 void Player::useGLES(bool bGLES)
 {
     errorIfPlaying("Player.useGLES");
@@ -324,6 +346,11 @@ CanvasPtr Player::loadFile(const string& sFilename)
 {
     errorIfPlaying("Player.loadFile");
     NodePtr pNode = loadMainNodeFromFile(sFilename);
+    // Scene files can contain any node tree, so the root type is checked here.
+    if (!dynamic_pointer_cast<AVGNode>(pNode)) {
+        throw (Exception(AVG_ERR_XML_PARSE,
+                "Root node of an avg tree needs to be an <avg> node."));
+    }
     if (m_pMainCanvas) {
         cleanup(false);
     }
@@ -346,9 +373,36 @@ CanvasPtr Player::loadString(const string& sAVG)
     return m_pMainCanvas;
 }
 
+void Player::saveSceneFile(const string& sFilename, NodePtr pRootNode)
+{
+    if (!pRootNode) {
+        if (!m_pMainCanvas) {
+            throw Exception(AVG_ERR_NO_NODE, 
+                    "Player.saveSceneFile: No node given and no main canvas loaded.");
+        }
+        pRootNode = m_pMainCanvas->getRootNode();
+    }
+    SceneFileWriter writer;
+    writer.addNodeTree(pRootNode);
+    writer.save(sFilename);
+}
+
+void Player::convertToSceneFile(const string& sAVGFilename, const string& sSceneFilename)
+{
+    string sAVG;
+    readWholeFile(sAVGFilename, sAVG);
+    SceneFileWriter writer;
+    writer.addAVG(sAVG, sAVGFilename);
+    writer.save(sSceneFilename);
+}
+
 OffscreenCanvasPtr Player::loadCanvasFile(const string& sFilename)
 {
     NodePtr pNode = loadMainNodeFromFile(sFilename);
+    if (!dynamic_pointer_cast<OffscreenCanvasNode>(pNode)) {
+        throw (Exception(AVG_ERR_XML_PARSE,
+                "Root node of a canvas tree needs to be a <canvas> node."));
+    }
     return registerOffscreenCanvas(pNode);
 }
 
@@ -465,9 +519,15 @@ NodePtr Player::loadMainNodeFromFile(const string& sFilename)
     }
     m_CurDirName = sRealFilename.substr(0, sRealFilename.rfind('/')+1);
 
-    string sAVG;
-    readWholeFile(sRealFilename, sAVG);
-    NodePtr pNode = internalLoad(sAVG, sRealFilename);
+    NodePtr pNode;
+    if (isSceneFile(sRealFilename)) {
+        SceneFileReader reader(sRealFilename);
+        pNode = reader.createNodes();
+    } else {
+        string sAVG;
+        readWholeFile(sRealFilename, sAVG);
+        pNode = internalLoad(sAVG, sRealFilename);
+    }
 
     // Reset the directory to load assets from to the current dir.
     m_CurDirName = string(pBuf)+"/";
@@ -493,6 +553,7 @@ void Player::play()
         notifySubscribers("PLAYBACK_START");
         try {
             ThreadProfiler::get()->start();
+            FramePhaseTimer::startMeasuring();
             doFrame(true);
             while (!m_bStopping) {
                 doFrame(false);
@@ -531,6 +592,9 @@ void Player::initPlayback()
     AVG_TRACE(Logger::category::PLAYER, Logger::severity::INFO, "Playback started.");
     initGraphics();
     initAudio();
+    startPreRenderThreads();
+    m_pContextManager->setMipmapUploadBudget(m_MipmapUploadBudget*1024);
+    m_pContextManager->setMipmapThreads(m_NumMipmapThreads);
     try {
         for (unsigned i = 0; i < m_pCanvases.size(); ++i) {
             m_pCanvases[i]->initPlayback();
@@ -550,7 +614,7 @@ void Player::initPlayback()
     } else {
 #if defined(_WIN32) || defined(__linux__)
         SDLWindowPtr pWin = dynamic_pointer_cast<SDLWindow>(m_pDisplayEngine->getWindow(0));
-        if (!pWin->hasTouchHandler()) {
+        if (pWin && !pWin->hasTouchHandler()) {
             SDLTouchInputDevicePtr pMultitouchInputDevice =
                     SDLTouchInputDevicePtr(new SDLTouchInputDevice);
             pWin->setTouchHandler(pMultitouchInputDevice);
@@ -589,6 +653,50 @@ void Player::setVBlankFramerate(int rate)
     m_DP.setFramerate(0, rate);
 }
 
+void Player::setFrameTimePolicy(const string& sPolicy, float maxFrameStep)
+{
+    m_DP.setFrameTimePolicy(DisplayParams::string2FrameTimePolicy(sPolicy), 
+            maxFrameStep);
+    if (m_bIsPlaying) {
+        m_pDisplayEngine->setFrameTimePolicy(m_DP.getFrameTimePolicy(), maxFrameStep);
+    }
+}
+
+string Player::getFrameTimePolicy() const
+{
+    return DisplayParams::frameTimePolicy2String(m_DP.getFrameTimePolicy());
+}
+
+void Player::setLateFrameStart(bool bLateStart, float margin)
+{
+    m_DP.setLateFrameStart(bLateStart, margin);
+    if (m_bIsPlaying) {
+        m_pDisplayEngine->setLateFrameStart(bLateStart, margin);
+    }
+}
+
+float Player::getFrameLateness()
+{
+    if (!m_bIsPlaying) {
+        throw Exception(AVG_ERR_UNSUPPORTED,
+                "Must call Player.play() before getFrameLateness().");
+    }
+    return m_pDisplayEngine->getFrameLateness();
+}
+
+long long Player::getPredictedPresentTime()
+{
+    if (!m_bIsPlaying) {
+        throw Exception(AVG_ERR_UNSUPPORTED,
+                "Must call Player.play() before getPredictedPresentTime().");
+    }
+    if (m_bFakeFPS) {
+        return (long long)(((m_NumFrames+1)*1000.0)/m_FakeFPS);
+    } else {
+        return m_pDisplayEngine->getPredictedPresentTime();
+    }
+}
+
 float Player::getEffectiveFramerate()
 {
     if (m_bIsPlaying) {
@@ -818,6 +926,31 @@ BitmapPtr Player::screenshot()
     return m_pDisplayEngine->screenshot();
 }
 
+void Player::screenshotAsync(PyObject * pyfunc)
+{
+    if (!m_bIsPlaying) {
+        throw Exception(AVG_ERR_UNSUPPORTED,
+                "Must call Player.play() before screenshotAsync().");
+    }
+    if (!PyCallable_Check(pyfunc)) {
+        throw Exception(AVG_ERR_INVALID_ARGS,
+                "Player.screenshotAsync(): callback is not callable.");
+    }
+    boost::python::object callback(boost::python::handle<>(
+            boost::python::borrowed(pyfunc)));
+    getScreenshotReader()->requestScreenshot(callback);
+}
+
+ScreenshotReader* Player::getScreenshotReader()
+{
+    if (!m_pScreenshotReader) {
+        m_pScreenshotReader = ScreenshotReaderPtr(
+                new ScreenshotReader(m_pDisplayEngine.get()));
+        registerFrameEndListener(m_pScreenshotReader.get());
+    }
+    return m_pScreenshotReader.get();
+}
+
 void Player::showCursor(bool bShow)
 {
     if (m_pDisplayEngine) {
@@ -926,6 +1059,16 @@ void Player::unregisterPreRenderListener(IPreRenderListener* pListener)
     }
 }
 
+void Player::registerFrameListener(IFrameListener* pListener)
+{
+    m_FrameSignal.connect(pListener);
+}
+
+void Player::unregisterFrameListener(IFrameListener* pListener)
+{
+    m_FrameSignal.disconnect(pListener);
+}
+
 bool Player::handleEvent(EventPtr pEvent)
 {
     AVG_ASSERT(pEvent);
@@ -986,6 +1129,17 @@ static ProfilingZoneID OffscreenProfilingZone("Offscreen rendering");
 
 void Player::doFrame(bool bFirstFrame)
 {
+    // Headless with fake fps: Nobody is watching, so frames are produced as fast as
+    // possible.
+    bool bWait = !(m_bFakeFPS && m_DP.isHeadless());
+    if (m_bPythonAvailable) {
+        Py_BEGIN_ALLOW_THREADS;
+        m_pDisplayEngine->startFrame(bWait);
+        Py_END_ALLOW_THREADS;
+    } else {
+        m_pDisplayEngine->startFrame(bWait);
+    }
+    long long frameStartTime = TimeSource::get()->getCurrentMicrosecs();
     {
         ScopeTimer Timer(MainProfilingZone);
         if (!bFirstFrame) {
@@ -993,19 +1147,25 @@ void Player::doFrame(bool bFirstFrame)
             if (m_bFakeFPS) {
                 m_FrameTime = (long long)((m_NumFrames*1000.0)/m_FakeFPS);
             } else {
-                m_FrameTime = m_pDisplayEngine->getDisplayTime();
+                m_FrameTime = m_pDisplayEngine->getFrameTime();
             }
             {
                 ScopeTimer Timer(TimersProfilingZone);
+                FramePhaseTimer phaseTimer(FramePhaseTimer::TIMERS);
                 handleTimers();
             }
             {
                 ScopeTimer Timer(EventsProfilingZone);
+                FramePhaseTimer phaseTimer(FramePhaseTimer::EVENTS);
                 m_pEventDispatcher->dispatch();
                 sendFakeEvents();
                 removeDeadEventCaptures();
             }
         }
+        vector<GLContext*> pContexts = getWindowContexts();
+        for (unsigned i = 0; i < pContexts.size(); ++i) {
+            pContexts[i]->resetStateChangeStats();
+        }
         for (unsigned i = 0; i < m_pCanvases.size(); ++i) {
             ScopeTimer Timer(OffscreenProfilingZone);
             dispatchOffscreenRendering(m_pCanvases[i].get());
@@ -1018,16 +1178,20 @@ void Player::doFrame(bool bFirstFrame)
         if (m_bPythonAvailable) {
             Py_BEGIN_ALLOW_THREADS;
             try {
-                m_pDisplayEngine->endFrame();
+                m_pDisplayEngine->endFrame(bWait);
             } catch(...) {
                 Py_BLOCK_THREADS;
                 throw;
             }
             Py_END_ALLOW_THREADS;
         } else {
-            m_pDisplayEngine->endFrame();
+            m_pDisplayEngine->endFrame(bWait);
         }
     }
+    FramePhaseTimer::countFrame(TimeSource::get()->getCurrentMicrosecs()-frameStartTime);
+    if (m_MemoryStatsInterval > 0) {
+        logMemoryStats();
+    }
     ThreadProfiler::get()->reset();
     if (m_NumFrames == 5) {
         ThreadProfiler::get()->restart();
@@ -1066,6 +1230,59 @@ size_t Player::getVideoMemUsed()
     return GLContext::getCurrent()->getVideoMemUsed();
 }
 
+MemoryStatsMap Player::getMemoryStats()
+{
+    MemoryStatsMap stats = ObjectCounter::get()->getMemoryStats();
+    if (ImageCache::exists()) {
+        ImageCache* pCache = ImageCache::get();
+        stats["Image cache: CPU"] = MemoryStats(
+                pCache->getMemUsed(CachedImage::STORAGE_CPU), pCache->getNumCPUImages());
+        stats["Image cache: GPU"] = MemoryStats(
+                pCache->getMemUsed(CachedImage::STORAGE_GPU), pCache->getNumGPUImages());
+    }
+    stats["Resident set size"] = MemoryStats(getMemoryUsage(), 1);
+    return stats;
+}
+
+void Player::setMemoryStatsInterval(int interval)
+{
+    if (interval < 0) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE, 
+                "Player.setMemoryStatsInterval: interval must be >= 0.");
+    }
+    m_MemoryStatsInterval = interval;
+    m_LastMemoryStatsTime = 0;
+    m_LastMemoryStats.clear();
+}
+
+unsigned Player::getNumGLStateChanges()
+{
+    if (!m_pDisplayEngine) {
+        throw Exception(AVG_ERR_UNSUPPORTED,
+                "Player.getNumGLStateChanges must be called after Player.play().");
+    }
+    vector<GLContext*> pContexts = getWindowContexts();
+    unsigned numChanges = 0;
+    for (unsigned i = 0; i < pContexts.size(); ++i) {
+        numChanges += pContexts[i]->getNumIssuedStateChanges();
+    }
+    return numChanges;
+}
+
+unsigned Player::getNumElidedGLStateChanges()
+{
+    if (!m_pDisplayEngine) {
+        throw Exception(AVG_ERR_UNSUPPORTED,
+                "Player.getNumElidedGLStateChanges must be called after Player.play().");
+    }
+    vector<GLContext*> pContexts = getWindowContexts();
+    unsigned numChanges = 0;
+    for (unsigned i = 0; i < pContexts.size(); ++i) {
+        numChanges += pContexts[i]->getNumElidedStateChanges();
+    }
+    return numChanges;
+}
+
 void Player::setGamma(float red, float green, float blue)
 {
     if (m_pDisplayEngine) {
@@ -1087,6 +1304,16 @@ void Player::initConfig()
     }
     m_DP.setBPP(bpp);
     m_DP.setFullscreen(pMgr->getBoolOption("scr", "fullscreen", false));
+    m_DP.setParallelRender(pMgr->getBoolOption("scr", "parallelrender", false));
+    m_DP.setHeadless(DisplayEngine::isHeadlessRequested());
+    m_DP.setFrameTimePolicy(DisplayParams::string2FrameTimePolicy(
+            *pMgr->getOption("scr", "frametimepolicy")),
+            pMgr->getFloatOption("scr", "maxframestep", 3));
+    m_DP.setLateFrameStart(pMgr->getBoolOption("scr", "latestart", false),
+            pMgr->getFloatOption("scr", "latestartmargin", 2));
+    m_NumPreRenderThreads = pMgr->getIntOption("scr", "prerenderthreads", 0);
+    m_NumMipmapThreads = pMgr->getIntOption("scr", "mipmapthreads", 0);
+    m_MipmapUploadBudget = pMgr->getIntOption("scr", "mipmapuploadbudget", 8192);
 
     WindowParams& wp = m_DP.getWindowParams(0);
     wp.m_Size.x = atoi(pMgr->getOption("scr", "windowwidth")->c_str());
@@ -1494,6 +1721,40 @@ void Player::dispatchOffscreenRendering(OffscreenCanvas* pOffscreenCanvas)
     }
 }
 
+vector<GLContext*> Player::getWindowContexts() const
+{
+    // Several windows can share a context.
+    vector<GLContext*> pContexts;
+    if (m_pDisplayEngine) {
+        for (unsigned i = 0; i < m_pDisplayEngine->getNumWindows(); ++i) {
+            GLContext* pContext = m_pDisplayEngine->getWindow(i)->getGLContext();
+            if (find(pContexts.begin(), pContexts.end(), pContext) == pContexts.end()) {
+                pContexts.push_back(pContext);
+            }
+        }
+    }
+    return pContexts;
+}
+
+void Player::logMemoryStats()
+{
+    long long curTime = TimeSource::get()->getCurrentMillisecs();
+    if (curTime-m_LastMemoryStatsTime < m_MemoryStatsInterval) {
+        return;
+    }
+    MemoryStatsMap stats = getMemoryStats();
+    AVG_TRACE(Logger::category::MEMORY, Logger::severity::INFO, 
+            "Memory usage:" << endl << ObjectCounter::dumpMemoryStats(stats));
+    if (m_LastMemoryStatsTime != 0) {
+        MemoryStatsMap diff = ObjectCounter::diffMemoryStats(m_LastMemoryStats, stats);
+        AVG_TRACE(Logger::category::MEMORY, Logger::severity::INFO, 
+                "Changes in the last " << curTime-m_LastMemoryStatsTime << " ms:" << endl
+                << ObjectCounter::dumpMemoryStats(diff));
+    }
+    m_LastMemoryStats = stats;
+    m_LastMemoryStatsTime = curTime;
+}
+
 void Player::errorIfPlaying(const string& sFunc) const
 {
     if (m_bIsPlaying) {
@@ -1510,6 +1771,113 @@ void Player::errorIfMultiDisplay(const string& sFunc) const
     }
 }
 
+void Player::setPreRenderThreads(int numThreads)
+{
+    errorIfPlaying("Player.setPreRenderThreads");
+    if (numThreads < 0) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE,
+                "Number of prerender threads must be >= 0 (was " + 
+                toString(numThreads) + ").");
+    }
+    m_NumPreRenderThreads = numThreads;
+}
+
+int Player::getPreRenderThreads() const
+{
+    return m_NumPreRenderThreads;
+}
+
+void Player::setMipmapThreads(int numThreads)
+{
+    errorIfPlaying("Player.setMipmapThreads");
+    if (numThreads < 0) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE,
+                "Number of mipmap threads must be >= 0 (was " + 
+                toString(numThreads) + ").");
+    }
+    m_NumMipmapThreads = numThreads;
+}
+
+int Player::getMipmapThreads() const
+{
+    return m_NumMipmapThreads;
+}
+
+void Player::setMipmapUploadBudget(int kBytes)
+{
+    errorIfPlaying("Player.setMipmapUploadBudget");
+    if (kBytes < 0) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE,
+                "Mipmap upload budget must be >= 0 (was " + toString(kBytes) + ").");
+    }
+    m_MipmapUploadBudget = kBytes;
+}
+
+int Player::getNumPendingMipmaps() const
+{
+    return m_pContextManager->getNumPendingMipmaps();
+}
+
+bool Player::hasPreRenderThreads() const
+{
+    return !m_pPreRenderThreads.empty();
+}
+
+void Player::preRenderInThreads(const vector<Node*>& pNodes)
+{
+    // Several batches per thread so threads that finish early can pick up work from
+    // the others.
+    unsigned numThreads = m_pPreRenderThreads.size();
+    unsigned batchSize = max(unsigned(pNodes.size()/(numThreads*4)), 8u);
+    int numBatches = 0;
+    for (unsigned start = 0; start < pNodes.size(); start += batchSize) {
+        unsigned end = min(start+batchSize, unsigned(pNodes.size()));
+        m_pPreRenderCmdQueue->pushCmd(boost::bind(&PreRenderThread::runJobs, _1, 
+                &pNodes, start, end));
+        numBatches++;
+    }
+    boost::shared_ptr<Exception> pException;
+    for (int i = 0; i < numBatches; ++i) {
+        PreRenderResultQueue::QElementPtr pResult = m_pPreRenderResultQueue->pop();
+        if (pResult->m_pException && !pException) {
+            pException = pResult->m_pException;
+        }
+    }
+    if (pException) {
+        throw *pException;
+    }
+}
+
+void Player::startPreRenderThreads()
+{
+    if (m_NumPreRenderThreads == 0) {
+        return;
+    }
+    AVG_TRACE(Logger::category::CONFIG, Logger::severity::INFO,
+            "Using " << m_NumPreRenderThreads << " prerender threads.");
+    m_pPreRenderCmdQueue = PreRenderThread::CQueuePtr(new PreRenderThread::CQueue);
+    m_pPreRenderResultQueue = PreRenderResultQueuePtr(new PreRenderResultQueue);
+    for (int i = 0; i < m_NumPreRenderThreads; ++i) {
+        m_pPreRenderThreads.push_back(new boost::thread(
+                PreRenderThread(*m_pPreRenderCmdQueue, *m_pPreRenderResultQueue)));
+    }
+}
+
+void Player::stopPreRenderThreads()
+{
+    // All threads share one queue, so each thread picks up exactly one stop command.
+    for (unsigned i = 0; i < m_pPreRenderThreads.size(); ++i) {
+        m_pPreRenderCmdQueue->pushCmd(boost::bind(&PreRenderThread::stop, _1));
+    }
+    for (unsigned i = 0; i < m_pPreRenderThreads.size(); ++i) {
+        m_pPreRenderThreads[i]->join();
+        delete m_pPreRenderThreads[i];
+    }
+    m_pPreRenderThreads.clear();
+    m_pPreRenderCmdQueue = PreRenderThread::CQueuePtr();
+    m_pPreRenderResultQueue = PreRenderResultQueuePtr();
+}
+
 
 
 void Player::handleTimers()
@@ -1541,6 +1909,7 @@ void Player::handleTimers()
     }
     m_NewTimeouts.clear();
     
+    m_FrameSignal.emit();
     notifySubscribers("ON_FRAME");
     
     m_bInHandleTimers = false;
@@ -1647,16 +2016,26 @@ void Player::cleanup(bool bIsAbort)
     m_pLastCursorStates.clear();
     m_pTestHelper->reset();
     ThreadProfiler::get()->dumpStatistics();
+    if (m_pMainCanvas) {
+        m_pMainCanvas->dumpCullingStatistics();
+        m_pMainCanvas->dumpVATransferStatistics();
+    }
     for (unsigned i = 0; i < m_pCanvases.size(); ++i) {
         m_pCanvases[i]->stopPlayback(bIsAbort);
     }
     m_pCanvases.clear();
+    if (m_pScreenshotReader) {
+        unregisterFrameEndListener(m_pScreenshotReader.get());
+        m_pScreenshotReader = ScreenshotReaderPtr();
+    }
     if (m_pMainCanvas) {
         unregisterFrameEndListener(BitmapManager::get());
         delete BitmapManager::get();
         m_pMainCanvas->stopPlayback(bIsAbort);
         m_pMainCanvas = MainCanvasPtr();
     }
+    stopPreRenderThreads();
+    m_pContextManager->setMipmapThreads(0);
 
     if (m_pMultitouchInputDevice) {
         m_pMultitouchInputDevice = InputDevicePtr();
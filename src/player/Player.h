@@ -27,8 +27,12 @@
 #include "DisplayParams.h"
 #include "BoostPython.h"
 #include "Event.h"
+#include "PreRenderThread.h"
 
 #include "../audio/AudioParams.h"
+#include "../base/IFrameListener.h"
+#include "../base/Signal.h"
+#include "../base/ObjectCounter.h"
 #include "../graphics/GLConfig.h"
 
 #include <libxml/parser.h>
@@ -56,6 +60,7 @@ class CursorEvent;
 class DisplayEngine;
 class Display;
 class GLContextManager;
+class GLContext;
 class Timeout;
 class CursorState;
 class TestHelper;
@@ -64,6 +69,7 @@ class Bitmap;
 class AVGNode;
 class ImageCache;
 class NodeChain;
+class ScreenshotReader;
 
 typedef boost::shared_ptr<Node> NodePtr;
 typedef boost::weak_ptr<Node> NodeWeakPtr;
@@ -76,6 +82,7 @@ typedef boost::shared_ptr<MouseEvent> MouseEventPtr;
 typedef boost::shared_ptr<CursorEvent> CursorEventPtr;
 typedef boost::shared_ptr<DisplayEngine> DisplayEnginePtr;
 typedef boost::shared_ptr<Display> DisplayPtr;
+typedef boost::shared_ptr<ScreenshotReader> ScreenshotReaderPtr;
 typedef boost::shared_ptr<GLContextManager> GLContextManagerPtr;
 typedef boost::shared_ptr<CursorState> CursorStatePtr;
 typedef boost::shared_ptr<TestHelper> TestHelperPtr;
@@ -99,6 +106,7 @@ class AVG_API Player: public Publisher
         void setWindowPos(int x=0, int y=0);
         void setWindowTitle(const std::string& sTitle);
         void setWindowConfig(const std::string& sFileName);
+        void setParallelRender(bool bParallelRender);
         
         void useGLES(bool bGLES);
         void setOGLOptions(bool bUsePOTTextures, bool bUsePixelBuffers, 
@@ -116,6 +124,10 @@ class AVG_API Player: public Publisher
         CanvasPtr loadFile(const std::string& sFilename);
         CanvasPtr loadString(const std::string& sAVG);
 
+        void saveSceneFile(const std::string& sFilename, NodePtr pRootNode=NodePtr());
+        void convertToSceneFile(const std::string& sAVGFilename,
+                const std::string& sSceneFilename);
+
         OffscreenCanvasPtr loadCanvasFile(const std::string& sFilename);
         OffscreenCanvasPtr loadCanvasString(const std::string& sAVG);
         CanvasPtr createMainCanvas(const py::dict& params);
@@ -133,6 +145,11 @@ class AVG_API Player: public Publisher
         bool isPlaying();
         void setFramerate(float rate);
         void setVBlankFramerate(int rate);
+        void setFrameTimePolicy(const std::string& sPolicy, float maxFrameStep=3);
+        std::string getFrameTimePolicy() const;
+        void setLateFrameStart(bool bLateStart, float margin=2);
+        float getFrameLateness();
+        long long getPredictedPresentTime();
         float getEffectiveFramerate();
         TestHelper * getTestHelper();
         void setFakeFPS(float fps);
@@ -163,6 +180,8 @@ class AVG_API Player: public Publisher
         int getKeyModifierState() const;
 
         BitmapPtr screenshot();
+        void screenshotAsync(PyObject * pyfunc);
+        ScreenshotReader* getScreenshotReader();
         void showCursor(bool bShow);
         bool isCursorShown();
 
@@ -173,6 +192,14 @@ class AVG_API Player: public Publisher
         float getVideoRefreshRate();
         size_t getVideoMemInstalled();
         size_t getVideoMemUsed();
+        // GL state changes in the last frame, summed over all windows.
+        unsigned getNumGLStateChanges();
+        unsigned getNumElidedGLStateChanges();
+        // Bytes and object counts per memory category, including the image cache and
+        // the resident set size of the process.
+        MemoryStatsMap getMemoryStats();
+        // Logs a memory snapshot and the changes since the last one every interval ms.
+        void setMemoryStatsInterval(int interval);
         void setGamma(float red, float green, float blue);
         DisplayEngine * getDisplayEngine() const;
         void keepWindowOpen();
@@ -208,9 +235,20 @@ class AVG_API Player: public Publisher
         void unregisterPlaybackEndListener(IPlaybackEndListener* pListener);
         void registerPreRenderListener(IPreRenderListener* pListener);
         void unregisterPreRenderListener(IPreRenderListener* pListener);
+        void registerFrameListener(IFrameListener* pListener);
+        void unregisterFrameListener(IFrameListener* pListener);
 
         bool handleEvent(EventPtr pEvent);
 
+        void setPreRenderThreads(int numThreads);
+        int getPreRenderThreads() const;
+        bool hasPreRenderThreads() const;
+        void setMipmapThreads(int numThreads);
+        int getMipmapThreads() const;
+        void setMipmapUploadBudget(int kBytes);
+        int getNumPendingMipmaps() const;
+        void preRenderInThreads(const std::vector<Node*>& pNodes);
+
     private:
         void initConfig();
         void initGraphics();
@@ -235,15 +273,21 @@ class AVG_API Player: public Publisher
         void updateCursorState(CursorEventPtr pEvent, NodeChainPtr pCursorNodes);
 
         void dispatchOffscreenRendering(OffscreenCanvas* pOffscreenCanvas);
+        std::vector<GLContext*> getWindowContexts() const;
+        void logMemoryStats();
 
         void errorIfPlaying(const std::string& sFunc) const;
         void errorIfMultiDisplay(const std::string& sFunc) const;
 
+        void startPreRenderThreads();
+        void stopPreRenderThreads();
+
         GLContextManagerPtr m_pContextManager;
         MainCanvasPtr m_pMainCanvas;
 
         DisplayEnginePtr m_pDisplayEngine;
         bool m_bDisplayEngineBroken;
+        ScreenshotReaderPtr m_pScreenshotReader;
         TestHelperPtr m_pTestHelper;
 
         std::string m_CurDirName;
@@ -252,6 +296,13 @@ class AVG_API Player: public Publisher
 
         InputDevicePtr m_pMultitouchInputDevice;
 
+        int m_NumPreRenderThreads;
+        std::vector<boost::thread*> m_pPreRenderThreads;
+        PreRenderThread::CQueuePtr m_pPreRenderCmdQueue;
+        PreRenderResultQueuePtr m_pPreRenderResultQueue;
+        int m_NumMipmapThreads;
+        int m_MipmapUploadBudget;
+
         // Timeout handling
         int internalSetTimeout(int time, PyObject * pyfunc, bool bIsInterval);
         int addTimeout(Timeout* pTimeout);
@@ -280,6 +331,11 @@ class AVG_API Player: public Publisher
         long long m_PlayStartTime;
         long long m_NumFrames;
 
+        // Periodic memory snapshots
+        int m_MemoryStatsInterval;
+        long long m_LastMemoryStatsTime;
+        MemoryStatsMap m_LastMemoryStats;
+
         float m_Volume;
 
         bool m_bPythonAvailable;
@@ -308,6 +364,8 @@ class AVG_API Player: public Publisher
 
         PyObject * m_EventHookPyFunc;
         bool m_bMouseEnabled;
+
+        Signal<IFrameListener> m_FrameSignal;
 };
 
 }
@@ -26,7 +26,7 @@
 
 #include "../base/Exception.h"
 #include "../base/GeomHelper.h"
-#include "../base/Polygon.h"
+#include "../base/TriangulationCache.h"
 #include "../graphics/VertexData.h"
 
 #include "../glm/gtx/norm.hpp"
@@ -176,8 +176,7 @@ void PolygonNode::triangulate()
         if (getNumDifferentPts(m_Pts) < 3) {
             return;
         }
-        Polygon poly(m_Pts);
-        poly.triangulate(m_TriPts, m_TriIndexes);
+        TriangulationCache::get()->triangulate(m_Pts, m_TriPts, m_TriIndexes);
         m_bPtsChanged = false;
     }
 }
@@ -0,0 +1,83 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "PreRenderThread.h"
+
+#include "Node.h"
+
+#include "../base/Exception.h"
+#include "../base/ScopeTimer.h"
+
+using namespace std;
+
+namespace avg {
+
+PreRenderResult::PreRenderResult()
+{
+}
+
+PreRenderResult::PreRenderResult(const Exception& ex)
+    : m_pException(new Exception(ex))
+{
+}
+
+PreRenderThread::PreRenderThread(CQueue& cmdQ, PreRenderResultQueue& resultQ)
+    : WorkerThread<PreRenderThread>("PreRender", cmdQ),
+      m_ResultQ(resultQ)
+{
+}
+
+PreRenderThread::~PreRenderThread()
+{
+}
+
+static ProfilingZoneID RunJobsProfilingZone("PreRenderThread: run jobs", true);
+
+void PreRenderThread::runJobs(const vector<Node*>* pNodes, unsigned start, unsigned end)
+{
+    ScopeTimer timer(RunJobsProfilingZone);
+    // Every batch must produce a result, or the main thread waits forever. Failures
+    // are rethrown there.
+    PreRenderResult* pResult;
+    try {
+        for (unsigned i = start; i < end; ++i) {
+            (*pNodes)[i]->runPreRenderJob();
+        }
+        pResult = new PreRenderResult();
+    } catch (const Exception& ex) {
+        pResult = new PreRenderResult(ex);
+    } catch (const std::exception& ex) {
+        pResult = new PreRenderResult(Exception(AVG_ERR_UNKNOWN,
+                string("PreRenderThread: ")+ex.what()));
+    } catch (...) {
+        pResult = new PreRenderResult(Exception(AVG_ERR_UNKNOWN,
+                "PreRenderThread: Unknown exception."));
+    }
+    m_ResultQ.push(PreRenderResultQueue::QElementPtr(pResult));
+}
+
+bool PreRenderThread::work()
+{
+    waitForCommand();
+    return true;
+}
+
+}
@@ -0,0 +1,69 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _PreRenderThread_H_
+#define _PreRenderThread_H_
+
+#include "../api.h"
+
+#include "../base/WorkerThread.h"
+#include "../base/Queue.h"
+
+#include <boost/thread.hpp>
+
+#include <vector>
+
+namespace avg {
+
+class Node;
+
+// Sent back to the main thread when a batch of nodes has been processed.
+struct AVG_API PreRenderResult
+{
+    PreRenderResult();
+    PreRenderResult(const Exception& ex);
+
+    boost::shared_ptr<Exception> m_pException;
+};
+
+typedef Queue<PreRenderResult> PreRenderResultQueue;
+typedef boost::shared_ptr<PreRenderResultQueue> PreRenderResultQueuePtr;
+
+// Runs the thread-safe part of Node::preRender() (usually vertex calculation) for 
+// batches of nodes. All threads of a pool share one command queue, so idle threads
+// pick up the remaining batches.
+class AVG_API PreRenderThread : public WorkerThread<PreRenderThread>
+{
+    public:
+        PreRenderThread(CQueue& cmdQ, PreRenderResultQueue& resultQ);
+        virtual ~PreRenderThread();
+
+        void runJobs(const std::vector<Node*>* pNodes, unsigned start, unsigned end);
+
+    private:
+        virtual bool work();
+
+        PreRenderResultQueue& m_ResultQ;
+};
+
+}
+
+#endif
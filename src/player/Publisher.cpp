@@ -35,11 +35,13 @@ namespace avg {
 int Publisher::s_LastSubscriberID = 0;
 
 Publisher::Publisher()
+    : m_NumSubscribers(0)
 {
     m_pPublisherDef = PublisherDefinition::create("");
 }
 
 Publisher::Publisher(const string& sTypeName)
+    : m_NumSubscribers(0)
 {
     m_pPublisherDef = PublisherDefinitionRegistry::get()->getDefinition(sTypeName);
     vector<MessageID> messageIDs = m_pPublisherDef->getMessageIDs();
@@ -61,6 +63,7 @@ int Publisher::subscribe(MessageID messageID, PyObject* pCallable)
 //        cerr << this << " subscribe " << messageID << ", " << subscriberID << endl;
         subscribers.push_front(SubscriberInfoPtr(
                 new SubscriberInfo(subscriberID, pCallable)));
+        m_NumSubscribers++;
         return subscriberID;
     } else {
         if (pCallable != Py_None) {
@@ -161,6 +164,11 @@ bool Publisher::isSubscribedCallable(MessageID messageID, PyObject* pCallable)
     return false;
 }
 
+bool Publisher::hasSubscribers() const
+{
+    return m_NumSubscribers > 0;
+}
+
 void Publisher::publish(MessageID messageID)
 {
     if (m_SignalMap.find(messageID) != m_SignalMap.end()) {
@@ -176,24 +184,42 @@ void Publisher::removeSubscribers()
     for (it = m_SignalMap.begin(); it != m_SignalMap.end(); ++it) {
         it->second = SubscriberInfoList();
     }
+    m_NumSubscribers = 0;
 }
 
 void Publisher::notifySubscribers(MessageID messageID)
 {
     SubscriberInfoList& subscribers = safeFindSubscribers(messageID);
     if (!subscribers.empty()) {
-        py::list args;
-        notifySubscribersPy(messageID, args);
+        invokeSubscribers(messageID, py::tuple());
     }
 }
     
 void Publisher::notifySubscribers(const string& sMsgName)
 {
-    MessageID messageID = m_pPublisherDef->getMessageID(sMsgName);
+    // Look the name up first so invalid names are caught even without subscribers.
+    const MessageID& messageID = m_pPublisherDef->getMessageID(sMsgName);
+    if (m_NumSubscribers == 0) {
+        return;
+    }
     notifySubscribers(messageID);
 }
 
 void Publisher::notifySubscribersPy(MessageID messageID, const py::list& args)
+{
+    SubscriberInfoList& subscribers = safeFindSubscribers(messageID);
+    if (!subscribers.empty()) {
+        invokeSubscribers(messageID, py::tuple(args));
+    }
+}
+
+MessageID Publisher::genMessageID()
+{
+    return PublisherDefinitionRegistry::get()->genMessageID();
+}
+
+void Publisher::invokeSubscribers(const MessageID& messageID, 
+        const py::tuple& args)
 {
 //    cerr << this << " notifySubscribers " << messageID << endl;
 //    cerr << "  ";
@@ -223,24 +249,21 @@ void Publisher::notifySubscribersPy(MessageID messageID, const py::list& args)
 //    cerr << "  end notify" << endl;
 }
 
-MessageID Publisher::genMessageID()
-{
-    return PublisherDefinitionRegistry::get()->genMessageID();
-}
-
 void Publisher::unsubscribeIterator(MessageID messageID, SubscriberInfoList::iterator it)
 {
     m_SignalMap[messageID].erase(it);
+    m_NumSubscribers--;
 }
 
 
-Publisher::SubscriberInfoList& Publisher::safeFindSubscribers(MessageID messageID)
+Publisher::SubscriberInfoList& Publisher::safeFindSubscribers(
+        const MessageID& messageID)
 {
-    if (m_SignalMap.find(messageID) == m_SignalMap.end()) {
+    SignalMap::iterator it = m_SignalMap.find(messageID);
+    if (it == m_SignalMap.end()) {
         throw Exception(AVG_ERR_INVALID_ARGS, "No signal with ID "+toString(messageID));
     }
-    SubscriberInfoList& subscribers = m_SignalMap[messageID];
-    return subscribers;
+    return it->second;
 }
 
 void Publisher::throwSubscriberNotFound(MessageID messageID, int subscriberID)
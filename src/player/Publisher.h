@@ -60,6 +60,8 @@ public:
     int getNumSubscribers(MessageID messageID);
     bool isSubscribed(MessageID messageID, int subscriberID);
     bool isSubscribedCallable(MessageID messageID, PyObject* pCallable);
+    // Constant-time check used to skip building python arguments when nobody listens.
+    bool hasSubscribers() const;
 
     // The following methods should really be protected, but python derived classes need
     // to call them too.
@@ -84,13 +86,15 @@ private:
     typedef std::list<SubscriberInfoPtr> SubscriberInfoList;
     typedef std::map<MessageID, SubscriberInfoList> SignalMap;
     
+    void invokeSubscribers(const MessageID& messageID, const py::tuple& args);
     void unsubscribeIterator(MessageID messageID, SubscriberInfoList::iterator it);
-    SubscriberInfoList& safeFindSubscribers(MessageID messageID);
+    SubscriberInfoList& safeFindSubscribers(const MessageID& messageID);
     void throwSubscriberNotFound(MessageID messageID, int subscriberID);
     void dumpSubscribers(MessageID messageID);
 
     PublisherDefinitionPtr m_pPublisherDef;
     SignalMap m_SignalMap;
+    int m_NumSubscribers;
     static int s_LastSubscriberID;
 
     typedef std::pair<MessageID, int> UnsubscribeDescription;
@@ -99,13 +103,13 @@ private:
 template<class ARG_TYPE>
 void Publisher::notifySubscribers(const std::string& sMsgName, const ARG_TYPE& arg)
 {
-    MessageID messageID = m_pPublisherDef->getMessageID(sMsgName);
+    const MessageID& messageID = m_pPublisherDef->getMessageID(sMsgName);
+    if (m_NumSubscribers == 0) {
+        return;
+    }
     SubscriberInfoList& subscribers = safeFindSubscribers(messageID);
     if (!subscribers.empty()) {
-        py::list args;
-        py::object pyArg(arg);
-        args.append(pyArg);
-        notifySubscribersPy(messageID, args);
+        invokeSubscribers(messageID, py::make_tuple(arg));
     }
 }
 
@@ -113,15 +117,13 @@ template<class ARG1_TYPE, class ARG2_TYPE>
 void Publisher::notifySubscribers(const std::string& sMsgName, const ARG1_TYPE& arg1,
         const ARG2_TYPE& arg2)
 {
-    MessageID messageID = m_pPublisherDef->getMessageID(sMsgName);
+    const MessageID& messageID = m_pPublisherDef->getMessageID(sMsgName);
+    if (m_NumSubscribers == 0) {
+        return;
+    }
     SubscriberInfoList& subscribers = safeFindSubscribers(messageID);
     if (!subscribers.empty()) {
-        py::list args;
-        py::object pyArg1(arg1);
-        args.append(pyArg1);
-        py::object pyArg2(arg2);
-        args.append(pyArg2);
-        notifySubscribersPy(messageID, args);
+        invokeSubscribers(messageID, py::make_tuple(arg1, arg2));
     }
 }
 
@@ -386,7 +386,7 @@ void RasterNode::renderFX(GLContext* pContext)
 
         bool bPremultipliedAlpha = m_pSurface->isPremultipliedAlpha();
         if (bPremultipliedAlpha) {
-            glproc::BlendColor(1.0f, 1.0f, 1.0f, 1.0f);
+            pContext->setBlendColor(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
         }
         pContext->setBlendMode(GLContext::BLEND_BLEND, bPremultipliedAlpha);
         m_pImagingProjection->setColor(m_Color);
@@ -428,7 +428,7 @@ void RasterNode::scheduleFXRender()
 
 void RasterNode::calcVertexArray(const VertexArrayPtr& pVA)
 {
-    if (m_pSurface->isCreated() && !m_bHasStdVertices && isVisible()) {
+    if (m_pSurface->isCreated() && !m_bHasStdVertices && isVisible() && !isCulled()) {
         pVA->startSubVA(*m_pSubVA);
         for (unsigned y = 0; y < m_TileVertices.size()-1; y++) {
             for (unsigned x = 0; x < m_TileVertices[0].size()-1; x++) {
@@ -447,6 +447,29 @@ void RasterNode::calcVertexArray(const VertexArrayPtr& pVA)
     }
 }
 
+bool RasterNode::getLocalRenderBounds(FRect& bounds)
+{
+    return calcRenderBounds(getSize(), bounds);
+}
+
+bool RasterNode::calcRenderBounds(const glm::vec2& destSize, FRect& bounds)
+{
+    if (!m_pSurface->isCreated() || m_pFXNode) {
+        return false;
+    }
+    // Tile vertices are in [0,1] unless the node is warped.
+    glm::vec2 minPt = m_TileVertices[0][0];
+    glm::vec2 maxPt = minPt;
+    for (unsigned y = 0; y < m_TileVertices.size(); y++) {
+        for (unsigned x = 0; x < m_TileVertices[y].size(); x++) {
+            minPt = glm::min(minPt, m_TileVertices[y][x]);
+            maxPt = glm::max(maxPt, m_TileVertices[y][x]);
+        }
+    }
+    bounds = FRect(minPt*destSize, maxPt*destSize);
+    return true;
+}
+
 void RasterNode::blt32(GLContext* pContext, const glm::mat4& transform)
 {
     blt(pContext, transform, getSize());
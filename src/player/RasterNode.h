@@ -101,6 +101,8 @@ class AVG_API RasterNode: public AreaNode
         virtual void renderFX(GLContext* pContext);
         void resetFXDirty();
 
+        virtual bool getLocalRenderBounds(FRect& bounds);
+
     protected:
         RasterNode(const std::string& sPublisherName);
         
@@ -109,6 +111,7 @@ class AVG_API RasterNode: public AreaNode
         void blt32(GLContext* pContext, const glm::mat4& transform);
         void blt(GLContext* pContext, const glm::mat4& transform,
                 const glm::vec2& destSize);
+        bool calcRenderBounds(const glm::vec2& destSize, FRect& bounds);
 
         virtual OGLSurface * getSurface();
         bool hasMask() const;
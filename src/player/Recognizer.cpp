@@ -0,0 +1,350 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "Recognizer.h"
+
+#include "Node.h"
+#include "CanvasNode.h"
+#include "Contact.h"
+#include "CursorEvent.h"
+#include "Player.h"
+#include "PublisherDefinition.h"
+#include "PublisherDefinitionRegistry.h"
+
+#include "../base/Exception.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace avg {
+
+void Recognizer::registerType()
+{
+    PublisherDefinitionPtr pPubDef = PublisherDefinition::create("Recognizer");
+    pPubDef->addMessage("POSSIBLE");
+    pPubDef->addMessage("DETECTED");
+    pPubDef->addMessage("FAILED");
+    pPubDef->addMessage("MOTION");
+    pPubDef->addMessage("UP");
+    pPubDef->addMessage("END");
+}
+
+Recognizer::Recognizer(NodePtr pNode, bool bIsContinuous, int maxContacts,
+        const py::object& possibleHandler, const py::object& failHandler,
+        const py::object& detectedHandler, const py::object& endHandler)
+    : Publisher("Recognizer"),
+      m_pNode(pNode),
+      m_bIsContinuous(bIsContinuous),
+      m_MaxContacts(maxContacts),
+      m_bIsEnabled(true),
+      m_State(IDLE),
+      m_bDownListenerRegistered(false),
+      m_bFrameListenerRegistered(false)
+{
+    if (!m_pNode) {
+        throw Exception(AVG_ERR_INVALID_ARGS, "Recognizer: node must not be None.");
+    }
+    setEventHandler();
+    subscribeHandler("POSSIBLE", possibleHandler);
+    subscribeHandler("FAILED", failHandler);
+    subscribeHandler("DETECTED", detectedHandler);
+    subscribeHandler("END", endHandler);
+}
+
+Recognizer::~Recognizer()
+{
+    for (unsigned i=0; i<m_Contacts.size(); ++i) {
+        m_Contacts[i]->unregisterCursorListener(this);
+    }
+    if (m_bFrameListenerRegistered) {
+        Player::get()->unregisterFrameListener(this);
+    }
+    if (m_pNode && m_bDownListenerRegistered) {
+        m_pNode->unregisterCursorListener(this);
+    }
+}
+
+vector<ContactPtr> Recognizer::getContacts() const
+{
+    return m_Contacts;
+}
+
+void Recognizer::abort()
+{
+    if (m_bIsEnabled) {
+        doAbort();
+        setEventHandler();
+    }
+}
+
+void Recognizer::enable(bool bEnable)
+{
+    if (bEnable != m_bIsEnabled) {
+        m_bIsEnabled = bEnable;
+        if (bEnable) {
+            setEventHandler();
+        } else {
+            doAbort();
+        }
+    }
+}
+
+bool Recognizer::isEnabled() const
+{
+    return m_bIsEnabled;
+}
+
+string Recognizer::getState() const
+{
+    switch (m_State) {
+        case IDLE:
+            return "IDLE";
+        case POSSIBLE:
+            return "POSSIBLE";
+        case RUNNING:
+            return "RUNNING";
+        default:
+            AVG_ASSERT(false);
+            return "";
+    }
+}
+
+void Recognizer::onCursorDown(CursorEventPtr pEvent)
+{
+    // Python callbacks might release the last reference to the recognizer.
+    ExportedObjectPtr pThis = shared_from_this();
+    processDown(pEvent);
+    updateFrameListener();
+}
+
+void Recognizer::onCursorMotion(CursorEventPtr pEvent)
+{
+    ExportedObjectPtr pThis = shared_from_this();
+    if (!handleNodeGone() && isContactValid(pEvent->getContact())) {
+        handleMove(pEvent);
+        updateFrameListener();
+    }
+}
+
+void Recognizer::onCursorUp(CursorEventPtr pEvent)
+{
+    ExportedObjectPtr pThis = shared_from_this();
+    ContactPtr pContact = pEvent->getContact();
+    if (!handleNodeGone() && isContactValid(pContact)) {
+        pContact->unregisterCursorListener(this);
+        m_Contacts.erase(find(m_Contacts.begin(), m_Contacts.end(), pContact));
+        updateFrameListener();
+        handleUp(pEvent);
+        updateFrameListener();
+    }
+}
+
+void Recognizer::onNodeKilled()
+{
+    ExportedObjectPtr pThis = shared_from_this();
+    enable(false);
+    m_pNode = NodePtr();
+}
+
+void Recognizer::onFrame()
+{
+    ExportedObjectPtr pThis = shared_from_this();
+    handleFrame();
+    updateFrameListener();
+}
+
+void Recognizer::handleInitialEvent(CursorEventPtr pInitialEvent)
+{
+    if (pInitialEvent) {
+        processDown(pInitialEvent);
+        updateFrameListener();
+    }
+}
+
+void Recognizer::subscribeHandler(const string& sMsgName, const py::object& handler)
+{
+    MessageID messageID = PublisherDefinitionRegistry::get()
+            ->getDefinition("Recognizer")->getMessageID(sMsgName);
+    subscribe(messageID, handler.ptr());
+}
+
+Recognizer::State Recognizer::getStateEnum() const
+{
+    return m_State;
+}
+
+int Recognizer::getNumContacts() const
+{
+    return int(m_Contacts.size());
+}
+
+void Recognizer::setPossible()
+{
+    changeState(POSSIBLE);
+    notifySubscribers("POSSIBLE");
+}
+
+void Recognizer::setFail()
+{
+    AVG_ASSERT(m_State != RUNNING);
+    if (m_State != IDLE) {
+        changeState(IDLE);
+    }
+    disconnectContacts();
+    notifySubscribers("FAILED");
+}
+
+void Recognizer::setDetected()
+{
+    if (m_bIsContinuous) {
+        changeState(RUNNING);
+    } else {
+        changeState(IDLE);
+    }
+    notifySubscribers("DETECTED");
+}
+
+void Recognizer::setEnd()
+{
+    AVG_ASSERT(m_State != POSSIBLE);
+    if (m_State != IDLE) {
+        changeState(IDLE);
+    }
+    notifySubscribers("END");
+}
+
+void Recognizer::disconnectContacts()
+{
+    for (unsigned i=0; i<m_Contacts.size(); ++i) {
+        m_Contacts[i]->unregisterCursorListener(this);
+    }
+    m_Contacts.clear();
+    updateFrameListener();
+}
+
+void Recognizer::updateFrameListener()
+{
+    bool bNeedsFrames = needsFrames();
+    if (bNeedsFrames && !m_bFrameListenerRegistered) {
+        Player::get()->registerFrameListener(this);
+        m_bFrameListenerRegistered = true;
+    } else if (!bNeedsFrames && m_bFrameListenerRegistered) {
+        Player::get()->unregisterFrameListener(this);
+        m_bFrameListenerRegistered = false;
+    }
+}
+
+bool Recognizer::handleNodeGone()
+{
+    return !m_pNode;
+}
+
+bool Recognizer::needsFrames() const
+{
+    return !m_Contacts.empty();
+}
+
+glm::vec2 Recognizer::relEventPos(NodePtr pNode, CursorEventPtr pEvent) const
+{
+    if (!boost::dynamic_pointer_cast<CanvasNode>(pNode)) {
+        pNode = pNode->getParent();
+    }
+    return pEvent->getContact()->getRelPos(pNode, pEvent->getPos());
+}
+
+void Recognizer::verifyInitialEvent(CursorEventPtr pInitialEvent, NodePtr pCoordSysNode)
+        const
+{
+    if (pInitialEvent && !pInitialEvent->getContact()->isNodeInTargets(pCoordSysNode)) {
+        throw Exception(AVG_ERR_INVALID_ARGS, "Gestures with an initialEvent must have coordSysNode set to a node under the event.");
+    }
+}
+
+bool Recognizer::isNodeUnlinked(NodePtr pNode) const
+{
+    return !pNode || 
+            (!pNode->getParent() && !boost::dynamic_pointer_cast<CanvasNode>(pNode));
+}
+
+void Recognizer::processDown(CursorEventPtr pEvent)
+{
+    ContactPtr pContact = pEvent->getContact();
+    if (pContact && !handleNodeGone()) {
+        if (m_MaxContacts == -1 || int(m_Contacts.size()) < m_MaxContacts) {
+            pContact->registerCursorListener(this);
+            m_Contacts.push_back(pContact);
+            handleDown(pEvent);
+        }
+    }
+}
+
+bool Recognizer::isContactValid(const ContactPtr& pContact) const
+{
+    return find(m_Contacts.begin(), m_Contacts.end(), pContact) != m_Contacts.end();
+}
+
+void Recognizer::changeState(State newState)
+{
+    bool bValid;
+    switch (m_State) {
+        case IDLE:
+            bValid = (newState == POSSIBLE || (m_bIsContinuous && newState == RUNNING));
+            break;
+        case POSSIBLE:
+            bValid = (newState == IDLE || (m_bIsContinuous && newState == RUNNING));
+            break;
+        case RUNNING:
+            bValid = (newState == IDLE);
+            break;
+        default:
+            bValid = false;
+    }
+    if (!bValid) {
+        throw Exception(AVG_ERR_INVALID_ARGS, "Recognizer: Invalid state change from " +
+                getState() + ".");
+    }
+    m_State = newState;
+}
+
+void Recognizer::doAbort()
+{
+    if (m_State != IDLE) {
+        changeState(IDLE);
+    }
+    if (!m_Contacts.empty()) {
+        disconnectContacts();
+    }
+    if (m_pNode && m_bDownListenerRegistered) {
+        m_pNode->unregisterCursorListener(this);
+        m_bDownListenerRegistered = false;
+    }
+}
+
+void Recognizer::setEventHandler()
+{
+    if (m_pNode && !m_bDownListenerRegistered) {
+        m_pNode->registerCursorListener(this);
+        m_bDownListenerRegistered = true;
+    }
+}
+
+}
@@ -0,0 +1,119 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _Recognizer_H_
+#define _Recognizer_H_
+
+#include "../api.h"
+
+#include "Publisher.h"
+#include "ICursorListener.h"
+
+#include "../base/IFrameListener.h"
+#include "../base/GLMHelper.h"
+
+#include <boost/shared_ptr.hpp>
+
+// Python docs say python.h should be included before any standard headers (!)
+#include "WrapPython.h" 
+
+#include <string>
+#include <vector>
+
+namespace avg {
+
+class Node;
+typedef boost::shared_ptr<Node> NodePtr;
+class Contact;
+typedef boost::shared_ptr<class Contact> ContactPtr;
+
+// Base class for the native gesture recognizers. Cursor events arrive through 
+// ICursorListener, so only the resulting state changes are delivered to python.
+class AVG_API Recognizer: public Publisher, public ICursorListener, public IFrameListener
+{
+public:
+    enum State {IDLE, POSSIBLE, RUNNING};
+
+    static void registerType();
+    virtual ~Recognizer();
+
+    std::vector<ContactPtr> getContacts() const;
+    virtual void abort();
+    virtual void enable(bool bEnable);
+    bool isEnabled() const;
+    std::string getState() const;
+
+    virtual void onCursorDown(CursorEventPtr pEvent);
+    virtual void onCursorMotion(CursorEventPtr pEvent);
+    virtual void onCursorUp(CursorEventPtr pEvent);
+    virtual void onNodeKilled();
+    virtual void onFrame();
+
+protected:
+    Recognizer(NodePtr pNode, bool bIsContinuous, int maxContacts,
+            const py::object& possibleHandler, const py::object& failHandler,
+            const py::object& detectedHandler, const py::object& endHandler);
+
+    void handleInitialEvent(CursorEventPtr pInitialEvent);
+    void subscribeHandler(const std::string& sMsgName, const py::object& handler);
+
+    State getStateEnum() const;
+    int getNumContacts() const;
+    void setPossible();
+    void setFail();
+    void setDetected();
+    void setEnd();
+    void disconnectContacts();
+    void updateFrameListener();
+
+    virtual void handleDown(CursorEventPtr pEvent) {};
+    virtual void handleMove(CursorEventPtr pEvent) {};
+    virtual void handleUp(CursorEventPtr pEvent) {};
+    virtual void handleFrame() {};
+    virtual bool handleNodeGone();
+    virtual bool needsFrames() const;
+
+    glm::vec2 relEventPos(NodePtr pNode, CursorEventPtr pEvent) const;
+    void verifyInitialEvent(CursorEventPtr pInitialEvent, NodePtr pCoordSysNode) const;
+    bool isNodeUnlinked(NodePtr pNode) const;
+
+private:
+    void processDown(CursorEventPtr pEvent);
+    bool isContactValid(const ContactPtr& pContact) const;
+    void changeState(State newState);
+    void doAbort();
+    void setEventHandler();
+
+    NodePtr m_pNode;
+    bool m_bIsContinuous;
+    int m_MaxContacts;
+    bool m_bIsEnabled;
+    State m_State;
+    bool m_bDownListenerRegistered;
+    bool m_bFrameListenerRegistered;
+    std::vector<ContactPtr> m_Contacts;
+};
+
+typedef boost::shared_ptr<Recognizer> RecognizerPtr;
+
+}
+
+#endif
@@ -95,6 +95,14 @@ SDLWindow::SDLWindow(const DisplayParams& dp, const WindowParams& wp, GLConfig g
         SDL_GL_SetAttribute(SDL_GL_CONTEXT_FLAGS, SDL_GL_CONTEXT_DEBUG_FLAG);
     }
 
+    // Additional windows share textures with the window created first, so uploads
+    // happen once regardless of the number of windows.
+    GLContext* pSharedContext = 0;
+    if (SDL_GL_GetCurrentContext()) {
+        pSharedContext = GLContext::getCurrent();
+    }
+    SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, pSharedContext != 0);
+
     while (glConfig.m_MultiSampleSamples && !m_SDLGLContext) {
         if (glConfig.m_MultiSampleSamples > 1) {
             SDL_GL_SetAttribute(SDL_GL_MULTISAMPLEBUFFERS, 1);
@@ -111,11 +119,21 @@ SDLWindow::SDLWindow(const DisplayParams& dp, const WindowParams& wp, GLConfig g
         } else {
             m_SDLGLContext = 0;
         }
-        if (!m_SDLGLContext) {
+        if (!m_SDLGLContext && pSharedContext) {
+            AVG_LOG_WARNING("Creating shared OpenGL context failed. Textures will be "
+                    "uploaded separately for each window.");
+            pSharedContext = 0;
+            SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 0);
+            if (m_pSDLWindow) {
+                SDL_DestroyWindow(m_pSDLWindow);
+                m_pSDLWindow = 0;
+            }
+        } else if (!m_SDLGLContext) {
             glConfig.m_MultiSampleSamples = GLContext::nextMultiSampleValue(
                     glConfig.m_MultiSampleSamples);
         }
     }
+    SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 0);
 
 #ifndef __linux__
     glConfig.m_bUseDebugContext = false;
@@ -132,7 +150,8 @@ SDLWindow::SDLWindow(const DisplayParams& dp, const WindowParams& wp, GLConfig g
     int rc = SDL_GetWindowWMInfo(m_pSDLWindow, &info);
     AVG_ASSERT(rc != -1);
     GLContext* pGLContext = 
-            GLContextManager::get()->createContext(glConfig, wp.m_Size, &info);
+            GLContextManager::get()->createContext(glConfig, wp.m_Size, &info,
+                    pSharedContext);
     setGLContext(pGLContext);
     pGLContext->logConfig();
 }
@@ -159,7 +178,7 @@ void SDLWindow::setTitle(const string& sTitle)
     SDL_SetWindowTitle(m_pSDLWindow, sTitle.c_str());
 }
 
-static ProfilingZoneID SwapBufferProfilingZone("Render - swap buffers");
+static ProfilingZoneID SwapBufferProfilingZone("Render - swap buffers", true);
 
 void SDLWindow::swapBuffers() const
 {
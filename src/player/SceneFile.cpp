@@ -0,0 +1,561 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "SceneFile.h"
+
+#include "Node.h"
+#include "DivNode.h"
+#include "TypeRegistry.h"
+#include "TypeDefinition.h"
+#include "ArgList.h"
+
+#include "../base/Exception.h"
+#include "../base/FileHelper.h"
+#include "../base/StringHelper.h"
+#include "../base/XMLHelper.h"
+
+#include "../graphics/Color.h"
+
+#include <string.h>
+#include <fstream>
+
+using namespace std;
+
+namespace avg {
+
+typedef std::vector<std::vector<glm::vec2> > CollVec2Vector;
+
+namespace {
+
+const char SCENE_FILE_MAGIC[8] = {'A', 'V', 'G', 'S', 'C', 'E', 'N', 'E'};
+const unsigned SCENE_FILE_VERSION = 1;
+// Written in native byte order. Files are only loaded on machines with the same
+// byte order as the one they were written on.
+const unsigned SCENE_FILE_BYTE_ORDER = 0x01020304;
+
+enum ArgTypeTag {
+    ARG_STRING,
+    ARG_UTF8STRING,
+    ARG_INT,
+    ARG_FLOAT,
+    ARG_BOOL,
+    ARG_VEC2,
+    ARG_VEC3,
+    ARG_IVEC3,
+    ARG_FLOAT_VECTOR,
+    ARG_INT_VECTOR,
+    ARG_VEC2_VECTOR,
+    ARG_IVEC3_VECTOR,
+    ARG_COLL_VEC2_VECTOR,
+    ARG_COLOR
+};
+
+template<class T>
+void appendValue(string& sBuffer, const T& val)
+{
+    sBuffer.append((const char*)&val, sizeof(T));
+}
+
+void appendString(string& sBuffer, const string& s)
+{
+    appendValue(sBuffer, unsigned(s.length()));
+    sBuffer.append(s);
+}
+
+template<class T>
+void appendVector(string& sBuffer, const vector<T>& v)
+{
+    appendValue(sBuffer, unsigned(v.size()));
+    if (!v.empty()) {
+        sBuffer.append((const char*)&v[0], v.size()*sizeof(T));
+    }
+}
+
+// x, y, width and height overlay pos and size. Storing both would make the
+// constructor complain about duplicate arguments, so only the vectors are written.
+bool isOverlayArg(const ArgList& defaultArgs, const string& sName)
+{
+    const ArgMap& argMap = defaultArgs.getArgMap();
+    if (sName == "x" || sName == "y") {
+        return argMap.find("pos") != argMap.end();
+    }
+    if (sName == "width" || sName == "height") {
+        return argMap.find("size") != argMap.end();
+    }
+    return false;
+}
+
+}
+
+bool isSceneFile(const string& sFilename)
+{
+    ifstream file(sFilename.c_str(), ios::in | ios::binary);
+    if (!file) {
+        return false;
+    }
+    char magic[sizeof(SCENE_FILE_MAGIC)];
+    file.read(magic, sizeof(magic));
+    return file.gcount() == sizeof(magic) && 
+            memcmp(magic, SCENE_FILE_MAGIC, sizeof(magic)) == 0;
+}
+
+SceneFileWriter::SceneFileWriter()
+    : m_bHasRoot(false)
+{
+}
+
+SceneFileWriter::~SceneFileWriter()
+{
+}
+
+void SceneFileWriter::addNodeTree(const NodePtr& pRootNode)
+{
+    if (m_bHasRoot) {
+        throw Exception(AVG_ERR_UNSUPPORTED, "A scene file can only hold one node tree.");
+    }
+    writeNode(pRootNode);
+    m_bHasRoot = true;
+}
+
+void SceneFileWriter::addAVG(const string& sAVG, const string& sAVGFilename)
+{
+    if (m_bHasRoot) {
+        throw Exception(AVG_ERR_UNSUPPORTED, "A scene file can only hold one node tree.");
+    }
+    XMLParser parser;
+    parser.setDTD(TypeRegistry::get()->getDTD(), "avg.dtd");
+    parser.parse(sAVG, sAVGFilename);
+    writeXmlNode(parser.getDoc(), parser.getRootNode());
+    m_bHasRoot = true;
+}
+
+void SceneFileWriter::save(const string& sFilename) const
+{
+    if (!m_bHasRoot) {
+        throw Exception(AVG_ERR_UNSUPPORTED, "Can't save empty scene file "+sFilename+".");
+    }
+    string sHeader(SCENE_FILE_MAGIC, sizeof(SCENE_FILE_MAGIC));
+    appendValue(sHeader, SCENE_FILE_VERSION);
+    appendValue(sHeader, SCENE_FILE_BYTE_ORDER);
+    appendValue(sHeader, unsigned(m_Strings.size()));
+    for (unsigned i = 0; i < m_Strings.size(); ++i) {
+        appendString(sHeader, m_Strings[i]);
+    }
+    writeWholeFile(sFilename, sHeader+m_sNodeData);
+}
+
+void SceneFileWriter::writeNode(const NodePtr& pNode)
+{
+    const TypeDefinition& def = *(pNode->getDefinition());
+    const ArgList& defaultArgs = def.getDefaultArgs();
+
+    // The current attribute values are queried through the python attributes of the
+    // node, so attributes that aren't exposed to python keep their default values.
+    py::object pyNode(pNode);
+    ArgList args;
+    args.copyArgsFrom(defaultArgs);
+    const ArgMap& argMap = defaultArgs.getArgMap();
+    for (ArgMap::const_iterator it = argMap.begin(); it != argMap.end(); ++it) {
+        const string& sName = it->first;
+        const ArgBase& defaultArg = *(it->second);
+        if (isOverlayArg(defaultArgs, sName)) {
+            continue;
+        }
+        py::object val;
+        try {
+            val = pyNode.attr(sName.c_str());
+        } catch (py::error_already_set&) {
+            PyErr_Clear();
+            continue;
+        }
+        try {
+            args.setArgValue(sName, val);
+        } catch (const Exception&) {
+            args.setArg(defaultArg);
+            continue;
+        }
+        string sDefaultVal;
+        string sVal;
+        if (!writeArg(defaultArg, sDefaultVal) || !writeArg(*args.getArg(sName), sVal) ||
+                sDefaultVal == sVal)
+        {
+            args.setArg(defaultArg);
+        }
+    }
+    writeNodeHeader(def, args);
+
+    DivNodePtr pDivNode = boost::dynamic_pointer_cast<DivNode>(pNode);
+    if (pDivNode) {
+        unsigned numChildren = pDivNode->getNumChildren();
+        appendValue(m_sNodeData, numChildren);
+        for (unsigned i = 0; i < numChildren; ++i) {
+            writeNode(pDivNode->getChild(i));
+        }
+    } else {
+        appendValue(m_sNodeData, unsigned(0));
+    }
+}
+
+void SceneFileWriter::writeXmlNode(const xmlDocPtr xmlDoc, const xmlNodePtr xmlNode)
+{
+    const char * pszNodeType = (const char *)xmlNode->name;
+    const TypeDefinition& def = TypeRegistry::get()->getTypeDef(pszNodeType);
+    ArgList args(def.getDefaultArgs(), xmlNode);
+    if (!strcmp(pszNodeType, "words")) {
+        // Inline markup takes precedence over the text attribute if it isn't empty.
+        // See WordsNode::setTextFromNodeValue().
+        string sText = getXmlChildrenAsString(xmlDoc, xmlNode);
+        if (!removeStartEndSpaces(sText).empty()) {
+            args.setArgVal<UTF8String>("text", sText);
+        }
+        writeNodeHeader(def, args);
+        appendValue(m_sNodeData, unsigned(0));
+        return;
+    }
+
+    vector<xmlNodePtr> children;
+    if (def.hasChildren()) {
+        for (xmlNodePtr pChild = xmlNode->xmlChildrenNode; pChild; pChild = pChild->next) {
+            const char * pszChildType = (const char *)pChild->name;
+            if (strcmp(pszChildType, "text") && strcmp(pszChildType, "comment")) {
+                children.push_back(pChild);
+            }
+        }
+    }
+    writeNodeHeader(def, args);
+    appendValue(m_sNodeData, unsigned(children.size()));
+    for (unsigned i = 0; i < children.size(); ++i) {
+        writeXmlNode(xmlDoc, children[i]);
+    }
+}
+
+void SceneFileWriter::writeNodeHeader(const TypeDefinition& def, const ArgList& args)
+{
+    string sArgData;
+    unsigned numArgs = 0;
+    const ArgMap& argMap = args.getArgMap();
+    for (ArgMap::const_iterator it = argMap.begin(); it != argMap.end(); ++it) {
+        const ArgBase& arg = *(it->second);
+        if (!arg.isDefault()) {
+            string sVal;
+            if (writeArg(arg, sVal)) {
+                appendValue(sArgData, getStringIndex(it->first));
+                sArgData.append(sVal);
+                numArgs++;
+            } else {
+                throw Exception(AVG_ERR_UNSUPPORTED, "Argument "+it->first+" of node type "
+                        +def.getName()+" can't be stored in a scene file.");
+            }
+        }
+    }
+    appendValue(m_sNodeData, getStringIndex(def.getName()));
+    appendValue(m_sNodeData, numArgs);
+    m_sNodeData.append(sArgData);
+}
+
+bool SceneFileWriter::writeArg(const ArgBase& arg, string& sBuffer) const
+{
+    const ArgBase* pArg = &arg;
+    if (const Arg<UTF8String>* pUTF8StringArg = dynamic_cast<const Arg<UTF8String>*>(pArg)) {
+        sBuffer.push_back(char(ARG_UTF8STRING));
+        appendString(sBuffer, pUTF8StringArg->getValue());
+    } else if (const Arg<string>* pStringArg = dynamic_cast<const Arg<string>*>(pArg)) {
+        sBuffer.push_back(char(ARG_STRING));
+        appendString(sBuffer, pStringArg->getValue());
+    } else if (const Arg<int>* pIntArg = dynamic_cast<const Arg<int>*>(pArg)) {
+        sBuffer.push_back(char(ARG_INT));
+        appendValue(sBuffer, pIntArg->getValue());
+    } else if (const Arg<float>* pFloatArg = dynamic_cast<const Arg<float>*>(pArg)) {
+        sBuffer.push_back(char(ARG_FLOAT));
+        appendValue(sBuffer, pFloatArg->getValue());
+    } else if (const Arg<bool>* pBoolArg = dynamic_cast<const Arg<bool>*>(pArg)) {
+        sBuffer.push_back(char(ARG_BOOL));
+        sBuffer.push_back(char(pBoolArg->getValue()));
+    } else if (const Arg<glm::vec2>* pVec2Arg = dynamic_cast<const Arg<glm::vec2>*>(pArg))
+    {
+        sBuffer.push_back(char(ARG_VEC2));
+        appendValue(sBuffer, pVec2Arg->getValue());
+    } else if (const Arg<glm::vec3>* pVec3Arg = dynamic_cast<const Arg<glm::vec3>*>(pArg))
+    {
+        sBuffer.push_back(char(ARG_VEC3));
+        appendValue(sBuffer, pVec3Arg->getValue());
+    } else if (const Arg<glm::ivec3>* pIVec3Arg = 
+            dynamic_cast<const Arg<glm::ivec3>*>(pArg))
+    {
+        sBuffer.push_back(char(ARG_IVEC3));
+        appendValue(sBuffer, pIVec3Arg->getValue());
+    } else if (const Arg<vector<float> >* pFVectorArg = 
+            dynamic_cast<const Arg<vector<float> >*>(pArg))
+    {
+        sBuffer.push_back(char(ARG_FLOAT_VECTOR));
+        appendVector(sBuffer, pFVectorArg->getValue());
+    } else if (const Arg<vector<int> >* pIVectorArg = 
+            dynamic_cast<const Arg<vector<int> >*>(pArg))
+    {
+        sBuffer.push_back(char(ARG_INT_VECTOR));
+        appendVector(sBuffer, pIVectorArg->getValue());
+    } else if (const Arg<vector<glm::vec2> >* pVec2VectorArg = 
+            dynamic_cast<const Arg<vector<glm::vec2> >*>(pArg))
+    {
+        sBuffer.push_back(char(ARG_VEC2_VECTOR));
+        appendVector(sBuffer, pVec2VectorArg->getValue());
+    } else if (const Arg<vector<glm::ivec3> >* pIVec3VectorArg = 
+            dynamic_cast<const Arg<vector<glm::ivec3> >*>(pArg))
+    {
+        sBuffer.push_back(char(ARG_IVEC3_VECTOR));
+        appendVector(sBuffer, pIVec3VectorArg->getValue());
+    } else if (const Arg<CollVec2Vector>* pCollVec2VectorArg = 
+            dynamic_cast<const Arg<CollVec2Vector>*>(pArg))
+    {
+        sBuffer.push_back(char(ARG_COLL_VEC2_VECTOR));
+        const CollVec2Vector& v = pCollVec2VectorArg->getValue();
+        appendValue(sBuffer, unsigned(v.size()));
+        for (unsigned i = 0; i < v.size(); ++i) {
+            appendVector(sBuffer, v[i]);
+        }
+    } else if (const Arg<Color>* pColorArg = dynamic_cast<const Arg<Color>*>(pArg)) {
+        sBuffer.push_back(char(ARG_COLOR));
+        const Color& color = pColorArg->getValue();
+        sBuffer.push_back(char(color.getR()));
+        sBuffer.push_back(char(color.getG()));
+        sBuffer.push_back(char(color.getB()));
+    } else {
+        return false;
+    }
+    return true;
+}
+
+unsigned SceneFileWriter::getStringIndex(const string& s)
+{
+    map<string, unsigned>::iterator it = m_StringIndexes.find(s);
+    if (it != m_StringIndexes.end()) {
+        return it->second;
+    }
+    unsigned index = unsigned(m_Strings.size());
+    m_Strings.push_back(s);
+    m_StringIndexes[s] = index;
+    return index;
+}
+
+
+SceneFileReader::SceneFileReader(const string& sFilename)
+    : m_File(sFilename)
+{
+    m_pCur = m_File.getData();
+    m_pEnd = m_pCur + m_File.getSize();
+    checkAvailable(sizeof(SCENE_FILE_MAGIC));
+    if (memcmp(m_pCur, SCENE_FILE_MAGIC, sizeof(SCENE_FILE_MAGIC)) != 0) {
+        throw Exception(AVG_ERR_FILEIO, sFilename+" is not a scene file.");
+    }
+    m_pCur += sizeof(SCENE_FILE_MAGIC);
+    unsigned version = readValue<unsigned>();
+    if (version != SCENE_FILE_VERSION) {
+        throw Exception(AVG_ERR_FILEIO, sFilename+": Unsupported scene file version "
+                +toString(version)+".");
+    }
+    if (readValue<unsigned>() != SCENE_FILE_BYTE_ORDER) {
+        throw Exception(AVG_ERR_FILEIO, sFilename+
+                ": Scene file was written on a machine with different byte order.");
+    }
+    unsigned numStrings = readValue<unsigned>();
+    m_Strings.reserve(numStrings);
+    for (unsigned i = 0; i < numStrings; ++i) {
+        m_Strings.push_back(readString());
+    }
+    m_TypeDefs.resize(numStrings, 0);
+    m_pNodeData = m_pCur;
+}
+
+SceneFileReader::~SceneFileReader()
+{
+}
+
+NodePtr SceneFileReader::createNodes()
+{
+    m_pCur = m_pNodeData;
+    NodePtr pRootNode = readNode();
+    if (m_pCur != m_pEnd) {
+        throw Exception(AVG_ERR_FILEIO, m_File.getFilename()+
+                ": Unexpected data at end of scene file.");
+    }
+    return pRootNode;
+}
+
+NodePtr SceneFileReader::readNode()
+{
+    unsigned typeIndex = readValue<unsigned>();
+    if (typeIndex >= m_Strings.size()) {
+        throw Exception(AVG_ERR_FILEIO, m_File.getFilename()+": Corrupt scene file.");
+    }
+    // Type lookups are cached per string table entry.
+    const TypeDefinition* pDef = m_TypeDefs[typeIndex];
+    if (!pDef) {
+        pDef = &(TypeRegistry::get()->getTypeDef(m_Strings[typeIndex]));
+        m_TypeDefs[typeIndex] = pDef;
+    }
+
+    ArgList args;
+    args.copyArgsFrom(pDef->getDefaultArgs());
+    unsigned numArgs = readValue<unsigned>();
+    for (unsigned i = 0; i < numArgs; ++i) {
+        readArg(args);
+    }
+    NodePtr pNode = boost::dynamic_pointer_cast<Node>(
+            TypeRegistry::get()->createObject(*pDef, args));
+
+    unsigned numChildren = readValue<unsigned>();
+    if (numChildren > 0) {
+        DivNodePtr pDivNode = boost::dynamic_pointer_cast<DivNode>(pNode);
+        if (!pDivNode) {
+            throw Exception(AVG_ERR_FILEIO, m_File.getFilename()+": Node of type "
+                    +pDef->getName()+" can't have children.");
+        }
+        for (unsigned i = 0; i < numChildren; ++i) {
+            pDivNode->appendChild(readNode());
+        }
+    }
+    return pNode;
+}
+
+void SceneFileReader::readArg(ArgList& args)
+{
+    const string& sName = readStringRef();
+    unsigned char typeTag = readValue<unsigned char>();
+    switch (typeTag) {
+        case ARG_STRING:
+            args.setArgVal<string>(sName, readString());
+            break;
+        case ARG_UTF8STRING:
+            args.setArgVal<UTF8String>(sName, readString());
+            break;
+        case ARG_INT:
+            args.setArgVal<int>(sName, readValue<int>());
+            break;
+        case ARG_FLOAT:
+            args.setArgVal<float>(sName, readValue<float>());
+            break;
+        case ARG_BOOL:
+            args.setArgVal<bool>(sName, readValue<unsigned char>() != 0);
+            break;
+        case ARG_VEC2:
+            args.setArgVal<glm::vec2>(sName, readValue<glm::vec2>());
+            break;
+        case ARG_VEC3:
+            args.setArgVal<glm::vec3>(sName, readValue<glm::vec3>());
+            break;
+        case ARG_IVEC3:
+            args.setArgVal<glm::ivec3>(sName, readValue<glm::ivec3>());
+            break;
+        case ARG_FLOAT_VECTOR: {
+                vector<float> v;
+                readVector(v);
+                args.setArgVal(sName, v);
+            }
+            break;
+        case ARG_INT_VECTOR: {
+                vector<int> v;
+                readVector(v);
+                args.setArgVal(sName, v);
+            }
+            break;
+        case ARG_VEC2_VECTOR: {
+                vector<glm::vec2> v;
+                readVector(v);
+                args.setArgVal(sName, v);
+            }
+            break;
+        case ARG_IVEC3_VECTOR: {
+                vector<glm::ivec3> v;
+                readVector(v);
+                args.setArgVal(sName, v);
+            }
+            break;
+        case ARG_COLL_VEC2_VECTOR: {
+                CollVec2Vector v(readValue<unsigned>());
+                for (unsigned i = 0; i < v.size(); ++i) {
+                    readVector(v[i]);
+                }
+                args.setArgVal(sName, v);
+            }
+            break;
+        case ARG_COLOR: {
+                unsigned char r = readValue<unsigned char>();
+                unsigned char g = readValue<unsigned char>();
+                unsigned char b = readValue<unsigned char>();
+                args.setArgVal(sName, Color(r, g, b));
+            }
+            break;
+        default:
+            throw Exception(AVG_ERR_FILEIO, m_File.getFilename()+
+                    ": Unknown argument type in scene file.");
+    }
+}
+
+const string& SceneFileReader::readStringRef()
+{
+    unsigned index = readValue<unsigned>();
+    if (index >= m_Strings.size()) {
+        throw Exception(AVG_ERR_FILEIO, m_File.getFilename()+": Corrupt scene file.");
+    }
+    return m_Strings[index];
+}
+
+string SceneFileReader::readString()
+{
+    unsigned len = readValue<unsigned>();
+    checkAvailable(len);
+    string s((const char*)m_pCur, len);
+    m_pCur += len;
+    return s;
+}
+
+void SceneFileReader::checkAvailable(size_t numBytes) const
+{
+    if (size_t(m_pEnd-m_pCur) < numBytes) {
+        throw Exception(AVG_ERR_FILEIO, m_File.getFilename()+
+                ": Unexpected end of scene file.");
+    }
+}
+
+template<class T>
+T SceneFileReader::readValue()
+{
+    checkAvailable(sizeof(T));
+    // The mapped data isn't necessarily aligned, so values are copied out.
+    T val;
+    memcpy((void*)&val, m_pCur, sizeof(T));
+    m_pCur += sizeof(T);
+    return val;
+}
+
+template<class T>
+void SceneFileReader::readVector(vector<T>& v)
+{
+    unsigned size = readValue<unsigned>();
+    checkAvailable(size_t(size)*sizeof(T));
+    v.resize(size);
+    if (size > 0) {
+        memcpy((void*)&v[0], m_pCur, size*sizeof(T));
+        m_pCur += size*sizeof(T);
+    }
+}
+
+}
@@ -0,0 +1,105 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _SceneFile_H_
+#define _SceneFile_H_
+
+#include "../api.h"
+
+#include "../base/MappedFile.h"
+
+#include <libxml/parser.h>
+#include <boost/shared_ptr.hpp>
+
+#include <string>
+#include <vector>
+#include <map>
+
+namespace avg {
+
+class Node;
+typedef boost::shared_ptr<Node> NodePtr;
+class ArgBase;
+class ArgList;
+class TypeDefinition;
+
+// Compact binary serialization of a node tree. A scene file consists of a header,
+// a string table holding node type and attribute names and a depth-first list of
+// nodes. Attribute values are stored in their native binary representation, so
+// loading a scene file involves no xml or string parsing.
+
+bool AVG_API isSceneFile(const std::string& sFilename);
+
+class AVG_API SceneFileWriter
+{
+public:
+    SceneFileWriter();
+    virtual ~SceneFileWriter();
+
+    void addNodeTree(const NodePtr& pRootNode);
+    void addAVG(const std::string& sAVG, const std::string& sAVGFilename);
+    void save(const std::string& sFilename) const;
+
+private:
+    void writeNode(const NodePtr& pNode);
+    void writeXmlNode(const xmlDocPtr xmlDoc, const xmlNodePtr xmlNode);
+    void writeNodeHeader(const TypeDefinition& def, const ArgList& args);
+    bool writeArg(const ArgBase& arg, std::string& sBuffer) const;
+    unsigned getStringIndex(const std::string& s);
+
+    std::map<std::string, unsigned> m_StringIndexes;
+    std::vector<std::string> m_Strings;
+    std::string m_sNodeData;
+    bool m_bHasRoot;
+};
+
+class AVG_API SceneFileReader
+{
+public:
+    SceneFileReader(const std::string& sFilename);
+    virtual ~SceneFileReader();
+
+    NodePtr createNodes();
+
+private:
+    NodePtr readNode();
+    void readArg(ArgList& args);
+    const std::string& readStringRef();
+    std::string readString();
+    void checkAvailable(size_t numBytes) const;
+
+    template<class T>
+    T readValue();
+    template<class T>
+    void readVector(std::vector<T>& v);
+
+    MappedFile m_File;
+    const unsigned char* m_pNodeData;
+    const unsigned char* m_pCur;
+    const unsigned char* m_pEnd;
+
+    std::vector<std::string> m_Strings;
+    std::vector<const TypeDefinition*> m_TypeDefs;
+};
+
+}
+
+#endif
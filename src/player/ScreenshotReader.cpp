@@ -0,0 +1,265 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "ScreenshotReader.h"
+
+#include "DisplayEngine.h"
+#include "OffscreenCanvas.h"
+#include "Window.h"
+
+#include "../base/Exception.h"
+#include "../base/ScopeTimer.h"
+
+#include "../graphics/Bitmap.h"
+#include "../graphics/FilterUnmultiplyAlpha.h"
+#include "../graphics/GLContext.h"
+#include "../graphics/GLTexture.h"
+#include "../graphics/PBO.h"
+#include "../graphics/MCFBO.h"
+#include "../graphics/FBO.h"
+
+using namespace std;
+
+namespace avg {
+
+// Number of readbacks that can be in flight at the same time.
+static const unsigned NUM_SLOTS = 3;
+// Number of frames between issuing a readback and mapping the PBO.
+static const long long READBACK_LATENCY = 2;
+
+ScreenshotReader::Slot::Slot()
+    : m_bIsCanvas(false),
+      m_bInFlight(false),
+      m_FrameNum(0)
+{
+}
+
+ScreenshotReader::ScreenshotReader(DisplayEngine* pDisplayEngine)
+    : m_pDisplayEngine(pDisplayEngine),
+      m_Slots(NUM_SLOTS),
+      m_CurSlot(0),
+      m_FrameNum(0)
+{
+}
+
+ScreenshotReader::~ScreenshotReader()
+{
+    // PBOs need to be deleted in the context they were created in. Pending callbacks
+    // are discarded.
+    GLContext* pOldContext = GLContext::getCurrent();
+    for (unsigned i = 0; i < m_pDisplayEngine->getNumWindows(); ++i) {
+        m_pDisplayEngine->getWindow(i)->getGLContext()->activate();
+        for (unsigned j = 0; j < m_Slots.size(); ++j) {
+            if (i < m_Slots[j].m_pPBOs.size()) {
+                m_Slots[j].m_pPBOs[i] = PBOPtr();
+            }
+        }
+    }
+    if (pOldContext) {
+        pOldContext->activate();
+    }
+}
+
+void ScreenshotReader::requestScreenshot(const boost::python::object& callback,
+        const OffscreenCanvasPtr& pCanvas)
+{
+    Request request;
+    request.m_Callback = callback;
+    request.m_pCanvas = pCanvas;
+    m_Requests.push_back(request);
+}
+
+static ProfilingZoneID ScreenshotProfilingZone("Async screenshot");
+
+void ScreenshotReader::onFrameEnd()
+{
+    ScopeTimer timer(ScreenshotProfilingZone);
+    m_FrameNum++;
+    // Deliver old readbacks first, oldest first, so callbacks arrive in request order.
+    for (unsigned i = 0; i < m_Slots.size(); ++i) {
+        Slot& slot = m_Slots[(m_CurSlot+i) % m_Slots.size()];
+        if (slot.m_bInFlight && m_FrameNum - slot.m_FrameNum >= READBACK_LATENCY) {
+            finishReadback(slot);
+        }
+    }
+    // Requests made by callbacks are handled in the next frame.
+    vector<Request> requests;
+    requests.swap(m_Requests);
+    while (!requests.empty()) {
+        // All requests for the same canvas share one readback.
+        OffscreenCanvasPtr pCanvas = requests[0].m_pCanvas;
+        vector<boost::python::object> callbacks;
+        vector<Request> otherRequests;
+        for (unsigned i = 0; i < requests.size(); ++i) {
+            if (requests[i].m_pCanvas == pCanvas) {
+                callbacks.push_back(requests[i].m_Callback);
+            } else {
+                otherRequests.push_back(requests[i]);
+            }
+        }
+        requests.swap(otherRequests);
+        if (pCanvas && !pCanvas->isRunning()) {
+            // The canvas was deleted after the request.
+            continue;
+        }
+        Slot& slot = m_Slots[m_CurSlot];
+        if (slot.m_bInFlight) {
+            // All slots are busy: Wait for the oldest readback.
+            finishReadback(slot);
+        }
+        slot.m_Callbacks.swap(callbacks);
+        if (pCanvas) {
+            startCanvasReadback(slot, pCanvas);
+        } else {
+            startReadback(slot);
+        }
+        m_CurSlot = (m_CurSlot+1) % m_Slots.size();
+    }
+}
+
+static void ensurePBO(PBOPtr& pPBO, const IntPoint& size, PixelFormat pf)
+{
+    // Slots are reused for the main canvas and for offscreen canvases of any size.
+    if (!pPBO || pPBO->getSize() != size || pPBO->getPF() != pf) {
+        pPBO = PBOPtr(new PBO(size, pf, GL_STREAM_READ));
+    }
+}
+
+void ScreenshotReader::startReadback(Slot& slot)
+{
+    // Called after rendering and before the buffer swap, so the back buffer contains
+    // the current frame.
+    slot.m_bIsCanvas = false;
+    slot.m_bInFlight = true;
+    slot.m_FrameNum = m_FrameNum;
+    if (!isPBOReadbackSupported()) {
+        slot.m_pBmp = m_pDisplayEngine->screenshot(GL_BACK);
+        return;
+    }
+#ifndef AVG_ENABLE_EGL
+    GLContext* pOldContext = GLContext::getCurrent();
+    unsigned numWindows = m_pDisplayEngine->getNumWindows();
+    if (slot.m_pPBOs.size() < numWindows) {
+        slot.m_pPBOs.resize(numWindows);
+    }
+    for (unsigned i = 0; i < numWindows; ++i) {
+        WindowPtr pWindow = m_pDisplayEngine->getWindow(i);
+        pWindow->getGLContext()->activate();
+        const IntPoint& size = pWindow->getSize();
+        ensurePBO(slot.m_pPBOs[i], size, B8G8R8X8);
+        MCFBOPtr pRenderTarget = pWindow->getRenderTarget();
+        if (pRenderTarget) {
+            pRenderTarget->getCurFBO(pWindow->getGLContext())->moveToPBO(
+                    *slot.m_pPBOs[i]);
+        } else {
+            glproc::BindFramebuffer(GL_FRAMEBUFFER, 0);
+            glReadBuffer(GL_BACK);
+            GLContext::checkError("ScreenshotReader::startReadback: glReadBuffer()");
+            slot.m_pPBOs[i]->moveFramebufferToPBO(size);
+        }
+    }
+    if (pOldContext) {
+        pOldContext->activate();
+    }
+#endif
+}
+
+void ScreenshotReader::startCanvasReadback(Slot& slot, const OffscreenCanvasPtr& pCanvas)
+{
+    slot.m_bIsCanvas = true;
+    slot.m_bInFlight = true;
+    slot.m_FrameNum = m_FrameNum;
+    GLContext* pOldContext = GLContext::getCurrent();
+    GLContext* pContext = m_pDisplayEngine->getWindow(0)->getGLContext();
+    pContext->activate();
+    if (isPBOReadbackSupported()) {
+        FBOPtr pFBO = pCanvas->getFBO(pContext);
+        if (slot.m_pPBOs.empty()) {
+            slot.m_pPBOs.resize(1);
+        }
+        ensurePBO(slot.m_pPBOs[0], pFBO->getSize(), pFBO->getTex()->getPF());
+        pFBO->moveToPBO(*slot.m_pPBOs[0]);
+    } else {
+        slot.m_pBmp = pCanvas->screenshotIgnoreAlpha();
+    }
+    if (pOldContext) {
+        pOldContext->activate();
+    }
+}
+
+void ScreenshotReader::finishReadback(Slot& slot)
+{
+    AVG_ASSERT(slot.m_bInFlight);
+    BitmapPtr pBmp = slot.m_pBmp;
+    if (!pBmp && slot.m_bIsCanvas) {
+        GLContext* pOldContext = GLContext::getCurrent();
+        m_pDisplayEngine->getWindow(0)->getGLContext()->activate();
+        pBmp = slot.m_pPBOs[0]->movePBOToBmp();
+        if (pOldContext) {
+            pOldContext->activate();
+        }
+    } else if (!pBmp) {
+        GLContext* pOldContext = GLContext::getCurrent();
+        unsigned numWindows = m_pDisplayEngine->getNumWindows();
+        IntRect destRect;
+        for (unsigned i = 0; i < numWindows; ++i) {
+            WindowPtr pWindow = m_pDisplayEngine->getWindow(i);
+            destRect.expand(IntRect(pWindow->getPos(), 
+                    pWindow->getPos()+pWindow->getSize()));
+        }
+        for (unsigned i = 0; i < numWindows; ++i) {
+            WindowPtr pWindow = m_pDisplayEngine->getWindow(i);
+            pWindow->getGLContext()->activate();
+            // The flip happens while copying out of the mapped buffer.
+            BitmapPtr pWinBmp = slot.m_pPBOs[i]->movePBOToBmp(true);
+            if (numWindows == 1) {
+                pBmp = pWinBmp;
+            } else {
+                if (!pBmp) {
+                    pBmp = BitmapPtr(new Bitmap(destRect.size(), B8G8R8X8));
+                }
+                pBmp->blt(*pWinBmp, pWindow->getPos() - destRect.tl);
+            }
+        }
+        if (pOldContext) {
+            pOldContext->activate();
+        }
+    }
+    if (slot.m_bIsCanvas) {
+        // Same result as OffscreenCanvas::screenshot().
+        FilterUnmultiplyAlpha().applyInPlace(pBmp);
+    }
+    vector<boost::python::object> callbacks;
+    callbacks.swap(slot.m_Callbacks);
+    slot.m_pBmp = BitmapPtr();
+    slot.m_bInFlight = false;
+    for (unsigned i = 0; i < callbacks.size(); ++i) {
+        boost::python::call<void>(callbacks[i].ptr(), pBmp);
+    }
+}
+
+bool ScreenshotReader::isPBOReadbackSupported() const
+{
+    GLContext* pContext = m_pDisplayEngine->getWindow(0)->getGLContext();
+    return pContext->getMemoryMode() == MM_PBO && !pContext->isGLES();
+}
+
+}
@@ -0,0 +1,95 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _ScreenshotReader_H_
+#define _ScreenshotReader_H_
+
+#include "../api.h"
+#include "WrapPython.h"
+
+#include "../base/IFrameEndListener.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/python.hpp>
+
+#include <vector>
+
+namespace avg {
+
+class DisplayEngine;
+class OffscreenCanvas;
+typedef boost::shared_ptr<OffscreenCanvas> OffscreenCanvasPtr;
+class PBO;
+typedef boost::shared_ptr<PBO> PBOPtr;
+class Bitmap;
+typedef boost::shared_ptr<Bitmap> BitmapPtr;
+
+// Asynchronous screenshots of the main canvas and of offscreen canvases. Readbacks go
+// into a ring of pack PBOs and are mapped a few frames later, so the GPU pipeline isn't
+// stalled.
+class AVG_API ScreenshotReader: public IFrameEndListener
+{
+    public:
+        ScreenshotReader(DisplayEngine* pDisplayEngine);
+        virtual ~ScreenshotReader();
+
+        // An empty pCanvas requests a screenshot of the main canvas.
+        void requestScreenshot(const boost::python::object& callback,
+                const OffscreenCanvasPtr& pCanvas=OffscreenCanvasPtr());
+
+        virtual void onFrameEnd();
+
+    private:
+        struct Request {
+            boost::python::object m_Callback;
+            OffscreenCanvasPtr m_pCanvas;
+        };
+
+        struct Slot {
+            Slot();
+
+            // Main canvas: One PBO per window. Offscreen canvas: One PBO in the first
+            // window's context.
+            std::vector<PBOPtr> m_pPBOs;
+            std::vector<boost::python::object> m_Callbacks;
+            BitmapPtr m_pBmp;
+            bool m_bIsCanvas;
+            bool m_bInFlight;
+            long long m_FrameNum;
+        };
+
+        void startReadback(Slot& slot);
+        void startCanvasReadback(Slot& slot, const OffscreenCanvasPtr& pCanvas);
+        void finishReadback(Slot& slot);
+        bool isPBOReadbackSupported() const;
+
+        DisplayEngine* m_pDisplayEngine;
+        std::vector<Slot> m_Slots;
+        unsigned m_CurSlot;
+        long long m_FrameNum;
+        std::vector<Request> m_Requests;
+};
+
+typedef boost::shared_ptr<ScreenshotReader> ScreenshotReaderPtr;
+
+}
+
+#endif
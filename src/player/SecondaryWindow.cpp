@@ -55,7 +55,7 @@ SecondaryWindow::SecondaryWindow(const WindowParams& wp, bool bIsFullscreen,
     IntRect windowDimensions(wp.m_Pos, wp.m_Pos+wp.m_Size);
     string sDisplay = ":0." + toString(wp.m_DisplayServer);
     pGLContext = new GLXContext(glConfig, sDisplay, windowDimensions,
-            wp.m_bHasWindowFrame);
+            wp.m_bHasWindowFrame, dynamic_cast<GLXContext*>(pMainContext));
     setGLContext(pGLContext);
     
     pMainContext->activate();
@@ -71,7 +71,7 @@ void SecondaryWindow::setTitle(const std::string& sTitle)
 {
 }
 
-static ProfilingZoneID SwapBufferProfilingZone("Render - swap buffers");
+static ProfilingZoneID SwapBufferProfilingZone("Render - swap buffers", true);
 
 void SecondaryWindow::swapBuffers() const
 {
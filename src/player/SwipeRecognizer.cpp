@@ -0,0 +1,117 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "SwipeRecognizer.h"
+
+#include "Contact.h"
+#include "CursorEvent.h"
+#include "Player.h"
+
+#include "../base/Exception.h"
+#include "../base/MathHelper.h"
+#include "../base/StringHelper.h"
+
+using namespace std;
+
+namespace avg {
+
+SwipeRecognizer::SwipeRecognizer(NodePtr pNode, int direction, int numContacts,
+        CursorEventPtr pInitialEvent, float directionTolerance, float minDist,
+        float maxContactDist, const py::object& possibleHandler, 
+        const py::object& failHandler, const py::object& detectedHandler)
+    : Recognizer(pNode, false, numContacts, possibleHandler, failHandler, 
+            detectedHandler, py::object()),
+      m_NumContacts(numContacts),
+      m_AngleWanted(angleFromDirection(direction)),
+      m_DirectionTolerance(directionTolerance),
+      m_MinDist(minDist*Player::get()->getPixelsPerMM()),
+      m_MaxInterContactDist(maxContactDist*Player::get()->getPixelsPerMM()),
+      m_StartPos(0,0)
+{
+    handleInitialEvent(pInitialEvent);
+}
+
+SwipeRecognizer::~SwipeRecognizer()
+{
+}
+
+void SwipeRecognizer::handleDown(CursorEventPtr pEvent)
+{
+    if (getNumContacts() == 1) {
+        m_StartPos = pEvent->getPos();
+    } else {
+        if (glm::length(pEvent->getPos()-m_StartPos) > m_MaxInterContactDist) {
+            setFail();
+            return;
+        }
+    }
+    if (getNumContacts() == m_NumContacts) {
+        setPossible();
+    }
+}
+
+void SwipeRecognizer::handleUp(CursorEventPtr pEvent)
+{
+    if (getStateEnum() == POSSIBLE) {
+        ContactPtr pContact = pEvent->getContact();
+        if (pContact->getDistanceFromStart() < m_MinDist ||
+                !isValidAngle(pContact->getMotionAngle()))
+        {
+            setFail();
+        } else if (getNumContacts() == 0) {
+            setDetected();
+        }
+    }
+}
+
+float SwipeRecognizer::angleFromDirection(int direction)
+{
+    switch (direction) {
+        case RIGHT:
+            return 0;
+        case DOWN:
+            return float(M_PI/2);
+        case LEFT:
+            return float(M_PI);
+        case UP:
+            return float(3*M_PI/2);
+        default:
+            throw Exception(AVG_ERR_INVALID_ARGS, 
+                    toString(direction) + " is not a valid direction.");
+    }
+}
+
+bool SwipeRecognizer::isValidAngle(float angle) const
+{
+    if (angle < 0) {
+        angle += float(2*M_PI);
+    }
+    float minAngle = m_AngleWanted - m_DirectionTolerance;
+    float maxAngle = m_AngleWanted + m_DirectionTolerance;
+    if (minAngle >= 0) {
+        return minAngle < angle && angle < maxAngle;
+    } else {
+        // Valid range spans 0
+        return angle > minAngle+2*M_PI || angle < maxAngle;
+    }
+}
+
+}
@@ -0,0 +1,66 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _SwipeRecognizer_H_
+#define _SwipeRecognizer_H_
+
+#include "../api.h"
+
+#include "Recognizer.h"
+
+#include "../base/GLMHelper.h"
+
+#include <boost/shared_ptr.hpp>
+
+namespace avg {
+
+class AVG_API SwipeRecognizer: public Recognizer
+{
+public:
+    enum Direction {LEFT=1, RIGHT, UP, DOWN};
+
+    SwipeRecognizer(NodePtr pNode, int direction, int numContacts,
+            CursorEventPtr pInitialEvent, float directionTolerance, float minDist,
+            float maxContactDist, const py::object& possibleHandler, 
+            const py::object& failHandler, const py::object& detectedHandler);
+    virtual ~SwipeRecognizer();
+
+protected:
+    virtual void handleDown(CursorEventPtr pEvent);
+    virtual void handleUp(CursorEventPtr pEvent);
+
+private:
+    static float angleFromDirection(int direction);
+    bool isValidAngle(float angle) const;
+
+    int m_NumContacts;
+    float m_AngleWanted;
+    float m_DirectionTolerance;
+    float m_MinDist;
+    float m_MaxInterContactDist;
+    glm::vec2 m_StartPos;
+};
+
+typedef boost::shared_ptr<SwipeRecognizer> SwipeRecognizerPtr;
+
+}
+
+#endif
@@ -0,0 +1,86 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "TapRecognizer.h"
+
+#include "Contact.h"
+#include "CursorEvent.h"
+#include "Player.h"
+
+using namespace std;
+
+namespace avg {
+
+TapRecognizer::TapRecognizer(NodePtr pNode, float maxTime, float maxDist, 
+        CursorEventPtr pInitialEvent, const py::object& possibleHandler, 
+        const py::object& failHandler, const py::object& detectedHandler)
+    : Recognizer(pNode, false, 1, possibleHandler, failHandler, detectedHandler,
+            py::object()),
+      m_MaxTime(maxTime),
+      m_MaxDist(maxDist),
+      m_StartTime(0)
+{
+    handleInitialEvent(pInitialEvent);
+}
+
+TapRecognizer::~TapRecognizer()
+{
+}
+
+void TapRecognizer::handleDown(CursorEventPtr pEvent)
+{
+    setPossible();
+    m_StartTime = Player::get()->getFrameTime();
+}
+
+void TapRecognizer::handleMove(CursorEventPtr pEvent)
+{
+    if (getStateEnum() != IDLE && isTooFar(pEvent)) {
+        setFail();
+    }
+}
+
+void TapRecognizer::handleUp(CursorEventPtr pEvent)
+{
+    if (getStateEnum() == POSSIBLE) {
+        if (isTooFar(pEvent)) {
+            setFail();
+        } else {
+            setDetected();
+        }
+    }
+}
+
+void TapRecognizer::handleFrame()
+{
+    long long downTime = Player::get()->getFrameTime() - m_StartTime;
+    if (getStateEnum() == POSSIBLE && m_MaxTime > 0 && downTime > m_MaxTime) {
+        setFail();
+    }
+}
+
+bool TapRecognizer::isTooFar(CursorEventPtr pEvent) const
+{
+    return pEvent->getContact()->getDistanceFromStart() > 
+            m_MaxDist*Player::get()->getPixelsPerMM();
+}
+
+}
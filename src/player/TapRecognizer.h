@@ -0,0 +1,59 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _TapRecognizer_H_
+#define _TapRecognizer_H_
+
+#include "../api.h"
+
+#include "Recognizer.h"
+
+#include <boost/shared_ptr.hpp>
+
+namespace avg {
+
+class AVG_API TapRecognizer: public Recognizer
+{
+public:
+    TapRecognizer(NodePtr pNode, float maxTime, float maxDist, 
+            CursorEventPtr pInitialEvent, const py::object& possibleHandler, 
+            const py::object& failHandler, const py::object& detectedHandler);
+    virtual ~TapRecognizer();
+
+protected:
+    virtual void handleDown(CursorEventPtr pEvent);
+    virtual void handleMove(CursorEventPtr pEvent);
+    virtual void handleUp(CursorEventPtr pEvent);
+    virtual void handleFrame();
+
+private:
+    bool isTooFar(CursorEventPtr pEvent) const;
+
+    float m_MaxTime;
+    float m_MaxDist;
+    long long m_StartTime;
+};
+
+typedef boost::shared_ptr<TapRecognizer> TapRecognizerPtr;
+
+}
+
+#endif
@@ -26,6 +26,7 @@
 
 #include "../base/Exception.h"
 #include "../base/StringHelper.h"
+#include "../base/TimeSource.h"
 
 #include <iostream>
 
@@ -33,10 +34,14 @@ using namespace std;
 
 namespace avg {
 
-TouchStatus::TouchStatus(CursorEventPtr pEvent)
+TouchStatus::TouchStatus(CursorEventPtr pEvent, float filterMinCutoff, float filterBeta)
     : m_bFirstFrame(true),
-      m_CursorID(pEvent->getCursorID())
+      m_CursorID(pEvent->getCursorID()),
+      m_bFilter(filterMinCutoff > 0),
+      m_XFilter(m_bFilter ? filterMinCutoff : 1, filterBeta),
+      m_YFilter(m_bFilter ? filterMinCutoff : 1, filterBeta)
 {
+    filterEvent(pEvent);
     m_pNewEvents.push_back(pEvent);
     m_pLastEvent = pEvent;
 }
@@ -49,6 +54,7 @@ void TouchStatus::pushEvent(CursorEventPtr pEvent, bool bCheckMotion)
 {
     AVG_ASSERT(pEvent);
     pEvent->setCursorID(m_CursorID);
+    filterEvent(pEvent);
 
     if (m_bFirstFrame) {
         // Ignore unless cursorup.
@@ -104,5 +110,20 @@ int TouchStatus::getID() const
     return m_CursorID;
 }
 
+void TouchStatus::filterEvent(CursorEventPtr pEvent)
+{
+    if (!m_bFilter) {
+        return;
+    }
+    // Filter every sample the driver delivers, not just the ones that survive until
+    // the next poll. Event timestamps are frame times, so they can't be used here.
+    double time = TimeSource::get()->getCurrentMicrosecs()/1000.;
+    glm::vec2 rawPos = pEvent->getPos();
+    glm::vec2 pos(m_XFilter.apply(rawPos.x, time), m_YFilter.apply(rawPos.y, time));
+    // The filter derivative is in pixels per second, event speeds in pixels per ms.
+    glm::vec2 speed(m_XFilter.getDerivative()/1000., m_YFilter.getDerivative()/1000.);
+    pEvent->setFilteredState(pos, speed);
+}
+
 }
 
@@ -24,6 +24,8 @@
 
 #include "../api.h"
 
+#include "../base/OneEuroFilter.h"
+
 #include <boost/shared_ptr.hpp>
 
 #include <vector>
@@ -35,7 +37,9 @@ typedef boost::shared_ptr<class CursorEvent> CursorEventPtr;
 
 class AVG_API TouchStatus {
 public:
-    TouchStatus(CursorEventPtr pEvent);
+    // If filterMinCutoff > 0, positions are smoothed with a one-euro filter and the
+    // filtered state is attached to every event.
+    TouchStatus(CursorEventPtr pEvent, float filterMinCutoff=-1, float filterBeta=0);
     virtual ~TouchStatus();
 
     void pushEvent(CursorEventPtr pEvent, bool bCheckMotion=true);
@@ -45,11 +49,17 @@ public:
     int getID() const;
 
 private:
+    void filterEvent(CursorEventPtr pEvent);
+
     CursorEventPtr m_pLastEvent;
     std::vector<CursorEventPtr> m_pNewEvents;
 
     bool m_bFirstFrame;
     int m_CursorID;
+
+    bool m_bFilter;
+    OneEuroFilter m_XFilter;
+    OneEuroFilter m_YFilter;
 };
 
 typedef boost::shared_ptr<class TouchStatus> TouchStatusPtr;
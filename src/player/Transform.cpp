@@ -0,0 +1,106 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "Transform.h"
+
+#include <sstream>
+
+using namespace std;
+
+namespace avg {
+
+namespace {
+
+// 2D homogenous matrices. glm matrices are column-major.
+glm::mat3 translateMat(const glm::vec2& t)
+{
+    glm::mat3 m(1.0f);
+    m[2][0] = t.x;
+    m[2][1] = t.y;
+    return m;
+}
+
+glm::mat3 rotateMat(float angle)
+{
+    glm::mat3 m(1.0f);
+    m[0][0] = cos(angle);
+    m[0][1] = sin(angle);
+    m[1][0] = -sin(angle);
+    m[1][1] = cos(angle);
+    return m;
+}
+
+glm::mat3 scaleMat(const glm::vec2& s)
+{
+    glm::mat3 m(1.0f);
+    m[0][0] = s.x;
+    m[1][1] = s.y;
+    return m;
+}
+
+}
+
+Transform::Transform(const glm::vec2& trans, float rot, float scale, 
+        const glm::vec2& pivot)
+    : m_Trans(trans),
+      m_Rot(rot),
+      m_Scale(scale),
+      m_Pivot(pivot)
+{
+}
+
+void Transform::moveNode(const py::object& node) const
+{
+    // Node attributes are accessed through python so properties overridden in python 
+    // derived classes are honored.
+    glm::vec2 pos = py::extract<glm::vec2>(node.attr("pos"));
+    glm::vec2 nodePivot = py::extract<glm::vec2>(node.attr("pivot"));
+    float angle = py::extract<float>(node.attr("angle"));
+    glm::vec2 size = py::extract<glm::vec2>(node.attr("size"));
+
+    glm::mat3 startTransform = translateMat(pos) * translateMat(nodePivot) * 
+            rotateMat(angle) * translateMat(-nodePivot) * scaleMat(size);
+    glm::mat3 newTransform = translateMat(m_Pivot) * rotateMat(m_Rot) * 
+            scaleMat(glm::vec2(m_Scale, m_Scale)) * translateMat(-m_Pivot) *
+            translateMat(m_Trans) * startTransform;
+
+    glm::vec3 xAxis = newTransform * glm::vec3(1, 0, 0);
+    glm::vec3 yAxis = newTransform * glm::vec3(0, 1, 0);
+    glm::vec3 origin = newTransform * glm::vec3(0, 0, 1);
+    float newAngle = getAngle(glm::vec2(xAxis));
+    glm::vec2 newSize(glm::length(glm::vec2(xAxis)), glm::length(glm::vec2(yAxis)));
+    glm::vec2 newPivot = newSize/2.f;
+    py::setattr(node, "angle", py::object(newAngle));
+    py::setattr(node, "size", py::object(newSize));
+    py::setattr(node, "pivot", py::object(newPivot));
+    glm::vec2 newPos = glm::vec2(origin) + getRotated(newPivot, newAngle) - newPivot;
+    py::setattr(node, "pos", py::object(newPos));
+}
+
+string Transform::toString() const
+{
+    stringstream s;
+    s << "Transform(" << m_Trans << ", " << m_Rot << ", " << m_Scale << ", " << m_Pivot
+            << ")";
+    return s.str();
+}
+
+}
@@ -0,0 +1,53 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _Transform_H_
+#define _Transform_H_
+
+#include "../api.h"
+
+#include "../base/GLMHelper.h"
+
+#include "BoostPython.h"
+
+#include <string>
+
+namespace avg {
+
+// Incremental 2D transformation as delivered by gesture recognizers.
+class AVG_API Transform
+{
+public:
+    Transform(const glm::vec2& trans, float rot=0, float scale=1, 
+            const glm::vec2& pivot=glm::vec2(0,0));
+
+    void moveNode(const py::object& node) const;
+    std::string toString() const;
+
+    glm::vec2 m_Trans;
+    float m_Rot;
+    float m_Scale;
+    glm::vec2 m_Pivot;
+};
+
+}
+
+#endif
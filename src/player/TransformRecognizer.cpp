@@ -0,0 +1,307 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "TransformRecognizer.h"
+
+#include "Contact.h"
+#include "CursorEvent.h"
+#include "Node.h"
+#include "Player.h"
+
+#include "../base/MathHelper.h"
+
+using namespace std;
+
+namespace avg {
+
+namespace {
+
+glm::vec2 getCentroid(const vector<int>& indexes, const vector<glm::vec2>& pts)
+{
+    glm::vec2 c(0,0);
+    for (unsigned i=0; i<indexes.size(); ++i) {
+        c += pts[indexes[i]];
+    }
+    return c/float(indexes.size());
+}
+
+// Splits pts into two clusters, returning indexes into pts.
+void calcKMeans(const vector<glm::vec2>& pts, vector<int> clusters[2])
+{
+    AVG_ASSERT(pts.size() > 1);
+    glm::vec2 p1 = pts[0];
+    glm::vec2 p2 = pts[1];
+    glm::vec2 oldP1;
+    glm::vec2 oldP2;
+    bool bFirst = true;
+    int j = 0;
+    while ((bFirst || !(p1 == oldP1 && p2 == oldP2)) && j < 50) {
+        bFirst = false;
+        clusters[0].clear();
+        clusters[1].clear();
+        // Group points
+        for (unsigned i=0; i<pts.size(); ++i) {
+            float dist1 = glm::length(pts[i]-p1);
+            float dist2 = glm::length(pts[i]-p2);
+            if (dist1 < dist2) {
+                clusters[0].push_back(i);
+            } else {
+                clusters[1].push_back(i);
+            }
+        }
+        oldP1 = p1;
+        oldP2 = p2;
+        p1 = getCentroid(clusters[0], pts);
+        p2 = getCentroid(clusters[1], pts);
+        j++;
+    }
+}
+
+float vecAngle(const glm::vec2& pt1, const glm::vec2& pt2)
+{
+    float angle = fmod(getAngle(pt1) - getAngle(pt2), float(2*M_PI));
+    if (angle < 0) {
+        angle += float(2*M_PI);
+    }
+    return angle;
+}
+
+}
+
+TransformRecognizer::ContactFilter::ContactFilter(float minCutoff, float beta)
+    : m_XFilter(minCutoff, beta),
+      m_YFilter(minCutoff, beta)
+{
+}
+
+TransformRecognizer::TransformRecognizer(NodePtr pEventNode, NodePtr pCoordSysNode, 
+        CursorEventPtr pInitialEvent, float friction, float filterMinCutoff,
+        float filterBeta, const py::object& detectedHandler, 
+        const py::object& moveHandler, const py::object& upHandler, 
+        const py::object& endHandler)
+    : Recognizer(pEventNode, true, -1, py::object(), py::object(), detectedHandler,
+            endHandler),
+      m_pCoordSysNode(pCoordSysNode ? pCoordSysNode : pEventNode),
+      m_Friction(friction),
+      m_FilterMinCutoff(filterMinCutoff),
+      m_FilterBeta(filterBeta)
+{
+    verifyInitialEvent(pInitialEvent, m_pCoordSysNode.lock());
+    subscribeHandler("MOTION", moveHandler);
+    subscribeHandler("UP", upHandler);
+    handleInitialEvent(pInitialEvent);
+}
+
+TransformRecognizer::~TransformRecognizer()
+{
+}
+
+void TransformRecognizer::abort()
+{
+    doAbort();
+    Recognizer::abort();
+    updateFrameListener();
+}
+
+void TransformRecognizer::enable(bool bEnable)
+{
+    if (bEnable != isEnabled() && !bEnable) {
+        doAbort();
+    }
+    Recognizer::enable(bEnable);
+    updateFrameListener();
+}
+
+void TransformRecognizer::handleDown(CursorEventPtr pEvent)
+{
+    newPhase();
+    if (isFiltered()) {
+        m_Filters[pEvent->getContact()] = 
+                ContactFilterPtr(new ContactFilter(m_FilterMinCutoff, m_FilterBeta));
+    }
+    if (getNumContacts() == 1) {
+        if (m_pInertiaHandler) {
+            m_pInertiaHandler = InertiaHandlerPtr();
+            setEnd();
+        }
+        setDetected();
+        if (m_Friction != -1) {
+            m_pInertiaHandler = InertiaHandlerPtr(new InertiaHandler(m_Friction));
+        }
+    }
+}
+
+void TransformRecognizer::handleUp(CursorEventPtr pEvent)
+{
+    ContactPtr pContact = pEvent->getContact();
+    if (getNumContacts() == 0) {
+        Transform transform(filteredRelContactPos(pContact) - m_LastPosns[0]);
+        if (m_Friction != -1 && m_pInertiaHandler) {
+            m_pInertiaHandler->onDrag(transform);
+            m_pInertiaHandler->onUp();
+            // The first inertia step happens immediately.
+            handleFrame();
+        } else {
+            setEnd();
+        }
+        notifySubscribers("UP", transform);
+    } else {
+        newPhase();
+    }
+    if (isFiltered()) {
+        m_Filters.erase(pContact);
+    }
+}
+
+void TransformRecognizer::handleFrame()
+{
+    if (m_pInertiaHandler) {
+        // While contacts are down, this just decays the tracked velocity.
+        InertiaHandlerPtr pInertiaHandler = m_pInertiaHandler;
+        Transform transform(glm::vec2(0,0));
+        switch (pInertiaHandler->onFrame(transform)) {
+            case InertiaHandler::MOVING:
+                notifySubscribers("MOTION", transform);
+                break;
+            case InertiaHandler::STOPPED:
+                onInertiaStop();
+                break;
+            default:
+                break;
+        }
+    }
+    if (getNumContacts() > 0 && !handleNodeGone()) {
+        move();
+    }
+}
+
+bool TransformRecognizer::handleNodeGone()
+{
+    if (isNodeUnlinked(m_pCoordSysNode.lock())) {
+        enable(false);
+        return true;
+    } else {
+        return Recognizer::handleNodeGone();
+    }
+}
+
+bool TransformRecognizer::needsFrames() const
+{
+    return Recognizer::needsFrames() || m_pInertiaHandler;
+}
+
+void TransformRecognizer::move()
+{
+    vector<ContactPtr> contacts = getContacts();
+    vector<glm::vec2> contactPosns;
+    for (unsigned i=0; i<contacts.size(); ++i) {
+        contactPosns.push_back(filteredRelContactPos(contacts[i]));
+    }
+    if (contacts.size() == 1) {
+        Transform transform(contactPosns[0] - m_LastPosns[0]);
+        if (m_Friction != -1 && m_pInertiaHandler) {
+            m_pInertiaHandler->onDrag(transform);
+        }
+        notifySubscribers("MOTION", transform);
+        m_LastPosns = contactPosns;
+    } else {
+        vector<glm::vec2> posns;
+        if (contacts.size() == 2) {
+            posns = contactPosns;
+        } else {
+            posns.push_back(getCentroid(m_Clusters[0], contactPosns));
+            posns.push_back(getCentroid(m_Clusters[1], contactPosns));
+        }
+
+        glm::vec2 startDelta = m_LastPosns[1]-m_LastPosns[0];
+        glm::vec2 curDelta = posns[1]-posns[0];
+        glm::vec2 pivot = (posns[0]+posns[1])/2.f;
+        float rot = vecAngle(curDelta, startDelta);
+        float scale;
+        if (m_LastPosns[0] == m_LastPosns[1]) {
+            scale = 1;
+        } else {
+            scale = glm::length(posns[0]-posns[1]) / 
+                    glm::length(m_LastPosns[0]-m_LastPosns[1]);
+        }
+        glm::vec2 trans = (posns[0]+posns[1])/2.f - (m_LastPosns[0]+m_LastPosns[1])/2.f;
+        Transform transform(trans, rot, scale, pivot);
+        if (m_Friction != -1 && m_pInertiaHandler) {
+            m_pInertiaHandler->onDrag(transform);
+        }
+        notifySubscribers("MOTION", transform);
+        m_LastPosns = posns;
+    }
+}
+
+void TransformRecognizer::newPhase()
+{
+    m_LastPosns.clear();
+    vector<ContactPtr> contacts = getContacts();
+    vector<glm::vec2> contactPosns;
+    for (unsigned i=0; i<contacts.size(); ++i) {
+        contactPosns.push_back(relContactPos(contacts[i]));
+    }
+    if (contacts.size() == 1 || contacts.size() == 2) {
+        m_LastPosns = contactPosns;
+    } else if (contacts.size() > 2) {
+        calcKMeans(contactPosns, m_Clusters);
+        m_LastPosns.push_back(getCentroid(m_Clusters[0], contactPosns));
+        m_LastPosns.push_back(getCentroid(m_Clusters[1], contactPosns));
+    }
+}
+
+void TransformRecognizer::onInertiaStop()
+{
+    m_pInertiaHandler = InertiaHandlerPtr();
+    setEnd();
+}
+
+glm::vec2 TransformRecognizer::filteredRelContactPos(ContactPtr pContact)
+{
+    glm::vec2 rawPos = relContactPos(pContact);
+    if (isFiltered()) {
+        ContactFilterPtr pFilter = m_Filters[pContact];
+        long long frameTime = Player::get()->getFrameTime();
+        return glm::vec2(pFilter->m_XFilter.apply(rawPos.x, frameTime),
+                pFilter->m_YFilter.apply(rawPos.y, frameTime));
+    } else {
+        return rawPos;
+    }
+}
+
+glm::vec2 TransformRecognizer::relContactPos(ContactPtr pContact) const
+{
+    return relEventPos(m_pCoordSysNode.lock(), pContact->getEvents().back());
+}
+
+bool TransformRecognizer::isFiltered() const
+{
+    return m_FilterMinCutoff != -1;
+}
+
+void TransformRecognizer::doAbort()
+{
+    m_pInertiaHandler = InertiaHandlerPtr();
+    m_Filters.clear();
+}
+
+}
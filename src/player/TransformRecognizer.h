@@ -0,0 +1,92 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _TransformRecognizer_H_
+#define _TransformRecognizer_H_
+
+#include "../api.h"
+
+#include "Recognizer.h"
+#include "InertiaHandler.h"
+
+#include "../base/GLMHelper.h"
+#include "../base/OneEuroFilter.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/weak_ptr.hpp>
+
+#include <map>
+#include <vector>
+
+namespace avg {
+
+class AVG_API TransformRecognizer: public Recognizer
+{
+public:
+    TransformRecognizer(NodePtr pEventNode, NodePtr pCoordSysNode, 
+            CursorEventPtr pInitialEvent, float friction, float filterMinCutoff,
+            float filterBeta, const py::object& detectedHandler, 
+            const py::object& moveHandler, const py::object& upHandler, 
+            const py::object& endHandler);
+    virtual ~TransformRecognizer();
+
+    virtual void abort();
+    virtual void enable(bool bEnable);
+
+protected:
+    virtual void handleDown(CursorEventPtr pEvent);
+    virtual void handleUp(CursorEventPtr pEvent);
+    virtual void handleFrame();
+    virtual bool handleNodeGone();
+    virtual bool needsFrames() const;
+
+private:
+    void move();
+    void newPhase();
+    void onInertiaStop();
+    glm::vec2 filteredRelContactPos(ContactPtr pContact);
+    glm::vec2 relContactPos(ContactPtr pContact) const;
+    bool isFiltered() const;
+    void doAbort();
+
+    // Weak, so the recognizer doesn't keep the node alive.
+    boost::weak_ptr<Node> m_pCoordSysNode;
+    float m_Friction;
+    float m_FilterMinCutoff;
+    float m_FilterBeta;
+
+    std::vector<glm::vec2> m_LastPosns;
+    std::vector<int> m_Clusters[2];
+    InertiaHandlerPtr m_pInertiaHandler;
+    struct ContactFilter {
+        ContactFilter(float minCutoff, float beta);
+        OneEuroFilter m_XFilter;
+        OneEuroFilter m_YFilter;
+    };
+    typedef boost::shared_ptr<ContactFilter> ContactFilterPtr;
+    std::map<ContactPtr, ContactFilterPtr> m_Filters;
+};
+
+typedef boost::shared_ptr<TransformRecognizer> TransformRecognizerPtr;
+
+}
+
+#endif
@@ -100,6 +100,15 @@ ExportedObjectPtr TypeRegistry::createObject(const string& sType, const py::dict
     return pObj;
 }
 
+ExportedObjectPtr TypeRegistry::createObject(const TypeDefinition& def,
+        const ArgList& args)
+{
+    ObjectBuilder builder = def.getBuilder();
+    ExportedObjectPtr pObj = builder(args);
+    pObj->setTypeInfo(&def);
+    return pObj;
+}
+
 string TypeRegistry::getDTD() const
 {
     if (m_TypeDefs.empty()) {
@@ -65,7 +65,8 @@ void VectorNode::registerType()
 
 VectorNode::VectorNode(const ArgList& args, const string& sPublisherName)
     : Node(sPublisherName), 
-      m_Translate(glm::vec2(0,0))
+      m_Translate(glm::vec2(0,0)),
+      m_PolyLineJoinsStrokeWidth(-1)
 {
     m_pShape = ShapePtr(createDefaultShape());
 
@@ -142,6 +143,21 @@ void VectorNode::setBlendModeStr(const string& sBlendMode)
     m_BlendMode = GLContext::stringToBlendMode(sBlendMode);
 }
 
+void VectorNode::collectPreRenderJobs(vector<Node*>& pNodes)
+{
+    if (m_bDrawNeeded) {
+        pNodes.push_back(this);
+    }
+}
+
+void VectorNode::runPreRenderJob()
+{
+    // The vertexes only depend on the node's own attributes, so they can be
+    // calculated in any thread. Appending them to the canvas vertex array happens in
+    // preRender().
+    checkRedraw();
+}
+
 static ProfilingZoneID PrerenderProfilingZone("VectorNode::prerender");
 
 void VectorNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive, 
@@ -168,7 +184,7 @@ void VectorNode::maybeRender(GLContext* pContext, const glm::mat4& parentTransfo
     }
 }
 
-static ProfilingZoneID RenderProfilingZone("VectorNode::render");
+static ProfilingZoneID RenderProfilingZone("VectorNode::render", true);
 
 void VectorNode::render(GLContext* pContext, const glm::mat4& transform)
 {
@@ -312,6 +328,8 @@ void VectorNode::calcEffPolyLineTexCoords(vector<float>& effTC,
     }
 }
 
+static ProfilingZoneID PolyLineJoinsProfilingZone("VectorNode: update polyline joins");
+
 void VectorNode::calcPolyLine(const vector<glm::vec2>& origPts, 
         const vector<float>& origTexCoords, bool bIsClosed, LineJoin lineJoin, 
         const VertexDataPtr& pVertexData, Pixel32 color)
@@ -334,51 +352,26 @@ void VectorNode::calcPolyLine(const vector<glm::vec2>& origPts,
     }
 
     int numPts = pts.size();
+    updatePolyLineJoins(pts, bIsClosed);
 
-    // Create array of wide lines.
-    vector<WideLine> lines;
-    lines.reserve(numPts-1);
-    for (int i = 0; i < numPts-1; ++i) {
-        lines.push_back(WideLine(pts[i], pts[i+1], m_StrokeWidth));
-    }
-    if (bIsClosed) {
-        lines.push_back(WideLine(pts[numPts-1], pts[0], m_StrokeWidth));
-    }
     // First points
     if (bIsClosed) {
-        WideLine lastLine = lines[lines.size()-1];
-        glm::vec2 pli = getLineLineIntersection(lastLine.pl0, lastLine.dir, 
-                lines[0].pl0, lines[0].dir);
-        glm::vec2 pri = getLineLineIntersection(lastLine.pr0, lastLine.dir, 
-                lines[0].pr0, lines[0].dir);
-        Triangle tri(lastLine.pl1, lines[0].pl0, pri);
-        if (tri.isClockwise()) {
-            if (!LineSegment(lastLine.pr0, lastLine.pr1).isPointOver(pri) &&
-                    !LineSegment(lines[0].pr0, lines[0].pr1).isPointOver(pri))
-            {
-                pri = lines[0].pr1;
-            }
-        } else {
-            if (!LineSegment(lastLine.pl0, lastLine.pl1).isPointOver(pli) &&
-                    !LineSegment(lines[0].pl0, lines[0].pl1).isPointOver(pli))
-            {
-                pli = lines[0].pl1;
-            }
-        }
-
+        const PolyLineJoin& join = m_PolyLineJoins[0];
         float curTC = texCoords[0];
         switch (lineJoin) {
             case LJ_MITER:
-                pVertexData->appendPos(pli, glm::vec2(curTC,1), color);
-                pVertexData->appendPos(pri, glm::vec2(curTC,0), color);
+                pVertexData->appendPos(join.m_LeftPt, glm::vec2(curTC,1), color);
+                pVertexData->appendPos(join.m_RightPt, glm::vec2(curTC,0), color);
                 break;
             case LJ_BEVEL: {
-                    if (tri.isClockwise()) {
-                        pVertexData->appendPos(lines[0].pl0, glm::vec2(curTC,1), color);
-                        pVertexData->appendPos(pri, glm::vec2(curTC,0), color);
+                    if (join.m_bIsClockwise) {
+                        pVertexData->appendPos(join.m_Line2Start, glm::vec2(curTC,1), 
+                                color);
+                        pVertexData->appendPos(join.m_RightPt, glm::vec2(curTC,0), color);
                     } else {
-                        pVertexData->appendPos(pli, glm::vec2(curTC,1), color);
-                        pVertexData->appendPos(lines[0].pr0, glm::vec2(curTC,0), color);
+                        pVertexData->appendPos(join.m_LeftPt, glm::vec2(curTC,1), color);
+                        pVertexData->appendPos(join.m_Line2Start, glm::vec2(curTC,0), 
+                                color);
                     }
                 }
                 break;
@@ -387,8 +380,9 @@ void VectorNode::calcPolyLine(const vector<glm::vec2>& origPts,
                 break;
         }
     } else {
-        pVertexData->appendPos(lines[0].pl0, glm::vec2(texCoords[0],1), color);
-        pVertexData->appendPos(lines[0].pr0, glm::vec2(texCoords[0],0), color);
+        WideLine firstLine(pts[0], pts[1], m_StrokeWidth);
+        pVertexData->appendPos(firstLine.pl0, glm::vec2(texCoords[0],1), color);
+        pVertexData->appendPos(firstLine.pr0, glm::vec2(texCoords[0],0), color);
     }
 
     // All complete line segments
@@ -399,38 +393,13 @@ void VectorNode::calcPolyLine(const vector<glm::vec2>& origPts,
         numNormalSegments = pts.size()-2;
     }
     for (unsigned i = 0; i < numNormalSegments; ++i) {
-        const WideLine* pLine1 = &(lines[i]);
-        const WideLine* pLine2;
-        if (i == pts.size()-1) {
-            pLine2 = &(lines[0]);
-        } else {
-            pLine2 = &(lines[i+1]);
-        }
-        glm::vec2 pli = getLineLineIntersection(pLine1->pl0, pLine1->dir, pLine2->pl0,
-                pLine2->dir);
-        glm::vec2 pri = getLineLineIntersection(pLine1->pr0, pLine1->dir, pLine2->pr0,
-                pLine2->dir);
-        Triangle tri(pLine1->pl1, pLine2->pl0, pri);
-        if (tri.isClockwise()) {
-            if (!LineSegment(pLine1->pr0, pLine1->pr1).isPointOver(pri) &&
-                    !LineSegment(pLine2->pr0, pLine2->pr1).isPointOver(pri))
-            {
-                pri = pLine2->pr1;
-            }
-        } else {
-            if (!LineSegment(pLine1->pl0, pLine1->pl1).isPointOver(pli) &&
-                    !LineSegment(pLine2->pl0, pLine2->pl1).isPointOver(pli))
-            {
-                pli = pLine2->pl1;
-            }
-        }
-
+        const PolyLineJoin& join = m_PolyLineJoins[(i+1)%numPts];
         int curVertex = pVertexData->getNumVerts();
         float curTC = texCoords[i+1];
         switch (lineJoin) {
             case LJ_MITER:
-                pVertexData->appendPos(pli, glm::vec2(curTC,1), color);
-                pVertexData->appendPos(pri, glm::vec2(curTC,0), color);
+                pVertexData->appendPos(join.m_LeftPt, glm::vec2(curTC,1), color);
+                pVertexData->appendPos(join.m_RightPt, glm::vec2(curTC,0), color);
                 pVertexData->appendQuadIndexes(
                         curVertex-1, curVertex-2, curVertex+1, curVertex);
                 break;
@@ -438,20 +407,21 @@ void VectorNode::calcPolyLine(const vector<glm::vec2>& origPts,
                 {
                     float TC0;
                     float TC1;
-                    if (tri.isClockwise()) {
-                        calcBevelTC(*pLine1, *pLine2, true, texCoords, i+1, TC0, TC1);
-                        pVertexData->appendPos(pLine1->pl1, glm::vec2(TC0,1), color);
-                        pVertexData->appendPos(pLine2->pl0, glm::vec2(TC1,1), color);
-                        pVertexData->appendPos(pri, glm::vec2(curTC,0), color);
+                    calcBevelTC(join, texCoords, i+1, TC0, TC1);
+                    if (join.m_bIsClockwise) {
+                        pVertexData->appendPos(join.m_Line1End, glm::vec2(TC0,1), color);
+                        pVertexData->appendPos(join.m_Line2Start, glm::vec2(TC1,1), 
+                                color);
+                        pVertexData->appendPos(join.m_RightPt, glm::vec2(curTC,0), color);
                         pVertexData->appendQuadIndexes(
                                 curVertex-1, curVertex-2, curVertex+2, curVertex);
                         pVertexData->appendTriIndexes(
                                 curVertex, curVertex+1, curVertex+2);
                     } else {
-                        calcBevelTC(*pLine1, *pLine2, false,  texCoords, i+1, TC0, TC1);
-                        pVertexData->appendPos(pLine1->pr1, glm::vec2(TC0,0), color);
-                        pVertexData->appendPos(pli, glm::vec2(curTC,1), color);
-                        pVertexData->appendPos(pLine2->pr0, glm::vec2(TC1,0), color);
+                        pVertexData->appendPos(join.m_Line1End, glm::vec2(TC0,0), color);
+                        pVertexData->appendPos(join.m_LeftPt, glm::vec2(curTC,1), color);
+                        pVertexData->appendPos(join.m_Line2Start, glm::vec2(TC1,0), 
+                                color);
                         pVertexData->appendQuadIndexes(
                                 curVertex-2, curVertex-1, curVertex+1, curVertex);
                         pVertexData->appendTriIndexes(
@@ -466,38 +436,15 @@ void VectorNode::calcPolyLine(const vector<glm::vec2>& origPts,
 
     // Last segment (PolyLine only)
     if (!bIsClosed) {
+        WideLine lastLine(pts[numPts-2], pts[numPts-1], m_StrokeWidth);
         int curVertex = pVertexData->getNumVerts();
         float curTC = texCoords[numPts-1];
-        pVertexData->appendPos(lines[numPts-2].pl1, glm::vec2(curTC,1), color);
-        pVertexData->appendPos(lines[numPts-2].pr1, glm::vec2(curTC,0), color);
+        pVertexData->appendPos(lastLine.pl1, glm::vec2(curTC,1), color);
+        pVertexData->appendPos(lastLine.pr1, glm::vec2(curTC,0), color);
         pVertexData->appendQuadIndexes(curVertex-1, curVertex-2, curVertex+1, curVertex);
     }
 }
 
-void VectorNode::calcBevelTC(const WideLine& line1, const WideLine& line2, 
-        bool bIsLeft, const vector<float>& texCoords, unsigned i, 
-        float& TC0, float& TC1)
-{
-    float line1Len = line1.getLen();
-    float line2Len = line2.getLen();
-    float triLen;
-    if (bIsLeft) {
-        triLen = glm::length(line1.pl1 - line2.pl0);
-    } else {
-        triLen = glm::length(line1.pr1 - line2.pr0);
-    }
-    float ratio0 = line1Len/(line1Len+triLen/2);
-    TC0 = (1-ratio0)*texCoords[i-1]+ratio0*texCoords[i];
-    float nextTexCoord;
-    if (i == texCoords.size()-1) {
-        nextTexCoord = texCoords[i];
-    } else {
-        nextTexCoord = texCoords[i+1];
-    }
-    float ratio1 = line2Len/(line2Len+triLen/2);
-    TC1 = ratio1*texCoords[i]+(1-ratio1)*nextTexCoord;
-}
-
 int VectorNode::getNumDifferentPts(const vector<glm::vec2>& pts)
 {
     int numPts = pts.size();
@@ -544,4 +491,113 @@ Shape* VectorNode::createDefaultShape() const
     return new Shape(WrapMode(GL_REPEAT, GL_CLAMP_TO_EDGE), false);
 }
 
+void VectorNode::updatePolyLineJoins(const vector<glm::vec2>& pts, bool bIsClosed)
+{
+    ScopeTimer timer(PolyLineJoinsProfilingZone);
+    if (m_PolyLineJoinsStrokeWidth != m_StrokeWidth) {
+        m_PolyLineJoins.clear();
+        m_PolyLineJoinsStrokeWidth = m_StrokeWidth;
+    }
+
+    // Joins in the unchanged prefix and suffix of the point list are candidates for
+    // reuse. This covers appending, inserting, removing and moving points.
+    unsigned numPts = pts.size();
+    unsigned numOldPts = m_PolyLineJoins.size();
+    unsigned maxMatch = min(numPts, numOldPts);
+    unsigned prefixLen = 0;
+    while (prefixLen < maxMatch && m_PolyLineJoins[prefixLen].m_Pt == pts[prefixLen]) {
+        prefixLen++;
+    }
+    unsigned suffixLen = 0;
+    while (suffixLen < maxMatch-prefixLen && 
+            m_PolyLineJoins[numOldPts-1-suffixLen].m_Pt == pts[numPts-1-suffixLen])
+    {
+        suffixLen++;
+    }
+
+    vector<PolyLineJoin> joins(numPts);
+    for (unsigned i = 0; i < numPts; ++i) {
+        PolyLineJoin& join = joins[i];
+        join.m_Pt = pts[i];
+        join.m_bIsValid = false;
+        if (!bIsClosed && (i == 0 || i == numPts-1)) {
+            // End points of open lines don't have a join.
+            continue;
+        }
+        const glm::vec2& prevPt = pts[(i+numPts-1)%numPts];
+        const glm::vec2& nextPt = pts[(i+1)%numPts];
+        int oldIndex = -1;
+        if (i < prefixLen) {
+            oldIndex = i;
+        } else if (i >= numPts-suffixLen) {
+            oldIndex = i+numOldPts-numPts;
+        }
+        if (oldIndex != -1) {
+            const PolyLineJoin& oldJoin = m_PolyLineJoins[oldIndex];
+            if (oldJoin.m_bIsValid && oldJoin.m_PrevPt == prevPt &&
+                    oldJoin.m_NextPt == nextPt)
+            {
+                join = oldJoin;
+                continue;
+            }
+        }
+        calcPolyLineJoin(prevPt, pts[i], nextPt, join);
+    }
+    m_PolyLineJoins.swap(joins);
+}
+
+void VectorNode::calcPolyLineJoin(const glm::vec2& prevPt, const glm::vec2& pt,
+        const glm::vec2& nextPt, PolyLineJoin& join) const
+{
+    WideLine line1(prevPt, pt, m_StrokeWidth);
+    WideLine line2(pt, nextPt, m_StrokeWidth);
+    glm::vec2 pli = getLineLineIntersection(line1.pl0, line1.dir, line2.pl0, line2.dir);
+    glm::vec2 pri = getLineLineIntersection(line1.pr0, line1.dir, line2.pr0, line2.dir);
+    Triangle tri(line1.pl1, line2.pl0, pri);
+    join.m_bIsClockwise = tri.isClockwise();
+    if (join.m_bIsClockwise) {
+        if (!LineSegment(line1.pr0, line1.pr1).isPointOver(pri) &&
+                !LineSegment(line2.pr0, line2.pr1).isPointOver(pri))
+        {
+            pri = line2.pr1;
+        }
+        join.m_Line1End = line1.pl1;
+        join.m_Line2Start = line2.pl0;
+    } else {
+        if (!LineSegment(line1.pl0, line1.pl1).isPointOver(pli) &&
+                !LineSegment(line2.pl0, line2.pl1).isPointOver(pli))
+        {
+            pli = line2.pl1;
+        }
+        join.m_Line1End = line1.pr1;
+        join.m_Line2Start = line2.pr0;
+    }
+    float triLen = glm::length(join.m_Line1End - join.m_Line2Start);
+    float line1Len = line1.getLen();
+    float line2Len = line2.getLen();
+    join.m_BevelRatio0 = line1Len/(line1Len+triLen/2);
+    join.m_BevelRatio1 = line2Len/(line2Len+triLen/2);
+
+    join.m_LeftPt = pli;
+    join.m_RightPt = pri;
+    join.m_PrevPt = prevPt;
+    join.m_NextPt = nextPt;
+    join.m_bIsValid = true;
+}
+
+void VectorNode::calcBevelTC(const PolyLineJoin& join, const vector<float>& texCoords,
+        unsigned i, float& TC0, float& TC1) const
+{
+    float ratio0 = join.m_BevelRatio0;
+    TC0 = (1-ratio0)*texCoords[i-1]+ratio0*texCoords[i];
+    float nextTexCoord;
+    if (i == texCoords.size()-1) {
+        nextTexCoord = texCoords[i];
+    } else {
+        nextTexCoord = texCoords[i+1];
+    }
+    float ratio1 = join.m_BevelRatio1;
+    TC1 = ratio1*texCoords[i]+(1-ratio1)*nextTexCoord;
+}
+
 }
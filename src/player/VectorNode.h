@@ -34,7 +34,6 @@
 
 namespace avg {
 
-struct WideLine;
 class VertexArray;
 typedef boost::shared_ptr<VertexArray> VertexArrayPtr;
 class VertexData;
@@ -65,6 +64,8 @@ class AVG_API VectorNode : public Node
         const std::string& getBlendModeStr() const;
         void setBlendModeStr(const std::string& sBlendMode);
 
+        virtual void collectPreRenderJobs(std::vector<Node*>& pNodes);
+        virtual void runPreRenderJob();
         virtual void preRender(const VertexArrayPtr& pVA, bool bIsParentActive, 
                 float parentEffectiveOpacity);
         virtual void maybeRender(GLContext* pContext, const glm::mat4& parentTransform);
@@ -99,9 +100,6 @@ class AVG_API VectorNode : public Node
         void calcPolyLine(const std::vector<glm::vec2>& origPts, 
                 const std::vector<float>& origTexCoords, bool bIsClosed, 
                 LineJoin lineJoin, const VertexDataPtr& pVertexData, Pixel32 color);
-        void calcBevelTC(const WideLine& line1, const WideLine& line2, 
-                bool bIsLeft, const std::vector<float>& texCoords, unsigned i, 
-                float& TC0, float& TC1);
         int getNumDifferentPts(const std::vector<glm::vec2>& pts);
 
         void setTranslate(const glm::vec2& trans);
@@ -109,7 +107,30 @@ class AVG_API VectorNode : public Node
         virtual void checkRedraw();
 
     private:
+        // Geometry of the polyline corner at one point. Cached between redraws so
+        // that changing a few points of a long line only recalculates the
+        // corners around them.
+        struct PolyLineJoin {
+            bool m_bIsValid;
+            glm::vec2 m_PrevPt;
+            glm::vec2 m_Pt;
+            glm::vec2 m_NextPt;
+
+            glm::vec2 m_LeftPt;
+            glm::vec2 m_RightPt;
+            glm::vec2 m_Line1End;
+            glm::vec2 m_Line2Start;
+            bool m_bIsClockwise;
+            float m_BevelRatio0;
+            float m_BevelRatio1;
+        };
+
         Shape* createDefaultShape() const;
+        void updatePolyLineJoins(const std::vector<glm::vec2>& pts, bool bIsClosed);
+        void calcPolyLineJoin(const glm::vec2& prevPt, const glm::vec2& pt, 
+                const glm::vec2& nextPt, PolyLineJoin& join) const;
+        void calcBevelTC(const PolyLineJoin& join, const std::vector<float>& texCoords,
+                unsigned i, float& TC0, float& TC1) const;
 
         Color m_Color;
         float m_StrokeWidth;
@@ -122,6 +143,9 @@ class AVG_API VectorNode : public Node
         glm::vec2 m_Translate;
         ShapePtr m_pShape;
         GLContext::BlendMode m_BlendMode;
+
+        std::vector<PolyLineJoin> m_PolyLineJoins;
+        float m_PolyLineJoinsStrokeWidth;
 };
 
 typedef boost::shared_ptr<VectorNode> VectorNodePtr;
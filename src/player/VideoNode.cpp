@@ -671,7 +671,7 @@ void VideoNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive,
     calcVertexArray(pVA);
 }
 
-static ProfilingZoneID RenderProfilingZone("VideoNode::render");
+static ProfilingZoneID RenderProfilingZone("VideoNode::render", true);
 
 void VideoNode::render(GLContext* pContext, const glm::mat4& transform)
 {
@@ -26,10 +26,14 @@
 #include "Window.h"
 
 #include "../graphics/FBO.h"
+#include "../graphics/MCFBO.h"
+#include "../graphics/PBO.h"
+#include "../graphics/GLTexture.h"
 #include "../graphics/GPURGB2YUVFilter.h"
 #include "../graphics/Filterfill.h"
 #include "../graphics/GLContext.h"
 #include "../base/StringHelper.h"
+#include "../base/ScopeTimer.h"
 
 #include <boost/bind.hpp>
 
@@ -41,21 +45,38 @@ using namespace boost;
 
 namespace avg {
 
+// Number of readbacks that can be in flight at the same time.
+static const unsigned NUM_READBACK_PBOS = 3;
+// Number of frames between starting a readback and mapping the PBO.
+static const long long READBACK_LATENCY = 2;
+
 VideoWriter::VideoWriter(CanvasPtr pCanvas, const string& sOutFileName, int frameRate,
-        int qMin, int qMax, bool bSyncToPlayback)
+        int qMin, int qMax, bool bSyncToPlayback, const string& sCodec,
+        const string& sPreset, int numThreads, int maxQueueLength, bool bDropFrames)
     : m_pCanvas(pCanvas),
       m_sOutFileName(sOutFileName),
       m_FrameRate(frameRate),
       m_QMin(qMin),
       m_QMax(qMax),
+      m_sCodec(sCodec),
+      m_sPreset(sPreset),
+      m_NumThreads(numThreads),
+      m_MaxQueueLength(maxQueueLength),
+      m_bDropFrames(bDropFrames),
       m_bHasValidData(false),
+      m_bUsePBOs(false),
+      m_NextPBOIndex(0),
+      m_NumFrameEnds(0),
+      m_CmdQueue(maxQueueLength),
       m_bSyncToPlayback(bSyncToPlayback),
       m_bPaused(false),
       m_PauseTime(0),
       m_bStopped(false),
       m_CurFrame(0),
       m_StartTime(-1),
-      m_bFramePending(false)
+      m_NumCapturedFrames(0),
+      m_NumDroppedFrames(0),
+      m_MaxUsedQueueLength(0)
 {
     if (!pCanvas) {
         throw Exception(AVG_ERR_INVALID_ARGS, "VideoWriter needs a canvas to write to.");
@@ -63,6 +84,18 @@ VideoWriter::VideoWriter(CanvasPtr pCanvas, const string& sOutFileName, int fram
     if (GLContext::getCurrent()->isGLES()) {
         throw Exception(AVG_ERR_UNSUPPORTED, "VideoWriter not supported under GLES.");
     }
+    if (maxQueueLength < 1) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE, 
+                "VideoWriter: maxqueuelength must be at least 1.");
+    }
+    if (numThreads < 0) {
+        throw Exception(AVG_ERR_OUT_OF_RANGE, 
+                "VideoWriter: numthreads must not be negative.");
+    }
+    if (!VideoWriterThread::isCodecAvailable(m_sCodec)) {
+        throw Exception(AVG_ERR_VIDEO_INIT_FAILED, 
+                string("VideoWriter: Codec '") + m_sCodec + "' not available.");
+    }
 #ifdef WIN32
     int fd = _open(m_sOutFileName.c_str(), O_RDWR | O_CREAT, _S_IREAD | _S_IWRITE);
 #elif defined __linux__
@@ -83,22 +116,26 @@ VideoWriter::VideoWriter(CanvasPtr pCanvas, const string& sOutFileName, int fram
     remove(m_sOutFileName.c_str());
     CanvasPtr pMainCanvas = Player::get()->getMainCanvas();
     DisplayEngine* pDisplayEngine = Player::get()->getDisplayEngine();
+    m_pMainGLContext = pDisplayEngine->getWindow(0)->getGLContext();
     if (pMainCanvas == m_pCanvas) {
         m_FrameSize = pDisplayEngine->getWindowSize();
+        // Multiple windows are composited on the CPU by DisplayEngine::screenshot().
+        m_bUsePBOs = (pDisplayEngine->getNumWindows() == 1 && 
+                m_pMainGLContext->getMemoryMode() == MM_PBO);
     } else {
         m_FrameSize = m_pCanvas->getSize();
         GLContext* pOldContext = GLContext::getCurrent();
-        m_pMainGLContext = pDisplayEngine->getWindow(0)->getGLContext();
         m_pMainGLContext->activate();
         m_pFBO = dynamic_pointer_cast<OffscreenCanvas>(m_pCanvas)->
                 getFBO(m_pMainGLContext);
         if (GLContext::getCurrent()->useGPUYUVConversion()) {
             m_pFilter = GPURGB2YUVFilterPtr(new GPURGB2YUVFilter(m_FrameSize));
         }
+        m_bUsePBOs = true;
         pOldContext->activate();
     }
     VideoWriterThread writer(m_CmdQueue, m_sOutFileName, m_FrameSize, m_FrameRate, 
-            qMin, qMax);
+            qMin, qMax, m_sCodec, m_sPreset, m_NumThreads);
     m_pThread = new boost::thread(writer);
     m_pCanvas->registerPlaybackEndListener(this);
     m_pCanvas->registerFrameEndListener(this);
@@ -116,10 +153,14 @@ VideoWriter::~VideoWriter()
 void VideoWriter::stop()
 {
     if (!m_bStopped) {
-        getFrameFromPBO();
+        finishReadbacks(true);
         if (!m_bHasValidData) {
             writeDummyFrame();
         }
+        AVG_TRACE(Logger::category::PROFILE, Logger::severity::INFO,
+                "VideoWriter '" << m_sOutFileName << "': " << m_NumCapturedFrames << 
+                " frames captured, " << m_NumDroppedFrames << 
+                " dropped, max. encoder queue length " << m_MaxUsedQueueLength << ".");
 
         m_bStopped = true;
         m_CmdQueue.pushCmd(boost::bind(&VideoWriterThread::stop, _1));
@@ -127,6 +168,13 @@ void VideoWriter::stop()
         m_pCanvas->unregisterFrameEndListener(this);
         m_pCanvas->unregisterPlaybackEndListener(this);
 
+        if (!m_pReadbackPBOs.empty()) {
+            // PBOs need to be deleted in the context they were created in.
+            GLContext* pOldContext = GLContext::getCurrent();
+            m_pMainGLContext->activate();
+            m_pReadbackPBOs.clear();
+            pOldContext->activate();
+        }
         m_pFBO = FBOPtr();
         m_pFilter = GPURGB2YUVFilterPtr();
     }
@@ -174,91 +222,175 @@ int VideoWriter::getQMax() const
     return m_QMax;
 }
 
+string VideoWriter::getCodec() const
+{
+    return m_sCodec;
+}
+
+string VideoWriter::getPreset() const
+{
+    return m_sPreset;
+}
+
+int VideoWriter::getNumThreads() const
+{
+    return m_NumThreads;
+}
+
+int VideoWriter::getMaxQueueLength() const
+{
+    return m_MaxQueueLength;
+}
+
+bool VideoWriter::getDropFrames() const
+{
+    return m_bDropFrames;
+}
+
+int VideoWriter::getNumDroppedFrames() const
+{
+    return m_NumDroppedFrames;
+}
+
 void VideoWriter::onFrameEnd()
 {
-    // The VideoWriter handles OffscreenCanvas and MainCanvas differently:
-    // For MainCanvas, it simply does a screenshot onFrameEnd and sends that to the 
-    // VideoWriterThread immediately.
-    // For OffscreenCanvas, an asynchronous PBO readback is started in onFrameEnd.
-    // In the next frame's onFrameEnd, the data is read into a bitmap and sent to 
-    // the VideoWriterThread.
-    if (m_pFBO) {
-        // Read last frame's bitmap.
-        GLContext* pOldContext = GLContext::getCurrent();
-        m_pMainGLContext->activate();
-        getFrameFromPBO();
-        pOldContext->activate();
-    }
+    // Frames are read back asynchronously into a ring of PBOs. A readback is mapped
+    // and sent to the VideoWriterThread READBACK_LATENCY frames after it was started,
+    // so the GPU never stalls on the current frame. If PBOs aren't available, 
+    // screenshots of the main canvas are taken synchronously.
+    m_NumFrameEnds++;
     if (m_StartTime == -1) {
         m_StartTime = Player::get()->getFrameTime();
     }
     if (!m_bPaused) {
         if (m_bSyncToPlayback) {
-            getFrameFromFBO();
+            startReadback();
         } else {
             long long movieTime = Player::get()->getFrameTime() - m_StartTime
                     - m_PauseTime;
             float timePerFrame = 1000.f/m_FrameRate;
             int wantedFrame = int(movieTime/timePerFrame+0.1);
             if (wantedFrame > m_CurFrame) {
-                getFrameFromFBO();
+                startReadback();
                 if (wantedFrame > m_CurFrame + 1) {
                     m_CurFrame = wantedFrame - 1;
                 }
             }
         }
     }
-    
-    if (!m_pFBO) {
-        getFrameFromPBO();
-    }
+    finishReadbacks(false);
 }
 
-void VideoWriter::getFrameFromFBO()
+static ProfilingZoneID StartReadbackProfilingZone("VideoWriter: start readback");
+
+void VideoWriter::startReadback()
 {
-    if (m_pFBO) {
-        GLContext* pOldContext = GLContext::getCurrent();
-        m_pMainGLContext->activate();
-        if (m_pFilter) {
-            m_pFilter->apply(m_pMainGLContext, m_pFBO->getTex());
-            FBOPtr pYUVFBO = m_pFilter->getFBO(m_pMainGLContext);
-            pYUVFBO->moveToPBO();
-        } else {
-            m_pFBO->moveToPBO();
+    ScopeTimer timer(StartReadbackProfilingZone);
+    m_CurFrame++;
+    long long frameNum = m_NumCapturedFrames;
+    m_NumCapturedFrames++;
+    if (!m_bUsePBOs) {
+        BitmapPtr pBmp = Player::get()->getDisplayEngine()->screenshot(GL_BACK);
+        sendFrameToEncoder(pBmp, frameNum);
+        return;
+    }
+    if (m_PendingReadbacks.size() == NUM_READBACK_PBOS) {
+        // All PBOs are in use: Wait for the oldest one.
+        finishReadback();
+    }
+    GLContext* pOldContext = GLContext::getCurrent();
+    m_pMainGLContext->activate();
+    FBOPtr pFBO = getReadbackFBO();
+    if (m_pReadbackPBOs.empty()) {
+        for (unsigned i = 0; i < NUM_READBACK_PBOS; ++i) {
+            if (pFBO) {
+                m_pReadbackPBOs.push_back(PBOPtr(new PBO(pFBO->getSize(), 
+                        pFBO->getTex()->getPF(), GL_STREAM_READ)));
+            } else {
+                m_pReadbackPBOs.push_back(PBOPtr(new PBO(m_FrameSize, B8G8R8X8, 
+                        GL_STREAM_READ)));
+            }
         }
-        pOldContext->activate();
-        m_bFramePending = true;
+    }
+    PBO& pbo = *m_pReadbackPBOs[m_NextPBOIndex];
+    if (pFBO) {
+        pFBO->moveToPBO(pbo);
     } else {
-        BitmapPtr pBmp = Player::get()->getDisplayEngine()->screenshot(GL_BACK);
-        sendFrameToEncoder(pBmp);
+        MCFBOPtr pRenderTarget = Player::get()->getDisplayEngine()->getWindow(0)->
+                getRenderTarget();
+        if (pRenderTarget) {
+            // Headless window. The FBO is upside down like a real window.
+            pRenderTarget->getCurFBO(m_pMainGLContext)->moveToPBO(pbo);
+        } else {
+            glproc::BindFramebuffer(GL_FRAMEBUFFER, 0);
+            glReadBuffer(GL_BACK);
+            GLContext::checkError("VideoWriter::startReadback: glReadBuffer()");
+            pbo.moveFramebufferToPBO(m_FrameSize);
+        }
     }
+    pOldContext->activate();
+
+    PendingReadback readback;
+    readback.m_PBOIndex = m_NextPBOIndex;
+    readback.m_FrameNum = frameNum;
+    readback.m_StartFrame = m_NumFrameEnds;
+    m_PendingReadbacks.push_back(readback);
+    m_NextPBOIndex = (m_NextPBOIndex+1) % NUM_READBACK_PBOS;
 }
 
-void VideoWriter::getFrameFromPBO()
+static ProfilingZoneID FinishReadbackProfilingZone("VideoWriter: finish readback");
+
+void VideoWriter::finishReadback()
 {
-    if (m_bFramePending) {
-        BitmapPtr pBmp;
-        GLContext* pOldContext = GLContext::getCurrent();
-        m_pMainGLContext->activate();
-        if (m_pFilter) {
-            pBmp = m_pFilter->getFBO(m_pMainGLContext)->getImageFromPBO();
-        } else {
-            pBmp = m_pFBO->getImageFromPBO();
-        }
-            pOldContext->activate();
-        sendFrameToEncoder(pBmp);
-        m_bFramePending = false;
+    ScopeTimer timer(FinishReadbackProfilingZone);
+    AVG_ASSERT(!m_PendingReadbacks.empty());
+    PendingReadback readback = m_PendingReadbacks.front();
+    m_PendingReadbacks.pop_front();
+    GLContext* pOldContext = GLContext::getCurrent();
+    m_pMainGLContext->activate();
+    // Window contents are upside down, FBO contents aren't.
+    bool bFlip = !m_pFBO;
+    BitmapPtr pBmp = m_pReadbackPBOs[readback.m_PBOIndex]->movePBOToBmp(bFlip);
+    pOldContext->activate();
+    sendFrameToEncoder(pBmp, readback.m_FrameNum);
+}
+
+void VideoWriter::finishReadbacks(bool bAll)
+{
+    while (!m_PendingReadbacks.empty() && (bAll || 
+            m_NumFrameEnds - m_PendingReadbacks.front().m_StartFrame >= READBACK_LATENCY))
+    {
+        finishReadback();
     }
 }
 
-void VideoWriter::sendFrameToEncoder(BitmapPtr pBitmap)
+FBOPtr VideoWriter::getReadbackFBO() const
 {
-    m_CurFrame++;
+    if (m_pFilter) {
+        m_pFilter->apply(m_pMainGLContext, m_pFBO->getTex());
+        return m_pFilter->getFBO(m_pMainGLContext);
+    } else {
+        return m_pFBO;
+    }
+}
+
+void VideoWriter::sendFrameToEncoder(BitmapPtr pBitmap, long long frameNum)
+{
+    int queueLength = m_CmdQueue.size();
+    if (m_bDropFrames && queueLength >= m_MaxQueueLength) {
+        // The encoder can't keep up. Dropped frames leave a gap in the frame numbers.
+        m_NumDroppedFrames++;
+        return;
+    }
+    // If frames aren't dropped, pushCmd() blocks until there is room in the queue.
+    m_MaxUsedQueueLength = max(m_MaxUsedQueueLength, min(queueLength+1, m_MaxQueueLength));
     m_bHasValidData = true;
     if (m_pFilter) {
-        m_CmdQueue.pushCmd(boost::bind(&VideoWriterThread::encodeYUVFrame, _1, pBitmap));
+        m_CmdQueue.pushCmd(boost::bind(&VideoWriterThread::encodeYUVFrame, _1, pBitmap,
+                frameNum));
     } else {
-        m_CmdQueue.pushCmd(boost::bind(&VideoWriterThread::encodeFrame, _1, pBitmap));
+        m_CmdQueue.pushCmd(boost::bind(&VideoWriterThread::encodeFrame, _1, pBitmap,
+                frameNum));
     }
 }
 
@@ -274,7 +406,8 @@ void VideoWriter::writeDummyFrame()
 {
     BitmapPtr pBmp = BitmapPtr(new Bitmap(m_FrameSize, B8G8R8X8));
     FilterFill<Pixel32>(Pixel32(0,0,0,255)).applyInPlace(pBmp);
-    sendFrameToEncoder(pBmp);
+    sendFrameToEncoder(pBmp, m_NumCapturedFrames);
+    m_NumCapturedFrames++;
 }
 
 }
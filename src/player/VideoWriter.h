@@ -34,6 +34,8 @@
 #include <boost/thread.hpp>
 
 #include <string>
+#include <vector>
+#include <deque>
 
 namespace avg {
 
@@ -41,6 +43,8 @@ class Canvas;
 typedef boost::shared_ptr<Canvas> CanvasPtr;
 class FBO;
 typedef boost::shared_ptr<FBO> FBOPtr;
+class PBO;
+typedef boost::shared_ptr<PBO> PBOPtr;
 class GPURGB2YUVFilter;
 typedef boost::shared_ptr<GPURGB2YUVFilter> GPURGB2YUVFilterPtr;
 class GLContext;
@@ -49,7 +53,9 @@ class AVG_API VideoWriter : public IFrameEndListener, IPlaybackEndListener
 {
     public:
         VideoWriter(CanvasPtr pCanvas, const std::string& sOutFileName,
-                int frameRate=30, int qMin=3, int qMax=5, bool bSyncToPlayback=true);
+                int frameRate=30, int qMin=3, int qMax=5, bool bSyncToPlayback=true,
+                const std::string& sCodec="mjpeg", const std::string& sPreset="",
+                int numThreads=0, int maxQueueLength=16, bool bDropFrames=false);
         virtual ~VideoWriter();
         void stop();
         void pause();
@@ -59,15 +65,23 @@ class AVG_API VideoWriter : public IFrameEndListener, IPlaybackEndListener
         int getFramerate() const;
         int getQMin() const;
         int getQMax() const;
+        std::string getCodec() const;
+        std::string getPreset() const;
+        int getNumThreads() const;
+        int getMaxQueueLength() const;
+        bool getDropFrames() const;
+        int getNumDroppedFrames() const;
 
         virtual void onFrameEnd();
         virtual void onPlaybackEnd();
 
     private:
-        void getFrameFromFBO();
-        void getFrameFromPBO();
+        void startReadback();
+        void finishReadback();
+        void finishReadbacks(bool bAll);
+        FBOPtr getReadbackFBO() const;
 
-        void sendFrameToEncoder(BitmapPtr pBitmap);
+        void sendFrameToEncoder(BitmapPtr pBitmap, long long frameNum);
         void writeDummyFrame();
 
         CanvasPtr m_pCanvas;
@@ -78,10 +92,28 @@ class AVG_API VideoWriter : public IFrameEndListener, IPlaybackEndListener
         int m_FrameRate;
         int m_QMin;
         int m_QMax;
+        std::string m_sCodec;
+        std::string m_sPreset;
+        int m_NumThreads;
+        int m_MaxQueueLength;
+        bool m_bDropFrames;
         IntPoint m_FrameSize;
 
         bool m_bHasValidData;
 
+        // Ring of readback PBOs. Each pending readback is mapped a few frames after it
+        // was started.
+        struct PendingReadback {
+            unsigned m_PBOIndex;
+            long long m_FrameNum;
+            long long m_StartFrame;
+        };
+        bool m_bUsePBOs;
+        std::vector<PBOPtr> m_pReadbackPBOs;
+        std::deque<PendingReadback> m_PendingReadbacks;
+        unsigned m_NextPBOIndex;
+        long long m_NumFrameEnds;
+
         VideoWriterThread::CQueue m_CmdQueue;
         boost::thread* m_pThread;
         bool m_bSyncToPlayback;
@@ -94,7 +126,9 @@ class AVG_API VideoWriter : public IFrameEndListener, IPlaybackEndListener
 
         int m_CurFrame;
         long long m_StartTime;
-        bool m_bFramePending;
+        long long m_NumCapturedFrames;
+        int m_NumDroppedFrames;
+        int m_MaxUsedQueueLength;
 };
 
 }
@@ -25,6 +25,7 @@
 #include "../base/ProfilingZoneID.h"
 #include "../base/ScopeTimer.h"
 #include "../base/StringHelper.h"
+#include "../base/TimeSource.h"
 #include "../video/VideoDecoder.h"
 
 #if LIBAVCODEC_VERSION_INT < AV_VERSION_INT(55, 18, 102)
@@ -39,17 +40,21 @@ namespace avg {
 const unsigned int VIDEO_BUFFER_SIZE = 400000;
 #endif
 
-const AVPixelFormat STREAM_PIXEL_FORMAT = AV_PIX_FMT_YUVJ420P;
-
 VideoWriterThread::VideoWriterThread(CQueue& cmdQueue, const string& sFilename,
-        IntPoint size, int frameRate, int qMin, int qMax)
+        IntPoint size, int frameRate, int qMin, int qMax, const string& sCodec,
+        const string& sPreset, int numThreads)
     : WorkerThread<VideoWriterThread>(sFilename, cmdQueue, Logger::category::PROFILE),
       m_sFilename(sFilename),
       m_Size(size),
       m_FrameRate(frameRate),
       m_QMin(qMin),
       m_QMax(qMax),
-      m_pOutputFormatContext()
+      m_sCodec(sCodec),
+      m_sPreset(sPreset),
+      m_NumThreads(numThreads),
+      m_pOutputFormatContext(),
+      m_FramesWritten(0),
+      m_EncodeTime(0)
 {
 }
 
@@ -59,19 +64,23 @@ VideoWriterThread::~VideoWriterThread()
 
 static ProfilingZoneID ProfilingZoneEncodeFrame("Encode frame", true);
 
-void VideoWriterThread::encodeYUVFrame(BitmapPtr pBmp)
+void VideoWriterThread::encodeYUVFrame(BitmapPtr pBmp, long long frameNum)
 {
     ScopeTimer timer(ProfilingZoneEncodeFrame);
+    long long startTime = TimeSource::get()->getCurrentMicrosecs();
     convertYUVImage(pBmp);
-    writeFrame(m_pConvertedFrame);
+    writeFrame(m_pConvertedFrame, frameNum);
+    m_EncodeTime += TimeSource::get()->getCurrentMicrosecs() - startTime;
     ThreadProfiler::get()->reset();
 }
 
-void VideoWriterThread::encodeFrame(BitmapPtr pBmp)
+void VideoWriterThread::encodeFrame(BitmapPtr pBmp, long long frameNum)
 {
     ScopeTimer timer(ProfilingZoneEncodeFrame);
+    long long startTime = TimeSource::get()->getCurrentMicrosecs();
     convertRGBImage(pBmp);
-    writeFrame(m_pConvertedFrame);
+    writeFrame(m_pConvertedFrame, frameNum);
+    m_EncodeTime += TimeSource::get()->getCurrentMicrosecs() - startTime;
     ThreadProfiler::get()->reset();
 }
 
@@ -105,6 +114,13 @@ void VideoWriterThread::close()
     }
 }
 
+bool VideoWriterThread::isCodecAvailable(const string& sCodec)
+{
+    lock_guard lock(VideoDecoder::s_OpenMutex);
+    av_register_all();
+    return avcodec_find_encoder_by_name(sCodec.c_str()) != 0;
+}
+
 bool VideoWriterThread::init()
 {
     open();
@@ -119,6 +135,12 @@ bool VideoWriterThread::work()
 
 void VideoWriterThread::deinit()
 {
+    if (m_FramesWritten > 0 && m_EncodeTime > 0) {
+        AVG_TRACE(Logger::category::PROFILE, Logger::severity::INFO,
+                "VideoWriter '" << m_sFilename << "': " << m_FramesWritten << 
+                " frames encoded, encoder throughput " << 
+                m_FramesWritten*1000000./m_EncodeTime << " fps.");
+    }
     close();
 }
 
@@ -128,7 +150,10 @@ void VideoWriterThread::open()
     av_register_all(); // TODO: make sure this is only done once. 
 //    av_log_set_level(AV_LOG_DEBUG);
     m_pOutputFormat = av_guess_format(0, m_sFilename.c_str(), 0);
-    m_pOutputFormat->video_codec = AV_CODEC_ID_MJPEG;
+    AVCodec* pCodec = avcodec_find_encoder_by_name(m_sCodec.c_str());
+    // Availability has been checked in VideoWriter.
+    AVG_ASSERT(pCodec);
+    m_pOutputFormat->video_codec = pCodec->id;
 
     m_pOutputFormatContext = avformat_alloc_context();
     m_pOutputFormatContext->oformat = m_pOutputFormat;
@@ -164,10 +189,10 @@ void VideoWriterThread::open()
     }
 
     m_pFrameConversionContext = sws_getContext(m_Size.x, m_Size.y, 
-            AV_PIX_FMT_RGB32, m_Size.x, m_Size.y, STREAM_PIXEL_FORMAT, 
+            AV_PIX_FMT_RGB32, m_Size.x, m_Size.y, getStreamPixelFormat(), 
             SWS_BILINEAR, NULL, NULL, NULL);
 
-    m_pConvertedFrame = createFrame(STREAM_PIXEL_FORMAT, m_Size);
+    m_pConvertedFrame = createFrame(getStreamPixelFormat(), m_Size);
 
     avformat_write_header(m_pOutputFormatContext, 0);
 }
@@ -192,10 +217,12 @@ void VideoWriterThread::setupVideoStream()
     pCodecContext->time_base.den = m_FrameRate;
     pCodecContext->time_base.num = 1;
 //    pCodecContext->gop_size = 12; /* emit one intra frame every twelve frames at most */
-    pCodecContext->pix_fmt = STREAM_PIXEL_FORMAT;
+    pCodecContext->pix_fmt = getStreamPixelFormat();
     // Quality of quantization
     pCodecContext->qmin = m_QMin;
     pCodecContext->qmax = m_QMax;
+    // 0 lets the codec choose the number of threads.
+    pCodecContext->thread_count = m_NumThreads;
     // some formats want stream headers to be separate
     if (m_pOutputFormatContext->oformat->flags & AVFMT_GLOBALHEADER) {
         pCodecContext->flags |= CODEC_FLAG_GLOBAL_HEADER;
@@ -208,8 +235,18 @@ void VideoWriterThread::openVideoCodec()
     AVCodec* videoCodec = avcodec_find_encoder(m_pVideoStream->codec->codec_id);
     AVG_ASSERT(videoCodec);
 
-    int rc = avcodec_open2(m_pVideoStream->codec, videoCodec, 0);
+    AVDictionary* pOptions = 0;
+    if (!m_sPreset.empty()) {
+        av_dict_set(&pOptions, "preset", m_sPreset.c_str(), 0);
+    }
+    int rc = avcodec_open2(m_pVideoStream->codec, videoCodec, &pOptions);
     AVG_ASSERT(rc == 0);
+    if (av_dict_count(pOptions) > 0) {
+        AVG_TRACE(Logger::category::VIDEO, Logger::severity::WARNING,
+                "VideoWriter: Codec '" << m_sCodec << "' doesn't support preset '" <<
+                m_sPreset << "'. Ignoring preset.");
+    }
+    av_dict_free(&pOptions);
 }
 
 AVFrame* VideoWriterThread::createFrame(AVPixelFormat pixelFormat, IntPoint size)
@@ -279,10 +316,13 @@ void VideoWriterThread::convertYUVImage(BitmapPtr pSrcBmp)
 
 static ProfilingZoneID ProfilingZoneWriteFrame(" Write frame", true);
 
-void VideoWriterThread::writeFrame(AVFrame* pFrame)
+void VideoWriterThread::writeFrame(AVFrame* pFrame, long long frameNum)
 {
     ScopeTimer timer(ProfilingZoneWriteFrame);
     m_FramesWritten++;
+    // Frames dropped by the VideoWriter leave gaps in the frame numbers, so timing is
+    // preserved.
+    pFrame->pts = frameNum;
     AVCodecContext* pCodecContext = m_pVideoStream->codec;
     AVPacket packet = { 0 };
     int ret;
@@ -328,7 +368,15 @@ void VideoWriterThread::writeFrame(AVFrame* pFrame)
         }
         AVG_ASSERT(ret == 0);
     }
+}
 
+AVPixelFormat VideoWriterThread::getStreamPixelFormat() const
+{
+    if (m_sCodec == "mjpeg") {
+        return AV_PIX_FMT_YUVJ420P;
+    } else {
+        return AV_PIX_FMT_YUV420P;
+    }
 }
 
 }
@@ -39,13 +39,16 @@ namespace avg {
 class AVG_API VideoWriterThread : public WorkerThread<VideoWriterThread>  {
     public:
         VideoWriterThread(CQueue& cmdQueue, const std::string& sFilename, IntPoint size,
-                int frameRate, int qMin, int qMax);
+                int frameRate, int qMin, int qMax, const std::string& sCodec="mjpeg",
+                const std::string& sPreset="", int numThreads=0);
         virtual ~VideoWriterThread();
 
-        void encodeYUVFrame(BitmapPtr pBmp);
-        void encodeFrame(BitmapPtr pBmp);
+        void encodeYUVFrame(BitmapPtr pBmp, long long frameNum);
+        void encodeFrame(BitmapPtr pBmp, long long frameNum);
         void close();
 
+        static bool isCodecAvailable(const std::string& sCodec);
+
     private:
         bool init();
         void open();
@@ -61,13 +64,17 @@ class AVG_API VideoWriterThread : public WorkerThread<VideoWriterThread>  {
 
         void convertRGBImage(BitmapPtr pSrcBmp);
         void convertYUVImage(BitmapPtr pSrcBmp);
-        void writeFrame(AVFrame* pFrame);
+        void writeFrame(AVFrame* pFrame, long long frameNum);
+        AVPixelFormat getStreamPixelFormat() const;
 
         std::string m_sFilename;
         IntPoint m_Size;
         int m_FrameRate;
         int m_QMin;
         int m_QMax;
+        std::string m_sCodec;
+        std::string m_sPreset;
+        int m_NumThreads;
         
         AVOutputFormat* m_pOutputFormat;
         AVFormatContext* m_pOutputFormatContext;
@@ -79,6 +86,7 @@ class AVG_API VideoWriterThread : public WorkerThread<VideoWriterThread>  {
         unsigned char* m_pVideoBuffer;
 #endif
         int m_FramesWritten;
+        long long m_EncodeTime;
 };
 
 }
@@ -139,6 +139,11 @@ GLContext* Window::getGLContext() const
     return m_pGLContext;
 }
 
+MCFBOPtr Window::getRenderTarget() const
+{
+    return MCFBOPtr();
+}
+
 void Window::setGLContext(GLContext* pGLContext)
 {
     m_pGLContext = pGLContext;
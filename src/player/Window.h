@@ -44,6 +44,8 @@ namespace avg {
 class Bitmap;
 typedef boost::shared_ptr<class Bitmap> BitmapPtr;
 class GLContext;
+class MCFBO;
+typedef boost::shared_ptr<MCFBO> MCFBOPtr;
 
 class AVG_API Window
 {
@@ -53,13 +55,15 @@ class AVG_API Window
 
         virtual void setTitle(const std::string& sTitle) = 0;
         virtual void swapBuffers() const = 0;
-        BitmapPtr screenshot(int buffer=0);
+        virtual BitmapPtr screenshot(int buffer=0);
 
         const IntPoint& getPos() const;
         const IntPoint& getSize() const;
         const IntRect& getViewport() const;
         bool isFullscreen() const;
         GLContext* getGLContext() const;
+        // Offscreen buffer that replaces the window framebuffer if there is one.
+        virtual MCFBOPtr getRenderTarget() const;
         
         virtual std::vector<EventPtr> pollEvents() = 0;
 
@@ -0,0 +1,91 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "WindowRenderThread.h"
+
+#include "Window.h"
+
+#include "../base/Exception.h"
+#include "../base/ScopeTimer.h"
+
+#include "../graphics/GLContext.h"
+
+namespace avg {
+
+WindowRenderResult::WindowRenderResult()
+{
+}
+
+WindowRenderResult::WindowRenderResult(const Exception& ex)
+    : m_pException(new Exception(ex))
+{
+}
+
+WindowRenderThread::WindowRenderThread(CQueue& cmdQ, WindowRenderResultQueue& resultQ,
+        const WindowPtr& pWindow)
+    : WorkerThread<WindowRenderThread>("WindowRender", cmdQ),
+      m_ResultQ(resultQ),
+      m_pWindow(pWindow)
+{
+}
+
+WindowRenderThread::~WindowRenderThread()
+{
+}
+
+static ProfilingZoneID RenderProfilingZone("WindowRenderThread: render");
+
+void WindowRenderThread::render(const WindowRenderFunc& renderFunc)
+{
+    ScopeTimer timer(RenderProfilingZone);
+    GLContext* pContext = m_pWindow->getGLContext();
+    try {
+        pContext->activate();
+        renderFunc(m_pWindow);
+        pContext->deactivate();
+    } catch (const Exception& ex) {
+        pContext->deactivate();
+        m_ResultQ.push(WindowRenderResultQueue::QElementPtr(new WindowRenderResult(ex)));
+        return;
+    }
+    m_ResultQ.push(WindowRenderResultQueue::QElementPtr(new WindowRenderResult()));
+}
+
+void WindowRenderThread::swapBuffers()
+{
+    try {
+        m_pWindow->swapBuffers();
+        m_pWindow->getGLContext()->deactivate();
+    } catch (const Exception& ex) {
+        m_pWindow->getGLContext()->deactivate();
+        m_ResultQ.push(WindowRenderResultQueue::QElementPtr(new WindowRenderResult(ex)));
+        return;
+    }
+    m_ResultQ.push(WindowRenderResultQueue::QElementPtr(new WindowRenderResult()));
+}
+
+bool WindowRenderThread::work()
+{
+    waitForCommand();
+    return true;
+}
+
+}
@@ -0,0 +1,73 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#ifndef _WindowRenderThread_H_
+#define _WindowRenderThread_H_
+
+#include "../api.h"
+
+#include "../base/WorkerThread.h"
+#include "../base/Queue.h"
+
+#include <boost/thread.hpp>
+#include <boost/function.hpp>
+
+namespace avg {
+
+class Window;
+typedef boost::shared_ptr<Window> WindowPtr;
+
+// Sent back to the main thread when a command has been executed.
+struct AVG_API WindowRenderResult
+{
+    WindowRenderResult();
+    WindowRenderResult(const Exception& ex);
+
+    boost::shared_ptr<Exception> m_pException;
+};
+
+typedef Queue<WindowRenderResult> WindowRenderResultQueue;
+typedef boost::shared_ptr<WindowRenderResultQueue> WindowRenderResultQueuePtr;
+
+typedef boost::function<void (const WindowPtr&)> WindowRenderFunc;
+
+// Renders and swaps a single window. The window's GL context is only current in this
+// thread while a command is executing.
+class AVG_API WindowRenderThread : public WorkerThread<WindowRenderThread>
+{
+    public:
+        WindowRenderThread(CQueue& cmdQ, WindowRenderResultQueue& resultQ, 
+                const WindowPtr& pWindow);
+        virtual ~WindowRenderThread();
+
+        void render(const WindowRenderFunc& renderFunc);
+        void swapBuffers();
+
+    private:
+        virtual bool work();
+
+        WindowRenderResultQueue& m_ResultQ;
+        WindowPtr m_pWindow;
+};
+
+}
+
+#endif
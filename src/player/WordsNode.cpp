@@ -50,6 +50,9 @@ using namespace boost;
 
 namespace avg {
 
+// Pango doesn't report the memory its layouts use, so only the count is tracked.
+static const string LAYOUT_MEM_CATEGORY = "Pango layouts";
+
 void WordsNode::registerType()
 {
     static const string sDTDElements = 
@@ -143,6 +146,7 @@ WordsNode::~WordsNode()
     }
     if (m_pLayout) {
         g_object_unref(m_pLayout);
+        ObjectCounter::get()->decMemory(LAYOUT_MEM_CATEGORY, 0);
     }
     ObjectCounter::get()->decRef(&typeid(*this));
 }
@@ -541,8 +545,10 @@ void WordsNode::updateLayout()
 
         if (m_pLayout) {
             g_object_unref(m_pLayout);
+            ObjectCounter::get()->decMemory(LAYOUT_MEM_CATEGORY, 0);
         }
         m_pLayout = pango_layout_new(pContext);
+        ObjectCounter::get()->incMemory(LAYOUT_MEM_CATEGORY, 0);
 
         PangoAttrList * pAttrList = 0;
 #if PANGO_VERSION > PANGO_VERSION_ENCODE(1,18,2) 
@@ -694,7 +700,7 @@ void WordsNode::preRender(const VertexArrayPtr& pVA, bool bIsParentActive,
     calcVertexArray(pVA);
 }
 
-static ProfilingZoneID RenderProfilingZone("WordsNode::render");
+static ProfilingZoneID RenderProfilingZone("WordsNode::render", true);
 
 void WordsNode::render(GLContext* pContext, const glm::mat4& transform)
 {
@@ -711,6 +717,18 @@ void WordsNode::render(GLContext* pContext, const glm::mat4& transform)
     }
 }
 
+bool WordsNode::getLocalRenderBounds(FRect& bounds)
+{
+    if (m_sText.length() == 0 ||
+            !calcRenderBounds(glm::vec2(getSurface()->getSize()), bounds))
+    {
+        return false;
+    }
+    glm::vec2 offset(m_InkOffset + IntPoint(m_AlignOffset, 0));
+    bounds = FRect(bounds.tl+offset, bounds.br+offset);
+    return true;
+}
+
 IntPoint WordsNode::getMediaSize()
 {
     return m_LogicalSize;
@@ -48,6 +48,7 @@ class AVG_API WordsNode : public RasterNode
         virtual void preRender(const VertexArrayPtr& pVA, bool bIsParentActive, 
                 float parentEffectiveOpacity);
         virtual void render(GLContext* pContext, const glm::mat4& transform);
+        virtual bool getLocalRenderBounds(FRect& bounds);
 
         virtual void setWidth(float width);
         virtual void setHeight(float width);
@@ -20,10 +20,13 @@
 //
 
 #include "Player.h"
+#include "TouchEvent.h"
+#include "TouchStatus.h"
 
 #include "../base/TestSuite.h"
 #include "../base/Exception.h"
 #include "../base/Logger.h"
+#include "../base/TimeSource.h"
 
 #include "../graphics/GLConfig.h"
 #include "../graphics/GLContext.h"
@@ -80,6 +83,73 @@ public:
         } catch (bad_cast&) {
 
         }
+        runPublisherTests(player);
+        runTouchStatusTests();
+    }
+
+private:
+    void runPublisherTests(Player& player)
+    {
+        TEST(!player.hasSubscribers());
+        player.notifySubscribers("KEY_DOWN");
+        // Invalid message names are caught even if nobody is subscribed.
+        TEST_EXCEPTION(player.notifySubscribers("NO_SUCH_MESSAGE"), Exception);
+        TEST_EXCEPTION(player.notifySubscribers("NO_SUCH_MESSAGE", 1), Exception);
+    }
+
+    // Events need a Player for their timestamps, so this runs as part of PlayerTest.
+    void runTouchStatusTests()
+    {
+        {
+            // Unfiltered contacts report the raw position as filtered position.
+            TouchEventPtr pEvent = createTouchEvent(Event::CURSOR_DOWN, 100, 50);
+            TouchStatus status(pEvent);
+            TEST(!pEvent->isFiltered());
+            TEST(pEvent->getFilteredPos() == pEvent->getPos());
+        }
+        {
+            // Jitter around a fixed point should be smoothed away.
+            TouchEventPtr pEvent = createTouchEvent(Event::CURSOR_DOWN, 100, 50);
+            TouchStatus status(pEvent, 1, 0);
+            TEST(pEvent->isFiltered());
+            bool bAllFiltered = true;
+            float maxRawDist = 0;
+            float maxFilteredDist = 0;
+            float maxFilteredSpeed = 0;
+            for (int i=0; i<50; ++i) {
+                msleep(2);
+                int jitter = (i%2 == 0) ? 4 : -4;
+                pEvent = createTouchEvent(Event::CURSOR_MOTION, 100+jitter, 50-jitter);
+                status.pushEvent(pEvent);
+                bAllFiltered &= pEvent->isFiltered();
+                glm::vec2 center(100, 50);
+                maxRawDist = max(maxRawDist, glm::length(pEvent->getPos()-center));
+                maxFilteredDist = max(maxFilteredDist, 
+                        glm::length(pEvent->getFilteredPos()-center));
+                maxFilteredSpeed = max(maxFilteredSpeed,
+                        glm::length(pEvent->getFilteredSpeed()));
+            }
+            TEST(bAllFiltered);
+            TEST(maxRawDist > 5);
+            TEST(maxFilteredDist < 1.5);
+            // Raw jitter moves 8 pixels in 2 ms.
+            TEST(maxFilteredSpeed < 1);
+
+            // The filter still follows real movement.
+            for (int i=0; i<100; ++i) {
+                msleep(5);
+                pEvent = createTouchEvent(Event::CURSOR_MOTION, 200, 50);
+                status.pushEvent(pEvent);
+            }
+            glm::vec2 filteredPos = pEvent->getFilteredPos();
+            TEST(filteredPos.x > 190 && filteredPos.x <= 200);
+            TEST(fabs(filteredPos.y-50) < 1);
+        }
+    }
+
+    TouchEventPtr createTouchEvent(Event::Type type, int x, int y)
+    {
+        return TouchEventPtr(new TouchEvent(1, type, IntPoint(x, y), Event::TOUCH));
     }
 };
 
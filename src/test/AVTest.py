@@ -582,6 +582,12 @@ class AVTestCase(AVGTestCase):
             self.assertRaises(avg.Exception,
                     lambda: avg.VideoWriter(player.getMainCanvas(), 
                             "nonexistentdir/test.mov", 30))
+            self.assertRaises(avg.Exception,
+                    lambda: avg.VideoWriter(player.getMainCanvas(), "test.mov", 30,
+                            codec="nonexistentcodec"))
+            self.assertRaises(avg.Exception,
+                    lambda: avg.VideoWriter(player.getMainCanvas(), "test.mov", 30,
+                            maxqueuelength=0))
 
         if not(self._isCurrentDirWriteable()):
             self.skip("Current dir not writeable.")
@@ -638,6 +644,57 @@ class AVTestCase(AVGTestCase):
                 ))
             os.remove("test.mov")    
 
+    def testVideoWriterDropFrames(self):
+        NUM_FRAMES = 20
+
+        def startWriter():
+            self.videoWriter = avg.VideoWriter(player.getMainCanvas(), "test.mov", 30,
+                    maxqueuelength=1, dropframes=True)
+            self.assertEqual(self.videoWriter.maxqueuelength, 1)
+            self.assert_(self.videoWriter.dropframes)
+
+        def stopWriter():
+            self.videoWriter.stop()
+            self.numDroppedFrames = self.videoWriter.numdroppedframes
+
+        def killWriter():
+            self.videoWriter = None
+
+        def checkVideo():
+            savedVideoNode = avg.VideoNode(href="../test.mov", threaded=False, 
+                    parent=root)
+            savedVideoNode.pause()
+            numFrames = savedVideoNode.getNumFrames()
+            self.assertEqual(numFrames + self.numDroppedFrames, NUM_FRAMES)
+            # Dropped frames leave gaps in the timestamps instead of shifting later 
+            # frames, so the video is as long as the captured sequence. Only dropped
+            # frames at the end can make it shorter.
+            durationInFrames = int(round(savedVideoNode.duration*30/1000.))
+            self.assert_(numFrames <= durationInFrames <= NUM_FRAMES)
+            if self.numDroppedFrames == 0:
+                self.assertEqual(durationInFrames, NUM_FRAMES)
+            savedVideoNode.unlink(True)
+
+        if not(self._isCurrentDirWriteable()):
+            self.skip("Current dir not writeable.")
+            return
+        if player.isUsingGLES():
+            self.skip("VideoWriter not supported under GLES.")
+            return
+
+        player.setFakeFPS(30)
+        root = self.loadEmptyScene()
+        videoNode = avg.VideoNode(href="mpeg1-48x48.mov", threaded=False, parent=root)
+        self.start(False,
+                (videoNode.play,
+                 startWriter,
+                 [None]*(NUM_FRAMES-1),
+                 stopWriter,
+                 killWriter,
+                 checkVideo,
+                ))
+        os.remove("test.mov")
+
     def test2VideosAtOnce(self):
         player.setFakeFPS(25)
         self.loadEmptyScene()
@@ -672,6 +729,7 @@ def AVTestSuite(tests):
             "testVideoSeekAfterEOF",
             "testException",
             "testVideoWriter",
+            "testVideoWriterDropFrames",
             "test2VideosAtOnce",
             ]
     return createAVGTestSuite(availableTests, AVTestCase, tests)
@@ -478,6 +478,56 @@ class EventTestCase(AVGTestCase):
         self.assert_(not(self.event2Called))
 
 
+    def testPublisherSubscriberCount(self):
+
+        def onDown(event):
+            self.downCalled = True
+
+        def onUnsubscribeDown(event):
+            self.img.unsubscribe(avg.Node.CURSOR_DOWN, self.subscriberID)
+
+        def subscribeDuringNotify():
+            self.subscriberID = self.img.subscribe(avg.Node.CURSOR_DOWN,
+                    onUnsubscribeDown)
+            checkCounts(1, 0)
+
+        def resubscribe():
+            self.downCalled = False
+            self.img.subscribe(avg.Node.CURSOR_DOWN, onDown)
+            checkCounts(1, 0)
+
+        def checkCounts(numDown, numUp):
+            self.assertEqual(self.img.getNumSubscribers(avg.Node.CURSOR_DOWN), numDown)
+            self.assertEqual(self.img.getNumSubscribers(avg.Node.CURSOR_UP), numUp)
+            self.assertEqual(self.img.hasSubscribers(), numDown+numUp > 0)
+
+        root = self.loadEmptyScene()
+        self.img = avg.ImageNode(pos=(0,0), href="rgb24-65x65.png", parent=root)
+        checkCounts(0, 0)
+        downID = self.img.subscribe(avg.Node.CURSOR_DOWN, onDown)
+        upID = self.img.subscribe(avg.Node.CURSOR_UP, onDown)
+        checkCounts(1, 1)
+        self.img.unsubscribe(avg.Node.CURSOR_UP, upID)
+        checkCounts(1, 0)
+        self.img.unsubscribe(avg.Node.CURSOR_DOWN, onDown)
+        checkCounts(0, 0)
+        upID = self.img.subscribe(avg.Node.CURSOR_UP, onDown)
+        self.img.unsubscribe(upID)
+        checkCounts(0, 0)
+        # Failed unsubscribes don't change the count.
+        self.assertRaises(avg.Exception,
+                lambda: self.img.unsubscribe(avg.Node.CURSOR_DOWN, downID))
+        checkCounts(0, 0)
+        self.start(False,
+                (subscribeDuringNotify,
+                 lambda: self.fakeClick(10,10),
+                 lambda: checkCounts(0, 0),
+                 # Events are delivered again once there are new subscribers.
+                 resubscribe,
+                 lambda: self.fakeClick(10,10),
+                 lambda: self.assert_(self.downCalled),
+                ))
+
     def testObscuringEvents(self):
         root = self.loadEmptyScene()
         img1 = avg.ImageNode(pos=(0,0), href="rgb24-65x65.png", parent=root)
@@ -878,6 +928,10 @@ class EventTestCase(AVGTestCase):
             self.assertEqual(contact.distancetravelled, 10)
             self.assertEqual(contact.events[-1].pos, event.pos)
             self.assert_(len(contact.events) > 1)
+            # Simulated events bypass the input device jitter filter.
+            self.assert_(not(event.filtered))
+            self.assertEqual(event.filteredpos, event.pos)
+            self.assertEqual(event.filteredspeed, event.speed)
             self.numContactCallbacks += 1
  
         def onUp(event):
@@ -1135,6 +1189,7 @@ def eventTestSuite(tests):
             "testComplexPublisher",
             "testPublisherAutoDelete",
             "testPublisherNestedUnsubscribe",
+            "testPublisherSubscriberCount",
             "testObscuringEvents",
             "testSensitive",
             "testChangingHandlers",
@@ -786,6 +786,37 @@ class GestureTestCase(AVGTestCase):
         self.assert_(not self.__upRecognizerCalled)
 
 
+    def testDragRecognizerCoordSysNodeDeleted(self):
+        # The recognizer mustn't keep its coordSysNode alive.
+        def onDrag(offset):
+            self.assertEqual(offset, (40,40))
+            self.__dragRecognizerCalled = True
+
+        def onUp(offset):
+            self.__upRecognizerCalled = True
+
+        def deleteCoordSysNode():
+            self.__coordSysNode.unlink(True)
+            self.__coordSysNode = None
+
+        root = self.loadEmptyScene()
+        image = avg.ImageNode(parent=root, href="rgb24-64x64.png")
+        self.__coordSysNode = avg.DivNode(pos=(64,64), parent=root)
+        dragRecognizer = gesture.DragRecognizer(image, moveHandler=onDrag,
+                upHandler=onUp, coordSysNode=self.__coordSysNode, friction=-1)
+        self.__dragRecognizerCalled = False
+        self.__upRecognizerCalled = False
+        self.start(False,
+                (lambda: self._sendMouseEvent(avg.Event.CURSOR_DOWN, 30, 30),
+                 lambda: self._sendMouseEvent(avg.Event.CURSOR_MOTION, 70, 70),
+                 deleteCoordSysNode,
+                 lambda: self._sendMouseEvent(avg.Event.CURSOR_MOTION, 80, 80),
+                 lambda: self._sendMouseEvent(avg.Event.CURSOR_UP, 80, 80),
+                ))
+        self.assert_(self.__dragRecognizerCalled)
+        self.assert_(not self.__upRecognizerCalled)
+
+
     def testDragRecognizerMinDist(self):
 
         def onMove(offset):
@@ -1094,6 +1125,30 @@ class GestureTestCase(AVGTestCase):
         self.assertAlmostEqual(image.size, (30,40))
         self.assertAlmostEqual(image.angle, 1.57)
 
+    def testTransformMoveNode(self):
+        image = avg.ImageNode(pos=(10,20), size=(30,40), angle=0.5, 
+                href="rgb24alpha-64x64.png")
+        refImage = avg.ImageNode(pos=(10,20), size=(30,40), angle=0.5, 
+                href="rgb24alpha-64x64.png")
+        transform = gesture.Transform((5,-5), 0.3, 2, (15,25))
+        self.assertAlmostEqual(transform.trans, (5,-5))
+        self.assertAlmostEqual(transform.pivot, (15,25))
+        transform.moveNode(image)
+
+        # Compare with the equivalent matrix operations.
+        pivotMat = gesture.Mat3x3.translate(transform.pivot)
+        refTransform = pivotMat.applyMat(
+                gesture.Mat3x3.rotate(transform.rot).applyMat(
+                gesture.Mat3x3.scale((transform.scale, transform.scale)).applyMat(
+                pivotMat.inverse().applyMat(
+                gesture.Mat3x3.translate(transform.trans).applyMat(
+                gesture.Mat3x3.fromNode(refImage))))))
+        refTransform.setNodeTransform(refImage)
+        self.assertAlmostEqual(image.pos, refImage.pos, 0.001)
+        self.assertAlmostEqual(image.size, refImage.size, 0.001)
+        self.assertAlmostEqual(image.angle, refImage.angle, 0.001)
+        self.assertAlmostEqual(image.pivot, refImage.pivot, 0.001)
+
     def testTwoRecognizers(self):
         self.__initImageScene()
         self.__tapRecognizer = gesture.TapRecognizer(self.image)
@@ -1138,11 +1193,13 @@ def gestureTestSuite(tests):
         "testDragRecognizerInitialEvent",
         "testDragRecognizerCoordSysNode",
         "testDragRecognizerCoordSysNodeParentUnlink",
+        "testDragRecognizerCoordSysNodeDeleted",
         "testDragRecognizerMinDist",
         "testTransformRecognizer",
         "testTwoRecognizers",
         "testKMeans",
         "testMat3x3",
+        "testTransformMoveNode",
         )
 
     return createAVGTestSuite(availableTests, GestureTestCase, tests)
@@ -21,6 +21,7 @@
 #
 
 
+import os
 import shutil
 
 from libavg import avg, player
@@ -288,6 +289,43 @@ class ImageTestCase(AVGTestCase):
                  testSubBitmap,
                 ))
 
+    def testBitmapDirtyRect(self):
+        def setPartial():
+            # Two overlapping rects in one frame get merged into a single upload.
+            partialNode.setBitmap(shiftedBmp, ((32,32), (65,49)))
+            partialNode.setBitmap(shiftedBmp, ((32,40), (65,65)))
+            self.assertEqual(partialNode.getMediaSize(), (65,65))
+
+        def comparePartial():
+            screenBmp = player.screenshot()
+            self.assert_(self.areSimilarBmps(avg.Bitmap(screenBmp, (0,0), (65,65)),
+                    avg.Bitmap(screenBmp, (80,0), (145,65)), 0.01, 0.01))
+
+        def setOtherSize():
+            partialNode.setBitmap(avg.Bitmap('media/rgb24-32x32.png'), ((0,0), (16,16)))
+            self.assertEqual(partialNode.getMediaSize(), (32,32))
+
+        root = self.loadEmptyScene()
+        srcBmp = avg.Bitmap('media/rgb24-65x65.png')
+        shiftedBmp = avg.Bitmap((65,65), srcBmp.getFormat(), "shifted")
+        shiftedBmp.blt(srcBmp, (0,0))
+        shiftedBmp.blt(srcBmp, (32,32))
+        expectedBmp = avg.Bitmap((65,65), srcBmp.getFormat(), "expected")
+        expectedBmp.blt(srcBmp, (0,0))
+        expectedBmp.blt(avg.Bitmap(shiftedBmp, (32,32), (65,65)), (32,32))
+        partialNode = avg.ImageNode(pos=(0,0), parent=root)
+        partialNode.setBitmap(srcBmp)
+        avg.ImageNode(pos=(80,0), parent=root).setBitmap(expectedBmp)
+        self.assertRaises(avg.Exception,
+                lambda: partialNode.setBitmap(srcBmp, ((32,32), (66,66))))
+        self.assertRaises(avg.Exception,
+                lambda: partialNode.setBitmap(srcBmp, ((32,32), (32,40))))
+        self.start(False,
+                (setPartial,
+                 comparePartial,
+                 setOtherSize,
+                ))
+
     def testBitmapManager(self):
         WAIT_TIMEOUT = 5000
         def expectException(returnValue, nextAction):
@@ -531,6 +569,65 @@ class ImageTestCase(AVGTestCase):
         self.start(False,
                 (lambda: self.compareImage("testMipmap"),))
 
+    def testImageMipmapThreads(self):
+        def checkMipmapped():
+            bmp = avg.Bitmap(player.screenshot(), (0,0), (64,64))
+            # Gamma-correct filtering keeps the average brightness of the checkerboard.
+            self.assert_(bmp.getChannelAvg(0) > 155)
+
+        if player.isUsingGLES():
+            self.skip("Mipmap streaming not supported under GLES")
+            return
+        self.assertRaises(avg.Exception, lambda: player.setMipmapThreads(-1))
+        player.setMipmapThreads(2)
+        self.assertEqual(player.getMipmapThreads(), 2)
+        root = self.loadEmptyScene()
+        avg.ImageNode(size=(64,64), href="checker.png", mipmap=True, parent=root)
+        self.start(False,
+                (lambda: self.delay(100),
+                 checkMipmapped,
+                 lambda: self.assertEqual(player.getNumPendingMipmaps(), 0),
+                ))
+
+        # With a small upload budget, the levels arrive over several frames. The image
+        # is shown unscaled, so it only shows the checkerboard once level 0 is in.
+        def recordFrame():
+            if self.recording:
+                bmp = player.screenshot()
+                self.frames.append((player.getNumPendingMipmaps(), bmp.getAvg(), 
+                        bmp.getStdDev()))
+
+        def startRecording():
+            self.recording = True
+
+        def checkCoarseToFine():
+            self.recording = False
+            self.assertEqual(self.frames[-1][0], 0)
+            # Every frame shows defined texture data.
+            for numPending, average, stdDev in self.frames:
+                self.assert_(average > 100)
+            # Coarse levels are uniform grey, finer levels add detail.
+            self.assert_(self.frames[0][2] < 50)
+            self.assert_(self.frames[-1][2] > 100)
+            for prevFrame, frame in zip(self.frames, self.frames[1:]):
+                self.assert_(frame[2] >= prevFrame[2]-5)
+
+        player.setMipmapUploadBudget(1)
+        root = self.loadEmptyScene()
+        avg.ImageNode(href="checker.png", mipmap=True, parent=root)
+        self.recording = False
+        self.frames = []
+        onFrameID = player.setOnFrameHandler(recordFrame)
+        self.start(False,
+                (None,
+                 startRecording,
+                 lambda: self.delay(300),
+                 checkCoarseToFine,
+                ))
+        player.clearInterval(onFrameID)
+        player.setMipmapUploadBudget(8192)
+        player.setMipmapThreads(0)
+
     def testImageCompression(self):
         def loadBitmap():
             bmp = avg.Bitmap("media/colorramp.png")
@@ -556,6 +653,57 @@ class ImageTestCase(AVGTestCase):
                  checkAlpha,
                 ])
 
+    def testInstancedNode(self):
+        def setInstances():
+            self.node.setInstances(positions=[(10,10), (50,20), (90,30)], 
+                    sizes=[(8,8), (16,16), (32,32)], angles=[0, 0.5, 1],
+                    colors=["FF0000", "00FF00", "0000FF"])
+            self.assertEqual(self.node.numinstances, 3)
+            self.assertEqual(len(self.node.opacities), 0)
+
+        def changeInstances():
+            # Changing the number of instances requires all arrays to be replaced.
+            self.assertRaises(avg.Exception,
+                    lambda: setattr(self.node, "positions", [(0,0)]))
+            self.node.setInstances([(x, x) for x in xrange(0, 160, 2)])
+            self.assertEqual(self.node.numinstances, 80)
+            self.node.opacities = [0.5]*80
+            self.node.shape = "circle"
+
+        def checkErrors():
+            self.assertRaises(avg.Exception,
+                    lambda: setattr(self.node, "shape", "triangle"))
+            self.assertRaises(avg.Exception,
+                    lambda: setattr(self.node, "angles", [0, 1]))
+
+        def clearInstances():
+            self.node.setInstances([])
+            self.assertEqual(self.node.numinstances, 0)
+
+        def runTest():
+            root = self.loadEmptyScene()
+            self.node = avg.InstancedNode(href="rgb24-64x64.png", parent=root)
+            self.assertEqual(self.node.numinstances, 0)
+            self.assertEqual(self.node.shape, "rect")
+            self.start(False,
+                    (setInstances,
+                     lambda: self.compareImage("testInstancedNode1"),
+                     changeInstances,
+                     lambda: self.compareImage("testInstancedNode2"),
+                     checkErrors,
+                     clearInstances,
+                     lambda: self.node.unlink(True),
+                    ))
+
+        runTest()
+        # The expanded fallback without instancing must render the same images.
+        os.environ["AVG_DISABLE_INSTANCING"] = "1"
+        try:
+            runTest()
+        finally:
+            del os.environ["AVG_DISABLE_INSTANCING"]
+        self.node = None
+
     def testSpline(self):
         spline = avg.CubicSpline([(0,3),(1,2),(2,1),(3,0)])
         self.assertAlmostEqual(spline.interpolate(0), 3)
@@ -579,6 +727,7 @@ def imageTestSuite(tests):
             "testImageSize",
             "testImageCache",
             "testBitmap",
+            "testBitmapDirtyRect",
             "testBitmapManager",
             "testBitmapManagerException",
             "testBlendMode",
@@ -586,7 +735,9 @@ def imageTestSuite(tests):
             "testImageMaskCanvas",
             "testImageMaskPos",
             "testImageMipmap",
+            "testImageMipmapThreads",
             "testImageCompression",
+            "testInstancedNode",
             "testSpline",
             )
     return createAVGTestSuite(availableTests, ImageTestCase, tests)
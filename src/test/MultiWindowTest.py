@@ -37,6 +37,42 @@ class MultiWindowTestCase(AVGTestCase):
                 (lambda: self.compareImage("testMultiWindow1"),
                 ))
 
+    def testMultiWindowParallelRender(self):
+        def getScreenshot():
+            self.__bmp = player.screenshot()
+
+        def setEffect():
+            effect = avg.HueSatFXNode()
+            effect.saturation = -200
+            node.setEffect(effect)
+
+        root = self.loadEmptyScene()
+        node = avg.ImageNode(pos=(0,0), href="rgb24-64x64.png", parent=root)
+        avg.WordsNode(pos=(70,10), text="Parallel", color="FF0000", parent=root)
+        player.setWindowConfig("avgwindowconfig.xml")
+        self.start(False,
+                (self.skipIfMinimalShader,
+                 setEffect,
+                 getScreenshot,
+                ))
+        if self.skipped():
+            return
+        singleThreadedBmp = self.__bmp
+
+        root = self.loadEmptyScene()
+        node = avg.ImageNode(pos=(0,0), href="rgb24-64x64.png", parent=root)
+        avg.WordsNode(pos=(70,10), text="Parallel", color="FF0000", parent=root)
+        player.setWindowConfig("avgwindowconfig.xml")
+        player.setParallelRender(True)
+        try:
+            self.start(False,
+                    (setEffect,
+                     getScreenshot,
+                    ))
+        finally:
+            player.setParallelRender(False)
+        self.assert_(self.areSimilarBmps(self.__bmp, singleThreadedBmp, 0.1, 0.5))
+
     def testMultiWindowApp(self):
         app = AppTest.TestApp()
         app.CUSTOM_SETTINGS = {}
@@ -147,6 +183,7 @@ def multiWindowTestSuite(tests):
     if not player.isUsingGLES():
         availableTests = (
                 "testMultiWindowBase",
+                "testMultiWindowParallelRender",
                 "testMultiWindowApp",
                 "testMultiWindowCanvas",
                 "testMultiWindowManualCanvas",
@@ -22,6 +22,7 @@
 from libavg import avg, player, gesture
 from libavg.testcase import *
 import gc
+import os
 
 class OffscreenTestCase(AVGTestCase):
     def __init__(self, testFuncName):
@@ -111,6 +112,26 @@ class OffscreenTestCase(AVGTestCase):
                  lambda: self.compareImage("testOffscreen1"),
                 ))
 
+    def testCanvasSceneFile(self):
+        def loadCanvasSceneFile():
+            player.loadCanvasFile("canvas.avgscene")
+            self.node = avg.ImageNode(parent=root, href="canvas:offscreencanvas")
+
+        root = self.loadEmptyScene()
+        canvas = self.__createOffscreenCanvas("offscreencanvas", False)
+        player.saveSceneFile("canvas.avgscene", canvas.getRootNode())
+        player.deleteCanvas("offscreencanvas")
+        player.saveSceneFile("avg.avgscene")
+        # Scene files are only loaded if the root node matches the kind of canvas.
+        self.assertRaises(avg.Exception, lambda: player.loadFile("canvas.avgscene"))
+        self.assertRaises(avg.Exception, lambda: player.loadCanvasFile("avg.avgscene"))
+        os.remove("avg.avgscene")
+        self.start(False,
+                (loadCanvasSceneFile,
+                 lambda: self.compareImage("testOffscreen1"),
+                ))
+        os.remove("canvas.avgscene")
+
     def testCanvasResize(self):
         def setSize():
             self.node.size = (80, 60)
@@ -280,6 +301,50 @@ class OffscreenTestCase(AVGTestCase):
                  renderCanvas
                 ))
 
+    def testCanvasScreenshotAsync(self):
+        def requestScreenshots():
+            self.screenshots = []
+            self.__offscreenCanvas.screenshotAsync(self.screenshots.append)
+            self.__offscreenCanvas.screenshotAsync(self.screenshots.append)
+            # Requests for the main canvas and the offscreen canvas can be mixed.
+            player.screenshotAsync(self.screenshots.append)
+
+        def checkScreenshots():
+            self.assertEqual(len(self.screenshots), 3)
+            bmp = self.__offscreenCanvas.screenshot()
+            for asyncBmp in self.screenshots[:2]:
+                self.assertEqual(asyncBmp.getSize(), (160,120))
+                self.assert_(self.areSimilarBmps(bmp, asyncBmp, 0.01, 0.01))
+            self.assertEqual(self.screenshots[2].getSize(), (160,120))
+
+        def requestAndDelete():
+            self.screenshots = []
+            self.__offscreenCanvas.screenshotAsync(self.screenshots.append)
+            player.deleteCanvas("testcanvas")
+            self.__offscreenCanvas = None
+
+        self.loadEmptyScene()
+        self.__offscreenCanvas = player.createCanvas(id="testcanvas", size=(160,120),
+                mediadir="media", autorender=False)
+        avg.ImageNode(href="rgb24-65x65.png", parent=self.__offscreenCanvas.getRootNode())
+        self.assertRaises(avg.Exception,
+                lambda: self.__offscreenCanvas.screenshotAsync(lambda bmp: 0))
+        self.start(False,
+                (lambda: self.assertRaises(avg.Exception, 
+                        lambda: self.__offscreenCanvas.screenshotAsync(lambda bmp: 0)),
+                 self.__offscreenCanvas.render,
+                 requestScreenshots,
+                 None,
+                 None,
+                 None,
+                 checkScreenshots,
+                 requestAndDelete,
+                 None,
+                 None,
+                 None,
+                 lambda: self.assertEqual(len(self.screenshots), 0),
+                ))
+
     def testCanvasAutoRender(self):
         def createCanvas():
             canvas = self.__createOffscreenCanvas("testcanvas", False)
@@ -498,6 +563,7 @@ def offscreenTestSuite(tests):
         availableTests = (
                 "testCanvasBasics",
                 "testCanvasLoadAfterPlay",
+                "testCanvasSceneFile",
                 "testCanvasResize",
                 "testCanvasErrors",
                 "testCanvasAPI",
@@ -505,6 +571,7 @@ def offscreenTestSuite(tests):
                 "testCanvasDrag",
                 "testCanvasEventCapture",
                 "testCanvasRender",
+                "testCanvasScreenshotAsync",
                 "testCanvasAutoRender",
                 "testCanvasCrop",
                 "testCanvasAlpha",
@@ -21,6 +21,7 @@
 
 import math
 import threading
+import time
 
 from libavg import avg, player
 from libavg.testcase import *
@@ -186,6 +187,94 @@ class PlayerTestCase(AVGTestCase):
                 (checkTime,
                 ))
 
+    def testFramePacing(self):
+        def checkPacing():
+            self.assert_(player.getFrameLateness() >= 0)
+            self.assertEqual(player.getPredictedPresentTime(), 
+                    player.getFrameTime()+50)
+            player.setFrameTimePolicy("smooth", 2)
+            self.assertEqual(player.getFrameTimePolicy(), "smooth")
+            player.setLateFrameStart(True, 1)
+
+        self.assertEqual(player.getFrameTimePolicy(), "realtime")
+        self.assertRaises(avg.Exception, lambda: player.setFrameTimePolicy("invalid"))
+        self.assertRaises(avg.Exception, lambda: player.setFrameTimePolicy("fixed", 0.5))
+        self.assertRaises(avg.Exception, lambda: player.setLateFrameStart(True, -1))
+        self.loadEmptyScene()
+        self.assertRaises(avg.Exception, player.getFrameLateness)
+        player.setFakeFPS(20)
+        self.start(False,
+                (checkPacing,
+                 lambda: self.assertEqual(player.getFrameTimePolicy(), "smooth"),
+                ))
+        player.setFrameTimePolicy("realtime")
+        player.setLateFrameStart(False)
+
+    def testFramePacingRealTime(self):
+        # Runs with real frame timing at 25 fps (40 ms per frame).
+        def onFrame():
+            self.samples.append((player.getFrameTime(), time.time()*1000))
+
+        def startPhase(policy, bLateStart):
+            player.setFrameTimePolicy(policy, 3)
+            player.setLateFrameStart(bLateStart, 2)
+            self.samples = []
+
+        def getFrameDeltas():
+            frameTimes = [sample[0] for sample in self.samples]
+            return [t2-t1 for t1, t2 in zip(frameTimes, frameTimes[1:])]
+
+        def getMedianStartOffset():
+            # Time between the last presentation and the start of the next frame,
+            # up to a constant. Needs the realtime policy.
+            offsets = sorted([wallTime-frameTime
+                    for frameTime, wallTime in self.samples[1:]])
+            return offsets[len(offsets)/2]
+
+        def hitch():
+            time.sleep(0.3)
+
+        def storeStartOffset():
+            self.startOffset = getMedianStartOffset()
+
+        def checkLateStart():
+            # Without late start, the frame starts right after the last presentation.
+            # With it, the frame starts shortly before the next one.
+            self.assert_(getMedianStartOffset()-self.startOffset > 10)
+
+        def checkRealtime():
+            self.assert_(max(getFrameDeltas()) >= 300)
+
+        def checkSmooth():
+            # The hitch counts as a single frame, so no step exceeds maxFrameStep 
+            # frames.
+            self.assert_(max(getFrameDeltas()) <= 121)
+
+        def checkFixed():
+            for delta in getFrameDeltas():
+                self.assertEqual(delta, 40)
+
+        def runPhase(policy, bLateStart, checkFunc, actions):
+            return ([lambda: startPhase(policy, bLateStart)] + [None]*10 + actions +
+                    [None]*3 + [checkFunc])
+
+        self.loadEmptyScene()
+        player.setFakeFPS(-1)
+        self.samples = []
+        self.onFrameID = player.setOnFrameHandler(onFrame)
+        self.start(False,
+                (lambda: player.setFramerate(25),
+                 [None]*10,
+                 runPhase("realtime", False, storeStartOffset, []),
+                 runPhase("realtime", True, checkLateStart, []),
+                 runPhase("realtime", False, checkRealtime, [hitch]),
+                 runPhase("smooth", False, checkSmooth, [hitch]),
+                 runPhase("fixed", False, checkFixed, [hitch]),
+                ))
+        player.clearInterval(self.onFrameID)
+        player.setFrameTimePolicy("realtime")
+        player.setLateFrameStart(False)
+
     def testDivResize(self):
         def checkSize (w, h):
             self.assertEqual(node.width, w)
@@ -467,6 +556,28 @@ class PlayerTestCase(AVGTestCase):
                 ))
         self.assertRaises(avg.Exception, lambda: player.loadFile("filedoesntexist.avg"))
 
+    def testSceneFile(self):
+        player.convertToSceneFile("image.avg", "image.avgscene")
+        player.loadFile("image.avgscene")
+        self.start(False,
+                (lambda: self.compareImage("testAVGFile"),
+                 lambda: player.saveSceneFile("image2.avgscene"),
+                ))
+        player.loadFile("image2.avgscene")
+        self.start(False,
+                (lambda: self.compareImage("testAVGFile"),
+                ))
+        os.remove("image.avgscene")
+        os.remove("image2.avgscene")
+        self.assertRaises(avg.Exception, lambda: player.loadFile("image.avgscene"))
+
+        # Scene files that don't contain an <avg> root can't be loaded.
+        divNode = avg.DivNode(size=(10,10))
+        avg.RectNode(size=(5,5), parent=divNode)
+        player.saveSceneFile("div.avgscene", divNode)
+        self.assertRaises(avg.Exception, lambda: player.loadFile("div.avgscene"))
+        os.remove("div.avgscene")
+
     def testBroken(self):
         def testBrokenString(string):
             self.assertRaises(avg.Exception, lambda: player.loadString(string))
@@ -726,9 +837,119 @@ class PlayerTestCase(AVGTestCase):
                  setAbsDir
                 ))
 
+    def testCulling(self):
+        def checkNumCulled(num):
+            self.assertEqual(player.getMainCanvas().getNumCulledNodes(), num)
+
+        def moveOnScreen():
+            self.offscreenNode.x = 100
+
+        root = self.loadEmptyScene()
+        avg.ImageNode(href="rgb24-64x64.png", parent=root)
+        self.offscreenNode = avg.ImageNode(pos=(200,0), href="rgb24-64x64.png", 
+                parent=root)
+        cropDiv = avg.DivNode(pos=(0,60), size=(40,40), crop=True, parent=root)
+        avg.ImageNode(pos=(50,0), href="rgb24-64x64.png", parent=cropDiv)
+        self.start(False,
+                (lambda: checkNumCulled(2),
+                 moveOnScreen,
+                 lambda: checkNumCulled(1),
+                ))
+
+    def testScreenshotAsync(self):
+        def requestScreenshots():
+            self.screenshots = []
+            player.screenshotAsync(self.screenshots.append)
+            player.screenshotAsync(self.screenshots.append)
+
+        def checkScreenshots():
+            self.assertEqual(len(self.screenshots), 2)
+            bmp = player.screenshot()
+            for asyncBmp in self.screenshots:
+                self.assert_(self.areSimilarBmps(bmp, asyncBmp, 0.01, 0.01))
+
+        root = self.loadEmptyScene()
+        avg.ImageNode(href="rgb24-64x64.png", parent=root)
+        self.assertRaises(avg.Exception, lambda: player.screenshotAsync(lambda bmp: 0))
+        self.start(False,
+                (requestScreenshots,
+                 None,
+                 None,
+                 None,
+                 checkScreenshots,
+                ))
+
     def testMemoryQuery(self):
         self.assertNotEqual(player.getMemoryUsage(), 0)
 
+    def testGLStateChanges(self):
+        def checkStateChanges():
+            self.assert_(player.getNumGLStateChanges() > 0)
+            # Identical images share almost all of their state.
+            self.assert_(player.getNumElidedGLStateChanges() > 0)
+
+        root = self.loadEmptyScene()
+        for i in range(10):
+            avg.ImageNode(pos=(i*10,0), href="rgb24-64x64.png", parent=root)
+        self.start(False,
+                (checkStateChanges,
+                 checkStateChanges,
+                ))
+
+    def testFramePhaseTimes(self):
+        def checkPhaseTimes():
+            times = player.getFramePhaseTimes()
+            self.assertEqual(sorted(times.keys()), ["events", "frame", "prerender",
+                    "render", "swap", "timers", "upload"])
+            self.assert_(times["frame"] > 0)
+            phaseSum = sum(time for phase, time in times.iteritems() if phase != "frame")
+            self.assert_(phaseSum <= times["frame"]*1.01)
+
+        def checkReset():
+            player.resetFramePhaseTimes()
+            self.assertEqual(player.getFramePhaseTimes()["frame"], 0)
+
+        root = self.loadEmptyScene()
+        avg.ImageNode(href="rgb24-64x64.png", parent=root)
+        self.start(False,
+                (None,
+                 checkPhaseTimes,
+                 checkReset,
+                 checkPhaseTimes,
+                ))
+
+    def testMemoryStats(self):
+        def getTextureBytes(stats):
+            return sum(numBytes for category, (numBytes, numObjects) in stats.iteritems()
+                    if category.startswith("GL textures"))
+
+        def checkStats():
+            stats = player.getMemoryStats()
+            self.assert_(stats["Resident set size"][0] > 0)
+            self.assert_(getTextureBytes(stats) >= 64*64*4)
+            self.assertEqual(player.diffMemoryStats(stats, stats), {})
+            self.__stats = stats
+
+        def addImage():
+            bmp = avg.Bitmap("media/rgb24-65x65.png")
+            avg.ImageNode(parent=root).setBitmap(bmp)
+
+        def checkDiff():
+            diff = player.diffMemoryStats(self.__stats, player.getMemoryStats())
+            self.assert_(getTextureBytes(diff) >= 65*65*4)
+
+        root = self.loadEmptyScene()
+        avg.ImageNode(href="rgb24-64x64.png", parent=root)
+        self.assertRaises(avg.Exception, lambda: player.setMemoryStatsInterval(-1))
+        player.setMemoryStatsInterval(10)
+        self.start(False,
+                (None,
+                 checkStats,
+                 addImage,
+                 checkDiff,
+                 lambda: player.setMemoryStatsInterval(0),
+                ))
+
     def testStopOnEscape(self):
         def pressEscape():
             Helper = player.getTestHelper()
@@ -907,6 +1128,8 @@ def playerTestSuite(tests):
             "testSetResolution",
             "testColorParse",
             "testFakeTime",
+            "testFramePacing",
+            "testFramePacingRealTime",
             "testDivResize",
             "testRotate",
             "testRotate2",
@@ -922,13 +1145,19 @@ def playerTestSuite(tests):
             "testTimeoutOnFrameHandling",
             "testCallFromThread",
             "testAVGFile",
+            "testSceneFile",
             "testBroken",
             "testMove",
             "testCropImage",
             "testCropMovie",
             "testWarp",
             "testMediaDir",
+            "testCulling",
+            "testScreenshotAsync",
             "testMemoryQuery",
+            "testGLStateChanges",
+            "testFramePhaseTimes",
+            "testMemoryStats",
             "testStopOnEscape",
             "testScreenDimensions",
             "testSVG",
@@ -444,6 +444,60 @@ class VectorTestCase(AVGTestCase):
                  lambda: self.compareImage("testTexturedPolyLine4")
                 ))
 
+    def testIncrementalPolyLine(self):
+        # Geometry that is reused between changes must match geometry calculated
+        # from scratch.
+        def createLines():
+            self.polyline = avg.PolyLineNode(strokewidth=3, parent=canvas)
+            self.polygon = avg.PolygonNode(pos=polygonPts, fillopacity=0.5,
+                    fillcolor="00FF00", parent=canvas)
+
+        def appendPoint(i):
+            self.polyline.pos = linePts[:i+1]
+
+        def movePoint(pt):
+            pts = list(linePts)
+            pts[4] = pt
+            self.polyline.pos = pts
+
+        def insertPoint():
+            pts = list(linePts)
+            pts.insert(2, (40,50))
+            self.polyline.pos = pts
+
+        def movePolygon(dx):
+            self.polygon.pos = [(x+dx,y) for (x,y) in polygonPts]
+
+        def recreateLines():
+            self.polyline.unlink(True)
+            self.polygon.unlink(True)
+            self.polyline = avg.PolyLineNode(strokewidth=3, pos=linePts, parent=canvas)
+            self.polygon = avg.PolygonNode(pos=polygonPts, fillopacity=0.5,
+                    fillcolor="00FF00", parent=canvas)
+
+        def storeScreenshot():
+            self.screenshots.append(player.screenshot())
+
+        linePts = [(10+i*15, 10+(i%3)*20) for i in xrange(10)]
+        polygonPts = [(20,80), (60,70), (90,100), (50,110), (30,95)]
+        self.screenshots = []
+        canvas = self.makeEmptyCanvas()
+        createLines()
+        self.start(False,
+                ([lambda i=i: appendPoint(i) for i in xrange(len(linePts))],
+                 lambda: movePoint((75,35)),
+                 lambda: movePoint(linePts[4]),
+                 insertPoint,
+                 lambda: movePoint(linePts[4]),
+                 lambda: movePolygon(10),
+                 lambda: movePolygon(0),
+                 storeScreenshot,
+                 recreateLines,
+                 storeScreenshot,
+                ))
+        self.assert_(self.areSimilarBmps(self.screenshots[0], self.screenshots[1],
+                0.01, 0.01))
+
     def testPolygon(self):
         def addPolygon():
             polygon = avg.PolygonNode(strokewidth=2, color="FF00FF",
@@ -810,8 +864,43 @@ class VectorTestCase(AVGTestCase):
                  lambda: self.fakeClick(20, 20),
                  lambda: self.assert_(self.onDownCalled)
                 ))
-        
-        
+
+
+    def testParallelPreRender(self):
+        def createScene():
+            canvas = self.makeEmptyCanvas()
+            self.circles = []
+            for i in xrange(40):
+                x = (i%8)*20
+                y = (i/8)*20
+                avg.PolygonNode(pos=((x,y), (x+15,y), (x+15,y+15), (x,y+5)),
+                        fillopacity=0.5, fillcolor="00FF00", parent=canvas)
+                self.circles.append(avg.CircleNode(pos=(x+8,y+8), r=5, strokewidth=2,
+                        parent=canvas))
+
+        def changeScene():
+            for circle in self.circles:
+                circle.r = 7
+
+        def storeScreenshot():
+            self.screenshots.append(player.screenshot())
+
+        self.screenshots = []
+        for numThreads in (0, 2):
+            player.setPreRenderThreads(numThreads)
+            createScene()
+            self.start(False,
+                    (storeScreenshot,
+                     changeScene,
+                     storeScreenshot,
+                    ))
+        player.setPreRenderThreads(0)
+        self.assertEqual(len(self.screenshots), 4)
+        for i in xrange(2):
+            self.assert_(self.areSimilarBmps(self.screenshots[i], self.screenshots[i+2],
+                    0.01, 0.01))
+
+
 def vectorTestSuite(tests):
     availableTests = (
             "testLine",
@@ -826,6 +915,7 @@ def vectorTestSuite(tests):
             "testTexturedCurve",
             "testPolyLine",
             "testTexturedPolyLine",
+            "testIncrementalPolyLine",
             "testPolygon",
             "testPolygonInDiv",
             "testPolygonEvents",
@@ -833,6 +923,7 @@ def vectorTestSuite(tests):
             "testPointInPolygon",
             "testCircle",
             "testMesh",
-            "testInactiveVector"
+            "testInactiveVector",
+            "testParallelPreRender",
             )
     return createAVGTestSuite(availableTests, VectorTestCase, tests)
@@ -19,6 +19,10 @@
 # Current versions can be found at www.libavg.de
 #
 
+import os
+import shutil
+import tempfile
+
 from libavg import avg, textarea, widget, player
 from libavg.testcase import *
 
@@ -563,6 +567,78 @@ class WidgetTestCase(AVGTestCase):
                 )) 
 
 
+    def testTiledImageNode(self):
+
+        def checkPyramid():
+            pyramid = widget.TilePyramid.fromDZI(dziPath)
+            self.assert_(pyramid.size == (65,65))
+            self.assert_(pyramid.maxLevel == 7)
+            self.assert_(pyramid.getBaseLevel() == 4)
+            self.assert_(pyramid.getNumTiles(7) == (5,5))
+            self.assert_(os.path.isfile(pyramid.getTilePath(7, 4, 4)))
+            self.assert_(os.path.isfile(pyramid.getTilePath(0, 0, 0)))
+
+        def compareToImageNode():
+            self.assert_(self.node.getNumPendingTiles() == 0)
+            screenBmp = player.screenshot()
+            tiledBmp = avg.Bitmap(screenBmp, (0,0), (65,65))
+            refBmp = avg.Bitmap(screenBmp, (80,0), (145,65))
+            self.assert_(self.areSimilarBmps(tiledBmp, refBmp, 0.5, 2))
+
+        def checkCache():
+            numCPUTiles, numGPUTiles = self.node.getNumTiles()
+            self.assert_(numCPUTiles == 25 and numGPUTiles == 25)
+            cpuMem, gpuMem = self.node.getMemUsed()
+            self.assert_(cpuMem > 0 and gpuMem > 0)
+
+        def zoomOut():
+            self.node.zoomAt((0,0), 0.5)
+            self.assert_(self.node.zoom == 0.5)
+
+        def shrinkCache():
+            self.node.capacity = (0, 0)
+            self.assert_(self.node.capacity == (0, 0))
+
+        def checkShrunkCache():
+            # Only the tiles visible at level 6 are kept.
+            self.assert_(self.node.getNumTiles() == (9, 9))
+
+        def createInDiv():
+            self.div = avg.DivNode(parent=root)
+            self.node = widget.TiledImageNode(dziPath, size=(65,65), parent=self.div)
+
+        def killParent():
+            # Killing an ancestor releases the tiles as well.
+            self.assert_(self.node.getNumTiles() != (0, 0))
+            self.div.unlink(True)
+            self.assert_(self.node.getNumTiles() == (0, 0))
+
+        tempDir = tempfile.mkdtemp()
+        dziPath = os.path.join(tempDir, "pyramid.dzi")
+        widget.generateTilePyramid("media/rgb24-65x65.png", dziPath, tileSize=16)
+        checkPyramid()
+
+        root = self.loadEmptyScene()
+        self.node = widget.TiledImageNode(dziPath, size=(65,65), parent=root)
+        avg.ImageNode(pos=(80,0), href="rgb24-65x65.png", parent=root)
+        self.start(False,
+                (lambda: self.delay(200),
+                 compareToImageNode,
+                 checkCache,
+                 zoomOut,
+                 lambda: self.delay(200),
+                 None,
+                 shrinkCache,
+                 None,
+                 checkShrunkCache,
+                 lambda: self.node.unlink(True),
+                 lambda: self.assert_(self.node.getNumTiles() == (0, 0)),
+                 createInDiv,
+                 lambda: self.delay(200),
+                 killParent,
+                ))
+        shutil.rmtree(tempDir)
+
     def testSlider(self):
         def onThumbPosChanged(pos):
             self.thumbPos = pos
@@ -827,6 +903,7 @@ def widgetTestSuite(tests):
         "testScrollPane",
         "testStretchNode",
         "testHVStretchNode",
+        "testTiledImageNode",
         "testSlider",
         "testScrollBar",
         "testProgressBar",
@@ -0,0 +1,347 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+# libavg - Media Playback Engine.
+# Copyright (C) 2003-2014 Ulrich von Zadow
+#
+# This library is free software; you can redistribute it and/or
+# modify it under the terms of the GNU Lesser General Public
+# License as published by the Free Software Foundation; either
+# version 2 of the License, or (at your option) any later version.
+#
+# This library is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+# Lesser General Public License for more details.
+#
+# You should have received a copy of the GNU Lesser General Public
+# License along with this library; if not, write to the Free Software
+# Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+#
+# Current versions can be found at www.libavg.de
+#
+
+"""
+Performance regression suite for the render loop. Runs a fixed set of scenes for a
+fixed number of frames with fake fps and collects the average time per frame spent in
+each phase of the main loop (see Player.getFramePhaseTimes()). The results are
+written as JSON and compared to a baseline file. The exit code is 1 if a phase got
+slower than the baseline allows.
+
+Timings depend on the machine, so baselines aren't portable. If the baseline file
+doesn't exist, it is created from the current results.
+"""
+
+import sys
+import os
+import json
+import random
+import optparse
+
+if sys.platform != 'win32':
+    sys.path.insert(0, '../..')
+
+from libavg import avg, player
+
+RESOLUTION = (800, 600)
+WARMUP_FRAMES = 20
+# Phases that take less time than this (in milliseconds) are dominated by noise and
+# aren't compared.
+MIN_COMPARE_TIME = 0.1
+
+
+class Scene(object):
+    def __init__(self, root):
+        self._root = root
+        # Every run should render the same frames.
+        self._random = random.Random(42)
+
+    def onFrame(self, frameNum):
+        pass
+
+    def _randPos(self, margin=64):
+        return avg.Point2D(self._random.randrange(RESOLUTION[0]-margin),
+                self._random.randrange(RESOLUTION[1]-margin))
+
+
+class ImagesScene(Scene):
+    NUM_NODES = 500
+
+    def __init__(self, root):
+        super(ImagesScene, self).__init__(root)
+        self.__nodes = [avg.ImageNode(href="rgb24alpha-64x64.png", pos=self._randPos(),
+                parent=root) for i in xrange(self.NUM_NODES)]
+
+    def onFrame(self, frameNum):
+        for node in self.__nodes:
+            node.pos = self._randPos()
+
+
+class VideosScene(Scene):
+    NUM_NODES = 40
+
+    def __init__(self, root):
+        super(VideosScene, self).__init__(root)
+        for i in xrange(self.NUM_NODES):
+            node = avg.VideoNode(href="mpeg1-48x48.mov", loop=True, pos=self._randPos(),
+                    parent=root)
+            node.play()
+
+
+class VectorScene(Scene):
+    NUM_NODES = 100
+
+    def __init__(self, root):
+        super(VectorScene, self).__init__(root)
+        self.__polygons = [avg.PolygonNode(fillopacity=0.5, parent=root)
+                for i in xrange(self.NUM_NODES)]
+        self.__polylines = [avg.PolyLineNode(strokewidth=3, parent=root)
+                for i in xrange(self.NUM_NODES)]
+        self.__circles = [avg.CircleNode(r=20, fillopacity=0.5, parent=root)
+                for i in xrange(self.NUM_NODES)]
+        self.__curves = [avg.CurveNode(strokewidth=2, parent=root)
+                for i in xrange(self.NUM_NODES)]
+
+    def onFrame(self, frameNum):
+        for node in self.__polygons:
+            node.pos = self.__genPts(node, 20)
+        for node in self.__polylines:
+            node.pos = self.__genPts(node, 20)
+        for node in self.__circles:
+            node.pos = self._randPos()
+        for node in self.__curves:
+            node.pos1, node.pos2, node.pos3, node.pos4 = self.__genPts(node, 4)
+
+    def __genPts(self, node, numPts):
+        basePos = self._randPos(100)
+        return [basePos + (self._random.random()*100, self._random.random()*100)
+                for i in xrange(numPts)]
+
+
+class TextScene(Scene):
+    NUM_NODES = 100
+
+    def __init__(self, root):
+        super(TextScene, self).__init__(root)
+        self.__nodes = [avg.WordsNode(fontsize=12, pos=self._randPos(100), parent=root)
+                for i in xrange(self.NUM_NODES)]
+
+    def onFrame(self, frameNum):
+        for i, node in enumerate(self.__nodes):
+            node.text = "Frame %i, node %i: %i" % (frameNum, i,
+                    self._random.randrange(1000000))
+
+
+class NodeChurnScene(Scene):
+    NUM_NODES = 200
+
+    def __init__(self, root):
+        super(NodeChurnScene, self).__init__(root)
+        self.__nodes = []
+
+    def onFrame(self, frameNum):
+        for node in self.__nodes:
+            node.unlink(True)
+        self.__nodes = []
+        for i in xrange(self.NUM_NODES):
+            if i%3 == 0:
+                node = avg.ImageNode(href="rgb24-64x64.png", pos=self._randPos(),
+                        parent=self._root)
+            elif i%3 == 1:
+                node = avg.RectNode(pos=self._randPos(), size=(32,32),
+                        fillopacity=1, parent=self._root)
+            else:
+                node = avg.WordsNode(text="churn", pos=self._randPos(),
+                        parent=self._root)
+            self.__nodes.append(node)
+
+
+class FXScene(Scene):
+    NUM_NODES = 40
+
+    def __init__(self, root):
+        super(FXScene, self).__init__(root)
+        self.__effects = []
+        for i in xrange(self.NUM_NODES):
+            node = avg.ImageNode(href="rgb24alpha-64x64.png", pos=self._randPos(),
+                    parent=root)
+            if i%3 == 0:
+                effect = avg.BlurFXNode(3)
+            elif i%3 == 1:
+                effect = avg.ShadowFXNode((2,2), 2, 0.5)
+            else:
+                effect = avg.HueSatFXNode(0, 50)
+            node.setEffect(effect)
+            self.__effects.append(effect)
+
+        # Chain: Nodes with effects inside an offscreen canvas that is displayed with
+        # another effect.
+        canvas = player.createCanvas(id="fxchain", size=(256,256))
+        canvasRoot = canvas.getRootNode()
+        canvasRoot.mediadir = root.mediadir
+        self.__chainEffects = []
+        for i in xrange(4):
+            node = avg.ImageNode(href="rgb24alpha-64x64.png", pos=(i*64, i*64),
+                    parent=canvasRoot)
+            effect = avg.BlurFXNode(2)
+            node.setEffect(effect)
+            self.__chainEffects.append(effect)
+        node = avg.ImageNode(href="canvas:fxchain", pos=(400,300), parent=root)
+        node.setEffect(avg.ShadowFXNode((4,4), 4, 0.5))
+
+    def onFrame(self, frameNum):
+        # Changing the effect parameters forces the effects to be rendered again.
+        for effect in self.__effects:
+            if isinstance(effect, avg.BlurFXNode):
+                effect.radius = 3 + frameNum%2
+            elif isinstance(effect, avg.ShadowFXNode):
+                effect.radius = 2 + frameNum%2
+            else:
+                effect.hue = frameNum%360
+        for effect in self.__chainEffects:
+            effect.radius = 2 + frameNum%2
+
+
+class EventScene(Scene):
+    NUM_NODES = 200
+    NUM_TOUCHES = 20
+
+    def __init__(self, root):
+        super(EventScene, self).__init__(root)
+        for i in xrange(self.NUM_NODES):
+            node = avg.RectNode(pos=self._randPos(), size=(64,64), parent=root)
+            for messageID in (avg.Node.CURSOR_DOWN, avg.Node.CURSOR_MOTION,
+                    avg.Node.CURSOR_UP):
+                node.subscribe(messageID, lambda event: None)
+
+    def onFrame(self, frameNum):
+        helper = player.getTestHelper()
+        phase = frameNum%10
+        if phase == 0:
+            eventType = avg.Event.CURSOR_DOWN
+        elif phase == 9:
+            eventType = avg.Event.CURSOR_UP
+        else:
+            eventType = avg.Event.CURSOR_MOTION
+        for i in xrange(self.NUM_TOUCHES):
+            helper.fakeTouchEvent(frameNum//10*self.NUM_TOUCHES+i, eventType,
+                    avg.Event.TOUCH, self._randPos())
+        helper.fakeMouseEvent(avg.Event.CURSOR_MOTION, False, False, False,
+                self._random.randrange(RESOLUTION[0]),
+                self._random.randrange(RESOLUTION[1]), 0)
+
+
+SCENES = (
+    ("images", ImagesScene),
+    ("videos", VideosScene),
+    ("vector", VectorScene),
+    ("text", TextScene),
+    ("nodechurn", NodeChurnScene),
+    ("fx", FXScene),
+    ("events", EventScene),
+)
+
+
+def runScene(sceneClass, numFrames):
+    player.createMainCanvas(size=RESOLUTION)
+    root = player.getRootNode()
+    root.mediadir = "media"
+    scene = sceneClass(root)
+    frameNum = [0]
+    times = {}
+
+    def onFrame():
+        scene.onFrame(frameNum[0])
+        frameNum[0] += 1
+        if frameNum[0] == WARMUP_FRAMES:
+            player.resetFramePhaseTimes()
+        elif frameNum[0] == WARMUP_FRAMES+numFrames:
+            times.update(player.getFramePhaseTimes())
+            player.stop()
+
+    player.setFakeFPS(60)
+    subscriberID = player.subscribe(player.ON_FRAME, onFrame)
+    player.play()
+    player.unsubscribe(player.ON_FRAME, subscriberID)
+    return times
+
+
+def compareResults(results, baseline, tolerance):
+    regressions = []
+    for sceneName, baselineTimes in sorted(baseline["scenes"].iteritems()):
+        if sceneName not in results["scenes"]:
+            continue
+        times = results["scenes"][sceneName]
+        for phase, baselineTime in sorted(baselineTimes.iteritems()):
+            if baselineTime < MIN_COMPARE_TIME or phase not in times:
+                continue
+            if times[phase] > baselineTime*(1+tolerance):
+                regressions.append("%s/%s: %.3f ms, baseline %.3f ms" %
+                        (sceneName, phase, times[phase], baselineTime))
+    return regressions
+
+
+def main():
+    parser = optparse.OptionParser(usage="%prog [options]\n"+__doc__.strip())
+    parser.add_option("--frames", "-f", dest="numFrames", type="int", default=300,
+            help="number of frames to measure per scene [Default: %default].")
+    parser.add_option("--scenes", "-s", dest="scenes", default="",
+            help="comma-separated list of scenes to run [Default: all]. "
+                    "Available: "+", ".join(name for name, sceneClass in SCENES))
+    parser.add_option("--output", "-o", dest="output", default="",
+            help="file to write the results to [Default: stdout].")
+    parser.add_option("--baseline", "-b", dest="baseline", default="",
+            help="baseline file to compare the results to.")
+    parser.add_option("--tolerance", "-t", dest="tolerance", type="float",
+            default=0.2, help="allowed slowdown relative to the baseline "
+                    "[Default: %default].")
+    parser.add_option("--update-baseline", "-u", dest="updateBaseline",
+            action="store_true", default=False,
+            help="overwrite the baseline file with the current results.")
+    parser.add_option("--window", "-w", dest="window", action="store_true",
+            default=False, help="render to a window instead of running headless.")
+    options, args = parser.parse_args()
+
+    if not options.window:
+        os.environ["AVG_HEADLESS"] = "1"
+    if options.scenes:
+        sceneNames = options.scenes.split(",")
+        for sceneName in sceneNames:
+            if sceneName not in dict(SCENES):
+                parser.error("Unknown scene '%s'." % sceneName)
+    else:
+        sceneNames = [name for name, sceneClass in SCENES]
+
+    results = {"frames": options.numFrames, "scenes": {}}
+    for sceneName in sceneNames:
+        sys.stderr.write("Running %s...\n" % sceneName)
+        results["scenes"][sceneName] = runScene(dict(SCENES)[sceneName],
+                options.numFrames)
+
+    resultString = json.dumps(results, indent=4, sort_keys=True)
+    if options.output:
+        with open(options.output, "w") as outFile:
+            outFile.write(resultString+"\n")
+    else:
+        print resultString
+
+    if options.baseline:
+        if options.updateBaseline or not os.path.exists(options.baseline):
+            with open(options.baseline, "w") as baselineFile:
+                baselineFile.write(resultString+"\n")
+            sys.stderr.write("Baseline written to %s.\n" % options.baseline)
+        else:
+            with open(options.baseline) as baselineFile:
+                baseline = json.load(baselineFile)
+            regressions = compareResults(results, baseline, options.tolerance)
+            if regressions:
+                sys.stderr.write("Performance regressions (tolerance %i%%):\n" %
+                        int(options.tolerance*100))
+                for regression in regressions:
+                    sys.stderr.write("    "+regression+"\n")
+                return 1
+            sys.stderr.write("No performance regressions.\n")
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -23,6 +23,7 @@
 #include "FFMpegDemuxer.h"
 
 #include "../base/TimeSource.h"
+#include "../base/ScopeTimer.h"
 
 using namespace std;
 
@@ -58,6 +59,9 @@ bool VideoDemuxerThread::init()
     return true;
 }
 
+static ProfilingZoneID DemuxProfilingZone("Demux packet", true);
+static ProfilingZoneID PushPacketProfilingZone("Push packet", true);
+
 bool VideoDemuxerThread::work() 
 {
     if (m_bEOF) {
@@ -85,7 +89,11 @@ bool VideoDemuxerThread::work()
             return true;
         }
 
-        AVPacket * pPacket = m_pDemuxer->getPacket(shortestQ);
+        AVPacket * pPacket;
+        {
+            ScopeTimer timer(DemuxProfilingZone);
+            pPacket = m_pDemuxer->getPacket(shortestQ);
+        }
         VideoMsgPtr pMsg(new VideoMsg);
         if (pPacket == 0) {
             onStreamEOF(shortestQ);
@@ -93,7 +101,11 @@ bool VideoDemuxerThread::work()
         } else {
             pMsg->setPacket(pPacket);
         }
-        m_PacketQs[shortestQ]->push(pMsg);
+        {
+            ScopeTimer timer(PushPacketProfilingZone);
+            m_PacketQs[shortestQ]->push(pMsg);
+        }
+        ThreadProfiler::get()->reset();
         msleep(0);
     }
     return true;
@@ -25,22 +25,33 @@
 #include "../base/ObjectCounter.h"
 #include "../base/Exception.h"
 
+#include "../graphics/Bitmap.h"
+
 namespace avg {
 
+// Decoded frames that haven't been picked up by the application yet. The bitmaps are
+// also counted in the per-pixel format bitmap categories.
+static const std::string MEM_CATEGORY = "Video frame queues";
+
 VideoMsg::VideoMsg()
 {
 }
 
 VideoMsg::~VideoMsg()
 {
+    if (getType() == FRAME) {
+        ObjectCounter::get()->decMemory(MEM_CATEGORY, getFrameMemNeeded());
+    }
 }
 
 void VideoMsg::setFrame(const std::vector<BitmapPtr>& pBmps, float frameTime)
 {
     AVG_ASSERT(pBmps.size() == 1 || pBmps.size() == 3 || pBmps.size() == 4);
+    AVG_ASSERT(getType() != FRAME);
     setType(FRAME);
     m_pBmps = pBmps;
     m_FrameTime = frameTime;
+    ObjectCounter::get()->incMemory(MEM_CATEGORY, getFrameMemNeeded());
 }
 
 void VideoMsg::setPacket(AVPacket* pPacket)
@@ -71,6 +82,15 @@ BitmapPtr VideoMsg::getFrameBitmap(int i)
     return m_pBmps[i];
 }
 
+long long VideoMsg::getFrameMemNeeded() const
+{
+    long long memNeeded = 0;
+    for (unsigned i = 0; i < m_pBmps.size(); ++i) {
+        memNeeded += m_pBmps[i]->getMemNeeded();
+    }
+    return memNeeded;
+}
+
 float VideoMsg::getFrameTime()
 {
     AVG_ASSERT(getType() == FRAME);
@@ -51,6 +51,8 @@ public:
     void freePacket();
 
 private:
+    long long getFrameMemNeeded() const;
+
     // FRAME
     std::vector<BitmapPtr> m_pBmps;
     float m_FrameTime;
@@ -0,0 +1,254 @@
+//
+//  libavg - Media Playback Engine. 
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+
+#include "AsyncVideoDecoder.h"
+
+#include "../base/TimeSource.h"
+#include "../base/Logger.h"
+#include "../base/ScopeTimer.h"
+#include "../base/ThreadProfiler.h"
+#include "../base/OSHelper.h"
+#include "../base/Exception.h"
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <algorithm>
+#include <stdlib.h>
+
+using namespace avg;
+using namespace std;
+
+// Decodes several files concurrently through AsyncVideoDecoder without rendering them.
+// Frames are requested as fast as the decoder threads deliver them, so the result is
+// the maximum sustainable decode rate of the pipeline.
+//
+// Usage: benchmarkvideo [-n numStreams] [-l numLoops] [-q queueLength] [files...]
+// Without files, the test media are used. Like the other cpp tests, the benchmark is
+// copied to python/libavg/test/cpptest and expects to be run from there.
+//
+// Per-stage times (demux, decode, convert, queue push/wait) are dumped by the
+// demuxer and decoder threads as they terminate.
+
+const int SAMPLE_INTERVAL = 500;
+
+struct StreamState {
+    AsyncVideoDecoderPtr m_pDecoder;
+    vector<BitmapPtr> m_pBmps;
+    float m_CurTime;
+    float m_TimePerFrame;
+    bool m_bEOF;
+};
+
+// Same locations as Test::getMediaDir().
+string getMediaDir()
+{
+#ifdef WIN32
+    return "../test/media";
+#else
+    return "../media";
+#endif
+}
+
+float getPercentile(vector<float>& values, float p)
+{
+    if (values.empty()) {
+        return 0;
+    }
+    sort(values.begin(), values.end());
+    return values[size_t(p*(values.size()-1)+0.5)];
+}
+
+float getRSSMB()
+{
+    return getMemoryUsage()/(1024.f*1024.f);
+}
+
+int getNumPlanes(AsyncVideoDecoderPtr pDecoder)
+{
+    PixelFormat pf = pDecoder->getPixelFormat();
+    if (pixelFormatIsPlanar(pf)) {
+        return pixelFormatHasAlpha(pf) ? 4 : 3;
+    } else {
+        return 1;
+    }
+}
+
+AsyncVideoDecoderPtr openStream(const string& sFilename, bool bYCbCr, int queueLength)
+{
+    AsyncVideoDecoderPtr pDecoder(new AsyncVideoDecoder(queueLength));
+    pDecoder->open(sFilename, false);
+    pDecoder->startDecoding(bYCbCr, 0);
+    return pDecoder;
+}
+
+// Returns the number of frames decoded.
+int decodeStreams(const vector<string>& sFilenames, int numStreams, bool bYCbCr, 
+        int queueLength)
+{
+    vector<StreamState> streams(numStreams);
+    for (int i = 0; i < numStreams; ++i) {
+        StreamState& stream = streams[i];
+        stream.m_pDecoder = openStream(sFilenames[i%sFilenames.size()], bYCbCr, 
+                queueLength);
+        stream.m_pBmps.resize(getNumPlanes(stream.m_pDecoder));
+        stream.m_CurTime = 0;
+        stream.m_TimePerFrame = 1.0f/stream.m_pDecoder->getFPS();
+        stream.m_bEOF = false;
+    }
+
+    long long startTime = TimeSource::get()->getCurrentMicrosecs();
+    long long lastSampleTime = startTime;
+    long long starvedTime = 0;
+    int numFrames = 0;
+    int lastSampleFrames = 0;
+    int numEOF = 0;
+    float queueSum = 0;
+    int numQueueSamples = 0;
+    while (numEOF < numStreams) {
+        bool bGotFrame = false;
+        for (int i = 0; i < numStreams; ++i) {
+            StreamState& stream = streams[i];
+            if (stream.m_bEOF) {
+                continue;
+            }
+            queueSum += stream.m_pDecoder->getNumFramesQueued();
+            numQueueSamples++;
+            FrameAvailableCode frameAvailable = stream.m_pDecoder->getRenderedBmps(
+                    stream.m_pBmps, stream.m_CurTime);
+            if (frameAvailable == FA_NEW_FRAME) {
+                numFrames++;
+                bGotFrame = true;
+                stream.m_CurTime += stream.m_TimePerFrame;
+            }
+            if (stream.m_pDecoder->isEOF()) {
+                stream.m_bEOF = true;
+                numEOF++;
+            }
+        }
+        long long now = TimeSource::get()->getCurrentMicrosecs();
+        if (!bGotFrame) {
+            msleep(0);
+            starvedTime += TimeSource::get()->getCurrentMicrosecs()-now;
+        }
+        if (now-lastSampleTime > SAMPLE_INTERVAL*1000) {
+            cerr << "    " << setw(6) << setprecision(1) << (now-startTime)/1000000.f 
+                    << " s: " << setw(7) << setprecision(1) 
+                    << (numFrames-lastSampleFrames)*1000000.f/(now-lastSampleTime)
+                    << " frames/s, queue " << setprecision(2) 
+                    << queueSum/numQueueSamples << "/" << queueLength 
+                    << ", RSS " << setprecision(1) << getRSSMB() << " MB" << endl;
+            lastSampleTime = now;
+            lastSampleFrames = numFrames;
+        }
+    }
+    long long elapsed = TimeSource::get()->getCurrentMicrosecs()-startTime;
+    for (int i = 0; i < numStreams; ++i) {
+        streams[i].m_pDecoder->close();
+    }
+    cerr << "    " << numFrames << " frames in " << setprecision(2) 
+            << elapsed/1000000.f << " s: " << setprecision(1) 
+            << numFrames*1000000.f/elapsed << " frames/s, main thread waiting " 
+            << starvedTime*100.f/elapsed << "% of the time, avg. queue occupancy "
+            << setprecision(2) << queueSum/numQueueSamples << "/" << queueLength
+            << endl;
+    return numFrames;
+}
+
+void measureSeeks(const string& sFilename, bool bYCbCr, int queueLength, int numSeeks)
+{
+    AsyncVideoDecoderPtr pDecoder = openStream(sFilename, bYCbCr, queueLength);
+    vector<BitmapPtr> pBmps(getNumPlanes(pDecoder));
+    // Stay clear of the end of the stream - asking for a frame after EOF is an error.
+    float maxTime = pDecoder->getVideoInfo().m_Duration*0.8f;
+    vector<float> latencies;
+    srand(1);
+    for (int i = 0; i < numSeeks; ++i) {
+        float destTime = maxTime*rand()/RAND_MAX;
+        long long startTime = TimeSource::get()->getCurrentMicrosecs();
+        pDecoder->seek(destTime);
+        pDecoder->getRenderedBmps(pBmps, -1);
+        latencies.push_back((TimeSource::get()->getCurrentMicrosecs()-startTime)/1000.f);
+    }
+    pDecoder->close();
+    cerr << "    Seek to first frame (" << sFilename << "): p50 " << setprecision(2) 
+            << getPercentile(latencies, 0.5f) << " ms, p90 " 
+            << getPercentile(latencies, 0.9f) << " ms, max " 
+            << getPercentile(latencies, 1) << " ms" << endl;
+}
+
+void runBenchmark(const vector<string>& sFilenames, int numStreams, int numLoops,
+        int queueLength, bool bYCbCr)
+{
+    cerr << (bYCbCr ? "YCbCr" : "RGB") << " delivery, " << numStreams << " streams:" 
+            << endl;
+    float startRSS = getRSSMB();
+    for (int i = 0; i < numLoops; ++i) {
+        decodeStreams(sFilenames, numStreams, bYCbCr, queueLength);
+        cerr << "    RSS after pass " << i+1 << ": " << setprecision(1) << getRSSMB()
+                << " MB (" << showpos << getRSSMB()-startRSS << noshowpos << " MB)" 
+                << endl;
+    }
+    for (unsigned i = 0; i < sFilenames.size(); ++i) {
+        measureSeeks(sFilenames[i], bYCbCr, queueLength, 20);
+    }
+}
+
+int main(int nargs, char** args)
+{
+    int numStreams = 4;
+    int numLoops = 1;
+    int queueLength = 8;
+    vector<string> sFilenames;
+    for (int i = 1; i < nargs; ++i) {
+        string sArg = args[i];
+        if (sArg == "-n" && i+1 < nargs) {
+            numStreams = atoi(args[++i]);
+        } else if (sArg == "-l" && i+1 < nargs) {
+            numLoops = atoi(args[++i]);
+        } else if (sArg == "-q" && i+1 < nargs) {
+            queueLength = atoi(args[++i]);
+        } else {
+            sFilenames.push_back(sArg);
+        }
+    }
+    if (sFilenames.empty()) {
+        string sMediaDir = getMediaDir();
+        sFilenames.push_back(sMediaDir+"/mpeg1-48x48.mov");
+        sFilenames.push_back(sMediaDir+"/mjpeg-48x48.avi");
+        sFilenames.push_back(sMediaDir+"/h264-48x48.h264");
+    }
+
+    Logger::get()->configureCategory(Logger::category::PROFILE, Logger::severity::INFO);
+    Logger::get()->configureCategory(Logger::category::PROFILE_VIDEO, 
+            Logger::severity::INFO);
+    ScopeTimer::enableTimers(true);
+    cerr << setiosflags(ios::fixed);
+    try {
+        runBenchmark(sFilenames, numStreams, numLoops, queueLength, false);
+        runBenchmark(sFilenames, numStreams, numLoops, queueLength, true);
+    } catch (Exception& ex) {
+        cerr << ex.getStr() << endl;
+        return 1;
+    }
+    return 0;
+}
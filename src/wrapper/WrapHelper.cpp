@@ -495,6 +495,7 @@ void export_base()
     to_python_converter<vector<string>, to_list<vector<string> > >();    
     from_python_sequence<vector<string> >();
   
+    to_python_converter<vector<float>, to_list<vector<float> > >();    
     from_python_sequence<vector<float> >();
     from_python_sequence<vector<int> >();
 
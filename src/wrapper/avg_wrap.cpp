@@ -24,11 +24,13 @@ void export_misc();
 void export_node();
 void export_event();
 void export_anim();
+void export_gesture();
 
 #include "WrapHelper.h"
 #include "raw_constructor.hpp"
 
 #include "../base/OSHelper.h"
+#include "../base/FramePhaseTimer.h"
 #include "../graphics/ImageCache.h"
 #include "../player/Player.h"
 #include "../player/AVGNode.h"
@@ -54,6 +56,12 @@ using namespace std;
 
 namespace bp = boost::python;
 
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(Player_saveSceneFile_overloads,
+        saveSceneFile, 1, 2)
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(Player_setFrameTimePolicy_overloads,
+        setFrameTimePolicy, 1, 2)
+BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(Player_setLateFrameStart_overloads,
+        setLateFrameStart, 1, 2)
 BOOST_PYTHON_MEMBER_FUNCTION_OVERLOADS(Player_createNode_overloads,
         createNode, 2, 3)
 
@@ -74,6 +82,63 @@ CanvasPtr createMainCanvas(const boost::python::tuple &args,
 boost::function<size_t (const bp::tuple& args, const bp::dict& kwargs )>
         playerGetMemoryUsage = boost::bind(getMemoryUsage);
 
+static bp::dict Player_getFramePhaseTimes(Player* pPlayer)
+{
+    bp::dict times;
+    int numFrames = FramePhaseTimer::getNumFrames();
+    float usecsToMSecs = 0;
+    if (numFrames > 0) {
+        usecsToMSecs = 1.f/(numFrames*1000);
+    }
+    for (int i=0; i<FramePhaseTimer::NUM_PHASES; ++i) {
+        FramePhaseTimer::Phase phase = FramePhaseTimer::Phase(i);
+        times[FramePhaseTimer::getPhaseName(phase)] = 
+                FramePhaseTimer::getPhaseTime(phase)*usecsToMSecs;
+    }
+    times["frame"] = FramePhaseTimer::getFrameTime()*usecsToMSecs;
+    return times;
+}
+
+static void Player_resetFramePhaseTimes(Player* pPlayer)
+{
+    FramePhaseTimer::reset();
+}
+
+static bp::dict memoryStatsToDict(const MemoryStatsMap& stats)
+{
+    bp::dict statsDict;
+    for (MemoryStatsMap::const_iterator it = stats.begin(); it != stats.end(); ++it) {
+        statsDict[it->first] = bp::make_tuple(it->second.m_NumBytes, 
+                it->second.m_NumObjects);
+    }
+    return statsDict;
+}
+
+static MemoryStatsMap dictToMemoryStats(const bp::dict& statsDict)
+{
+    MemoryStatsMap stats;
+    bp::list items = statsDict.items();
+    for (int i = 0; i < bp::len(items); ++i) {
+        string sCategory = bp::extract<string>(items[i][0]);
+        long long numBytes = bp::extract<long long>(items[i][1][0]);
+        int numObjects = bp::extract<int>(items[i][1][1]);
+        stats[sCategory] = MemoryStats(numBytes, numObjects);
+    }
+    return stats;
+}
+
+static bp::dict Player_getMemoryStats(Player* pPlayer)
+{
+    return memoryStatsToDict(pPlayer->getMemoryStats());
+}
+
+static bp::dict Player_diffMemoryStats(Player* pPlayer, const bp::dict& oldStats,
+        const bp::dict& newStats)
+{
+    return memoryStatsToDict(ObjectCounter::diffMemoryStats(
+            dictToMemoryStats(oldStats), dictToMemoryStats(newStats)));
+}
+
 BOOST_PYTHON_MODULE(avg)
 {
     try {
@@ -113,6 +178,7 @@ BOOST_PYTHON_MODULE(avg)
             .def("isSubscribed", &Publisher::isSubscribedCallable)
             .def("isSubscribed", &Publisher::isSubscribed)
             .def("getNumSubscribers", &Publisher::getNumSubscribers)
+            .def("hasSubscribers", &Publisher::hasSubscribers)
             .def("publish", &Publisher::publish)
             .def("notifySubscribers", &Publisher::notifySubscribersPy)
             .def("genMessageID", &Publisher::genMessageID)
@@ -122,6 +188,7 @@ BOOST_PYTHON_MODULE(avg)
         export_event();
         export_node();
         export_anim();
+        export_gesture();
 
         enum_<GLConfig::ShaderUsage>("ShaderUsage")
             .value("SHADERUSAGE_FULL", GLConfig::FULL)
@@ -141,6 +208,7 @@ BOOST_PYTHON_MODULE(avg)
             .def("setWindowPos", &Player::setWindowPos)
             .def("setWindowTitle", &Player::setWindowTitle)
             .def("setWindowConfig", &Player::setWindowConfig)
+            .def("setParallelRender", &Player::setParallelRender)
             .def("useGLES", &Player::useGLES)
             .def("setOGLOptions", &Player::setOGLOptions)
             .def("setMultiSampleSamples", &Player::setMultiSampleSamples)
@@ -151,6 +219,9 @@ BOOST_PYTHON_MODULE(avg)
             .def("assumePixelsPerMM", &Player::assumePixelsPerMM)
             .def("loadFile", &Player::loadFile)
             .def("loadString", &Player::loadString)
+            .def("saveSceneFile", &Player::saveSceneFile,
+                    Player_saveSceneFile_overloads())
+            .def("convertToSceneFile", &Player::convertToSceneFile)
             .def("loadCanvasFile", &Player::loadCanvasFile)
             .def("loadCanvasString", &Player::loadCanvasString)
             .def("createMainCanvas", raw_function(createMainCanvas))
@@ -164,12 +235,30 @@ BOOST_PYTHON_MODULE(avg)
             .def("setFramerate", &Player::setFramerate)
             .def("setVBlankFramerate", &Player::setVBlankFramerate)
             .def("getEffectiveFramerate", &Player::getEffectiveFramerate)
+            .def("setFrameTimePolicy", &Player::setFrameTimePolicy,
+                    Player_setFrameTimePolicy_overloads())
+            .def("getFrameTimePolicy", &Player::getFrameTimePolicy)
+            .def("setLateFrameStart", &Player::setLateFrameStart,
+                    Player_setLateFrameStart_overloads())
+            .def("getFrameLateness", &Player::getFrameLateness)
+            .def("getPredictedPresentTime", &Player::getPredictedPresentTime)
+            .def("setPreRenderThreads", &Player::setPreRenderThreads)
+            .def("getPreRenderThreads", &Player::getPreRenderThreads)
+            .def("setMipmapThreads", &Player::setMipmapThreads)
+            .def("getMipmapThreads", &Player::getMipmapThreads)
+            .def("setMipmapUploadBudget", &Player::setMipmapUploadBudget)
+            .def("getNumPendingMipmaps", &Player::getNumPendingMipmaps)
             .def("getMemoryUsage", raw_function(playerGetMemoryUsage))
             .def("getTestHelper", &Player::getTestHelper,
                     return_value_policy<reference_existing_object>())
             .def("setFakeFPS", &Player::setFakeFPS)
             .def("getFrameTime", &Player::getFrameTime)
             .def("getFrameDuration", &Player::getFrameDuration)
+            .def("getFramePhaseTimes", &Player_getFramePhaseTimes)
+            .def("resetFramePhaseTimes", &Player_resetFramePhaseTimes)
+            .def("getMemoryStats", &Player_getMemoryStats)
+            .def("diffMemoryStats", &Player_diffMemoryStats)
+            .def("setMemoryStatsInterval", &Player::setMemoryStatsInterval)
             .def("createNode", &Player::createNodeFromXmlString)
             .def("createNode", &Player::createNode, Player_createNode_overloads())
             .def("getTouchUserBmp", &Player::getTouchUserBmp)
@@ -184,6 +273,7 @@ BOOST_PYTHON_MODULE(avg)
             .def("getCurrentEvent", &Player::getCurrentEvent)
             .def("getKeyModifierState", &Player::getKeyModifierState)
             .def("screenshot", &Player::screenshot)
+            .def("screenshotAsync", &Player::screenshotAsync)
             .def("keepWindowOpen", &Player::keepWindowOpen)
             .def("stopOnEscape", &Player::setStopOnEscape)
             .def("showCursor", &Player::showCursor)
@@ -194,6 +284,8 @@ BOOST_PYTHON_MODULE(avg)
             .def("getVideoRefreshRate", &Player::getVideoRefreshRate)
             .def("getVideoMemInstalled", &Player::getVideoMemInstalled)
             .def("getVideoMemUsed", &Player::getVideoMemUsed)
+            .def("getNumGLStateChanges", &Player::getNumGLStateChanges)
+            .def("getNumElidedGLStateChanges", &Player::getNumElidedGLStateChanges)
             .def("setGamma", &Player::setGamma)
             .def("setMousePos", &Player::setMousePos)
             .def("loadPlugin", &Player::loadPlugin)
@@ -213,12 +305,14 @@ BOOST_PYTHON_MODULE(avg)
             .def("getRootNode", &Canvas::getRootNode)
             .def("getElementByID", &Canvas::getElementByID)
             .def("screenshot", &Canvas::screenshot)
+            .def("getNumCulledNodes", &Canvas::getNumCulledNodes)
         ;
 
         class_<OffscreenCanvas, bases<Canvas>, boost::noncopyable>
                 ("OffscreenCanvas", no_init)
             .def("getID", &OffscreenCanvas::getID)
             .def("render", &OffscreenCanvas::manualRender)
+            .def("screenshotAsync", &OffscreenCanvas::screenshotAsync)
             .def("registerCameraNode", &OffscreenCanvas::registerCameraNode)
             .def("unregisterCameraNode", &OffscreenCanvas::unregisterCameraNode)
             .add_property("handleevents", &OffscreenCanvas::getHandleEvents)
@@ -253,6 +253,8 @@ void export_bitmap()
     ;
     implicitly_convertible<glm::vec3, Color>();
     implicitly_convertible<string, Color>();
+    to_python_converter<vector<Color>, to_list<vector<Color> > >();    
+    from_python_sequence<vector<Color> >();
 
     enum_<PixelFormat>("pixelformat")
         .value("B5G6R5", B5G6R5)
@@ -300,6 +302,7 @@ void export_bitmap()
         .def("save", &Bitmap::save)
         .def("getSize", &Bitmap_getSize)
         .def("getFormat", &Bitmap::getPixelFormat)
+        .def("getMemNeeded", &Bitmap::getMemNeeded)
         .def("getPixels", &Bitmap_getPixels, Bitmap_getPixels_overloads())
         .def("setPixels", &Bitmap_setPixels, Bitmap_setPixels_overloads())
         .def("getPixel", &Bitmap::getPythonPixel)
@@ -116,6 +116,10 @@ void export_event()
         .add_property("node", &CursorEvent::getNode)
         .add_property("speed", make_function(&CursorEvent::getSpeed,
                 return_value_policy<copy_const_reference>()))
+        .add_property("filtered", &CursorEvent::isFiltered)
+        .add_property("filteredpos", &CursorEvent::getFilteredPos)
+        .add_property("filteredspeed", make_function(&CursorEvent::getFilteredSpeed,
+                return_value_policy<copy_const_reference>()))
         .add_property("contact", &CursorEvent::getContact)
     ;
 
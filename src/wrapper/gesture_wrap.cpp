@@ -0,0 +1,135 @@
+//
+//  libavg - Media Playback Engine.
+//  Copyright (C) 2003-2014 Ulrich von Zadow
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+//  Current versions can be found at www.libavg.de
+//
+
+#include "WrapHelper.h"
+
+#include "../player/Recognizer.h"
+#include "../player/TapRecognizer.h"
+#include "../player/DoubletapRecognizer.h"
+#include "../player/SwipeRecognizer.h"
+#include "../player/HoldRecognizer.h"
+#include "../player/DragRecognizer.h"
+#include "../player/TransformRecognizer.h"
+#include "../player/Transform.h"
+#include "../player/Contact.h"
+#include "../player/CursorEvent.h"
+#include "../player/Node.h"
+
+#include <boost/shared_ptr.hpp>
+
+using namespace boost::python;
+using namespace avg;
+using namespace std;
+namespace bp = boost::python;
+
+void export_gesture()
+{
+    to_python_converter<vector<ContactPtr>, to_list<vector<ContactPtr> > >();
+
+    class_<Transform>("Transform", 
+            init<const glm::vec2&, optional<float, float, const glm::vec2&> >
+            ((bp::arg("trans"), bp::arg("rot")=0, bp::arg("scale")=1, 
+             bp::arg("pivot")=glm::vec2(0,0))))
+        .add_property("trans", make_getter(&Transform::m_Trans, 
+                return_value_policy<return_by_value>()), 
+                make_setter(&Transform::m_Trans))
+        .def_readwrite("rot", &Transform::m_Rot)
+        .def_readwrite("scale", &Transform::m_Scale)
+        .add_property("pivot", make_getter(&Transform::m_Pivot, 
+                return_value_policy<return_by_value>()), 
+                make_setter(&Transform::m_Pivot))
+        .def("moveNode", &Transform::moveNode)
+        .def("__repr__", &Transform::toString)
+        ;
+
+    object recognizerClass = class_<Recognizer, boost::shared_ptr<Recognizer>, 
+            bases<Publisher>, boost::noncopyable>("Recognizer", no_init)
+        .add_property("contacts", &Recognizer::getContacts)
+        .def("abort", &Recognizer::abort)
+        .def("enable", &Recognizer::enable)
+        .def("isEnabled", &Recognizer::isEnabled)
+        .def("getState", &Recognizer::getState)
+        ;
+    exportMessages(recognizerClass, "Recognizer");
+
+    class_<TapRecognizer, boost::shared_ptr<TapRecognizer>, bases<Recognizer>, 
+            boost::noncopyable>("TapRecognizer", no_init)
+        .def(init<NodePtr, float, float, CursorEventPtr, const object&, const object&, 
+                const object&>
+                ((bp::arg("node"), bp::arg("maxTime"), bp::arg("maxDist"), 
+                 bp::arg("initialEvent"), bp::arg("possibleHandler"), 
+                 bp::arg("failHandler"), bp::arg("detectedHandler"))))
+        ;
+
+    class_<DoubletapRecognizer, boost::shared_ptr<DoubletapRecognizer>, 
+            bases<Recognizer>, boost::noncopyable>("DoubletapRecognizer", no_init)
+        .def(init<NodePtr, float, float, CursorEventPtr, const object&, const object&, 
+                const object&>
+                ((bp::arg("node"), bp::arg("maxTime"), bp::arg("maxDist"), 
+                 bp::arg("initialEvent"), bp::arg("possibleHandler"), 
+                 bp::arg("failHandler"), bp::arg("detectedHandler"))))
+        ;
+
+    class_<SwipeRecognizer, boost::shared_ptr<SwipeRecognizer>, bases<Recognizer>, 
+            boost::noncopyable>("SwipeRecognizer", no_init)
+        .def(init<NodePtr, int, int, CursorEventPtr, float, float, float, 
+                const object&, const object&, const object&>
+                ((bp::arg("node"), bp::arg("direction"), bp::arg("numContacts"), 
+                 bp::arg("initialEvent"), bp::arg("directionTolerance"),
+                 bp::arg("minDist"), bp::arg("maxContactDist"),
+                 bp::arg("possibleHandler"), bp::arg("failHandler"), 
+                 bp::arg("detectedHandler"))))
+        ;
+
+    class_<HoldRecognizer, boost::shared_ptr<HoldRecognizer>, bases<Recognizer>, 
+            boost::noncopyable>("HoldRecognizer", no_init)
+        .def(init<NodePtr, float, float, CursorEventPtr, const object&, const object&, 
+                const object&, const object&>
+                ((bp::arg("node"), bp::arg("delay"), bp::arg("maxDist"), 
+                 bp::arg("initialEvent"), bp::arg("possibleHandler"), 
+                 bp::arg("failHandler"), bp::arg("detectedHandler"), 
+                 bp::arg("endHandler"))))
+        ;
+
+    class_<DragRecognizer, boost::shared_ptr<DragRecognizer>, bases<Recognizer>, 
+            boost::noncopyable>("DragRecognizer", no_init)
+        .def(init<NodePtr, NodePtr, CursorEventPtr, int, float, float, float,
+                const object&, const object&, const object&, const object&, 
+                const object&, const object&>
+                ((bp::arg("eventNode"), bp::arg("coordSysNode"), 
+                 bp::arg("initialEvent"), bp::arg("direction"), 
+                 bp::arg("directionTolerance"), bp::arg("friction"), 
+                 bp::arg("minDragDist"), bp::arg("possibleHandler"), 
+                 bp::arg("failHandler"), bp::arg("detectedHandler"), 
+                 bp::arg("moveHandler"), bp::arg("upHandler"), bp::arg("endHandler"))))
+        ;
+
+    class_<TransformRecognizer, boost::shared_ptr<TransformRecognizer>, 
+            bases<Recognizer>, boost::noncopyable>("TransformRecognizer", no_init)
+        .def(init<NodePtr, NodePtr, CursorEventPtr, float, float, float,
+                const object&, const object&, const object&, const object&>
+                ((bp::arg("eventNode"), bp::arg("coordSysNode"), 
+                 bp::arg("initialEvent"), bp::arg("friction"), 
+                 bp::arg("filterMinCutoff"), bp::arg("filterBeta"),
+                 bp::arg("detectedHandler"), bp::arg("moveHandler"), 
+                 bp::arg("upHandler"), bp::arg("endHandler"))))
+        ;
+}
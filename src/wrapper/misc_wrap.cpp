@@ -133,9 +133,13 @@ void export_misc()
 
     class_<VideoWriter, boost::shared_ptr<VideoWriter>, boost::noncopyable>
             ("VideoWriter", no_init)
-        .def(init<CanvasPtr, const std::string&, int, int, int, bool>())
-        .def(init<CanvasPtr, const std::string&, int, int, int>())
-        .def(init<CanvasPtr, const std::string&, int>())
+        .def(init<CanvasPtr, const std::string&, optional<int, int, int, bool,
+                const std::string&, const std::string&, int, int, bool> >
+                ((bp::arg("canvas"), bp::arg("filename"), bp::arg("framerate")=30,
+                 bp::arg("qmin")=3, bp::arg("qmax")=5, bp::arg("synctoplayback")=true,
+                 bp::arg("codec")="mjpeg", bp::arg("preset")="", 
+                 bp::arg("numthreads")=0, bp::arg("maxqueuelength")=16,
+                 bp::arg("dropframes")=false)))
         .def("stop", &VideoWriter::stop)
         .def("pause", &VideoWriter::pause)
         .def("play", &VideoWriter::play)
@@ -143,6 +147,12 @@ void export_misc()
         .add_property("framerate", &VideoWriter::getFramerate)
         .add_property("qmin", &VideoWriter::getQMin)
         .add_property("qmax", &VideoWriter::getQMax)
+        .add_property("codec", &VideoWriter::getCodec)
+        .add_property("preset", &VideoWriter::getPreset)
+        .add_property("numthreads", &VideoWriter::getNumThreads)
+        .add_property("maxqueuelength", &VideoWriter::getMaxQueueLength)
+        .add_property("dropframes", &VideoWriter::getDropFrames)
+        .add_property("numdroppedframes", &VideoWriter::getNumDroppedFrames)
     ;
 
     BitmapPtr (SVG::*renderElement1)(const UTF8String&) = &SVG::renderElement;
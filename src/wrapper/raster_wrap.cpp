@@ -26,6 +26,7 @@ void export_raster2();
 
 #include "../graphics/Bitmap.h"
 #include "../player/ImageNode.h"
+#include "../player/InstancedNode.h"
 #include "../player/FontStyle.h"
 #include "../player/WordsNode.h"
 
@@ -33,10 +34,25 @@ using namespace boost::python;
 using namespace avg;
 using namespace std;
 
+namespace bp = boost::python;
+
 char imageNodeName[] = "image";
+char instancedNodeName[] = "instanced";
 char fontStyleName[] = "fontstyle";
 char wordsNodeName[] = "words";
 
+static void ImageNode_setBitmapRect(ImageNode* pNode, BitmapPtr pBmp,
+        const bp::object& dirtyRect)
+{
+    if (bp::len(dirtyRect) != 2) {
+        throw Exception(AVG_ERR_INVALID_ARGS, 
+                "setBitmap(): dirtyrect must be a pair of points.");
+    }
+    glm::vec2 tlPos = bp::extract<glm::vec2>(dirtyRect[0]);
+    glm::vec2 brPos = bp::extract<glm::vec2>(dirtyRect[1]);
+    pNode->setBitmap(pBmp, IntRect(IntPoint(tlPos), IntPoint(brPos)));
+}
+
 void export_raster()
 {
     scope mainScope;
@@ -84,7 +100,8 @@ void export_raster()
     class_<ImageNode, bases<RasterNode> >("ImageNode", no_init)
         .def("__init__", raw_constructor(createNode<imageNodeName>))
         .def("getBitmap", &ImageNode::getBitmap)
-        .def("setBitmap", &ImageNode::setBitmap)
+        .def("setBitmap", (void (ImageNode::*)(BitmapPtr))&ImageNode::setBitmap)
+        .def("setBitmap", &ImageNode_setBitmapRect)
         .add_property("href", 
                 make_function(&ImageNode::getHRef,
                         return_value_policy<copy_const_reference>()),
@@ -93,6 +110,44 @@ void export_raster()
                 &ImageNode::getCompression)
     ;
 
+    class_<InstancedNode, bases<AreaNode>, boost::noncopyable>("InstancedNode", no_init)
+        .def("__init__", raw_constructor(createNode<instancedNodeName>))
+        .def("setBitmap", &InstancedNode::setBitmap)
+        .def("setInstances", &InstancedNode::setInstances,
+                (bp::arg("positions"), bp::arg("sizes")=bp::list(),
+                 bp::arg("angles")=bp::list(), bp::arg("colors")=bp::list(),
+                 bp::arg("opacities")=bp::list()))
+        .add_property("href", 
+                make_function(&InstancedNode::getHRef,
+                        return_value_policy<copy_const_reference>()),
+                &InstancedNode::setHRef)
+        .add_property("shape", 
+                make_function(&InstancedNode::getShape,
+                        return_value_policy<copy_const_reference>()),
+                &InstancedNode::setShape)
+        .add_property("positions", 
+                make_function(&InstancedNode::getPositions,
+                        return_value_policy<copy_const_reference>()),
+                &InstancedNode::setPositions)
+        .add_property("sizes", 
+                make_function(&InstancedNode::getSizes,
+                        return_value_policy<copy_const_reference>()),
+                &InstancedNode::setSizes)
+        .add_property("angles", 
+                make_function(&InstancedNode::getAngles,
+                        return_value_policy<copy_const_reference>()),
+                &InstancedNode::setAngles)
+        .add_property("colors", 
+                make_function(&InstancedNode::getColors,
+                        return_value_policy<copy_const_reference>()),
+                &InstancedNode::setColors)
+        .add_property("opacities", 
+                make_function(&InstancedNode::getOpacities,
+                        return_value_policy<copy_const_reference>()),
+                &InstancedNode::setOpacities)
+        .add_property("numinstances", &InstancedNode::getNumInstances)
+    ;
+
     class_<FontStyle, bases<ExportedObject> >("FontStyle", no_init)
         .def("__init__", raw_constructor(createExportedObject<fontStyleName>))
         .def("__copy__", copyObject<FontStyle>)